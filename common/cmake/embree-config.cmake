@@ -56,3 +56,4 @@ SET(EMBREE_GEOMETRY_HAIR @EMBREE_GEOMETRY_HAIR@)
 SET(EMBREE_GEOMETRY_SUBDIV @EMBREE_GEOMETRY_SUBDIV@)
 SET(EMBREE_GEOMETRY_USER @EMBREE_GEOMETRY_USER@)
 SET(EMBREE_RAY_PACKETS @EMBREE_RAY_PACKETS@)
+SET(EMBREE_MAX_INSTANCE_LEVEL_COUNT @EMBREE_MAX_INSTANCE_LEVEL_COUNT@)
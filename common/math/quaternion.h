@@ -109,6 +109,8 @@ namespace embree
   template<typename T> __forceinline QuaternionT<T>& operator /=( QuaternionT<T>& a, const T             & b ) { return a = a*rcp(b); }
   template<typename T> __forceinline QuaternionT<T>& operator /=( QuaternionT<T>& a, const QuaternionT<T>& b ) { return a = a*rcp(b); }
 
+  template<typename T> __forceinline T dot( const QuaternionT<T>& a, const QuaternionT<T>& b ) { return a.r*b.r + a.i*b.i + a.j*b.j + a.k*b.k; }
+
   template<typename T> __forceinline Vec3<T> xfmPoint ( const QuaternionT<T>& a, const Vec3<T>&       b ) { return (a*QuaternionT<T>(b)*conj(a)).v(); }
   template<typename T> __forceinline Vec3<T> xfmVector( const QuaternionT<T>& a, const Vec3<T>&       b ) { return (a*QuaternionT<T>(b)*conj(a)).v(); }
   template<typename T> __forceinline Vec3<T> xfmNormal( const QuaternionT<T>& a, const Vec3<T>&       b ) { return (a*QuaternionT<T>(b)*conj(a)).v(); }
@@ -179,6 +181,25 @@ namespace embree
     k = sro*cya*cpi - cro*sya*spi;
   }
 
+  ////////////////////////////////////////////////////////////////////////////////
+  /// Interpolation
+  ////////////////////////////////////////////////////////////////////////////////
+
+  /*! spherical linear interpolation of two unit quaternions along the shorter arc */
+  template<typename T> __forceinline QuaternionT<T> slerp( const QuaternionT<T>& q0, const QuaternionT<T>& q1_, const T& t )
+  {
+    T cosTheta = dot(q0,q1_);
+    const QuaternionT<T> q1 = cosTheta < T(zero) ? -q1_ : q1_;
+    cosTheta = abs(cosTheta);
+
+    /* fall back to normalized linear interpolation for nearly identical rotations */
+    if (cosTheta > T(0.9995f))
+      return normalize((T(one)-t)*q0 + t*q1);
+
+    const T theta = acos(cosTheta);
+    return (sin((T(one)-t)*theta)*q0 + sin(t*theta)*q1)*rcp(sin(theta));
+  }
+
   ////////////////////////////////////////////////////////////////////////////////
   /// Output Operators
   ////////////////////////////////////////////////////////////////////////////////
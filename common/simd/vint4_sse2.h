@@ -108,7 +108,14 @@ namespace embree
     static __forceinline vint4 loadu( const unsigned char* const ptr ) {
       return  _mm_cvtepu8_epi32(_mm_loadu_si128((__m128i*)ptr));
     }
+#else
+    static __forceinline vint4 load( const unsigned char* const ptr ) {
+      return vint4(ptr[0],ptr[1],ptr[2],ptr[3]);
+    }
 
+    static __forceinline vint4 loadu( const unsigned char* const ptr ) {
+      return vint4(ptr[0],ptr[1],ptr[2],ptr[3]);
+    }
 #endif
 
     static __forceinline vint4 load(const unsigned short* const ptr) {
@@ -168,6 +168,15 @@ enum RTCParameter {
 
   RTC_CONFIG_COMMIT_JOIN = 23,               //!< checks if rtcCommitJoin can be used to join build operation (not supported when compiled with some older TBB versions)
   RTC_CONFIG_COMMIT_THREAD = 24,             //!< checks if rtcCommitThread is available (not supported when compiled with some older TBB versions)
+
+  RTC_TESSELLATION_CACHE_ACCESSES = 25,          //!< returns the number of lookups of patches in the tessellation cache (read only)
+  RTC_TESSELLATION_CACHE_HITS = 26,              //!< returns the number of lookups that found the patch in the tessellation cache (read only)
+  RTC_TESSELLATION_CACHE_TESSELLATIONS = 27,     //!< returns the number of patches tessellated into the tessellation cache (read only)
+  RTC_TESSELLATION_CACHE_TESSELLATED_BYTES = 28, //!< returns the number of bytes allocated for tessellated patches (read only)
+  RTC_TESSELLATION_CACHE_TESSELLATION_TIME = 29, //!< returns the time spent tessellating patches in microseconds, summed over all threads (read only)
+  RTC_TESSELLATION_CACHE_FLUSHES = 30,           //!< returns the number of invalidated tessellation cache segments (read only)
+  RTC_TESSELLATION_CACHE_WAIT_TIME = 31,         //!< returns the time threads waited for other threads of the tessellation cache in microseconds, summed over all threads (read only)
+  RTC_TESSELLATION_CACHE_CLEAR_STATS = 32,       //!< clears the tessellation cache statistics above (write only)
 };
 
 /*! \brief Configures some parameters. 
@@ -28,9 +28,9 @@ typedef struct __RTCThreadLocalAllocator {}* RTCThreadLocalAllocator;
 /*! Quality settings for BVH build. */
 enum RTCBuildQuality
 {
-  RTC_BUILD_QUALITY_LOW = 0,     //!< build low quality BVH (good for dynamic scenes)
-  RTC_BUILD_QUALITY_NORMAL = 1,  //!< build standard quality BVH
-  RTC_BUILD_QUALITY_HIGH = 2,    //!< build high quality BVH
+  RTC_BUILD_QUALITY_LOW = 0,     //!< build low quality BVH using a Morton builder (good for dynamic scenes)
+  RTC_BUILD_QUALITY_NORMAL = 1,  //!< build standard quality BVH using a PLOC builder
+  RTC_BUILD_QUALITY_HIGH = 2,    //!< build high quality BVH using a SAH builder
 };
 
 /*! Settings for builders */
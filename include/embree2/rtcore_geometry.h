@@ -66,6 +66,12 @@ enum RTCMatrixType {
   RTC_MATRIX_COLUMN_MAJOR_ALIGNED16 = 2,
 };
 
+/*! \brief Interpolation modes of the transformations of motion blurred instances */
+enum RTCTransformInterpolation {
+  RTC_TRANSFORM_INTERPOLATION_LINEAR = 0,     //!< linear interpolation of the transformation matrices
+  RTC_TRANSFORM_INTERPOLATION_QUATERNION = 1, //!< separate interpolation of translation, rotation (spherical), and scale/shear
+};
+
 /*! \brief Supported geometry flags to specify handling in dynamic scenes. */
 enum RTCGeometryFlags 
 {
@@ -222,6 +228,18 @@ RTCORE_API void rtcSetTransform2 (RTCScene scene,                         //!< s
                                   size_t timeStep = 0                     //!< timestep to set the matrix for 
   );
 
+/*! \brief Sets the interpolation mode of the transformations of a
+  motion blurred instance. With RTC_TRANSFORM_INTERPOLATION_QUATERNION
+  the transformation of each timestep is decomposed into a
+  translation, a rotation, and a scale/shear matrix, and the rotations
+  are interpolated spherically. This avoids the shrinking of objects
+  rotating between timesteps that the default linear interpolation of
+  the matrices causes. */
+RTCORE_API void rtcSetTransformInterpolation (RTCScene scene,                            //!< scene handle
+                                              unsigned int geomID,                       //!< ID of geometry
+                                              RTCTransformInterpolation interpolation    //!< interpolation mode
+  );
+
 /*! \brief Creates a new triangle mesh. The number of triangles
   (numTriangles), number of vertices (numVertices), and number of time
   steps (1 for normal meshes, and up to RTC_MAX_TIME_STEPS for multi
@@ -52,6 +52,9 @@ public:
   unsigned geomID;        //!< geometry ID
   unsigned primID;        //!< primitive ID
   unsigned instID;        //!< instance ID
+#if RTC_MAX_INSTANCE_LEVEL_COUNT > 1
+  unsigned nestedInstID[RTC_MAX_INSTANCE_LEVEL_COUNT-1]; //!< instance IDs of nested instance levels
+#endif
 };
 #endif
 
@@ -88,6 +91,9 @@ public:
   unsigned geomID[4];  //!< geometry ID
   unsigned primID[4];  //!< primitive ID
   unsigned instID[4];  //!< instance ID
+#if RTC_MAX_INSTANCE_LEVEL_COUNT > 1
+  unsigned nestedInstID[RTC_MAX_INSTANCE_LEVEL_COUNT-1][4]; //!< instance IDs of nested instance levels
+#endif
 };
 #endif
 
@@ -124,6 +130,9 @@ public:
   unsigned geomID[8];  //!< geometry ID
   unsigned primID[8];  //!< primitive ID
   unsigned instID[8];  //!< instance ID
+#if RTC_MAX_INSTANCE_LEVEL_COUNT > 1
+  unsigned nestedInstID[RTC_MAX_INSTANCE_LEVEL_COUNT-1][8]; //!< instance IDs of nested instance levels
+#endif
 };
 #endif
 
@@ -160,6 +169,9 @@ public:
   unsigned geomID[16];  //!< geometry ID
   unsigned primID[16];  //!< primitive ID
   unsigned instID[16];  //!< instance ID
+#if RTC_MAX_INSTANCE_LEVEL_COUNT > 1
+  unsigned nestedInstID[RTC_MAX_INSTANCE_LEVEL_COUNT-1][16]; //!< instance IDs of nested instance levels
+#endif
 };
 #endif
 
@@ -191,6 +203,9 @@ RTCORE_FORCEINLINE float& RTCRayN_v   (RTCRayN* ptr, size_t N, size_t i) { const
 RTCORE_FORCEINLINE unsigned& RTCRayN_geomID(RTCRayN* ptr, size_t N, size_t i) { const size_t N1 = (size_t)(N == 1); return ((unsigned*)ptr)[15*N+3*N1+i]; }; //!< geometry ID
 RTCORE_FORCEINLINE unsigned& RTCRayN_primID(RTCRayN* ptr, size_t N, size_t i) { const size_t N1 = (size_t)(N == 1); return ((unsigned*)ptr)[16*N+3*N1+i]; }; //!< primitive ID
 RTCORE_FORCEINLINE unsigned& RTCRayN_instID(RTCRayN* ptr, size_t N, size_t i) { const size_t N1 = (size_t)(N == 1); return ((unsigned*)ptr)[17*N+3*N1+i]; }; //!< instance ID
+#if RTC_MAX_INSTANCE_LEVEL_COUNT > 1
+RTCORE_FORCEINLINE unsigned& RTCRayN_nestedInstID(RTCRayN* ptr, size_t N, size_t i, size_t l) { const size_t N1 = (size_t)(N == 1); return ((unsigned*)ptr)[(18+l)*N+3*N1+i]; }; //!< instance ID of nested instance level l+1
+#endif
 #endif
 
 /* Helper structure to create a ray packet of compile time size N */
@@ -227,6 +242,9 @@ public:
   unsigned geomID[N];  //!< geometry ID
   unsigned primID[N];  //!< primitive ID
   unsigned instID[N];  //!< instance ID
+#if RTC_MAX_INSTANCE_LEVEL_COUNT > 1
+  unsigned nestedInstID[RTC_MAX_INSTANCE_LEVEL_COUNT-1][N]; //!< instance IDs of nested instance levels
+#endif
 };
 #endif
 
@@ -265,6 +283,9 @@ public:
   unsigned* geomID;  //!< geometry ID
   unsigned* primID;  //!< primitive ID
   unsigned* instID;  //!< instance ID (optional)
+#if RTC_MAX_INSTANCE_LEVEL_COUNT > 1
+  unsigned* nestedInstID[RTC_MAX_INSTANCE_LEVEL_COUNT-1]; //!< instance IDs of nested instance levels (optional)
+#endif
 };
 #endif
 
@@ -305,6 +326,36 @@ struct RTCHitNt : public RTCHitN
 };
 #endif
 
+/*! \brief Hit gathered by a k-nearest hit query. */
+#ifndef __RTCHit__
+#define __RTCHit__
+struct RTCHit
+{
+  float t;             //!< hit distance
+  float u;             //!< Barycentric u coordinate of hit
+  float v;             //!< Barycentric v coordinate of hit
+  float Ng[3];         //!< Unnormalized geometry normal
+
+  unsigned geomID;     //!< geometry ID
+  unsigned primID;     //!< primitive ID
+  unsigned instID;     //!< instance ID
+};
+#endif
+
+/*! \brief Buffer receiving the hits of a k-nearest hit query for a
+ *  single ray. The query stores the up to k closest hits of the ray
+ *  sorted by increasing distance in the hits array, which has to
+ *  provide space for k hits. */
+#ifndef __RTCHitBuffer__
+#define __RTCHitBuffer__
+struct RTCHitBuffer
+{
+  RTCHit* hits;        //!< array of k hits, sorted by increasing distance
+  unsigned k;          //!< maximal number of hits to gather
+  unsigned numHits;    //!< number of gathered hits, set by the query
+};
+#endif
+
 /*! @} */
 
 #endif
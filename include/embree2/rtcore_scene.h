@@ -26,6 +26,7 @@ struct RTCRay4;
 struct RTCRay8;
 struct RTCRay16;
 struct RTCRayNp;
+struct RTCHitBuffer;
 
 /*! scene flags */
 enum RTCSceneFlags 
@@ -39,6 +40,7 @@ enum RTCSceneFlags
   RTC_SCENE_COHERENT   = (1 << 9),    //!< optimize data structures for coherent rays
   RTC_SCENE_INCOHERENT = (1 << 10),    //!< optimize data structures for in-coherent rays (enabled by default)
   RTC_SCENE_HIGH_QUALITY = (1 << 11),  //!< create higher quality data structures
+  RTC_SCENE_OPTIMIZE_OCCLUSION = (1 << 12),  //!< order data structures for fast occlusion rays
 
   /* traversal algorithm flags */
   RTC_SCENE_ROBUST     = (1 << 16)     //!< use more robust traversal algorithms
@@ -59,7 +61,21 @@ enum RTCAlgorithmFlags
 enum RTCIntersectFlags
 {
   RTC_INTERSECT_COHERENT                 = 0,  //!< optimize for coherent rays
-  RTC_INTERSECT_INCOHERENT               = 1   //!< optimize for incoherent rays
+  RTC_INTERSECT_INCOHERENT               = 1,  //!< optimize for incoherent rays
+  RTC_INTERSECT_RAY_CONE                 = 2,  //!< select the tessellation level of subdivision surfaces by the ray cone of the context
+  RTC_INTERSECT_TRAVERSAL_STATS          = 4   //!< count the traversal steps of each ray into the traversal statistics of the context
+};
+
+/*! Traversal statistics of a single ray, see
+ *  RTC_INTERSECT_TRAVERSAL_STATS. The counters get incremented by
+ *  each traversal of the ray, thus have to get cleared by the
+ *  application. */
+struct RTCTraversalStats
+{
+  unsigned int numNodes;       //!< number of inner nodes intersected
+  unsigned int numLeaves;      //!< number of leaves visited
+  unsigned int numPrimBlocks;  //!< number of primitive blocks intersected, a block holds up to the SIMD width of primitives
+  unsigned int numFilterCalls; //!< number of intersection and occlusion filter function invocations
 };
 
 /*! intersection context passed to intersect/occluded calls */
@@ -67,6 +83,59 @@ struct RTCIntersectContext
 {
   RTCIntersectFlags flags;   //!< intersection flags
   void* userRayExt;          //!< can be used to pass extended ray data to callbacks
+  float coneWidth;           //!< width of the ray cone at the ray origin, only read with RTC_INTERSECT_RAY_CONE
+  float coneSpread;          //!< increase of the ray cone width per unit of ray distance, only read with RTC_INTERSECT_RAY_CONE
+  RTCTraversalStats* traversalStats; //!< statistics per ray of the query, only read with RTC_INTERSECT_TRAVERSAL_STATS
+};
+
+/*! Build and quality statistics of the acceleration structures of a
+ *  committed scene, see rtcGetSceneStatistics. Build times and
+ *  memory consumption are summed over all acceleration structures of
+ *  the scene. */
+struct RTCSceneStatistics
+{
+  /* build times of the last commit in seconds */
+  double commitTime;             //!< wall clock time of the last commit
+  double buildTime;              //!< time spent building the acceleration structures
+  double primRefTime;            //!< time spent generating primitive references
+  double hierarchyTime;          //!< time spent building the hierarchies (binning, node allocation, and leaf creation)
+
+  /* quality of the acceleration structures */
+  double sah;                    //!< SAH cost relative to the bounding box of the scene
+  size_t depth;                  //!< maximal depth of the hierarchies
+  size_t numPrimitives;          //!< number of primitives stored in the leaves
+  size_t numAlignedNodes;        //!< number of axis aligned nodes
+  size_t numUnalignedNodes;      //!< number of oriented nodes
+  size_t numAlignedNodesMB;      //!< number of axis aligned motion blur nodes
+  size_t numAlignedNodesMB4D;    //!< number of axis aligned motion blur nodes with time range
+  size_t numUnalignedNodesMB;    //!< number of oriented motion blur nodes
+  size_t numTransformNodes;      //!< number of transformation nodes
+  size_t numQuantizedNodes;      //!< number of quantized nodes
+  size_t numLeaves;              //!< number of leaves
+  size_t numPrimBlocks;          //!< number of primitive blocks stored in the leaves
+  double nodeFillRate;           //!< ratio of used to available child slots of the nodes
+  double leafFillRate;           //!< ratio of used to available primitive slots of the leaves
+
+  /* memory consumption of the acceleration structures in bytes */
+  size_t bytesUsed;              //!< bytes used by nodes and leaves
+  size_t bytesFree;              //!< bytes allocated but still free
+  size_t bytesWasted;            //!< bytes lost due to alignment and block borders
+};
+
+/*! Closest point query, see rtcPointQuery1. The query has to be
+ *  aligned to 16 bytes. */
+struct RTCORE_ALIGN(16) RTCPointQuery
+{
+  /* query input */
+  float p[3];                    //!< query position
+  float radius;                  //!< search radius, reduced to the distance of the closest point found
+
+  /* query output */
+  float closest[3];              //!< closest point on the surface
+  float u;                       //!< barycentric u coordinate of the closest point
+  float v;                       //!< barycentric v coordinate of the closest point
+  unsigned geomID;               //!< geometry ID of the closest primitive
+  unsigned primID;               //!< primitive ID of the closest primitive
 };
 
 /*! \brief Defines an opaque scene type */
@@ -80,6 +149,28 @@ RTCORE_API RTCORE_DEPRECATED RTCScene rtcNewScene (RTCSceneFlags flags, RTCAlgor
 /*! Creates a new scene. */
 RTCORE_API RTCScene rtcDeviceNewScene (RTCDevice device, RTCSceneFlags flags, RTCAlgorithmFlags aflags);
 
+/*! \brief Defines an opaque type for scenes shared between devices */
+typedef struct __RTCSharedScene {}* RTCSharedScene;
+
+/*! Exports a committed static scene for tracing from other devices
+ *  of the same process. The returned handle keeps the scene and its
+ *  device alive until the handle and all scenes imported from it got
+ *  deleted. */
+RTCORE_API RTCSharedScene rtcExportScene (RTCScene scene);
+
+/*! Creates a new scene of the specified device that references an
+ *  exported scene without copying its geometry or acceleration
+ *  structure. The imported scene is read-only, it can get traced and
+ *  instanced, but no geometries can get added to it. Geometry IDs
+ *  reported by the imported scene are the ones of the exported
+ *  scene. The imported scene has to get deleted using
+ *  rtcDeleteScene. */
+RTCORE_API RTCScene rtcDeviceImportScene (RTCDevice device, RTCSharedScene scene);
+
+/*! Deletes the handle of an exported scene. Scenes imported from the
+ *  handle stay valid. */
+RTCORE_API void rtcDeleteSharedScene (RTCSharedScene scene);
+
 /*! \brief Type of progress callback function. */
 typedef bool (*RTCProgressMonitorFunc)(void* ptr, const double n);
 RTCORE_DEPRECATED typedef RTCProgressMonitorFunc RTC_PROGRESS_MONITOR_FUNCTION;
@@ -112,6 +203,24 @@ RTCORE_API void rtcCommitJoin (RTCScene scene);
  *  coprocessor. */
 RTCORE_API void rtcCommitThread(RTCScene scene, unsigned int threadID, unsigned int numThreads);
 
+/*! Commits the geometry of the scene asynchronously. The function
+ *  starts building the acceleration structures in the background and
+ *  returns immediately. Until the build finished, ray queries trace
+ *  the previously committed version of the scene, the new version is
+ *  swapped in atomically when the build finished. The scene must not
+ *  get modified before rtcCommitFinished returned true or
+ *  rtcCommitWait returned. */
+RTCORE_API void rtcCommitAsync (RTCScene scene);
+
+/*! Returns true if the asynchronous commit of the scene finished, or
+ *  no asynchronous commit got started. Errors of the commit are
+ *  reported when this function returns true. */
+RTCORE_API bool rtcCommitFinished (RTCScene scene);
+
+/*! Waits for the asynchronous commit of the scene to finish. Errors
+ *  of the commit are reported by this function. */
+RTCORE_API void rtcCommitWait (RTCScene scene);
+
 /*! Returns AABB of the scene. rtcCommit has to get called
  *  previously to this function. */
 RTCORE_API void rtcGetBounds(RTCScene scene, RTCBounds& bounds_o);
@@ -121,6 +230,11 @@ RTCORE_API void rtcGetBounds(RTCScene scene, RTCBounds& bounds_o);
  *  previously to this function. */
 RTCORE_API void rtcGetLinearBounds(RTCScene scene, RTCBounds* bounds_o);
 
+/*! Returns build time, quality, and memory statistics of the
+ *  acceleration structures of the scene. rtcCommit has to get called
+ *  previously to this function. */
+RTCORE_API void rtcGetSceneStatistics(RTCScene scene, RTCSceneStatistics* stats_o);
+
 /*! Intersects a single ray with the scene. The ray has to be aligned
  *  to 16 bytes. This function can only be called for scenes with the
  *  RTC_INTERSECT1 flag set. */
@@ -192,6 +306,40 @@ RTCORE_API void rtcIntersectNM (RTCScene scene, const RTCIntersectContext* conte
  *  of the ray packet. */
 RTCORE_API void rtcIntersectNp (RTCScene scene, const RTCIntersectContext* context, const RTCRayNp& rays, const size_t N);
 
+/*! Gathers the k closest hits of a single ray. The hits are stored
+ *  sorted by increasing distance in the hit buffer, and the hit data
+ *  of the ray is set to the closest hit. Once k hits are found the
+ *  ray segment is shortened to the distance of the k-th closest hit
+ *  to cull the remaining traversal. Intersection filter functions
+ *  decide which hits get gathered. This function can only be called
+ *  for scenes with the RTC_INTERSECT1 flag set. */
+RTCORE_API void rtcIntersectKNearest1 (RTCScene scene, const RTCIntersectContext* context, RTCRay& ray, RTCHitBuffer& hits);
+
+/*! Gathers the k closest hits of each valid ray of a packet of 4
+ *  rays. The hits array provides one hit buffer per ray of the
+ *  packet. This function can only be called for scenes with the
+ *  RTC_INTERSECT4 flag set. */
+RTCORE_API void rtcIntersectKNearest4 (const void* valid, RTCScene scene, const RTCIntersectContext* context, RTCRay4& ray, RTCHitBuffer* hits);
+
+/*! Gathers the k closest hits of each valid ray of a packet of 8
+ *  rays. The hits array provides one hit buffer per ray of the
+ *  packet. This function can only be called for scenes with the
+ *  RTC_INTERSECT8 flag set. */
+RTCORE_API void rtcIntersectKNearest8 (const void* valid, RTCScene scene, const RTCIntersectContext* context, RTCRay8& ray, RTCHitBuffer* hits);
+
+/*! Gathers the k closest hits of each valid ray of a packet of 16
+ *  rays. The hits array provides one hit buffer per ray of the
+ *  packet. This function can only be called for scenes with the
+ *  RTC_INTERSECT16 flag set. */
+RTCORE_API void rtcIntersectKNearest16 (const void* valid, RTCScene scene, const RTCIntersectContext* context, RTCRay16& ray, RTCHitBuffer* hits);
+
+/*! Gathers the k closest hits of each ray of a stream of M rays. The
+ *  hits array provides one hit buffer per ray of the stream. This
+ *  function can only be called for scenes with the
+ *  RTC_INTERSECT_STREAM flag set. The stride specifies the offset
+ *  between rays in bytes. */
+RTCORE_API void rtcIntersectKNearest1M (RTCScene scene, const RTCIntersectContext* context, RTCRay* rays, RTCHitBuffer* hits, const size_t M, const size_t stride);
+
 /*! Tests if a single ray is occluded by the scene. The ray has to be
  *  aligned to 16 bytes. This function can only be called for scenes
  *  with the RTC_INTERSECT1 flag set. */
@@ -268,6 +416,19 @@ RTCORE_API void rtcOccludedNM (RTCScene scene, const RTCIntersectContext* contex
  *  of the ray packet. */
 RTCORE_API void rtcOccludedNp (RTCScene scene, const RTCIntersectContext* context, const RTCRayNp& rays, const size_t N);
 
+/*! Finds the closest point on the surface of the scene to the query
+ *  position within the search radius. If a point is found, its
+ *  position, barycentric coordinates, geometry ID, and primitive ID
+ *  are stored in the query, and the radius is set to its distance,
+ *  otherwise the geometry ID is set to RTC_INVALID_GEOMETRY_ID. Only
+ *  non motion blurred triangle meshes, quad meshes, and line segments are
+ *  considered, except for scenes created with RTC_SCENE_COMPACT. */
+RTCORE_API void rtcPointQuery1 (RTCScene scene, RTCPointQuery& query);
+
+/*! Performs M closest point queries stored with a stride of the
+ *  specified number of bytes, see rtcPointQuery1. */
+RTCORE_API void rtcPointQuery1M (RTCScene scene, RTCPointQuery* queries, const size_t M, const size_t stride);
+
 /*! Deletes the scene. All contained geometry get also destroyed. */
 RTCORE_API void rtcDeleteScene (RTCScene scene);
 
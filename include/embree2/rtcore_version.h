@@ -19,3 +19,6 @@
 #define RTCORE_VERSION_PATCH 4
 #define RTCORE_VERSION 21604
 #define RTCORE_VERSION_STRING "2.16.4"
+
+/*! maximal number of nested instance levels */
+#define RTC_MAX_INSTANCE_LEVEL_COUNT 1
@@ -0,0 +1,462 @@
+// ======================================================================== //
+// Copyright 2009-2017 Intel Corporation                                    //
+//                                                                          //
+// Licensed under the Apache License, Version 2.0 (the "License");          //
+// you may not use this file except in compliance with the License.         //
+// You may obtain a copy of the License at                                  //
+//                                                                          //
+//     http://www.apache.org/licenses/LICENSE-2.0                           //
+//                                                                          //
+// Unless required by applicable law or agreed to in writing, software      //
+// distributed under the License is distributed on an "AS IS" BASIS,        //
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. //
+// See the License for the specific language governing permissions and      //
+// limitations under the License.                                           //
+// ======================================================================== //
+
+#pragma once
+
+#include "bvh_builder_morton.h"
+#include "../../common/algorithms/parallel_prefix_sum.h"
+
+namespace embree
+{
+  namespace isa
+  {
+    /*! Parallel locally-ordered clustering (PLOC) builder. The
+     *  primitives get sorted by their Morton codes and then clustered
+     *  bottom-up: in each iteration every cluster searches the cluster
+     *  with the smallest merged surface area within a small window of
+     *  the Morton ordered cluster array, and mutual nearest neighbors
+     *  get merged. The resulting binary tree gets collapsed top-down
+     *  into a BVH of the requested branching factor, by always opening
+     *  the child with the largest surface area. The builder has the
+     *  same interface as the Morton builder. */
+    struct BVHBuilderPLOC
+    {
+      typedef BVHBuilderMorton::Settings Settings;
+      typedef BVHBuilderMorton::BuildPrim BuildPrim;
+
+      static const size_t MAX_BRANCHING_FACTOR = BVHBuilderMorton::MAX_BRANCHING_FACTOR;  //!< maximal supported BVH branching factor
+      static const size_t MIN_LARGE_LEAF_LEVELS = BVHBuilderMorton::MIN_LARGE_LEAF_LEVELS; //!< create balanced tree of we are that many levels before the maximal tree depth
+      static const size_t SEARCH_RADIUS = 16;      //!< number of clusters to the left and right searched for the nearest neighbor
+      static const size_t BLOCK_SIZE = 1024;       //!< number of clusters processed per task
+      static const size_t NN_BLOCK_SIZE = 256;     //!< number of clusters processed at once by the nearest neighbor search
+
+      /*! number of inner nodes and clusters written by a range of clusters */
+      struct MergeCounts
+      {
+        __forceinline MergeCounts () {}
+        __forceinline MergeCounts (unsigned nodes, unsigned clusters)
+          : nodes(nodes), clusters(clusters) {}
+
+        __forceinline friend MergeCounts operator+ (const MergeCounts& a, const MergeCounts& b) {
+          return MergeCounts(a.nodes+b.nodes,a.clusters+b.clusters);
+        }
+
+        unsigned nodes;
+        unsigned clusters;
+      };
+
+      template<
+        typename ReductionTy,
+        typename Allocator,
+        typename CreateAllocator,
+        typename CreateNodeFunc,
+        typename SetNodeBoundsFunc,
+        typename CreateLeafFunc,
+        typename CalculateBounds,
+        typename ProgressMonitor>
+
+        class BuilderT : private Settings
+      {
+        ALIGNED_CLASS;
+
+      public:
+
+        BuilderT (CreateAllocator& createAllocator,
+                  CreateNodeFunc& createNode,
+                  SetNodeBoundsFunc& setBounds,
+                  CreateLeafFunc& createLeaf,
+                  CalculateBounds& calculateBounds,
+                  ProgressMonitor& progressMonitor,
+                  const Settings& settings)
+
+          : Settings(settings),
+          createAllocator(createAllocator),
+          createNode(createNode),
+          setBounds(setBounds),
+          createLeaf(createLeaf),
+          calculateBounds(calculateBounds),
+          progressMonitor(progressMonitor),
+          numPrimitives(0) {}
+
+        /*! node IDs below numPrimitives are leaves, the others index the inner node arrays */
+        __forceinline bool isLeaf(unsigned id) const { return id < numPrimitives; }
+        __forceinline unsigned size(unsigned id) const { return isLeaf(id) ? 1 : innerSize[id-numPrimitives]; }
+        __forceinline const BBox3fa& nodeBounds(unsigned id) const { assert(!isLeaf(id)); return innerBounds[id-numPrimitives]; }
+        __forceinline unsigned child(unsigned id, size_t i) const { return i == 0 ? nodeBounds(id).lower.u : nodeBounds(id).upper.u; }
+
+        /*! calculates the cluster with the smallest merged surface area for each cluster of a block, each pair gets evaluated only once */
+        void nearestNeighbors(const BBox3fa* clusters, size_t numClusters, const range<size_t>& block, unsigned* neighbor) const
+        {
+          /* the search window of the block's clusters reaches SEARCH_RADIUS clusters into the neighboring blocks */
+          const size_t begin = block.begin() > SEARCH_RADIUS ? block.begin()-SEARCH_RADIUS : 0;
+          const size_t end   = min(block.end()+SEARCH_RADIUS,numClusters);
+
+          /* merged surface areas with the right neighbors i+1+k and left neighbors i-1-k, missing neighbors get an infinite area */
+          float areaRight[(NN_BLOCK_SIZE+2*SEARCH_RADIUS)*SEARCH_RADIUS];
+          float areaLeft [(NN_BLOCK_SIZE+2*SEARCH_RADIUS)*SEARCH_RADIUS];
+          for (size_t i=0; i<(end-begin)*SEARCH_RADIUS; i+=4) {
+            vfloat4::storeu(&areaRight[i],vfloat4(pos_inf));
+            vfloat4::storeu(&areaLeft [i],vfloat4(pos_inf));
+          }
+
+          for (size_t i=begin; i<end; i++)
+          {
+            const BBox3fa bi = clusters[i];
+            const size_t num = min(i+SEARCH_RADIUS+1,end)-(i+1);
+            for (size_t k=0; k<num; k++) {
+              const float A = halfArea(merge(bi,clusters[i+1+k]));
+              const float Ac = A < FLT_MAX ? A : FLT_MAX; // also handles NaN
+              areaRight[(i-begin)*SEARCH_RADIUS+k] = Ac;
+              areaLeft[(i+1+k-begin)*SEARCH_RADIUS+k] = Ac;
+            }
+          }
+
+          /* ties get resolved towards the smaller index such that all clusters order pairs the same */
+          for (size_t i=block.begin(); i<block.end(); i++)
+          {
+            const float* Ar = &areaRight[(i-begin)*SEARCH_RADIUS];
+            const float* Al = &areaLeft [(i-begin)*SEARCH_RADIUS];
+            vfloat4 vmin(pos_inf);
+            for (size_t k=0; k<SEARCH_RADIUS; k+=4)
+              vmin = min(vmin,min(vfloat4::loadu(&Ar[k]),vfloat4::loadu(&Al[k])));
+            vmin = vreduce_min(vmin);
+
+            size_t maskLeft = 0, maskRight = 0;
+            for (size_t k=0; k<SEARCH_RADIUS; k+=4) {
+              maskLeft  |= size_t(movemask(vfloat4::loadu(&Al[k]) == vmin)) << k;
+              maskRight |= size_t(movemask(vfloat4::loadu(&Ar[k]) == vmin)) << k;
+            }
+            neighbor[i] = maskLeft ? unsigned(i-1-__bsr(maskLeft)) : unsigned(i+1+__bsf(maskRight));
+          }
+        }
+
+        /*! merges mutual nearest neighbors until a single cluster is left, returns the root */
+        unsigned cluster()
+        {
+          avector<BBox3fa> clusters0(numPrimitives), clusters1(numPrimitives);
+          BBox3fa* clusters = clusters0.data();
+          BBox3fa* clustersTmp = clusters1.data();
+          std::vector<unsigned> neighbor(numPrimitives);
+          std::vector<unsigned> levels;
+
+          /* every primitive starts as its own cluster, lower.u stores the node ID */
+          parallel_for(size_t(0), numPrimitives, size_t(BLOCK_SIZE), [&] (const range<size_t>& r) {
+              for (size_t i=r.begin(); i<r.end(); i++) {
+                clusters[i] = calculateBounds(morton[i]);
+                clusters[i].lower.u = unsigned(i);
+              }
+            });
+
+          size_t numClusters = numPrimitives;
+          size_t numInner = 0;
+          while (numClusters > 1)
+          {
+            levels.push_back(unsigned(numInner));
+
+            parallel_for(size_t(0), numClusters, size_t(BLOCK_SIZE), [&] (const range<size_t>& r) {
+                for (size_t i=r.begin(); i<r.end(); i+=NN_BLOCK_SIZE)
+                  nearestNeighbors(clusters,numClusters,range<size_t>(i,min(i+NN_BLOCK_SIZE,r.end())),neighbor.data());
+              });
+
+            /* the left cluster of each mutual pair gets replaced by the merged cluster, the right one gets removed */
+            ParallelPrefixSumState<MergeCounts> pstate;
+            auto merge_clusters = [&] (const range<size_t>& r, const MergeCounts& base, bool write) -> MergeCounts
+            {
+              MergeCounts counts(0,0);
+              for (size_t i=r.begin(); i<r.end(); i++)
+              {
+                const unsigned j = neighbor[i];
+                const bool mutual = neighbor[j] == i;
+                if (mutual && j < i) continue;
+
+                if (mutual)
+                {
+                  if (write)
+                  {
+                    const size_t k = numInner+base.nodes+counts.nodes;
+                    BBox3fa b = merge(clusters[i],clusters[j]);
+                    b.lower.u = clusters[i].lower.u;
+                    b.upper.u = clusters[j].lower.u;
+                    innerBounds[k] = b;
+                    innerSize[k] = size(b.lower.u) + size(b.upper.u);
+                    b.lower.u = unsigned(numPrimitives+k);
+                    clustersTmp[base.clusters+counts.clusters] = b;
+                  }
+                  counts.nodes++;
+                }
+                else if (write)
+                  clustersTmp[base.clusters+counts.clusters] = clusters[i];
+
+                counts.clusters++;
+              }
+              return counts;
+            };
+
+            parallel_prefix_sum(pstate, size_t(0), numClusters, size_t(BLOCK_SIZE), MergeCounts(0,0), [&] (const range<size_t>& r, const MergeCounts& base) {
+                return merge_clusters(r,base,false);
+              }, std::plus<MergeCounts>());
+            const MergeCounts total = parallel_prefix_sum(pstate, size_t(0), numClusters, size_t(BLOCK_SIZE), MergeCounts(0,0), [&] (const range<size_t>& r, const MergeCounts& base) {
+                return merge_clusters(r,base,true);
+              }, std::plus<MergeCounts>());
+
+            /* the closest pair of clusters is always mutual, thus each iteration makes progress */
+            assert(total.nodes > 0);
+            numInner += total.nodes;
+            numClusters = total.clusters;
+            std::swap(clusters,clustersTmp);
+          }
+
+          /* calculate the offset of each subtree in depth first order, children are always created before their parents */
+          const unsigned root = clusters[0].lower.u;
+          offset[root] = 0;
+          for (ssize_t l=ssize_t(levels.size())-1; l>=0; l--)
+          {
+            const size_t begin = levels[l];
+            const size_t end = size_t(l+1) < levels.size() ? levels[l+1] : numInner;
+            parallel_for(begin, end, size_t(BLOCK_SIZE), [&] (const range<size_t>& r) {
+                for (size_t k=r.begin(); k<r.end(); k++) {
+                  const unsigned id = unsigned(numPrimitives+k);
+                  const unsigned left = child(id,0), right = child(id,1);
+                  offset[left ] = offset[id];
+                  offset[right] = offset[id] + size(left);
+                }
+              });
+          }
+          return root;
+        }
+
+        ReductionTy createLargeLeaf(size_t depth, const range<unsigned>& current, Allocator alloc)
+        {
+          /* this should never occur but is a fatal error */
+          if (depth > maxDepth)
+            throw_RTCError(RTC_UNKNOWN_ERROR,"depth limit reached");
+
+          /* create leaf for few primitives */
+          if (current.size() <= maxLeafSize)
+            return createLeaf(current,alloc);
+
+          /* fill all children by always splitting the largest one */
+          range<unsigned> children[MAX_BRANCHING_FACTOR];
+          size_t numChildren = 1;
+          children[0] = current;
+
+          do {
+
+            /* find best child with largest number of primitives */
+            size_t bestChild = -1;
+            size_t bestSize = 0;
+            for (size_t i=0; i<numChildren; i++)
+            {
+              /* ignore leaves as they cannot get split */
+              if (children[i].size() <= maxLeafSize)
+                continue;
+
+              /* remember child with largest size */
+              if (children[i].size() > bestSize) {
+                bestSize = children[i].size();
+                bestChild = i;
+              }
+            }
+            if (bestChild == size_t(-1)) break;
+
+            /*! split best child into left and right child */
+            auto split = children[bestChild].split();
+
+            /* add new children left and right */
+            children[bestChild] = children[numChildren-1];
+            children[numChildren-1] = split.first;
+            children[numChildren+0] = split.second;
+            numChildren++;
+
+          } while (numChildren < branchingFactor);
+
+          /* create node */
+          auto node = createNode(alloc,numChildren);
+
+          /* recurse into each child */
+          ReductionTy bounds[MAX_BRANCHING_FACTOR];
+          for (size_t i=0; i<numChildren; i++)
+            bounds[i] = createLargeLeaf(depth+1,children[i],alloc);
+
+          return setBounds(node,bounds,numChildren);
+        }
+
+        ReductionTy recurse(size_t depth, unsigned id, Allocator alloc, bool toplevel)
+        {
+          /* get thread local allocator */
+          if (!alloc)
+            alloc = createAllocator();
+
+          const range<unsigned> current(offset[id],offset[id]+size(id));
+
+          /* call memory monitor function to signal progress */
+          if (toplevel && current.size() <= singleThreadThreshold)
+            progressMonitor(current.size());
+
+          /* create leaf node */
+          if (unlikely(depth+MIN_LARGE_LEAF_LEVELS >= maxDepth || current.size() <= minLeafSize || isLeaf(id)))
+            return createLargeLeaf(depth,current,alloc);
+
+          /* fill all children by always opening the one with the largest surface area */
+          unsigned children[MAX_BRANCHING_FACTOR];
+          children[0] = child(id,0);
+          children[1] = child(id,1);
+          size_t numChildren = 2;
+
+          while (numChildren < branchingFactor)
+          {
+            int bestChild = -1;
+            float bestArea = neg_inf;
+            for (unsigned int i=0; i<numChildren; i++)
+            {
+              /* ignore leaves as they cannot get opened */
+              if (isLeaf(children[i]) || size(children[i]) <= minLeafSize)
+                continue;
+
+              /* remember child with largest area */
+              const float A = halfArea(nodeBounds(children[i]));
+              if (A > bestArea) {
+                bestArea = A;
+                bestChild = i;
+              }
+            }
+            if (bestChild == -1) break;
+
+            /* replace best child by its children */
+            const unsigned node = children[bestChild];
+            children[bestChild] = child(node,0);
+            children[numChildren++] = child(node,1);
+          }
+
+          /* allocate node */
+          auto node = createNode(alloc,numChildren);
+
+          /* process top parts of tree parallel */
+          ReductionTy bounds[MAX_BRANCHING_FACTOR];
+          if (current.size() > singleThreadThreshold)
+          {
+            /*! parallel_for is faster than spawing sub-tasks */
+            parallel_for(size_t(0), numChildren, [&] (const range<size_t>& r) {
+                for (size_t i=r.begin(); i<r.end(); i++) {
+                  bounds[i] = recurse(depth+1,children[i],nullptr,true);
+                  _mm_mfence(); // to allow non-temporal stores during build
+                }
+              });
+          }
+
+          /* finish tree sequentially */
+          else
+          {
+            for (size_t i=0; i<numChildren; i++)
+              bounds[i] = recurse(depth+1,children[i],alloc,false);
+          }
+
+          return setBounds(node,bounds,numChildren);
+        }
+
+        /* build function */
+        ReductionTy build(BuildPrim* src, BuildPrim* tmp, size_t numPrimitives)
+        {
+          /* sort morton codes */
+          morton = src;
+          this->numPrimitives = numPrimitives;
+          radix_sort_u32(src,tmp,numPrimitives,singleThreadThreshold);
+
+          if (numPrimitives <= 1)
+            return createLargeLeaf(1,range<unsigned>(0,(unsigned)numPrimitives),createAllocator());
+
+          /* build binary tree through clustering */
+          innerBounds.resize(numPrimitives-1);
+          innerSize.resize(numPrimitives-1);
+          offset.resize(2*numPrimitives-1);
+          const unsigned root = cluster();
+
+          /* reorder primitives such that each subtree covers a range of primitives, has to happen before
+           * nodes get allocated as tmp may be the first block of the node allocator */
+          parallel_for(size_t(0), numPrimitives, size_t(BLOCK_SIZE), [&] (const range<size_t>& r) {
+              for (size_t i=r.begin(); i<r.end(); i++) tmp[offset[i]] = src[i];
+            });
+          parallel_for(size_t(0), numPrimitives, size_t(BLOCK_SIZE), [&] (const range<size_t>& r) {
+              for (size_t i=r.begin(); i<r.end(); i++) src[i] = tmp[i];
+            });
+
+          /* collapse binary tree into BVH */
+          const ReductionTy result = recurse(1, root, nullptr, true);
+          _mm_mfence(); // to allow non-temporal stores during build
+
+          innerBounds.clear(); innerSize.clear(); offset.clear();
+          return result;
+        }
+
+      public:
+        CreateAllocator& createAllocator;
+        CreateNodeFunc& createNode;
+        SetNodeBoundsFunc& setBounds;
+        CreateLeafFunc& createLeaf;
+        CalculateBounds& calculateBounds;
+        ProgressMonitor& progressMonitor;
+
+      public:
+        BuildPrim* morton;
+        size_t numPrimitives;
+        avector<BBox3fa> innerBounds;    //!< bounds of inner nodes, lower.u and upper.u store the children
+        std::vector<unsigned> innerSize; //!< number of primitives of inner nodes
+        std::vector<unsigned> offset;    //!< offset of the first primitive of each node in depth first order
+      };
+
+      template<
+      typename ReductionTy,
+        typename CreateAllocFunc,
+        typename CreateNodeFunc,
+        typename SetBoundsFunc,
+        typename CreateLeafFunc,
+        typename CalculateBoundsFunc,
+        typename ProgressMonitor>
+
+        static ReductionTy build(CreateAllocFunc createAllocator,
+                                 CreateNodeFunc createNode,
+                                 SetBoundsFunc setBounds,
+                                 CreateLeafFunc createLeaf,
+                                 CalculateBoundsFunc calculateBounds,
+                                 ProgressMonitor progressMonitor,
+                                 BuildPrim* src,
+                                 BuildPrim* tmp,
+                                 size_t numPrimitives,
+                                 const Settings& settings)
+        {
+          typedef BuilderT<
+            ReductionTy,
+            decltype(createAllocator()),
+            CreateAllocFunc,
+            CreateNodeFunc,
+            SetBoundsFunc,
+            CreateLeafFunc,
+            CalculateBoundsFunc,
+            ProgressMonitor> Builder;
+
+          Builder builder(createAllocator,
+                          createNode,
+                          setBounds,
+                          createLeaf,
+                          calculateBounds,
+                          progressMonitor,
+                          settings);
+
+          return builder.build(src,tmp,numPrimitives);
+        }
+    };
+  }
+}
@@ -24,7 +24,7 @@
 #  define NUM_OBJECT_BINS 16
 #  define NUM_SPATIAL_BINS 16
 #else
-#  define NUM_OBJECT_BINS 32
+#  define NUM_OBJECT_BINS 64
 #  define NUM_SPATIAL_BINS 16
 #endif
 
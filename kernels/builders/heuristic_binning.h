@@ -32,11 +32,16 @@ namespace embree
       {
       public:
         __forceinline BinMapping() {}
+
+        /*! adaptive number of bins, many bins near the root and few bins in deep subtrees */
+        static __forceinline size_t numBins(size_t N) {
+          return min(BINS,size_t(4.0f + 0.05f*N));
+        }
         
         /*! calculates the mapping */
         __forceinline BinMapping(size_t N, const BBox3fa& centBounds) 
         {
-          num = min(BINS,size_t(4.0f + 0.05f*N));
+          num = numBins(N);
           assert(num >= 1);
           const vfloat4 diag = (vfloat4) centBounds.size();
           scale = select(diag > vfloat4(1E-34f),vfloat4(0.99f*num)/diag,vfloat4(0.0f));
@@ -56,7 +61,7 @@ namespace embree
         template<typename PrimInfo>
         __forceinline BinMapping(const PrimInfo& pinfo) 
         {
-          num = min(BINS,size_t(4.0f + 0.05f*pinfo.size()));
+          num = numBins(pinfo.size());
           const vfloat4 diag = (vfloat4) pinfo.centBounds.size();
           scale = select(diag > vfloat4(1E-34f),vfloat4(0.99f*num)/diag,vfloat4(0.0f));
           ofs  = (vfloat4) pinfo.centBounds.lower;
@@ -209,10 +214,10 @@ namespace embree
       __forceinline vint4 &counts(const size_t binID)             { return _counts[binID]; }
       __forceinline const vint4 &counts(const size_t binID) const { return _counts[binID]; }
 
-      /*! clears the bin info */
-      __forceinline void clear() 
+      /*! clears the bin info, binning only touches the first numBins bins */
+      __forceinline void clear(const size_t numBins = BINS) 
       {
-	for (size_t i=0; i<BINS; i++) {
+	for (size_t i=0; i<numBins; i++) {
 	  bounds(i,0) = bounds(i,1) = bounds(i,2) = empty;
 	  counts(i) = vint4(zero);
 	}
@@ -525,7 +530,7 @@ namespace embree
       }
       
       /*! clears the bin info */
-      __forceinline void clear() 
+      __forceinline void clear(const size_t numBins = 16) 
       {
         lower[0] = lower[1] = lower[2] = pos_inf;
         upper[0] = upper[1] = upper[2] = neg_inf;
@@ -937,7 +942,7 @@ namespace embree
       binner.bin(prims,begin,end,mapping);
     } else {
       binner = parallel_reduce(begin,end,blockSize,binner,
-                              [&](const range<size_t>& r) -> BinInfoT { BinInfoT binner(empty); binner.bin(prims + r.begin(), r.size(), mapping); return binner; },
+                              [&](const range<size_t>& r) -> BinInfoT { BinInfoT binner; binner.clear(mapping.size()); binner.bin(prims + r.begin(), r.size(), mapping); return binner; },
                               [&](const BinInfoT& b0, const BinInfoT& b1) -> BinInfoT { BinInfoT r = b0; r.merge(b1, mapping.size()); return r; });
     }
   }
@@ -949,7 +954,7 @@ namespace embree
       binner.bin(prims,begin,end,mapping,binBoundsAndCenter);
     } else {
       binner = parallel_reduce(begin,end,blockSize,binner,
-                              [&](const range<size_t>& r) -> BinInfoT { BinInfoT binner(empty); binner.bin(prims + r.begin(), r.size(), mapping, binBoundsAndCenter); return binner; },
+                              [&](const range<size_t>& r) -> BinInfoT { BinInfoT binner; binner.clear(mapping.size()); binner.bin(prims + r.begin(), r.size(), mapping, binBoundsAndCenter); return binner; },
                               [&](const BinInfoT& b0, const BinInfoT& b1) -> BinInfoT { BinInfoT r = b0; r.merge(b1, mapping.size()); return r; });
     }
   }
@@ -961,7 +966,7 @@ namespace embree
       binner.bin(prims,begin,end,mapping);
     } else {
       binner = parallel_reduce(begin,end,blockSize,binner,
-                              [&](const range<size_t>& r) -> BinInfoT { BinInfoT binner(empty); binner.bin(prims + r.begin(), r.size(), mapping); return binner; },
+                              [&](const range<size_t>& r) -> BinInfoT { BinInfoT binner; binner.clear(mapping.size()); binner.bin(prims + r.begin(), r.size(), mapping); return binner; },
                               [&](const BinInfoT& b0, const BinInfoT& b1) -> BinInfoT { BinInfoT r = b0; r.merge(b1, mapping.size()); return r; });
     }
   }
@@ -973,7 +978,7 @@ namespace embree
       binner.bin(prims,begin,end,mapping,binBoundsAndCenter);
     } else {
       binner = parallel_reduce(begin,end,blockSize,binner,
-                              [&](const range<size_t>& r) -> BinInfoT { BinInfoT binner(empty); binner.bin(prims + r.begin(), r.size(), mapping, binBoundsAndCenter); return binner; },
+                              [&](const range<size_t>& r) -> BinInfoT { BinInfoT binner; binner.clear(mapping.size()); binner.bin(prims + r.begin(), r.size(), mapping, binBoundsAndCenter); return binner; },
                               [&](const BinInfoT& b0, const BinInfoT& b1) -> BinInfoT { BinInfoT r = b0; r.merge(b1, mapping.size()); return r; });
     }
   }
@@ -81,8 +81,8 @@ namespace embree
         template<bool parallel>
         __forceinline const Split find_template(const PrimInfoRange& pinfo, const size_t logBlockSize)
         {
-          Binner binner(empty);
           const BinMapping<BINS> mapping(pinfo);
+          Binner binner; binner.clear(mapping.size());
           bin_serial_or_parallel<parallel>(binner,prims,pinfo.begin(),pinfo.end(),PARALLEL_FIND_BLOCK_SIZE,mapping);
           return binner.best(mapping,logBlockSize);
         }
@@ -229,8 +229,8 @@ namespace embree
         /*! finds the best object split */
         __noinline const ObjectSplit sequential_object_find(const PrimInfoExtRange& set, const size_t logBlockSize, SplitInfo &info)
         {
-          ObjectBinner binner(empty); 
           const BinMapping<OBJECT_BINS> mapping(set);
+          ObjectBinner binner; binner.clear(mapping.size());
           binner.bin(prims0,set.begin(),set.end(),mapping);
           ObjectSplit s = binner.best(mapping,logBlockSize);
           binner.getSplitInfo(mapping, s, info);
@@ -240,11 +240,11 @@ namespace embree
         /*! finds the best split */
         __noinline const ObjectSplit parallel_object_find(const PrimInfoExtRange& set, const size_t logBlockSize, SplitInfo &info)
         {
-          ObjectBinner binner(empty);
           const BinMapping<OBJECT_BINS> mapping(set);
           const BinMapping<OBJECT_BINS>& _mapping = mapping; // CLANG 3.4 parser bug workaround
+          ObjectBinner binner; binner.clear(mapping.size());
           binner = parallel_reduce(set.begin(),set.end(),PARALLEL_FIND_BLOCK_SIZE,binner,
-                                   [&] (const range<size_t>& r) -> ObjectBinner { ObjectBinner binner(empty); binner.bin(prims0+r.begin(),r.size(),_mapping); return binner; },
+                                   [&] (const range<size_t>& r) -> ObjectBinner { ObjectBinner binner; binner.clear(_mapping.size()); binner.bin(prims0+r.begin(),r.size(),_mapping); return binner; },
                                    [&] (const ObjectBinner& b0, const ObjectBinner& b1) -> ObjectBinner { ObjectBinner r = b0; r.merge(b1,_mapping.size()); return r; });
           ObjectSplit s = binner.best(mapping,logBlockSize);
           binner.getSplitInfo(mapping, s, info);
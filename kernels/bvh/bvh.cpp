@@ -39,6 +39,7 @@ namespace embree
   {
     set(BVHN::emptyNode,empty,0);
     alloc.clear();
+    cacheFile = nullptr;
   }
 
   template<int N>
@@ -123,6 +124,7 @@ namespace embree
   template<int N>
   double BVHN<N>::preBuild(const std::string& builderName)
   {
+    times = BuildTimes();
     if (builderName == "") 
       return inf;
 
@@ -132,9 +134,7 @@ namespace embree
       std::cout << "building BVH" << N << (builderName.find("MBlur") != std::string::npos ? "MB" : "") << "<" << primTy.name << "> using " << builderName << " ..." << std::endl << std::flush;
     }
 
-    double t0 = 0.0;
-    if (device->benchmark || device->verbosity(1)) t0 = getSeconds();
-    return t0;
+    return getSeconds();
   }
 
   template<int N>
@@ -143,9 +143,8 @@ namespace embree
     if (t0 == double(inf))
       return;
     
-    double dt = 0.0;
-    if (device->benchmark || device->verbosity(1)) 
-      dt = getSeconds()-t0;
+    const double dt = getSeconds()-t0;
+    times.total = dt;
 
     std::unique_ptr<BVHNStatistics<N>> stat;
 
@@ -190,6 +189,23 @@ namespace embree
     }
   }
 
+  template<int N>
+  void BVHN<N>::addStatistics(AccelStatistics& stat)
+  {
+    stat.buildTime     += times.total;
+    stat.primRefTime   += times.primrefs;
+    stat.hierarchyTime += times.hierarchy;
+    stat.bytesUsed     += alloc.getUsedBytes();
+    stat.bytesFree     += alloc.getFreeBytes();
+    stat.bytesWasted   += alloc.getWastedBytes();
+
+    if (root != BVHN::emptyNode)
+      BVHNStatistics<N>(this).add(stat);
+
+    for (size_t i=0; i<objects.size(); i++)
+      if (objects[i]) objects[i]->addStatistics(stat);
+  }
+
 #if defined(__AVX__)
   template class BVHN<8>;
 #endif
@@ -1223,7 +1223,8 @@ namespace embree
           scale_diff = diff / float(MAX_QUAN);
           iterations++;
         }
-        const float inv_diff   = float(MAX_QUAN) / diff;
+        /* flat bounds (e.g. of planar geometry) all quantize to zero */
+        const float inv_diff   = diff > 0.0f ? float(MAX_QUAN) / diff : 0.0f;
 
         vfloat<N> floor_lower = floor(  (lower - vfloat<N>(minF)) * vfloat<N>(inv_diff) );
         vfloat<N> ceil_upper  = ceil (  (upper - vfloat<N>(minF)) * vfloat<N>(inv_diff) );
@@ -1361,6 +1362,19 @@ namespace embree
       }
     }
 
+  public:
+
+    /*! build times of the last build in seconds */
+    struct BuildTimes
+    {
+      BuildTimes ()
+        : total(0.0), primrefs(0.0), hierarchy(0.0) {}
+
+      double total;      //!< time of the entire build
+      double primrefs;   //!< time to create the primref array
+      double hierarchy;  //!< time to build the hierarchy, including binning, node allocation, and leaf creation
+    };
+
   public:
 
     /*! BVHN default constructor. */
@@ -1388,6 +1402,9 @@ namespace embree
     /*! called by all builders after build ended */
     void postBuild(double t0);
 
+    /*! adds build times, quality, and memory statistics of the BVH */
+    void addStatistics(AccelStatistics& stat);
+
     /*! allocator class */
     struct Allocator {
       BVHN* bvh;
@@ -1481,11 +1498,13 @@ namespace embree
   public:
     size_t numPrimitives;              //!< number of primitives the BVH is build over
     size_t numVertices;                //!< number of vertices the BVH references
+    BuildTimes times;                  //!< build times of the last build
 
     /*! data arrays for special builders */
   public:
     std::vector<BVHN*> objects;
     vector_t<char,aligned_allocator<char,32>> subdiv_patches;
+    Ref<RefCount> cacheFile;           //!< mapped cache file the BVH got loaded from (see bvh_cache.h)
   };
 
   template<>
@@ -18,6 +18,9 @@
 
 #include "bvh8_factory.h"
 #include "../bvh/bvh.h"
+#include "../bvh/bvh_cache.h"
+#include "../bvh/bvh_restructure.h"
+#include "../bvh/bvh_occlusion_order.h"
 
 #include "../geometry/bezier1v.h"
 #include "../geometry/bezier1i.h"
@@ -173,6 +176,11 @@ namespace embree
 
   DECLARE_SYMBOL2(Accel::IntersectorN,BVH8VirtualIntersectorStream);
 
+  DECLARE_SYMBOL2(Accel::PointQuery1,BVH8Triangle4PointQuery1);
+  DECLARE_SYMBOL2(Accel::PointQuery1,BVH8Triangle4vPointQuery1);
+  DECLARE_SYMBOL2(Accel::PointQuery1,BVH8Quad4vPointQuery1);
+  DECLARE_SYMBOL2(Accel::PointQuery1,BVH8Line4iPointQuery1);
+
   DECLARE_ISA_FUNCTION(Builder*,BVH8Line4iSceneBuilderSAH,void* COMMA Scene* COMMA size_t);
   DECLARE_ISA_FUNCTION(Builder*,BVH8Line4iMBSceneBuilderSAH,void* COMMA Scene* COMMA size_t);
 
@@ -197,8 +205,10 @@ namespace embree
   DECLARE_ISA_FUNCTION(Builder*,BVH8VirtualMBSceneBuilderSAH,void* COMMA Scene* COMMA size_t);
 
   DECLARE_ISA_FUNCTION(Builder*,BVH8Triangle4SceneBuilderFastSpatialSAH,void* COMMA Scene* COMMA size_t);
+  DECLARE_ISA_FUNCTION(Builder*,BVH8Triangle4SceneBuilderStreamingSAH,void* COMMA Scene* COMMA size_t);
   DECLARE_ISA_FUNCTION(Builder*,BVH8Triangle4vSceneBuilderFastSpatialSAH,void* COMMA Scene* COMMA size_t);
   DECLARE_ISA_FUNCTION(Builder*,BVH8Quad4vSceneBuilderFastSpatialSAH,void* COMMA Scene* COMMA size_t);
+  DECLARE_ISA_FUNCTION(Builder*,BVH8Quad4vSceneBuilderStreamingSAH,void* COMMA Scene* COMMA size_t);
 
   DECLARE_ISA_FUNCTION(Builder*,BVH8BuilderTwoLevelTriangleMeshSAH,void* COMMA Scene* COMMA const createTriangleMeshAccelTy);
   DECLARE_ISA_FUNCTION(Builder*,BVH8BuilderTwoLevelQuadMeshSAH,void* COMMA Scene* COMMA const createQuadMeshAccelTy);
@@ -222,6 +232,9 @@ namespace embree
   DECLARE_ISA_FUNCTION(Builder*,BVH8Quad4vMeshBuilderMortonGeneral,void* COMMA QuadMesh* COMMA size_t);
   DECLARE_ISA_FUNCTION(Builder*,BVH8VirtualMeshBuilderMortonGeneral,void* COMMA AccelSet* COMMA size_t);
 
+  DECLARE_ISA_FUNCTION(Builder*,BVH8Triangle4MeshBuilderPLOC,void* COMMA TriangleMesh* COMMA size_t);
+  DECLARE_ISA_FUNCTION(Builder*,BVH8Quad4vMeshBuilderPLOC,void* COMMA QuadMesh* COMMA size_t);
+
   BVH8Factory::BVH8Factory(int bfeatures, int ifeatures)
   {
     selectBuilders(bfeatures);
@@ -255,8 +268,10 @@ namespace embree
     IF_ENABLED_USER(SELECT_SYMBOL_INIT_AVX(features,BVH8VirtualMBSceneBuilderSAH));
 
     IF_ENABLED_TRIS(SELECT_SYMBOL_INIT_AVX_AVX512KNL(features,BVH8Triangle4SceneBuilderFastSpatialSAH));
+    IF_ENABLED_TRIS(SELECT_SYMBOL_INIT_AVX_AVX512KNL(features,BVH8Triangle4SceneBuilderStreamingSAH));
     IF_ENABLED_TRIS(SELECT_SYMBOL_INIT_AVX_AVX512KNL(features,BVH8Triangle4vSceneBuilderFastSpatialSAH));
     IF_ENABLED_QUADS(SELECT_SYMBOL_INIT_AVX_AVX512KNL(features,BVH8Quad4vSceneBuilderFastSpatialSAH));
+    IF_ENABLED_QUADS(SELECT_SYMBOL_INIT_AVX_AVX512KNL(features,BVH8Quad4vSceneBuilderStreamingSAH));
 
     IF_ENABLED_TRIS  (SELECT_SYMBOL_INIT_AVX_AVX512KNL(features,BVH8BuilderTwoLevelTriangleMeshSAH));
     IF_ENABLED_QUADS (SELECT_SYMBOL_INIT_AVX_AVX512KNL(features,BVH8BuilderTwoLevelQuadMeshSAH));
@@ -279,6 +294,9 @@ namespace embree
     IF_ENABLED_TRIS(SELECT_SYMBOL_INIT_AVX_AVX2_AVX512KNL(features,BVH8Triangle4iMeshBuilderMortonGeneral));
     IF_ENABLED_QUADS(SELECT_SYMBOL_INIT_AVX_AVX2_AVX512KNL(features,BVH8Quad4vMeshBuilderMortonGeneral));
     IF_ENABLED_USER (SELECT_SYMBOL_INIT_AVX_AVX2_AVX512KNL(features,BVH8VirtualMeshBuilderMortonGeneral));
+
+    IF_ENABLED_TRIS(SELECT_SYMBOL_INIT_AVX_AVX2_AVX512KNL(features,BVH8Triangle4MeshBuilderPLOC));
+    IF_ENABLED_QUADS(SELECT_SYMBOL_INIT_AVX_AVX2_AVX512KNL(features,BVH8Quad4vMeshBuilderPLOC));
   }
 
   void BVH8Factory::selectIntersectors(int features)
@@ -316,6 +334,12 @@ namespace embree
     IF_ENABLED_USER(SELECT_SYMBOL_INIT_AVX_AVX2_AVX512KNL_AVX512SKX(features,BVH8VirtualIntersector1));
     IF_ENABLED_USER(SELECT_SYMBOL_INIT_AVX_AVX2_AVX512KNL_AVX512SKX(features,BVH8VirtualMBIntersector1));
 
+    /* select point queries */
+    IF_ENABLED_TRIS(SELECT_SYMBOL_INIT_AVX(features,BVH8Triangle4PointQuery1));
+    IF_ENABLED_TRIS(SELECT_SYMBOL_INIT_AVX(features,BVH8Triangle4vPointQuery1));
+    IF_ENABLED_QUADS(SELECT_SYMBOL_INIT_AVX(features,BVH8Quad4vPointQuery1));
+    IF_ENABLED_LINES(SELECT_SYMBOL_INIT_AVX(features,BVH8Line4iPointQuery1));
+
 #if defined (EMBREE_RAY_PACKETS)
 
     /* select intersectors4 */
@@ -505,6 +529,20 @@ namespace embree
     builder = factory->BVH8Quad4vMeshBuilderMortonGeneral(accel,mesh,0);
   }
 
+  void BVH8Factory::createTriangleMeshTriangle4PLOC(TriangleMesh* mesh, AccelData*& accel, Builder*& builder)
+  {
+    BVH8Factory* factory = mesh->scene->device->bvh8_factory.get();
+    accel = new BVH8(Triangle4::type,mesh->scene);
+    builder = factory->BVH8Triangle4MeshBuilderPLOC(accel,mesh,0);
+  }
+
+  void BVH8Factory::createQuadMeshQuad4vPLOC(QuadMesh* mesh, AccelData*& accel, Builder*& builder)
+  {
+    BVH8Factory* factory = mesh->scene->device->bvh8_factory.get();
+    accel = new BVH8(Quad4v::type,mesh->scene);
+    builder = factory->BVH8Quad4vMeshBuilderPLOC(accel,mesh,0);
+  }
+
   void BVH8Factory::createAccelSetMesh(AccelSet* mesh, AccelData*& accel, Builder*& builder)
   {
     BVH8Factory* factory = mesh->scene->device->bvh8_factory.get();
@@ -564,6 +602,7 @@ namespace embree
     Accel::Intersectors intersectors;
     intersectors.ptr = bvh;
     intersectors.intersector1  = BVH8Line4iIntersector1();
+    intersectors.pointQuery1   = BVH8Line4iPointQuery1();
 #if defined (EMBREE_RAY_PACKETS)
     intersectors.intersector4  = BVH8Line4iIntersector4();
     intersectors.intersector8  = BVH8Line4iIntersector8();
@@ -593,6 +632,7 @@ namespace embree
     Accel::Intersectors intersectors;
     intersectors.ptr = bvh;
     intersectors.intersector1           = BVH8Triangle4Intersector1Moeller();
+    intersectors.pointQuery1            = BVH8Triangle4PointQuery1();
 #if defined (EMBREE_RAY_PACKETS)
     intersectors.intersector4_filter    = BVH8Triangle4Intersector4HybridMoeller();
     intersectors.intersector4_nofilter  = BVH8Triangle4Intersector4HybridMoellerNoFilter();
@@ -612,6 +652,7 @@ namespace embree
     Accel::Intersectors intersectors;
     intersectors.ptr = bvh;
     intersectors.intersector1    = BVH8Triangle4vIntersector1Pluecker();
+    intersectors.pointQuery1     = BVH8Triangle4vPointQuery1();
 #if defined (EMBREE_RAY_PACKETS)
     intersectors.intersector4    = BVH8Triangle4vIntersector4HybridPluecker();
     intersectors.intersector8    = BVH8Triangle4vIntersector8HybridPluecker();
@@ -728,6 +769,7 @@ namespace embree
       Accel::Intersectors intersectors;
       intersectors.ptr = bvh;
       intersectors.intersector1           = BVH8Quad4vIntersector1Moeller();
+      intersectors.pointQuery1            = BVH8Quad4vPointQuery1();
 #if defined (EMBREE_RAY_PACKETS)
       intersectors.intersector4_filter    = BVH8Quad4vIntersector4HybridMoeller();
       intersectors.intersector4_nofilter  = BVH8Quad4vIntersector4HybridMoellerNoFilter();
@@ -745,6 +787,7 @@ namespace embree
       Accel::Intersectors intersectors;
       intersectors.ptr = bvh;
       intersectors.intersector1  = BVH8Quad4vIntersector1Pluecker();
+      intersectors.pointQuery1   = BVH8Quad4vPointQuery1();
 #if defined (EMBREE_RAY_PACKETS)
       intersectors.intersector4  = BVH8Quad4vIntersector4HybridPluecker();
       intersectors.intersector8  = BVH8Quad4vIntersector8HybridPluecker();
@@ -935,18 +978,23 @@ namespace embree
     Builder* builder = nullptr;
     if (scene->device->tri_builder == "default")  {
       switch (bvariant) {
-      case BuildVariant::STATIC      : builder = BVH8Triangle4SceneBuilderSAH(accel,scene,0); break;
+      case BuildVariant::STATIC      : builder = scene->device->build_memory_budget ? BVH8Triangle4SceneBuilderStreamingSAH(accel,scene,0) : BVH8Triangle4SceneBuilderSAH(accel,scene,0); break;
       case BuildVariant::DYNAMIC     : builder = BVH8BuilderTwoLevelTriangleMeshSAH(accel,scene,&createTriangleMeshTriangle4); break;
       case BuildVariant::HIGH_QUALITY: builder = BVH8Triangle4SceneBuilderFastSpatialSAH(accel,scene,0); break;
       }
     }
     else if (scene->device->tri_builder == "sah"         )  builder = BVH8Triangle4SceneBuilderSAH(accel,scene,0);
+    else if (scene->device->tri_builder == "streaming"   )  builder = BVH8Triangle4SceneBuilderStreamingSAH(accel,scene,0);
     else if (scene->device->tri_builder == "sah_fast_spatial")  builder = BVH8Triangle4SceneBuilderFastSpatialSAH(accel,scene,0);
     else if (scene->device->tri_builder == "sah_presplit")     builder = BVH8Triangle4SceneBuilderSAH(accel,scene,MODE_HIGH_QUALITY);
     else if (scene->device->tri_builder == "dynamic"     ) builder = BVH8BuilderTwoLevelTriangleMeshSAH(accel,scene,&createTriangleMeshTriangle4);
     else if (scene->device->tri_builder == "morton"     ) builder = BVH8BuilderTwoLevelTriangleMeshSAH(accel,scene,&createTriangleMeshTriangle4Morton);
+    else if (scene->device->tri_builder == "ploc"       ) builder = BVH8BuilderTwoLevelTriangleMeshSAH(accel,scene,&createTriangleMeshTriangle4PLOC);
     else throw_RTCError(RTC_INVALID_ARGUMENT,"unknown builder "+scene->device->tri_builder+" for BVH8<Triangle4>");
 
+    builder = BVHNRestructureBuilder<8>(accel,scene,builder,scene->device->tri_builder);
+    builder = BVHNOcclusionOrderBuilder<8>(accel,scene,builder,scene->device->tri_builder);
+    builder = BVHNCacheBuilder<8>(accel,scene,builder,Geometry::TRIANGLE_MESH,scene->device->tri_builder);
     return new AccelInstance(accel,builder,intersectors);
   }
 
@@ -963,6 +1011,8 @@ namespace embree
       }
     }
     else throw_RTCError(RTC_INVALID_ARGUMENT,"unknown builder "+scene->device->tri_builder+" for BVH8<Triangle4v>");
+    builder = BVHNRestructureBuilder<8>(accel,scene,builder,scene->device->tri_builder);
+    builder = BVHNOcclusionOrderBuilder<8>(accel,scene,builder,scene->device->tri_builder);
     return new AccelInstance(accel,builder,intersectors);
   }
 
@@ -982,6 +1032,9 @@ namespace embree
     else throw_RTCError(RTC_INVALID_ARGUMENT,"unknown builder "+scene->device->tri_builder+" for BVH8<Triangle4i>");
 
     scene->needTriangleVertices = true;
+    builder = BVHNRestructureBuilder<8>(accel,scene,builder,scene->device->tri_builder);
+    builder = BVHNOcclusionOrderBuilder<8>(accel,scene,builder,scene->device->tri_builder);
+    builder = BVHNCacheBuilder<8>(accel,scene,builder,Geometry::TRIANGLE_MESH,scene->device->tri_builder);
     return new AccelInstance(accel,builder,intersectors);
   }
 
@@ -1050,16 +1103,21 @@ namespace embree
     Builder* builder = nullptr;
     if (scene->device->quad_builder == "default") {
       switch (bvariant) {
-      case BuildVariant::STATIC      : builder = BVH8Quad4vSceneBuilderSAH(accel,scene,0); break;
+      case BuildVariant::STATIC      : builder = scene->device->build_memory_budget ? BVH8Quad4vSceneBuilderStreamingSAH(accel,scene,0) : BVH8Quad4vSceneBuilderSAH(accel,scene,0); break;
       case BuildVariant::DYNAMIC     : builder = BVH8BuilderTwoLevelQuadMeshSAH(accel,scene,&createQuadMeshQuad4v); break;
       case BuildVariant::HIGH_QUALITY: builder = BVH8Quad4vSceneBuilderFastSpatialSAH(accel,scene,0); break;
       }
     }
+    else if (scene->device->quad_builder == "streaming"    ) builder = BVH8Quad4vSceneBuilderStreamingSAH(accel,scene,0);
     else if (scene->device->quad_builder == "dynamic"      ) builder = BVH8BuilderTwoLevelQuadMeshSAH(accel,scene,&createQuadMeshQuad4v);
     else if (scene->device->quad_builder == "morton"       ) builder = BVH8BuilderTwoLevelQuadMeshSAH(accel,scene,&createQuadMeshQuad4vMorton);
+    else if (scene->device->quad_builder == "ploc"         ) builder = BVH8BuilderTwoLevelQuadMeshSAH(accel,scene,&createQuadMeshQuad4vPLOC);
     else if (scene->device->quad_builder == "sah_fast_spatial" ) builder = BVH8Quad4vSceneBuilderFastSpatialSAH(accel,scene,0);
     else throw_RTCError(RTC_INVALID_ARGUMENT,"unknown builder "+scene->device->quad_builder+" for BVH8<Quad4v>");
 
+    builder = BVHNRestructureBuilder<8>(accel,scene,builder,scene->device->quad_builder);
+    builder = BVHNOcclusionOrderBuilder<8>(accel,scene,builder,scene->device->quad_builder);
+    builder = BVHNCacheBuilder<8>(accel,scene,builder,Geometry::QUAD_MESH,scene->device->quad_builder);
     return new AccelInstance(accel,builder,intersectors);
   }
 
@@ -54,11 +54,13 @@ namespace embree
     static void createTriangleMeshTriangle4Morton (TriangleMesh* mesh, AccelData*& accel, Builder*& builder);
     static void createTriangleMeshTriangle4vMorton(TriangleMesh* mesh, AccelData*& accel, Builder*& builder);
     static void createTriangleMeshTriangle4iMorton(TriangleMesh* mesh, AccelData*& accel, Builder*& builder);
+    static void createTriangleMeshTriangle4PLOC   (TriangleMesh* mesh, AccelData*& accel, Builder*& builder);
     static void createTriangleMeshTriangle4 (TriangleMesh* mesh, AccelData*& accel, Builder*& builder);
     static void createTriangleMeshTriangle4v(TriangleMesh* mesh, AccelData*& accel, Builder*& builder);
     static void createTriangleMeshTriangle4i(TriangleMesh* mesh, AccelData*& accel, Builder*& builder);
 
     static void createQuadMeshQuad4vMorton(QuadMesh* mesh, AccelData*& accel, Builder*& builder);
+    static void createQuadMeshQuad4vPLOC(QuadMesh* mesh, AccelData*& accel, Builder*& builder);
     static void createQuadMeshQuad4v(QuadMesh* mesh, AccelData*& accel, Builder*& builder);
 
     static void createAccelSetMesh(AccelSet* mesh, AccelData*& accel, Builder*& builder);
@@ -231,6 +233,11 @@ namespace embree
 
     DEFINE_SYMBOL2(Accel::IntersectorN,BVH8VirtualIntersectorStream);
 
+    DEFINE_SYMBOL2(Accel::PointQuery1,BVH8Triangle4PointQuery1);
+    DEFINE_SYMBOL2(Accel::PointQuery1,BVH8Triangle4vPointQuery1);
+    DEFINE_SYMBOL2(Accel::PointQuery1,BVH8Quad4vPointQuery1);
+    DEFINE_SYMBOL2(Accel::PointQuery1,BVH8Line4iPointQuery1);
+
     // SAH scene builders
   private:
     DEFINE_ISA_FUNCTION(Builder*,BVH8Line4iSceneBuilderSAH,void* COMMA Scene* COMMA size_t);
@@ -259,8 +266,10 @@ namespace embree
     // SAH spatial scene builders
   private:
     DEFINE_ISA_FUNCTION(Builder*,BVH8Triangle4SceneBuilderFastSpatialSAH,void* COMMA Scene* COMMA size_t);
+    DEFINE_ISA_FUNCTION(Builder*,BVH8Triangle4SceneBuilderStreamingSAH,void* COMMA Scene* COMMA size_t);
     DEFINE_ISA_FUNCTION(Builder*,BVH8Triangle4vSceneBuilderFastSpatialSAH,void* COMMA Scene* COMMA size_t);
     DEFINE_ISA_FUNCTION(Builder*,BVH8Quad4vSceneBuilderFastSpatialSAH,void* COMMA Scene* COMMA size_t);
+    DEFINE_ISA_FUNCTION(Builder*,BVH8Quad4vSceneBuilderStreamingSAH,void* COMMA Scene* COMMA size_t);
 
     // twolevel scene builders
   private:
@@ -291,5 +300,8 @@ namespace embree
     DEFINE_ISA_FUNCTION(Builder*,BVH8Triangle4iMeshBuilderMortonGeneral,void* COMMA TriangleMesh* COMMA size_t);
     DEFINE_ISA_FUNCTION(Builder*,BVH8Quad4vMeshBuilderMortonGeneral,void* COMMA QuadMesh* COMMA size_t);
     DEFINE_ISA_FUNCTION(Builder*,BVH8VirtualMeshBuilderMortonGeneral,void* COMMA AccelSet* COMMA size_t);
+
+    DEFINE_ISA_FUNCTION(Builder*,BVH8Triangle4MeshBuilderPLOC,void* COMMA TriangleMesh* COMMA size_t);
+    DEFINE_ISA_FUNCTION(Builder*,BVH8Quad4vMeshBuilderPLOC,void* COMMA QuadMesh* COMMA size_t);
   };
 }
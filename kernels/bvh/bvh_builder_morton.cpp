@@ -22,6 +22,7 @@
 
 #include "../builders/primrefgen.h"
 #include "../builders/bvh_builder_morton.h"
+#include "../builders/bvh_builder_ploc.h"
 
 #include "../geometry/triangle.h"
 #include "../geometry/trianglev.h"
@@ -377,7 +378,8 @@ namespace embree
       Mesh* mesh;
     };        
 
-    template<int N, typename Mesh, typename Primitive>
+    /*! builds the BVH of a single mesh over the Morton codes of its primitives, using either the Morton or the PLOC builder */
+    template<int N, typename Mesh, typename Primitive, typename BVHBuilder = BVHBuilderMorton>
     class BVHNMeshBuilderMorton : public Builder
     {
       typedef BVHN<N> BVH;
@@ -422,7 +424,7 @@ namespace embree
         SetBVHNBounds<N> setBounds(bvh);
         CreateMortonLeaf<N,Primitive> createLeaf(mesh,morton.data());
         CalculateMeshBounds<Mesh> calculateBounds(mesh);
-        auto root = BVHBuilderMorton::build<NodeRecord>(
+        auto root = BVHBuilder::template build<NodeRecord>(
           typename BVH::CreateAlloc(bvh), 
           typename BVH::AlignedNode::Create(),
           setBounds,createLeaf,calculateBounds,bvh->scene->progressInterface,
@@ -477,6 +479,22 @@ namespace embree
 #endif
 #endif
 
+#if defined(EMBREE_GEOMETRY_TRIANGLES)
+    Builder* BVH4Triangle4MeshBuilderPLOC  (void* bvh, TriangleMesh* mesh, size_t mode) { return new class BVHNMeshBuilderMorton<4,TriangleMesh,Triangle4, BVHBuilderPLOC>((BVH4*)bvh,mesh,4,4); }
+    Builder* BVH4Triangle4vMeshBuilderPLOC (void* bvh, TriangleMesh* mesh, size_t mode) { return new class BVHNMeshBuilderMorton<4,TriangleMesh,Triangle4v,BVHBuilderPLOC>((BVH4*)bvh,mesh,4,4); }
+    Builder* BVH4Triangle4iMeshBuilderPLOC (void* bvh, TriangleMesh* mesh, size_t mode) { return new class BVHNMeshBuilderMorton<4,TriangleMesh,Triangle4i,BVHBuilderPLOC>((BVH4*)bvh,mesh,4,4); }
+#if defined(__AVX__)
+    Builder* BVH8Triangle4MeshBuilderPLOC  (void* bvh, TriangleMesh* mesh, size_t mode) { return new class BVHNMeshBuilderMorton<8,TriangleMesh,Triangle4, BVHBuilderPLOC>((BVH8*)bvh,mesh,4,4); }
+#endif
+#endif
+
+#if defined(EMBREE_GEOMETRY_QUADS)
+    Builder* BVH4Quad4vMeshBuilderPLOC (void* bvh, QuadMesh* mesh, size_t mode) { return new class BVHNMeshBuilderMorton<4,QuadMesh,Quad4v,BVHBuilderPLOC>((BVH4*)bvh,mesh,4,4); }
+#if defined(__AVX__)
+    Builder* BVH8Quad4vMeshBuilderPLOC (void* bvh, QuadMesh* mesh, size_t mode) { return new class BVHNMeshBuilderMorton<8,QuadMesh,Quad4v,BVHBuilderPLOC>((BVH8*)bvh,mesh,4,4); }
+#endif
+#endif
+
 #if defined(EMBREE_GEOMETRY_USER)
     Builder* BVH4VirtualMeshBuilderMortonGeneral (void* bvh, AccelSet* mesh, size_t mode) { return new class BVHNMeshBuilderMorton<4,AccelSet,Object>((BVH4*)bvh,mesh,1,BVH4::maxLeafBlocks); }
 #if defined(__AVX__)
@@ -16,7 +16,9 @@
 
 #include "bvh.h"
 #include "bvh_builder.h"
+#include "bvh_cache.h"
 #include "../builders/bvh_builder_msmblur.h"
+#include "../builders/bvh_builder_morton.h"
 
 #include "../builders/primrefgen.h"
 #include "../builders/splitter.h"
@@ -218,9 +220,12 @@ namespace embree
             settings.singleThreadThreshold = bvh->alloc.fixSingleThreadThreshold(N,DEFAULT_SINGLE_THREAD_THRESHOLD,numPrimitives,node_bytes+leaf_bytes);
             prims.resize(numPrimitives); 
 
+            const double t1 = getSeconds();
             PrimInfo pinfo = mesh ?
               createPrimRefArray<Mesh>  (mesh ,prims,bvh->scene->progressInterface) :
               createPrimRefArray<Mesh,false>(scene,prims,bvh->scene->progressInterface);
+            const double t2 = getSeconds();
+            bvh->times.primrefs = t2-t1;
 
             /* pinfo might has zero size due to invalid geometry */
             if (unlikely(pinfo.size() == 0))
@@ -232,6 +237,7 @@ namespace embree
 
             /* call BVH builder */
             NodeRef root = BVHNBuilderVirtual<N>::build(&bvh->alloc,CreateLeaf<N,Primitive>(bvh,prims.data()),bvh->scene->progressInterface,prims.data(),pinfo,settings);
+            bvh->times.hierarchy = getSeconds()-t2;
             bvh->set(root,LBBox3fa(pinfo.geomBounds),pinfo.size());
             bvh->layoutLargeNodes(size_t(pinfo.size()*0.005f));
 
@@ -308,9 +314,11 @@ namespace embree
 #endif
             /* create primref array */
             prims.resize(numPrimitives);
+            const double t1 = getSeconds();
             PrimInfo pinfo = mesh ?
               createPrimRefArray<Mesh>  (mesh ,prims,bvh->scene->progressInterface) :
               createPrimRefArray<Mesh,false>(scene,prims,bvh->scene->progressInterface);
+            bvh->times.primrefs = getSeconds()-t1;
 
             /* enable os_malloc for static scenes or dynamic scenes with static geometry */
             if (mesh == NULL || mesh->isStatic())
@@ -321,7 +329,9 @@ namespace embree
             const size_t leaf_bytes = size_t(1.2*Primitive::blocks(numPrimitives)*sizeof(Primitive));
             bvh->alloc.init_estimate(node_bytes+leaf_bytes);
             settings.singleThreadThreshold = bvh->alloc.fixSingleThreadThreshold(N,DEFAULT_SINGLE_THREAD_THRESHOLD,numPrimitives,node_bytes+leaf_bytes);
+            const double t2 = getSeconds();
             NodeRef root = BVHNBuilderQuantizedVirtual<N>::build(&bvh->alloc,CreateLeafQuantized<N,Primitive>(bvh,prims.data()),bvh->scene->progressInterface,prims.data(),pinfo,settings);
+            bvh->times.hierarchy = getSeconds()-t2;
             bvh->set(root,LBBox3fa(pinfo.geomBounds),pinfo.size());
             //bvh->layoutLargeNodes(pinfo.size()*0.005f); // FIXME: COPY LAYOUT FOR LARGE NODES !!!
 #if PROFILE
@@ -454,7 +464,9 @@ namespace embree
       {
         /* create primref array */
         mvector<PrimRef> prims(scene->device,numPrimitives);
+        const double t1 = getSeconds();
         const PrimInfo pinfo = createPrimRefArrayMBlur<Mesh>(0,scene,prims,bvh->scene->progressInterface);
+        bvh->times.primrefs = getSeconds()-t1;
 
         /* estimate acceleration structure size */
         const size_t node_bytes = pinfo.size()*sizeof(AlignedNodeMB)/(4*N);
@@ -473,10 +485,12 @@ namespace embree
         settings.singleThreadThreshold = bvh->alloc.fixSingleThreadThreshold(N,DEFAULT_SINGLE_THREAD_THRESHOLD,pinfo.size(),node_bytes+leaf_bytes);
 
         /* build hierarchy */
+        const double t2 = getSeconds();
         auto root = BVHBuilderBinnedSAH::build<NodeRecordMB>
           (typename BVH::CreateAlloc(bvh),typename BVH::AlignedNodeMB::Create2(),typename BVH::AlignedNodeMB::Set2(),
            CreateMBlurLeaf<N,Primitive>(bvh,prims.data(),0),bvh->scene->progressInterface,
            prims.data(),pinfo,settings);
+        bvh->times.hierarchy = getSeconds()-t2;
 
         bvh->set(root.ref,root.lbounds,pinfo.size());
       }
@@ -485,7 +499,9 @@ namespace embree
       {
         /* create primref array */
         mvector<PrimRefMB> prims(scene->device,numPrimitives);
+        const double t1 = getSeconds();
         PrimInfoMB pinfo = createPrimRefArrayMSMBlur<Mesh>(scene,prims,bvh->scene->progressInterface);
+        bvh->times.primrefs = getSeconds()-t1;
 
         /* estimate acceleration structure size */
         const size_t node_bytes = pinfo.num_time_segments*sizeof(AlignedNodeMB)/(4*N);
@@ -505,6 +521,7 @@ namespace embree
         settings.singleThreadThreshold = bvh->alloc.fixSingleThreadThreshold(N,DEFAULT_SINGLE_THREAD_THRESHOLD,pinfo.size(),node_bytes+leaf_bytes);
         
         /* build hierarchy */
+        const double t2 = getSeconds();
         auto root =
           BVHBuilderMSMBlur::build<NodeRef>(prims,pinfo,scene->device,
                                              RecalculatePrimRef<Mesh>(scene),
@@ -514,6 +531,7 @@ namespace embree
                                              CreateMSMBlurLeaf<N,Mesh,Primitive>(bvh),
                                              bvh->scene->progressInterface,
                                              settings);
+        bvh->times.hierarchy = getSeconds()-t2;
 
         bvh->set(root.ref,root.lbounds,pinfo.num_time_segments);
       }
@@ -527,6 +545,252 @@ namespace embree
     /************************************************************************************/
     /************************************************************************************/
 
+    /*! Out-of-core SAH builder for static scenes that keeps the
+     *  temporary build memory within the budget configured through the
+     *  build_memory_budget device option. The primitives get partitioned
+     *  along a Morton curve over their centroids into chunks that fit
+     *  into the budget. A sub-BVH gets built for each chunk, spilled to
+     *  a temporary file, and memory mapped back such that the OS can
+     *  evict its pages. A top level BVH gets finally built over the
+     *  roots of all chunks. The chunk BVHs are owned by the BVH through
+     *  its objects array. */
+    template<int N, typename Mesh, typename Primitive>
+    struct BVHNBuilderSAHStreaming : public Builder
+    {
+      typedef BVHN<N> BVH;
+      typedef typename BVHN<N>::NodeRef NodeRef;
+
+      static const size_t CELL_BITS = 18;                 //!< number of bits of the Morton code used to partition the primitives
+      static const size_t MIN_CHUNK_PRIMITIVES = 4096;    //!< chunks are never made smaller than this many primitives
+
+      /*! range of Morton cells assigned to one chunk */
+      struct Chunk
+      {
+        Chunk (unsigned int begin, unsigned int end, size_t size)
+          : begin(begin), end(end), size(size) {}
+
+        unsigned int begin, end;
+        size_t size;
+      };
+
+      BVH* bvh;
+      Scene* scene;
+      mvector<PrimRef> prims;
+      GeneralBVHBuilder::Settings settings;
+
+      BVHNBuilderSAHStreaming (BVH* bvh, Scene* scene, const size_t sahBlockSize, const float intCost, const size_t minLeafSize, const size_t maxLeafSize, const size_t mode)
+        : bvh(bvh), scene(scene), prims(scene->device,0),
+          settings(sahBlockSize, minLeafSize, min(maxLeafSize,Primitive::max_size()*BVH::maxLeafBlocks), travCost, intCost, DEFAULT_SINGLE_THREAD_THRESHOLD) {}
+
+      /*! estimated number of bytes required to build the BVH over a single primitive */
+      static size_t bytesPerPrimitive() {
+        return sizeof(PrimRef) + sizeof(typename BVH::AlignedNode)/(4*N) + size_t(1.2f*sizeof(Primitive)/Primitive::max_size()) + 1;
+      }
+
+      /*! directory to spill chunks to, prefers the BVH cache directory */
+      FileName spillDirectory() const
+      {
+        if (scene->device->bvh_cache != "") return FileName(scene->device->bvh_cache);
+        const char* dir = getenv("TMPDIR");
+        if (dir == nullptr) dir = getenv("TEMP");
+        if (dir == nullptr) dir = "/tmp";
+        return FileName(dir);
+      }
+
+      /*! deletes the chunk BVHs of the last build */
+      void deleteChunks()
+      {
+        for (size_t i=0; i<bvh->objects.size(); i++)
+          delete bvh->objects[i];
+        bvh->objects.clear();
+      }
+
+      /*! builds a BVH over the primitive references in prims */
+      void buildSAH(BVH* dst, const PrimInfo& pinfo)
+      {
+        dst->alloc.setOSallocation(true);
+        const size_t node_bytes = pinfo.size()*sizeof(typename BVH::AlignedNode)/(4*N);
+        const size_t leaf_bytes = size_t(1.2*Primitive::blocks(pinfo.size())*sizeof(Primitive));
+        dst->alloc.init_estimate(node_bytes+leaf_bytes);
+        settings.singleThreadThreshold = dst->alloc.fixSingleThreadThreshold(N,DEFAULT_SINGLE_THREAD_THRESHOLD,pinfo.size(),node_bytes+leaf_bytes);
+        NodeRef root = BVHNBuilderVirtual<N>::build(&dst->alloc,CreateLeaf<N,Primitive>(dst,prims.data()),bvh->scene->progressInterface,prims.data(),pinfo,settings);
+        dst->set(root,LBBox3fa(pinfo.geomBounds),pinfo.size());
+        dst->layoutLargeNodes(size_t(pinfo.size()*0.005f));
+      }
+
+      void build()
+      {
+	/* skip build for empty scene */
+        const size_t numPrimitives = scene->getNumPrimitives<Mesh,false>();
+        if (numPrimitives == 0) {
+          deleteChunks();
+          prims.clear();
+          bvh->clear();
+          return;
+        }
+
+        double t0 = bvh->preBuild(TOSTRING(isa) "::BVH" + toString(N) + "BuilderStreamingSAH");
+        deleteChunks();
+
+        /* calculate bounds without storing any primitive references */
+        Scene::Iterator<Mesh,false> iter(scene);
+        const PrimInfo pinfo = parallel_for_for_reduce(iter, size_t(1024), PrimInfo(empty), [&](Mesh* mesh, const range<size_t>& r, size_t k) -> PrimInfo
+        {
+          PrimInfo pinfo(empty);
+          for (size_t j=r.begin(); j<r.end(); j++)
+          {
+            BBox3fa bounds = empty;
+            if (!mesh->buildBounds(j,&bounds)) continue;
+            pinfo.add(bounds,bounds.center2());
+          }
+          return pinfo;
+        }, [](const PrimInfo& a, const PrimInfo& b) -> PrimInfo { return PrimInfo::merge(a,b); });
+
+        /* pinfo might has zero size due to invalid geometry */
+        if (unlikely(pinfo.size() == 0)) {
+          prims.clear();
+          bvh->clear();
+          return;
+        }
+
+        /* histogram of primitives over the Morton cells of their centroids */
+        const size_t numCells = size_t(1) << CELL_BITS;
+        const BVHBuilderMorton::MortonCodeMapping mapping(pinfo.centBounds);
+        auto cell = [&] (const BBox3fa& bounds) -> unsigned int { return mapping.code(bounds) >> (3*BVHBuilderMorton::MortonCodeMapping::LATTICE_BITS_PER_DIM-CELL_BITS); };
+        std::vector<std::atomic<size_t>> histogram(numCells);
+        for (size_t i=0; i<numCells; i++) histogram[i] = 0;
+        parallel_for_for(iter, size_t(1024), [&](Mesh* mesh, const range<size_t>& r, size_t k)
+        {
+          for (size_t j=r.begin(); j<r.end(); j++)
+          {
+            BBox3fa bounds = empty;
+            if (!mesh->buildBounds(j,&bounds)) continue;
+            histogram[cell(bounds)]++;
+          }
+        });
+
+        /* partition consecutive cells into chunks that fit into the memory budget */
+        const size_t budget = scene->device->build_memory_budget;
+        const size_t maxChunkPrimitives = budget ? max(budget/bytesPerPrimitive(),MIN_CHUNK_PRIMITIVES) : size_t(inf);
+        std::vector<Chunk> chunks;
+        size_t chunkSize = 0, chunkBegin = 0;
+        for (size_t i=0; i<numCells; i++)
+        {
+          const size_t n = histogram[i];
+          if (chunkSize && chunkSize+n > maxChunkPrimitives) {
+            chunks.push_back(Chunk(unsigned(chunkBegin),unsigned(i),chunkSize));
+            chunkBegin = i; chunkSize = 0;
+          }
+          chunkSize += n;
+        }
+        chunks.push_back(Chunk(unsigned(chunkBegin),unsigned(numCells),chunkSize));
+
+        /* the whole scene fits into the budget, build in memory */
+        if (chunks.size() == 1)
+        {
+          prims.resize(numPrimitives);
+          PrimInfo pinfo1 = createPrimRefArray<Mesh,false>(scene,prims,bvh->scene->progressInterface);
+          buildSAH(bvh,pinfo1);
+          prims.clear();
+          bvh->cleanup();
+          bvh->postBuild(t0);
+          return;
+        }
+
+        if (scene->device->verbosity(2)) {
+          Lock<MutexSys> lock(g_printMutex);
+          std::cout << "building " << pinfo.size() << " primitives in " << chunks.size() << " chunks of at most " << maxChunkPrimitives << " primitives" << std::endl;
+        }
+
+        /* build one BVH per chunk and spill it to disk */
+        const FileName dir = spillDirectory();
+        ParallelForForPrefixSumState<PrimInfo> pstate;
+        pstate.init(iter,size_t(1024));
+        bvh->objects.resize(chunks.size());
+        for (size_t c=0; c<chunks.size(); c++)
+        {
+          const Chunk& chunk = chunks[c];
+          BVH* object = bvh->objects[c] = new BVH(Primitive::type,scene);
+
+          /* gather primitive references of the chunk */
+          prims.resize(chunk.size);
+          auto gather = [&](Mesh* mesh, const range<size_t>& r, size_t k, size_t base) -> PrimInfo
+          {
+            PrimInfo pinfo(empty);
+            for (size_t j=r.begin(); j<r.end(); j++)
+            {
+              BBox3fa bounds = empty;
+              if (!mesh->buildBounds(j,&bounds)) continue;
+              const unsigned int i = cell(bounds);
+              if (i < chunk.begin || i >= chunk.end) continue;
+              if (base != size_t(-1)) prims[base+pinfo.size()] = PrimRef(bounds,mesh->geomID,unsigned(j));
+              pinfo.add(bounds,bounds.center2());
+            }
+            return pinfo;
+          };
+          parallel_for_for_prefix_sum0(pstate, iter, PrimInfo(empty), [&](Mesh* mesh, const range<size_t>& r, size_t k) -> PrimInfo {
+              return gather(mesh,r,k,size_t(-1));
+            }, [](const PrimInfo& a, const PrimInfo& b) -> PrimInfo { return PrimInfo::merge(a,b); });
+          const PrimInfo cinfo = parallel_for_for_prefix_sum1(pstate, iter, PrimInfo(empty), [&](Mesh* mesh, const range<size_t>& r, size_t k, const PrimInfo& base) -> PrimInfo {
+              return gather(mesh,r,k,base.size());
+            }, [](const PrimInfo& a, const PrimInfo& b) -> PrimInfo { return PrimInfo::merge(a,b); });
+          assert(cinfo.size() == chunk.size);
+
+          buildSAH(object,cinfo);
+          object->cleanup();
+
+          /* spill to disk and map back, the mapping stays valid after the file got removed */
+          std::stringstream name;
+          name << "embree_chunk_" << std::hex << size_t(bvh) << "_" << size_t(getSeconds()*1E6) << "_" << std::dec << c << ".bin";
+          const FileName fileName = dir + name.str();
+          const uint64_t key = uint64_t(size_t(bvh)*0x9e3779b97f4a7c15ull + c);
+          const bool spilled = BVHNCache<N>::store(object,fileName,key) && BVHNCache<N>::load(object,fileName,key);
+          std::remove(fileName.c_str());
+          if (!spilled && scene->device->verbosity(1)) {
+            Lock<MutexSys> lock(g_printMutex);
+            std::cout << "WARNING: cannot spill BVH" << N << "<" << bvh->primTy.name << "> chunk to " << fileName << ", keeping it in memory" << std::endl << std::flush;
+          }
+        }
+
+        /* build top level BVH over the chunk roots */
+        prims.resize(chunks.size());
+        PrimInfo tinfo(empty);
+        for (size_t c=0; c<chunks.size(); c++) {
+          const BBox3fa bounds = bvh->objects[c]->bounds.bounds();
+          prims[c] = PrimRef(bounds,unsigned(c),0);
+          tinfo.add(bounds,bounds.center2());
+        }
+        GeneralBVHBuilder::Settings tsettings;
+        tsettings.branchingFactor = N;
+        tsettings.maxDepth = BVH::maxBuildDepthLeaf;
+        tsettings.logBlockSize = __bsr(N);
+        tsettings.minLeafSize = 1;
+        tsettings.maxLeafSize = 1;
+        tsettings.travCost = 1.0f;
+        tsettings.intCost = 1.0f;
+        tsettings.singleThreadThreshold = DEFAULT_SINGLE_THREAD_THRESHOLD;
+        bvh->alloc.init_estimate(chunks.size()*sizeof(typename BVH::AlignedNode));
+        NodeRef root = BVHNBuilderVirtual<N>::build(&bvh->alloc,[&] (const range<size_t>& r, const FastAllocator::CachedAllocator& alloc) -> NodeRef {
+            assert(r.size() == 1);
+            return bvh->objects[prims[r.begin()].geomID()]->root;
+          },bvh->scene->progressInterface,prims.data(),tinfo,tsettings);
+        bvh->set(root,LBBox3fa(pinfo.geomBounds),pinfo.size());
+
+        prims.clear();
+	bvh->cleanup();
+        bvh->postBuild(t0);
+      }
+
+      void clear() {
+        prims.clear();
+      }
+    };
+
+    /************************************************************************************/
+    /************************************************************************************/
+    /************************************************************************************/
+    /************************************************************************************/
+
     template<int N, typename Mesh, typename Primitive, typename Splitter>
     struct BVHNBuilderFastSpatialSAH : public Builder
     {
@@ -570,9 +834,11 @@ namespace embree
         /* create primref array */
         const size_t numSplitPrimitives = max(numOriginalPrimitives,size_t(splitFactor*numOriginalPrimitives));
         prims0.resize(numSplitPrimitives);
+        const double t1 = getSeconds();
         PrimInfo pinfo = mesh ?
           createPrimRefArray<Mesh>  (mesh ,prims0,bvh->scene->progressInterface) :
           createPrimRefArray<Mesh,false>(scene,prims0,bvh->scene->progressInterface);
+        bvh->times.primrefs = getSeconds()-t1;
 
         Splitter splitter(scene);
 
@@ -588,6 +854,7 @@ namespace embree
         settings.branchingFactor = N;
         settings.maxDepth = BVH::maxBuildDepthLeaf;
 
+        const double t2 = getSeconds();
         NodeRef root = BVHBuilderBinnedFastSpatialSAH::build<NodeRef>(
           typename BVH::CreateAlloc(bvh),
           typename BVH::AlignedNode::Create2(),
@@ -598,6 +865,7 @@ namespace embree
           prims0.data(),
           numSplitPrimitives,
           pinfo,settings);
+        bvh->times.hierarchy = getSeconds()-t2;
 
         bvh->set(root,LBBox3fa(pinfo.geomBounds),pinfo.size());
         bvh->layoutLargeNodes(size_t(pinfo.size()*0.005f));
@@ -627,6 +895,7 @@ namespace embree
     Builder* BVH4Line4iMeshBuilderSAH     (void* bvh, LineSegments* mesh, size_t mode) { return new BVHNBuilderSAH<4,LineSegments,Line4i>((BVH4*)bvh,mesh,4,1.0f,4,inf,mode); }
     Builder* BVH4Line4iSceneBuilderSAH     (void* bvh, Scene* scene, size_t mode) { return new BVHNBuilderSAH<4,LineSegments,Line4i>((BVH4*)bvh,scene,4,1.0f,4,inf,mode); }
     Builder* BVH4Line4iMBSceneBuilderSAH (void* bvh, Scene* scene, size_t mode) { return new BVHNBuilderMBlurSAH<4,LineSegments,Line4i>((BVH4*)bvh,scene ,4,1.0f,4,inf); }
+    Builder* BVH4QuantizedLine4iSceneBuilderSAH (void* bvh, Scene* scene, size_t mode) { return new BVHNBuilderSAHQuantized<4,LineSegments,Line4i>((BVH4*)bvh,scene,4,1.0f,4,inf,mode); }
 #if defined(__AVX__)
     Builder* BVH8Line4iSceneBuilderSAH     (void* bvh, Scene* scene, size_t mode) { return new BVHNBuilderSAH<8,LineSegments,Line4i>((BVH8*)bvh,scene,4,1.0f,4,inf,mode); }
     Builder* BVH8Line4iMBSceneBuilderSAH (void* bvh, Scene* scene, size_t mode) { return new BVHNBuilderMBlurSAH<8,LineSegments,Line4i>((BVH8*)bvh,scene,4,1.0f,4,inf); }
@@ -655,6 +924,8 @@ namespace embree
     Builder* BVH4Triangle4iSceneBuilderFastSpatialSAH (void* bvh, Scene* scene, size_t mode) { return new BVHNBuilderFastSpatialSAH<4,TriangleMesh,Triangle4i,TriangleSplitterFactory>((BVH4*)bvh,scene,4,1.0f,4,inf,mode); }
 
 
+    Builder* BVH4Triangle4SceneBuilderStreamingSAH  (void* bvh, Scene* scene, size_t mode) { return new BVHNBuilderSAHStreaming<4,TriangleMesh,Triangle4>((BVH4*)bvh,scene,4,1.0f,4,inf,mode); }
+
     Builder* BVH4QuantizedTriangle4iSceneBuilderSAH (void* bvh, Scene* scene, size_t mode) { return new BVHNBuilderSAHQuantized<4,TriangleMesh,Triangle4i>((BVH4*)bvh,scene,4,1.0f,4,inf,mode); }
 #if defined(__AVX__)
     Builder* BVH8Triangle4MeshBuilderSAH  (void* bvh, TriangleMesh* mesh, size_t mode) { return new BVHNBuilderSAH<8,TriangleMesh,Triangle4>((BVH8*)bvh,mesh,4,1.0f,4,inf,mode); }
@@ -670,6 +941,8 @@ namespace embree
     Builder* BVH8QuantizedTriangle4iSceneBuilderSAH  (void* bvh, Scene* scene, size_t mode) { return new BVHNBuilderSAHQuantized<8,TriangleMesh,Triangle4i>((BVH8*)bvh,scene,4,1.0f,4,inf,mode); }
     Builder* BVH8QuantizedTriangle4SceneBuilderSAH  (void* bvh, Scene* scene, size_t mode) { return new BVHNBuilderSAHQuantized<8,TriangleMesh,Triangle4>((BVH8*)bvh,scene,4,1.0f,4,inf,mode); }
 
+    Builder* BVH8Triangle4SceneBuilderStreamingSAH  (void* bvh, Scene* scene, size_t mode) { return new BVHNBuilderSAHStreaming<8,TriangleMesh,Triangle4>((BVH8*)bvh,scene,4,1.0f,4,inf,mode); }
+
     Builder* BVH8Triangle4SceneBuilderFastSpatialSAH  (void* bvh, Scene* scene, size_t mode) { return new BVHNBuilderFastSpatialSAH<8,TriangleMesh,Triangle4,TriangleSplitterFactory>((BVH8*)bvh,scene,4,1.0f,4,inf,mode); }
     Builder* BVH8Triangle4vSceneBuilderFastSpatialSAH  (void* bvh, Scene* scene, size_t mode) { return new BVHNBuilderFastSpatialSAH<8,TriangleMesh,Triangle4v,TriangleSplitterFactory>((BVH8*)bvh,scene,4,1.0f,4,inf,mode); }
 
@@ -684,6 +957,7 @@ namespace embree
     Builder* BVH4Quad4iMBSceneBuilderSAH (void* bvh, Scene* scene, size_t mode) { return new BVHNBuilderMBlurSAH<4,QuadMesh,Quad4i>((BVH4*)bvh,scene,4,1.0f,4,inf); }
     Builder* BVH4QuantizedQuad4vSceneBuilderSAH     (void* bvh, Scene* scene, size_t mode) { return new BVHNBuilderSAHQuantized<4,QuadMesh,Quad4v>((BVH4*)bvh,scene,4,1.0f,4,inf,mode); }
     Builder* BVH4QuantizedQuad4iSceneBuilderSAH     (void* bvh, Scene* scene, size_t mode) { return new BVHNBuilderSAHQuantized<4,QuadMesh,Quad4i>((BVH4*)bvh,scene,4,1.0f,4,inf,mode); }
+    Builder* BVH4Quad4vSceneBuilderStreamingSAH     (void* bvh, Scene* scene, size_t mode) { return new BVHNBuilderSAHStreaming<4,QuadMesh,Quad4v>((BVH4*)bvh,scene,4,1.0f,4,inf,mode); }
     Builder* BVH4Quad4vSceneBuilderFastSpatialSAH  (void* bvh, Scene* scene, size_t mode) { return new BVHNBuilderFastSpatialSAH<4,QuadMesh,Quad4v,QuadSplitterFactory>((BVH4*)bvh,scene,4,1.0f,4,inf,mode); }
 
 #if defined(__AVX__)
@@ -693,6 +967,7 @@ namespace embree
     Builder* BVH8QuantizedQuad4vSceneBuilderSAH     (void* bvh, Scene* scene, size_t mode) { return new BVHNBuilderSAHQuantized<8,QuadMesh,Quad4v>((BVH8*)bvh,scene,4,1.0f,4,inf,mode); }
     Builder* BVH8QuantizedQuad4iSceneBuilderSAH     (void* bvh, Scene* scene, size_t mode) { return new BVHNBuilderSAHQuantized<8,QuadMesh,Quad4i>((BVH8*)bvh,scene,4,1.0f,4,inf,mode); }
     Builder* BVH8Quad4vMeshBuilderSAH     (void* bvh, QuadMesh* mesh, size_t mode)     { return new BVHNBuilderSAH<8,QuadMesh,Quad4v>((BVH8*)bvh,mesh,4,1.0f,4,inf,mode); }
+    Builder* BVH8Quad4vSceneBuilderStreamingSAH     (void* bvh, Scene* scene, size_t mode) { return new BVHNBuilderSAHStreaming<8,QuadMesh,Quad4v>((BVH8*)bvh,scene,4,1.0f,4,inf,mode); }
     Builder* BVH8Quad4vSceneBuilderFastSpatialSAH  (void* bvh, Scene* scene, size_t mode) { return new BVHNBuilderFastSpatialSAH<8,QuadMesh,Quad4v,QuadSplitterFactory>((BVH8*)bvh,scene,4,1.0f,4,inf,mode); }
 
 #endif
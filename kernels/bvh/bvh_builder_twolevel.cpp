@@ -16,6 +16,7 @@
 
 #include "bvh_builder_twolevel.h"
 #include "bvh_statistics.h"
+#include "bvh_rotate.h"
 #include "../builders/bvh_builder_sah.h"
 #include "../common/scene_line_segments.h"
 #include "../common/scene_triangle_mesh.h"
@@ -30,13 +31,18 @@
 #define SPLIT_MEMORY_RESERVE_SCALE 2
 #define SPLIT_MIN_EXT_SPACE 1000
 
+/* incremental update of the top level hierarchy */
+#define UPDATE_MAX_MODIFIED_FRACTION 0.25f
+#define UPDATE_MAX_SAH_INCREASE 1.5f
+
 namespace embree
 {
   namespace isa
   {
     template<int N, typename Mesh>
     BVHNBuilderTwoLevel<N,Mesh>::BVHNBuilderTwoLevel (BVH* bvh, Scene* scene, const createMeshAccelTy createMeshAccel, const size_t singleThreadThreshold)
-      : bvh(bvh), objects(bvh->objects), scene(scene), createMeshAccel(createMeshAccel), refs(scene->device,0), prims(scene->device,0), singleThreadThreshold(singleThreadThreshold) {}
+      : bvh(bvh), objects(bvh->objects), scene(scene), createMeshAccel(createMeshAccel), refs(scene->device,0), prims(scene->device,0), singleThreadThreshold(singleThreadThreshold),
+        numPresent(0), toplevelSAH(0.0f), toplevelValid(false) {}
     
     template<int N, typename Mesh>
     BVHNBuilderTwoLevel<N,Mesh>::~BVHNBuilderTwoLevel ()
@@ -55,6 +61,7 @@ namespace embree
       /* delete some objects */
       size_t num = scene->size();
       if (num < objects.size()) {
+        toplevelValid = false;
         parallel_for(num, objects.size(), [&] (const range<size_t>& r) {
             for (size_t i=r.begin(); i<r.end(); i++) {
               delete builders[i]; builders[i] = nullptr;
@@ -67,13 +74,12 @@ namespace embree
       while(1) 
 #endif
       {
-      /* reset memory allocator */
-      bvh->alloc.reset();
-      
       /* skip build for empty scene */
       const size_t numPrimitives = scene->getNumPrimitives<Mesh,false>();
 
       if (numPrimitives == 0) {
+        bvh->alloc.reset();
+        toplevelValid = false;
         prims.resize(0);
         bvh->set(BVH::emptyNode,empty,0);
         return;
@@ -86,6 +92,7 @@ namespace embree
       if (builders.size() < num) builders.resize(num);
       if (refs.size()     < num) refs.resize(num);
       nextRef.store(0);
+      std::atomic<size_t> numModifiedPrimitives(0);
       
       /* create acceleration structures */
       parallel_for(size_t(0), num, [&] (const range<size_t>& r)
@@ -121,8 +128,10 @@ namespace embree
           Builder* builder = builders[objectID]; assert(builder);
           
           /* build object if it got modified */
-          if (mesh->isModified())
+          if (mesh->isModified()) {
             builder->build();
+            numModifiedPrimitives += mesh->size();
+          }
 
           /* create build primitive */
           if (!object->getBounds().empty())
@@ -142,11 +151,22 @@ namespace embree
 #endif
       /* fast path for single geometry scenes */
       if (nextRef == 1) { 
+        bvh->alloc.reset();
+        toplevelValid = false;
         bvh->set(refs[0].node,LBBox3fa(refs[0].bounds()),numPrimitives);
       }
 
+      /* only reinsert the modified objects into the top level hierarchy if possible */
+#if ENABLE_DIRECT_SAH_MERGE_BUILDER
+      else if (!update(numPrimitives,numModifiedPrimitives))
+#else
       else
+#endif
       {     
+        /* reset memory allocator */
+        bvh->alloc.reset();
+        toplevelValid = false;
+
         /* open all large nodes */
         refs.resize(nextRef);
 
@@ -215,7 +235,13 @@ namespace embree
             settings.singleThreadThreshold = singleThreadThreshold;
       
 #if ENABLE_DIRECT_SAH_MERGE_BUILDER
+            /* remember which objects the top level hierarchy references */
+            present.assign(num,false);
+            for (size_t i=0; i<refs.size(); i++) present[refs[i].geomID()] = true;
+            numPresent = refs.size();
+            
             refs.resize(extSize); 
+            toplevel.assign(extSize,TopLevelRef(BVH::emptyNode,-1));
          
             NodeRef root = BVHBuilderBinnedOpenMergeSAH::build<NodeRef,BuildRef>(
               typename BVH::CreateAlloc(bvh),
@@ -224,7 +250,10 @@ namespace embree
               
               [&] (const range<size_t>& range, const FastAllocator::CachedAllocator& alloc) -> NodeRef  {
                 assert(range.size() == 1);
-                return (NodeRef) refs[range.begin()].node;
+                NodeRef ref = refs[range.begin()].node;
+                toplevel[range.begin()] = TopLevelRef(ref,refs[range.begin()].geomID());
+                ref.setBarrier();
+                return ref;
               },
               [&] (BuildRef &bref, BuildRef *refs) -> size_t { 
                 return openBuildRef(bref,refs);
@@ -247,6 +276,21 @@ namespace embree
 
             
             bvh->set(root,LBBox3fa(pinfo.geomBounds),numPrimitives);
+
+#if ENABLE_DIRECT_SAH_MERGE_BUILDER
+            /* record top level hierarchy for incremental updates */
+            toplevel.erase(std::remove_if(toplevel.begin(),toplevel.end(),[] (const TopLevelRef& r) { return r.ref == BVH::emptyNode; }),toplevel.end());
+            std::sort(toplevel.begin(),toplevel.end());
+            if (bvh->root.isBarrier()) {
+              bvh->clearBarrier(bvh->root);
+            } else {
+              const float A = area(pinfo.geomBounds);
+              toplevelSAH = A > 0.0f ? sah(bvh->root)/A : 0.0f;
+              std::vector<TopLevelRef> out; record(bvh->root,out);
+              toplevel.swap(out); std::sort(toplevel.begin(),toplevel.end());
+              toplevelValid = !scene->isHighQuality();
+            }
+#endif
           }
         }
 #if defined(TASKING_TBB) && defined(__AVX512ER__) && USE_TASK_ARENA // KNL
@@ -269,6 +313,7 @@ namespace embree
     void BVHNBuilderTwoLevel<N,Mesh>::deleteGeometry(size_t geomID)
     {
       if (geomID >= objects.size()) return;
+      toplevelValid = false;
       delete builders[geomID]; builders[geomID] = nullptr;
       delete objects [geomID]; objects [geomID] = nullptr;
     }
@@ -283,6 +328,161 @@ namespace embree
 	if (builders[i]) builders[i]->clear();
 
       refs.clear();
+      toplevel.clear();
+      toplevelValid = false;
+    }
+
+    template<int N, typename Mesh>
+    bool BVHNBuilderTwoLevel<N,Mesh>::update(const size_t numPrimitives, const size_t numModifiedPrimitives)
+    {
+      /* rebuild if the top level hierarchy got not recorded or too many primitives got modified */
+      if (!toplevelValid) return false;
+      if (numModifiedPrimitives > UPDATE_MAX_MODIFIED_FRACTION*numPrimitives) return false;
+
+      /* rebuild if the set of referenced objects changed */
+      const size_t numRefs = nextRef;
+      if (numRefs != numPresent) return false;
+      for (size_t i=0; i<numRefs; i++) {
+        const unsigned int geomID = refs[i].geomID();
+        if (geomID >= present.size() || !present[geomID]) return false;
+      }
+
+      /* remove references to modified objects, this marks all remaining object references as barriers */
+      BBox3fa bounds = refit(bvh->root);
+
+      /* reinsert modified objects as a whole */
+      std::vector<TopLevelRef> out;
+      for (size_t i=0; i<numRefs; i++) 
+      {
+        const unsigned int geomID = refs[i].geomID();
+        if (!scene->get(geomID)->isModified()) continue;
+        if (!insert(refs[i])) return false;
+        out.push_back(TopLevelRef(refs[i].node,geomID));
+        bounds.extend(refs[i].bounds());
+      }
+
+      /* local reoptimization of the top level hierarchy, rotations stop at the object references */
+      BVHNRotate<N>::rotate(bvh->root);
+
+      /* rebuild if the SAH cost degraded too much */
+      const float A = area(bounds);
+      const float cost = A > 0.0f ? sah(bvh->root)/A : 0.0f;
+      if (cost > UPDATE_MAX_SAH_INCREASE*toplevelSAH) return false;
+      
+      /* record top level hierarchy for the next update */
+      toplevel.insert(toplevel.end(),out.begin(),out.end());
+      std::sort(toplevel.begin(),toplevel.end());
+      out.clear(); record(bvh->root,out);
+      toplevel.swap(out); std::sort(toplevel.begin(),toplevel.end());
+
+      bvh->set(bvh->root,LBBox3fa(bounds),numPrimitives);
+      return true;
+    }
+
+    template<int N, typename Mesh>
+    BBox3fa BVHNBuilderTwoLevel<N,Mesh>::refit(NodeRef ref)
+    {
+      AlignedNode* node = ref.alignedNode();
+      BBox3fa bounds = empty;
+      for (size_t i=0; i<N; i++)
+      {
+        NodeRef& child = node->child(i);
+        if (child == BVH::emptyNode) continue;
+        const unsigned int geomID = lookup(child);
+
+        /* recurse into top level nodes and remove them if they got empty */
+        if (geomID == -1) 
+        {
+          const BBox3fa cbounds = refit(child);
+          if (cbounds.empty()) { node->set(i,BVH::emptyNode,empty); continue; }
+          node->setBounds(i,cbounds);
+        }
+
+        /* remove references to modified objects */
+        else if (scene->get(geomID)->isModified()) {
+          node->set(i,BVH::emptyNode,empty);
+          continue;
+        }
+        else 
+          child.setBarrier();
+
+        bounds.extend(node->bounds(i));
+      }
+      BVH::compact(node);
+      return bounds;
+    }
+
+    template<int N, typename Mesh>
+    bool BVHNBuilderTwoLevel<N,Mesh>::insert(const BuildRef& bref)
+    {
+      NodeRef ref = bref.node; ref.setBarrier();
+      const BBox3fa bounds = bref.bounds();
+
+      NodeRef cur = bvh->root;
+      for (size_t depth=1; ; depth++)
+      {
+        AlignedNode* node = cur.alignedNode();
+
+        /* insert into free slot */
+        for (size_t i=0; i<N; i++) {
+          if (node->child(i) == BVH::emptyNode) {
+            node->set(i,ref,bounds);
+            return true;
+          }
+        }
+
+        /* otherwise descend into the child whose area increases least */
+        size_t best = 0; float bestCost = pos_inf;
+        for (size_t i=0; i<N; i++) {
+          const BBox3fa cbounds = node->bounds(i);
+          const float cost = area(merge(cbounds,bounds))-area(cbounds);
+          if (cost < bestCost) { best = i; bestCost = cost; }
+        }
+        NodeRef child = node->child(best);
+        const BBox3fa cbounds = node->bounds(best);
+        node->setBounds(best,merge(cbounds,bounds));
+        if (!child.isBarrier()) { cur = child; continue; }
+
+        /* pair the new object reference with the object reference found */
+        if (depth >= BVH::maxBuildDepth) return false;
+        AlignedNode* pair = (AlignedNode*) bvh->alloc.getCachedAllocator().malloc0(sizeof(AlignedNode),BVH::byteNodeAlignment); pair->clear();
+        pair->set(0,child,cbounds);
+        pair->set(1,ref,bounds);
+        node->setRef(best,BVH::encodeNode(pair));
+        return true;
+      }
+    }
+
+    template<int N, typename Mesh>
+    float BVHNBuilderTwoLevel<N,Mesh>::sah(NodeRef ref)
+    {
+      AlignedNode* node = ref.alignedNode();
+      float cost = 0.0f;
+      for (size_t i=0; i<N; i++)
+      {
+        NodeRef child = node->child(i);
+        if (child == BVH::emptyNode) continue;
+        cost += area(node->bounds(i));
+        if (!child.isBarrier()) cost += sah(child);
+      }
+      return cost;
+    }
+
+    template<int N, typename Mesh>
+    void BVHNBuilderTwoLevel<N,Mesh>::record(NodeRef& ref, std::vector<TopLevelRef>& out)
+    {
+      if (ref.isBarrier()) {
+        ref.clearBarrier();
+        out.push_back(TopLevelRef(ref,lookup(ref)));
+        return;
+      }
+      
+      out.push_back(TopLevelRef(ref,-1));
+      AlignedNode* node = ref.alignedNode();
+      for (size_t i=0; i<N; i++) {
+        if (node->child(i) == BVH::emptyNode) continue;
+        record(node->child(i),out);
+      }
     }
 
     template<int N, typename Mesh>
@@ -81,6 +81,20 @@ namespace embree
         float bounds_area;
       };
 
+      /*! node or object reference of the top level hierarchy */
+      struct TopLevelRef
+      {
+        __forceinline TopLevelRef () {}
+        __forceinline TopLevelRef (NodeRef ref, unsigned int geomID) 
+          : ref(ref), geomID(geomID) {}
+
+        friend __forceinline bool operator< (const TopLevelRef& a, const TopLevelRef& b) {
+          return (size_t)a.ref < (size_t)b.ref;
+        }
+
+        NodeRef ref;
+        unsigned int geomID;
+      };
 
       __forceinline size_t openBuildRef(BuildRef &bref, BuildRef *const refs) {
         if (bref.node.isLeaf())
@@ -115,6 +129,29 @@ namespace embree
 
       void open_sequential(const size_t extSize);
 
+      /*! reinserts the modified objects into the top level hierarchy of the last build, returns false if a full rebuild is required */
+      bool update(const size_t numPrimitives, const size_t numModifiedPrimitives);
+
+      /*! removes references to modified objects and recalculates the bounds of the top level nodes */
+      BBox3fa refit(NodeRef ref);
+
+      /*! inserts some object reference into the top level hierarchy */
+      bool insert(const BuildRef& bref);
+
+      /*! calculates the SAH cost of the top level nodes */
+      float sah(NodeRef ref);
+
+      /*! records the top level nodes and object references for the next update */
+      void record(NodeRef& ref, std::vector<TopLevelRef>& out);
+
+      /*! returns the geometry ID of some object reference or -1 for top level nodes */
+      __forceinline unsigned int lookup(NodeRef ref) const 
+      {
+        auto i = std::lower_bound(toplevel.begin(),toplevel.end(),TopLevelRef(ref,-1));
+        if (i == toplevel.end() || i->ref != ref) return -1;
+        return i->geomID;
+      }
+
     public:
       BVH* bvh;
       std::vector<BVH*>& objects;
@@ -129,6 +166,12 @@ namespace embree
       std::atomic<int> nextRef;
       const size_t singleThreadThreshold;
 
+      std::vector<TopLevelRef> toplevel;   //!< sorted top level nodes and object references of the last build
+      std::vector<bool> present;           //!< objects referenced by the top level hierarchy
+      size_t numPresent;                   //!< number of objects referenced by the top level hierarchy
+      float toplevelSAH;                   //!< SAH cost of the top level hierarchy after the last full rebuild
+      bool toplevelValid;                  //!< true if the top level hierarchy can get updated incrementally
+
       typedef mvector<BuildRef> bvector;
 
     };
@@ -0,0 +1,459 @@
+// ======================================================================== //
+// Copyright 2009-2017 Intel Corporation                                    //
+//                                                                          //
+// Licensed under the Apache License, Version 2.0 (the "License");          //
+// you may not use this file except in compliance with the License.         //
+// You may obtain a copy of the License at                                  //
+//                                                                          //
+//     http://www.apache.org/licenses/LICENSE-2.0                           //
+//                                                                          //
+// Unless required by applicable law or agreed to in writing, software      //
+// distributed under the License is distributed on an "AS IS" BASIS,        //
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. //
+// See the License for the specific language governing permissions and      //
+// limitations under the License.                                           //
+// ======================================================================== //
+
+#include "bvh_cache.h"
+#include "../../common/algorithms/parallel_for.h"
+#include <fstream>
+#include <iomanip>
+#include <cstdio>
+
+#if defined(__UNIX__)
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+namespace embree
+{
+  /*! version of the cache file format, increase when the layout of nodes or leaves changes */
+  static const unsigned int BVH_CACHE_VERSION = 1;
+
+  /*! header stored in the first page of each cache file */
+  struct BVHCacheHeader
+  {
+    char magic[8];                 //!< identifies the file format
+    unsigned int version;          //!< version of the file format
+    unsigned int N;                //!< branching factor of the BVH
+    uint64_t key;                  //!< hash over geometries and build settings
+    uint64_t base;                 //!< address the node references got encoded for
+    uint64_t bytes;                //!< size of the file in bytes
+    uint64_t nodeOffset;           //!< offset of the node array
+    uint64_t numNodes;             //!< number of nodes
+    uint64_t nodeBytes;            //!< size of a single node
+    uint64_t primBytes;            //!< size of a single leaf block
+    uint64_t root;                 //!< root node reference
+    uint64_t numPrimitives;        //!< number of primitives in the BVH
+    Vec3f bounds[4];               //!< lower and upper bounds at start and end time
+  };
+
+  static const char bvh_cache_magic[8] = { 'E','M','B','V','H','C', 0, 0 };
+
+  static __forceinline uint64_t hashMix(uint64_t x)
+  {
+    x ^= x >> 33; x *= 0xff51afd7ed558ccdull;
+    x ^= x >> 33; x *= 0xc4ceb9fe1a85ec53ull;
+    x ^= x >> 33;
+    return x;
+  }
+
+  static uint64_t hashString(uint64_t h, const std::string& str)
+  {
+    for (size_t i=0; i<str.size(); i++) h = hashMix(h ^ (uint64_t)(unsigned char)str[i]);
+    return hashMix(h ^ str.size());
+  }
+
+  /*! hashes the first bytesPerItem bytes of each item of a buffer, blocks of items get hashed in parallel */
+  static uint64_t hashBuffer(const BufferRef& buffer, size_t bytesPerItem)
+  {
+    static const size_t blockSize = 4096;
+    assert(bytesPerItem % 4 == 0);
+    const size_t numItems = buffer.size();
+    const size_t numBlocks = (numItems+blockSize-1)/blockSize;
+    std::vector<uint64_t> hashes(numBlocks);
+
+    parallel_for(numBlocks, [&](const size_t b)
+    {
+      uint64_t h = b;
+      const size_t end = min(numItems,(b+1)*blockSize);
+      for (size_t i=b*blockSize; i<end; i++)
+      {
+        const unsigned int* p = (const unsigned int*) buffer.getPtr(i);
+        size_t j=0;
+        for (; j+1<bytesPerItem/4; j+=2) h = hashMix(h ^ (uint64_t(p[j]) | (uint64_t(p[j+1]) << 32)));
+        for (; j+0<bytesPerItem/4; j+=1) h = hashMix(h ^ uint64_t(p[j]));
+      }
+      hashes[b] = h;
+    });
+
+    uint64_t h = hashMix(numItems);
+    for (size_t b=0; b<numBlocks; b++) h = hashMix(h ^ hashes[b]);
+    return h;
+  }
+
+  /*! address the cache file should get mapped to such that no relocation is required */
+  static size_t preferredBaseAddress(uint64_t key, size_t bytes)
+  {
+#if defined(__X86_64__)
+    if (bytes <= (size_t(1) << 32))
+      return size_t(0x200000000000ull) + (size_t(key & 0x1fff) << 32);
+#endif
+    return 0;
+  }
+
+  /*! memory of a loaded cache file, released when the BVH gets cleared */
+  template<int N>
+  struct BVHNCacheFile : public RefCount
+  {
+    BVHNCacheFile (char* ptr, size_t bytes)
+      : ptr(ptr), bytes(bytes) {}
+
+    ~BVHNCacheFile ()
+    {
+#if defined(__UNIX__)
+      munmap(ptr,bytes);
+#else
+      alignedFree(ptr);
+#endif
+    }
+
+  public:
+    char* ptr;
+    size_t bytes;
+  };
+
+  /*! writes leaves in depth first order to the file and collects the nodes in an array */
+  template<int N>
+  struct BVHNCacheWriter
+  {
+    typedef BVHN<N> BVH;
+    typedef typename BVH::AlignedNode AlignedNode;
+    typedef typename BVH::NodeRef NodeRef;
+
+    BVHNCacheWriter (const BVH* bvh, std::ofstream& file, size_t base, size_t leafOffset, size_t nodeOffset, AlignedNode* nodes)
+      : bvh(bvh), file(file), base(base), leafOffset(leafOffset), nodeOffset(nodeOffset), nodes(nodes), numNodes(0) {}
+
+    /*! counts nodes and leaf bytes, returns false for unsupported node types */
+    static bool count(const BVH* bvh, NodeRef node, size_t& numNodes, size_t& leafBytes)
+    {
+      if (node == BVH::emptyNode)
+        return true;
+
+      if (node.isLeaf()) {
+        size_t num; node.leaf(num);
+        leafBytes += num*bvh->primTy.bytes;
+        return (num*bvh->primTy.bytes) % BVH::byteAlignment == 0;
+      }
+
+      if (!node.isAlignedNode())
+        return false;
+
+      numNodes++;
+      for (size_t i=0; i<N; i++)
+        if (!count(bvh,node.alignedNode()->child(i),numNodes,leafBytes)) return false;
+
+      return true;
+    }
+
+    /*! writes the subtree and returns its reference relative to the base address */
+    NodeRef write(NodeRef node)
+    {
+      if (node == BVH::emptyNode)
+        return node;
+
+      if (node.isLeaf())
+      {
+        size_t num; const char* prims = node.leaf(num);
+        const size_t bytes = num*bvh->primTy.bytes;
+        const size_t ofs = leafOffset;
+        file.write(prims,bytes);
+        leafOffset += bytes;
+        return NodeRef((base+ofs) | ((size_t)node & BVH::items_mask));
+      }
+
+      const size_t i = numNodes++;
+      const AlignedNode* src = node.alignedNode();
+      nodes[i] = *src;
+      for (size_t c=0; c<N; c++)
+        nodes[i].child(c) = write(src->child(c));
+      return NodeRef(base+nodeOffset+i*sizeof(AlignedNode));
+    }
+
+  public:
+    const BVH* bvh;
+    std::ofstream& file;
+    const size_t base;
+    size_t leafOffset;
+    const size_t nodeOffset;
+    AlignedNode* nodes;
+    size_t numNodes;
+  };
+
+  template<int N>
+  uint64_t BVHNCache<N>::key(const BVH* bvh, Geometry::Type gtype, const std::string& builderName)
+  {
+    uint64_t h = hashMix(BVH_CACHE_VERSION);
+    h = hashString(h,bvh->primTy.name);
+    h = hashString(h,builderName);
+    h = hashMix(h ^ N);
+    h = hashMix(h ^ sizeof(AlignedNode));
+    h = hashMix(h ^ bvh->primTy.bytes);
+    h = hashMix(h ^ bvh->scene->flags);
+
+    Scene* scene = bvh->scene;
+    for (size_t i=0; i<scene->size(); i++)
+    {
+      const Geometry* geom = scene->get(i);
+      if (geom == nullptr || geom->getType() != gtype) continue;
+      if (!geom->isEnabled() || geom->numTimeSteps != 1) continue;
+      h = hashMix(h ^ i);
+
+      if (gtype == Geometry::TRIANGLE_MESH) {
+        const TriangleMesh* mesh = (const TriangleMesh*) geom;
+        h = hashMix(h ^ hashBuffer(mesh->triangles,sizeof(TriangleMesh::Triangle)));
+        h = hashMix(h ^ hashBuffer(mesh->vertices0,3*sizeof(float)));
+      }
+      else if (gtype == Geometry::QUAD_MESH) {
+        const QuadMesh* mesh = (const QuadMesh*) geom;
+        h = hashMix(h ^ hashBuffer(mesh->quads,sizeof(QuadMesh::Quad)));
+        h = hashMix(h ^ hashBuffer(mesh->vertices0,3*sizeof(float)));
+      }
+      else
+        throw_RTCError(RTC_INVALID_OPERATION,"geometry type not supported by BVH cache");
+    }
+    return h;
+  }
+
+  template<int N>
+  FileName BVHNCache<N>::fileName(const BVH* bvh, uint64_t key)
+  {
+    std::stringstream name;
+    name << "bvh" << N << "_" << bvh->primTy.name << "_" << std::hex << std::setw(16) << std::setfill('0') << key << ".bin";
+    return FileName(bvh->device->bvh_cache) + name.str();
+  }
+
+  template<int N>
+  bool BVHNCache<N>::store(const BVH* bvh, const FileName& fileName, uint64_t key)
+  {
+    if (bvh->root == BVH::emptyNode)
+      return false;
+
+    /* count nodes and leaves, fails for unsupported node types */
+    size_t numNodes = 0, leafBytes = 0;
+    if (!BVHNCacheWriter<N>::count(bvh,bvh->root,numNodes,leafBytes))
+      return false;
+
+    /* header page, then leaves, then all nodes starting at a page boundary */
+    const size_t leafOffset = PAGE_SIZE;
+    const size_t nodeOffset = (leafOffset+leafBytes+PAGE_SIZE-1) & ~size_t(PAGE_SIZE-1);
+    const size_t bytes = nodeOffset + numNodes*sizeof(AlignedNode);
+    const size_t base = preferredBaseAddress(key,bytes);
+
+    BVHCacheHeader header;
+    memset(&header,0,sizeof(header));
+    memcpy(header.magic,bvh_cache_magic,sizeof(header.magic));
+    header.version = BVH_CACHE_VERSION;
+    header.N = N;
+    header.key = key;
+    header.base = base;
+    header.bytes = bytes;
+    header.nodeOffset = nodeOffset;
+    header.numNodes = numNodes;
+    header.nodeBytes = sizeof(AlignedNode);
+    header.primBytes = bvh->primTy.bytes;
+    header.numPrimitives = bvh->numPrimitives;
+    header.bounds[0] = Vec3f(bvh->bounds.bounds0.lower);
+    header.bounds[1] = Vec3f(bvh->bounds.bounds0.upper);
+    header.bounds[2] = Vec3f(bvh->bounds.bounds1.lower);
+    header.bounds[3] = Vec3f(bvh->bounds.bounds1.upper);
+
+    /* write into temporary file first such that concurrent readers never see partial files */
+    std::stringstream tmp;
+    tmp << fileName.str() << "." << std::hex << size_t(bvh) << size_t(getSeconds()*1E6) << ".tmp";
+    const std::string tmpName = tmp.str();
+
+    std::ofstream file(tmpName.c_str(),std::ios::binary);
+    if (!file.is_open())
+      return false;
+
+    AlignedNode* nodes = (AlignedNode*) alignedMalloc(max(numNodes,size_t(1))*sizeof(AlignedNode),64);
+    BVHNCacheWriter<N> writer(bvh,file,base,leafOffset,nodeOffset,nodes);
+    std::vector<char> padding(PAGE_SIZE,0);
+    file.write(padding.data(),PAGE_SIZE);
+    header.root = writer.write(bvh->root);
+    file.write(padding.data(),nodeOffset-writer.leafOffset);
+    file.write((const char*)nodes,numNodes*sizeof(AlignedNode));
+    file.seekp(0);
+    file.write((const char*)&header,sizeof(header));
+    const bool good = file.good();
+    file.close();
+    alignedFree(nodes);
+
+    if (!good || std::rename(tmpName.c_str(),fileName.c_str()) != 0) {
+      std::remove(tmpName.c_str());
+      return false;
+    }
+    return true;
+  }
+
+  template<int N>
+  bool BVHNCache<N>::load(BVH* bvh, const FileName& fileName, uint64_t key)
+  {
+    BVHCacheHeader header;
+
+#if defined(__UNIX__)
+
+    int fd = open(fileName.c_str(),O_RDONLY);
+    if (fd == -1) return false;
+
+    struct stat st;
+    if (pread(fd,&header,sizeof(header),0) != ssize_t(sizeof(header)) || fstat(fd,&st) == -1 || size_t(st.st_size) != header.bytes) {
+      close(fd);
+      return false;
+    }
+    if (memcmp(header.magic,bvh_cache_magic,sizeof(header.magic)) != 0 || header.version != BVH_CACHE_VERSION || header.key != key) {
+      close(fd);
+      return false;
+    }
+
+    /* map file at the address it was written for, all pages stay shared when this succeeds */
+    char* ptr = (char*) mmap((void*)size_t(header.base),header.bytes,PROT_READ,MAP_PRIVATE,fd,0);
+    close(fd);
+    if (ptr == MAP_FAILED) return false;
+
+#else
+
+    std::ifstream file(fileName.c_str(),std::ios::binary);
+    if (!file.is_open()) return false;
+
+    file.read((char*)&header,sizeof(header));
+    if (!file.good() || memcmp(header.magic,bvh_cache_magic,sizeof(header.magic)) != 0 || header.version != BVH_CACHE_VERSION || header.key != key)
+      return false;
+    file.seekg(0,std::ios::end);
+    if (size_t(file.tellg()) != header.bytes)
+      return false;
+    file.seekg(0,std::ios::beg);
+
+    char* ptr = (char*) alignedMalloc(header.bytes,PAGE_SIZE);
+    file.read(ptr,header.bytes);
+    if (!file.good()) {
+      alignedFree(ptr);
+      return false;
+    }
+
+#endif
+
+    Ref<BVHNCacheFile<N>> cacheFile = new BVHNCacheFile<N>(ptr,header.bytes);
+    if (header.N != N || header.nodeBytes != sizeof(AlignedNode) || header.primBytes != bvh->primTy.bytes)
+      return false;
+    if (header.nodeOffset+header.numNodes*sizeof(AlignedNode) != header.bytes)
+      return false;
+
+    /* relocate node references if the file got mapped to a different address */
+    const size_t delta = (size_t)ptr - (size_t)header.base;
+    NodeRef root = NodeRef(size_t(header.root));
+    if (delta != 0)
+    {
+      AlignedNode* nodes = (AlignedNode*) (ptr + header.nodeOffset);
+      const size_t nodeBytes = header.numNodes*sizeof(AlignedNode);
+#if defined(__UNIX__)
+      if (mprotect(nodes,nodeBytes,PROT_READ | PROT_WRITE) == -1)
+        return false;
+#endif
+      parallel_for(size_t(0), size_t(header.numNodes), size_t(4096), [&](const range<size_t>& r) {
+        for (size_t i=r.begin(); i<r.end(); i++)
+          for (size_t c=0; c<N; c++)
+            if (nodes[i].child(c) != BVH::emptyNode)
+              nodes[i].child(c) = NodeRef(size_t(nodes[i].child(c)) + delta);
+      });
+#if defined(__UNIX__)
+      mprotect(nodes,nodeBytes,PROT_READ);
+#endif
+      root = NodeRef(size_t(root) + delta);
+    }
+
+    const LBBox3fa bounds(BBox3fa(Vec3fa(header.bounds[0]),Vec3fa(header.bounds[1])),
+                          BBox3fa(Vec3fa(header.bounds[2]),Vec3fa(header.bounds[3])));
+    bvh->clear();
+    bvh->set(root,bounds,header.numPrimitives);
+    bvh->cacheFile = cacheFile.ptr;
+    return true;
+  }
+
+  /*! builder that loads the BVH from the cache and only builds on a cache miss */
+  template<int N>
+  class BVHNCachedBuilder : public Builder
+  {
+    typedef BVHN<N> BVH;
+
+  public:
+    BVHNCachedBuilder (BVH* bvh, Builder* builder, Geometry::Type gtype, const std::string& builderName)
+      : bvh(bvh), builder(builder), gtype(gtype), builderName(builderName) {}
+
+    void build()
+    {
+      Device* device = bvh->device;
+      const uint64_t key = BVHNCache<N>::key(bvh,gtype,builderName);
+      const FileName fileName = BVHNCache<N>::fileName(bvh,key);
+
+      /* skip build if the BVH is found in the cache */
+      double t0 = 0.0;
+      if (device->benchmark || device->verbosity(1)) t0 = getSeconds();
+      if (BVHNCache<N>::load(bvh,fileName,key))
+      {
+        if (device->verbosity(1)) {
+          Lock<MutexSys> lock(g_printMutex);
+          std::cout << "loading BVH" << N << "<" << bvh->primTy.name << "> from " << fileName << " ..." << std::endl << std::flush;
+        }
+        bvh->postBuild(t0);
+        return;
+      }
+
+      /* otherwise build and store the BVH */
+      builder->build();
+      if (bvh->root == BVH::emptyNode)
+        return;
+
+      if (!BVHNCache<N>::store(bvh,fileName,key) && device->verbosity(1)) {
+        Lock<MutexSys> lock(g_printMutex);
+        std::cout << "WARNING: cannot store BVH" << N << "<" << bvh->primTy.name << "> to " << fileName << std::endl << std::flush;
+      }
+    }
+
+    void deleteGeometry(size_t geomID) {
+      builder->deleteGeometry(geomID);
+    }
+
+    void clear() {
+      builder->clear();
+    }
+
+  private:
+    BVH* bvh;
+    std::unique_ptr<Builder> builder;
+    Geometry::Type gtype;
+    std::string builderName;
+  };
+
+  template<int N>
+  Builder* BVHNCacheBuilder(BVHN<N>* bvh, Scene* scene, Builder* builder, Geometry::Type gtype, const std::string& builderName)
+  {
+    if (builder == nullptr || scene->device->bvh_cache == "" || !scene->isStatic())
+      return builder;
+
+    return new BVHNCachedBuilder<N>(bvh,builder,gtype,builderName);
+  }
+
+#if defined(__AVX__)
+  template class BVHNCache<8>;
+  template Builder* BVHNCacheBuilder<8>(BVHN<8>* bvh, Scene* scene, Builder* builder, Geometry::Type gtype, const std::string& builderName);
+#endif
+
+#if !defined(__AVX__) || !defined(EMBREE_TARGET_SSE2) && !defined(EMBREE_TARGET_SSE42)
+  template class BVHNCache<4>;
+  template Builder* BVHNCacheBuilder<4>(BVHN<4>* bvh, Scene* scene, Builder* builder, Geometry::Type gtype, const std::string& builderName);
+#endif
+}
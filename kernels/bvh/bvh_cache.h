@@ -0,0 +1,61 @@
+// ======================================================================== //
+// Copyright 2009-2017 Intel Corporation                                    //
+//                                                                          //
+// Licensed under the Apache License, Version 2.0 (the "License");          //
+// you may not use this file except in compliance with the License.         //
+// You may obtain a copy of the License at                                  //
+//                                                                          //
+//     http://www.apache.org/licenses/LICENSE-2.0                           //
+//                                                                          //
+// Unless required by applicable law or agreed to in writing, software      //
+// distributed under the License is distributed on an "AS IS" BASIS,        //
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. //
+// See the License for the specific language governing permissions and      //
+// limitations under the License.                                           //
+// ======================================================================== //
+
+#pragma once
+
+#include "bvh.h"
+#include "../common/builder.h"
+
+namespace embree
+{
+  /*! Persistent on-disk cache for BVHs of static scenes. A BVH gets
+   *  stored as a single file that contains a header page, followed by
+   *  all leaf blocks, followed by all nodes. When loading, the file is
+   *  memory mapped at the address it was written for. If that address
+   *  is available no pointer has to get relocated and all pages stay
+   *  shared between the processes that map the same file. Otherwise
+   *  only the node pages get relocated and the leaf pages stay
+   *  shared. Only BVHs consisting of aligned nodes and leaves without
+   *  pointers (e.g. Triangle4, Triangle4i, Quad4v) are supported. */
+  template<int N>
+  class BVHNCache
+  {
+    typedef BVHN<N> BVH;
+    typedef typename BVH::AlignedNode AlignedNode;
+    typedef typename BVH::NodeRef NodeRef;
+
+  public:
+
+    /*! computes the cache key over the geometries of some type the BVH gets built over */
+    static uint64_t key(const BVH* bvh, Geometry::Type gtype, const std::string& builderName);
+
+    /*! returns the name of the cache file for some key */
+    static FileName fileName(const BVH* bvh, uint64_t key);
+
+    /*! stores the BVH into the cache file, returns false if the BVH cannot get stored */
+    static bool store(const BVH* bvh, const FileName& fileName, uint64_t key);
+
+    /*! loads the BVH from the cache file, returns false if the file is missing or does not match */
+    static bool load(BVH* bvh, const FileName& fileName, uint64_t key);
+  };
+
+  /*! Creates a builder that loads the BVH from the cache directory
+   *  configured at the device and only invokes the specified builder
+   *  on a cache miss. Returns the specified builder if the cache is
+   *  disabled or the scene is not static. */
+  template<int N>
+  Builder* BVHNCacheBuilder(BVHN<N>* bvh, Scene* scene, Builder* builder, Geometry::Type gtype, const std::string& builderName);
+}
@@ -92,6 +92,7 @@ namespace embree
           STAT3(normal.trav_nodes,1,1,1);
           bool nodeIntersected = BVHNNodeIntersector1<N,Nx,types,robust>::intersect(cur,vray,ray_near,ray_far,ray.time,tNear,mask);
           if (unlikely(!nodeIntersected)) { STAT3(normal.trav_nodes,-1,-1,-1); break; }
+          context->countNodes(1);
 
           /*! if no child is hit, pop next node */
           if (unlikely(mask == 0))
@@ -109,6 +110,7 @@ namespace embree
         assert(cur != BVH::emptyNode);
         STAT3(normal.trav_leaves,1,1,1);
         size_t num; Primitive* prim = (Primitive*) cur.leaf(num);
+        context->countLeaves(1,num);
         size_t lazy_node = 0;
         PrimitiveIntersector1::intersect(pre,ray,context,prim,num,lazy_node);
         ray_far = ray.tfar;
@@ -174,6 +176,7 @@ namespace embree
           STAT3(shadow.trav_nodes,1,1,1);
           bool nodeIntersected = BVHNNodeIntersector1<N,Nx,types,robust>::intersect(cur,vray,ray_near,ray_far,ray.time,tNear,mask);
           if (unlikely(!nodeIntersected)) { STAT3(shadow.trav_nodes,-1,-1,-1); break; }
+          context->countNodes(1);
 
           /*! if no child is hit, pop next node */
           if (unlikely(mask == 0))
@@ -191,6 +194,7 @@ namespace embree
         assert(cur != BVH::emptyNode);
         STAT3(shadow.trav_leaves,1,1,1);
         size_t num; Primitive* prim = (Primitive*) cur.leaf(num);
+        context->countLeaves(1,num);
         size_t lazy_node = 0;
         if (PrimitiveIntersector1::occluded(pre,ray,context,prim,num,lazy_node)) {
           ray.geomID = 0;
@@ -89,6 +89,7 @@ namespace embree
           /*! stop if we found a leaf node */
           if (unlikely(cur.isLeaf())) break;
           STAT3(normal.trav_nodes,1,1,1);
+          context->countNodes((size_t)1 << k);
 
           /* intersect node */
           size_t mask = 0;
@@ -107,6 +108,7 @@ namespace embree
         assert(cur != BVH::emptyNode);
         STAT3(normal.trav_leaves, 1, 1, 1);
         size_t num; Primitive* prim = (Primitive*)cur.leaf(num);
+        context->countLeaves((size_t)1 << k,num);
 
         size_t lazy_node = 0;
         PrimitiveIntersectorK::intersect(pre, ray, k, context, prim, num, lazy_node);
@@ -133,6 +135,7 @@ namespace embree
       /* return if there are no valid rays */
       size_t valid_bits = movemask(valid);
       if (unlikely(valid_bits == 0)) return;
+      STAT3(normal.trav_packets,1,popcnt(valid),K);
 
       /* verify correct input */
       assert(all(valid,ray.valid()));
@@ -231,6 +234,7 @@ namespace embree
             /* process nodes */
             const vbool<K> valid_node = ray_tfar > curDist;
             STAT3(normal.trav_nodes,1,popcnt(valid_node),K);
+            context->countNodes(movemask(valid_node));
             const NodeRef nodeRef = cur;
             const BaseNode* __restrict__ const node = nodeRef.baseNode(types);
 
@@ -331,6 +335,7 @@ namespace embree
           const vbool<K> valid_leaf = ray_tfar > curDist;
           STAT3(normal.trav_leaves,1,popcnt(valid_leaf),K);
           size_t items; const Primitive* prim = (Primitive*) cur.leaf(items);
+          context->countLeaves(movemask(valid_leaf),items);
 
           size_t lazy_node = 0;
           PrimitiveIntersectorK::intersect(valid_leaf,pre,ray,context,prim,items,lazy_node);
@@ -379,6 +384,7 @@ namespace embree
             /*! stop if we found a leaf node */
             if (unlikely(cur.isLeaf())) break;
             STAT3(shadow.trav_nodes,1,1,1);
+            context->countNodes((size_t)1 << k);
 
             /* intersect node */
             size_t mask = 0;
@@ -397,6 +403,7 @@ namespace embree
           assert(cur != BVH::emptyNode);
 	  STAT3(shadow.trav_leaves,1,1,1);
 	  size_t num; Primitive* prim = (Primitive*) cur.leaf(num);
+          context->countLeaves((size_t)1 << k,num);
 
           size_t lazy_node = 0;
           if (PrimitiveIntersectorK::occluded(pre,ray,k,context,prim,num,lazy_node)) {
@@ -424,6 +431,7 @@ namespace embree
       /* return if there are no valid rays */
       const size_t valid_bits = movemask(valid);
       if (unlikely(valid_bits == 0)) return;
+      STAT3(shadow.trav_packets,1,popcnt(valid),K);
 
       /* verify correct input */
       assert(all(valid,ray.valid()));
@@ -506,6 +514,7 @@ namespace embree
           /* process nodes */
           const vbool<K> valid_node = ray_tfar > curDist;
           STAT3(shadow.trav_nodes,1,popcnt(valid_node),K);
+          context->countNodes(movemask(valid_node));
           const NodeRef nodeRef = cur;
           const BaseNode* __restrict__ const node = nodeRef.baseNode(types);
 
@@ -573,9 +582,10 @@ namespace embree
 
         /* intersect leaf */
         assert(cur != BVH::emptyNode);
-        STAT(const vbool<K> valid_leaf = ray_tfar > curDist);
+        const vbool<K> valid_leaf = ray_tfar > curDist;
         STAT3(shadow.trav_leaves,1,popcnt(valid_leaf),K);
         size_t items; const Primitive* prim = (Primitive*) cur.leaf(items);
+        context->countLeaves(movemask(valid_leaf),items);
 
         size_t lazy_node = 0;
         terminated |= PrimitiveIntersectorK::occluded(!terminated,pre,ray,context,prim,items,lazy_node);
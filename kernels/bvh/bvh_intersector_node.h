@@ -927,6 +927,35 @@ namespace embree
     
 #endif
 
+    template<int N, int K>
+      __forceinline vbool<K> intersectNode(const typename BVHN<N>::QuantizedNode* node, size_t i, 
+                                           const Vec3vf<K>& org, const Vec3vf<K>& dir, const Vec3vf<K>& rdir, const Vec3vf<K>& org_rdir,
+                                           const vfloat<K>& tnear, const vfloat<K>& tfar, vfloat<K>& dist)
+ 
+    {
+      const BBox3fa bounds = node->bounds(i);
+#if defined(__AVX2__)
+      const vfloat<K> lclipMinX = msub(bounds.lower.x,rdir.x,org_rdir.x);
+      const vfloat<K> lclipMinY = msub(bounds.lower.y,rdir.y,org_rdir.y);
+      const vfloat<K> lclipMinZ = msub(bounds.lower.z,rdir.z,org_rdir.z);
+      const vfloat<K> lclipMaxX = msub(bounds.upper.x,rdir.x,org_rdir.x);
+      const vfloat<K> lclipMaxY = msub(bounds.upper.y,rdir.y,org_rdir.y);
+      const vfloat<K> lclipMaxZ = msub(bounds.upper.z,rdir.z,org_rdir.z);
+#else
+      const vfloat<K> lclipMinX = (bounds.lower.x - org.x) * rdir.x;
+      const vfloat<K> lclipMinY = (bounds.lower.y - org.y) * rdir.y;
+      const vfloat<K> lclipMinZ = (bounds.lower.z - org.z) * rdir.z;
+      const vfloat<K> lclipMaxX = (bounds.upper.x - org.x) * rdir.x;
+      const vfloat<K> lclipMaxY = (bounds.upper.y - org.y) * rdir.y;
+      const vfloat<K> lclipMaxZ = (bounds.upper.z - org.z) * rdir.z;
+#endif  
+      const vfloat<K> lnearP = maxi(mini(lclipMinX, lclipMaxX), mini(lclipMinY, lclipMaxY), mini(lclipMinZ, lclipMaxZ));
+      const vfloat<K> lfarP  = mini(maxi(lclipMinX, lclipMaxX), maxi(lclipMinY, lclipMaxY), maxi(lclipMinZ, lclipMaxZ));
+      const vbool<K> lhit    = maxi(lnearP, tnear) <= mini(lfarP, tfar);
+      dist = lnearP;
+      return lhit;
+    }
+
     //////////////////////////////////////////////////////////////////////////////////////
     // fast ray/BVHN::UnalignedNode intersection
     //////////////////////////////////////////////////////////////////////////////////////
@@ -1234,6 +1263,17 @@ namespace embree
       }
     };
 
+    template<int N, int K>
+    struct BVHNNodeIntersectorK<N,K,BVH_QN1,false>
+    {
+      static __forceinline bool intersect(const typename BVHN<N>::NodeRef& node, const size_t i, const Vec3vf<K>& org, const Vec3vf<K>& dir, const Vec3vf<K>& rdir, const Vec3vf<K>& org_rdir,
+                                          const vfloat<K>& tnear, const vfloat<K>& tfar, const vfloat<K>& time, vfloat<K>& dist, vbool<K>& vmask)
+      {
+        vmask = intersectNode<N,K>(node.quantizedNode(),i,org,dir,rdir,org_rdir,tnear,tfar,dist);
+        return true;
+      }
+    };
+
     template<int N, int K>
     struct BVHNNodeIntersectorK<N,K,BVH_AN2,false>
     {
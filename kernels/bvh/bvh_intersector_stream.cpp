@@ -83,6 +83,10 @@ namespace embree
         rayK[packetID].tfar[slotID]   = tfar;
         rayK[packetID].mask[slotID]   = inputRays[i]->mask;
         rayK[packetID].instID[slotID] = inputRays[i]->instID;
+#if RTC_MAX_INSTANCE_LEVEL_COUNT > 1
+        for (size_t l=0; l<RTC_MAX_INSTANCE_LEVEL_COUNT-1; l++)
+          rayK[packetID].nestedInstID[l][slotID] = inputRays[i]->nestedInstID[l];
+#endif
       }
       const size_t sign_min_dir = movemask(vfloat4(min_dir) < 0.0f);
       const size_t sign_max_dir = movemask(vfloat4(max_dir) < 0.0f);
@@ -112,11 +116,60 @@ namespace embree
             inputRays[i]->geomID = ray.geomID[slotID];
             inputRays[i]->primID = ray.primID[slotID];
             inputRays[i]->instID = ray.instID[slotID];
+#if RTC_MAX_INSTANCE_LEVEL_COUNT > 1
+            for (size_t l=0; l<RTC_MAX_INSTANCE_LEVEL_COUNT-1; l++)
+              inputRays[i]->nestedInstID[l] = ray.nestedInstID[l][slotID];
+#endif
           }
         }
       }
     }
 
+    /*! Intersects the rays set in bits one by one with the primitives
+     *  of a leaf and counts the leaf into the traversal statistics of
+     *  each ray. The statistics of the context are indexed by the
+     *  position of the ray in the stream, thus the context gets
+     *  offset to the statistics of the ray for the primitive
+     *  intersector and the callbacks it invokes. */
+    template<typename PrimitiveIntersector, typename Precalculations, typename Primitive>
+    __forceinline size_t intersectLeafStats(Precalculations* pre, size_t bits, Ray** rays, IntersectContext* context, const Primitive* prim, size_t num, size_t& lazy_node)
+    {
+      RTCTraversalStats* stats = context->stats;
+      size_t valid_isec = 0;
+      while (bits)
+      {
+        const size_t i = __bscf(bits);
+        const float old_far = rays[i]->tfar;
+        context->stats = stats + i;
+        context->countLeaves(1,num);
+        PrimitiveIntersector::intersect(pre[i],*rays[i],context,prim,num,lazy_node);
+        valid_isec |= (rays[i]->tfar < old_far) ? ((size_t)1 << i) : 0;
+      }
+      context->stats = stats;
+      return valid_isec;
+    }
+
+    /*! occlusion variant of intersectLeafStats, returns the occluded rays */
+    template<typename PrimitiveIntersector, typename Precalculations, typename Primitive>
+    __forceinline size_t occludedLeafStats(Precalculations* pre, size_t bits, Ray** rays, IntersectContext* context, const Primitive* prim, size_t num, size_t& lazy_node)
+    {
+      RTCTraversalStats* stats = context->stats;
+      size_t hit = 0;
+      while (bits)
+      {
+        const size_t i = __bscf(bits);
+        context->stats = stats + i;
+        context->countLeaves(1,num);
+        if (PrimitiveIntersector::occluded(pre[i],*rays[i],context,prim,num,lazy_node))
+        {
+          hit |= (size_t)1 << i;
+          rays[i]->geomID = 0;
+        }
+      }
+      context->stats = stats;
+      return hit;
+    }
+
     // =====================================================================================================
     // =====================================================================================================
     // =====================================================================================================
@@ -388,7 +441,7 @@ namespace embree
     void BVHNIntersectorStream<N, Nx, K, types, robust, PrimitiveIntersector>::intersect(BVH* __restrict__ bvh, Ray** inputRays, size_t numTotalRays, IntersectContext* context)
     {
 #if ENABLE_COHERENT_STREAM_PATH == 1
-      if (unlikely(PrimitiveIntersector::validIntersectorK && !robust && isCoherent(context->user->flags)))
+      if (unlikely(PrimitiveIntersector::validIntersectorK && !robust && isCoherent(context->user->flags) && !context->stats))
       {
         intersectCoherent(bvh, inputRays, numTotalRays, context);
         return;
@@ -400,6 +453,9 @@ namespace embree
       __aligned(64) Precalculations pre[MAX_RAYS_PER_OCTANT];
       __aligned(64) StackItemMask stack[stackSizeSingle];  //!< stack of nodes
 
+      /* traversal statistics are indexed by the position of the ray in the current chunk */
+      RTCTraversalStats* stats = context->stats;
+
       for (size_t r = 0; r < numTotalRays; r += MAX_RAYS_PER_OCTANT)
       {
         Ray** __restrict__ rays = inputRays + r;
@@ -408,7 +464,8 @@ namespace embree
         /* inactive rays should have been filtered out before */
         size_t m_active = numOctantRays == 8*sizeof(size_t) ? (size_t)-1 : (((size_t)1 << numOctantRays))-1;
 
-        if (m_active == 0) return;
+        if (m_active == 0) break;
+        if (unlikely(stats)) context->stats = stats + r;
 
         /* do per ray precalculations */
         for (size_t i = 0; i < numOctantRays; i++) {
@@ -445,6 +502,7 @@ namespace embree
             if (unlikely(cur.isLeaf())) break;
             const AlignedNode* __restrict__ const node = cur.alignedNode();
             assert(m_trav_active);
+            context->countNodes(m_trav_active);
 
 #if defined(__AVX512F__)
             /* AVX512 path for up to 64 rays */
@@ -477,7 +535,9 @@ namespace embree
 
           /*! intersect stream of rays with all primitives */
           size_t lazy_node = 0;
-          size_t valid_isec MAYBE_UNUSED = PrimitiveIntersector::intersect(pre, bits, rays, context, prim, num, lazy_node);
+          size_t valid_isec MAYBE_UNUSED = likely(!context->stats)
+            ? PrimitiveIntersector::intersect(pre, bits, rays, context, prim, num, lazy_node)
+            : intersectLeafStats<PrimitiveIntersector>(pre, bits, rays, context, prim, num, lazy_node);
 
           /* update tfar in ray context on successful hit */
           size_t isec_bits = valid_isec;
@@ -488,6 +548,7 @@ namespace embree
           }
         } // traversal + intersection
       }
+      context->stats = stats;
     }
 
 
@@ -495,7 +556,7 @@ namespace embree
     void BVHNIntersectorStream<N, Nx, K, types, robust, PrimitiveIntersector>::occluded(BVH* __restrict__ bvh, Ray **inputRays, size_t numTotalRays, IntersectContext* context)
     {
 #if ENABLE_COHERENT_STREAM_PATH == 1
-      if (unlikely(PrimitiveIntersector::validIntersectorK && !robust && isCoherent(context->user->flags)))
+      if (unlikely(PrimitiveIntersector::validIntersectorK && !robust && isCoherent(context->user->flags) && !context->stats))
       {
         occludedCoherent(bvh, inputRays, numTotalRays, context);
         return;
@@ -507,11 +568,22 @@ namespace embree
       __aligned(64) Precalculations pre[MAX_RAYS_PER_OCTANT];
       __aligned(64) StackItemMask stack[stackSizeSingle];  //!< stack of nodes
 
+      /* traversal statistics are indexed by the position of the ray in the current chunk */
+      RTCTraversalStats* stats = context->stats;
+
       for (size_t r = 0; r < numTotalRays; r += MAX_RAYS_PER_OCTANT)
       {
         Ray** rays = inputRays + r;
         const size_t numOctantRays = (r + MAX_RAYS_PER_OCTANT >= numTotalRays) ? numTotalRays-r : MAX_RAYS_PER_OCTANT;
         size_t m_active = numOctantRays == 8*sizeof(size_t) ? (size_t)-1 : (((size_t)1 << numOctantRays))-1;
+
+        /* with traversal statistics occluded rays are not filtered out of the stream */
+        if (unlikely(stats)) {
+          context->stats = stats + r;
+          for (size_t i = 0; i < numOctantRays; i++)
+            if (rays[i]->geomID == 0) m_active &= ~((size_t)1 << i);
+        }
+
         if (unlikely(m_active == 0)) continue;
 
         /* do per ray precalculations */
@@ -545,6 +617,7 @@ namespace embree
           {
             if (likely(cur.isLeaf())) break;
             assert(m_trav_active);
+            context->countNodes(m_trav_active);
 
             const AlignedNode* __restrict__ const node = cur.alignedNode();
 
@@ -578,10 +651,13 @@ namespace embree
           size_t bits = m_trav_active & m_active;
 
           assert(bits);
-          m_active = m_active & ~PrimitiveIntersector::occluded(pre, bits, rays, context, prim, num, lazy_node);
+          m_active = m_active & ~(likely(!context->stats)
+                                  ? PrimitiveIntersector::occluded(pre, bits, rays, context, prim, num, lazy_node)
+                                  : occludedLeafStats<PrimitiveIntersector>(pre, bits, rays, context, prim, num, lazy_node));
           if (unlikely(m_active == 0)) break;
         } // traversal + intersection
       }
+      context->stats = stats;
     }
 
     ////////////////////////////////////////////////////////////////////////////////
@@ -16,6 +16,7 @@
 
 #include "bvh_intersector_stream_filters.h"
 #include "bvh_intersector_stream.h"
+#include "../../include/embree2/rtcore_ray.h"
 
 namespace embree
 {
@@ -25,9 +26,315 @@ namespace embree
 
     static_assert(MAX_RAYS_PER_OCTANT <= MAX_INTERNAL_STREAM_SIZE,"maximal internal stream size exceeded");
 
+    /*! maximal number of rays sorted together, limited by the bits reserved for the ray index in the sort key */
+    static const size_t MAX_SORTED_RAYS = 4096;
+
+    /*! traces rays of a common octant */
+    __forceinline void traceOctant(Scene* scene, Ray** rays, const size_t numRays, IntersectContext* context, const bool intersect)
+    {
+      /* special codepath for very small number of rays per octant */
+      if (numRays == 1)
+      {
+        if (intersect) scene->intersect((RTCRay&)*rays[0],context);
+        else           scene->occluded ((RTCRay&)*rays[0],context);
+      }
+      /* codepath for large number of rays per octant */
+      else
+      {
+        if (intersect) scene->intersectN((RTCRay**)rays,numRays,context);
+        else           scene->occludedN ((RTCRay**)rays,numRays,context);
+      }
+    }
+
+    /*! Sorts blocks of up to ray_stream_sort_size rays of large streams
+     *  by direction octant and the Morton code of the ray origin, and
+     *  traces the sorted rays in chunks of up to MAX_RAYS_PER_OCTANT
+     *  rays of a common octant. Neighboring rays of a chunk start close
+     *  together, which makes the chunks more coherent than chunks of
+     *  rays that are only sorted by octant in input order. */
+    template<typename GetRay>
+    __forceinline void filterSorted(Scene* scene, const size_t N, const GetRay& getRay, IntersectContext* context, const bool intersect)
+    {
+      const size_t blockSize = min(scene->device->ray_stream_sort_size,MAX_SORTED_RAYS);
+      __aligned(64) uint64_t keys[MAX_SORTED_RAYS];
+      __aligned(64) Ray* rays[MAX_RAYS_PER_OCTANT];
+
+      for (size_t begin=0; begin<N; begin+=blockSize)
+      {
+        const size_t end = min(begin+blockSize,N);
+
+        /* gather valid rays and bounds of their origins */
+        size_t numValid = 0;
+        BBox3fa bounds(empty);
+        for (size_t i=begin; i<end; i++)
+        {
+          Ray& ray = getRay(i);
+          /* skip invalid rays */
+          if (unlikely(ray.tnear > ray.tfar)) continue;
+          if (unlikely(!intersect && ray.geomID == 0)) continue; // ignore already occluded rays
+#if defined(EMBREE_IGNORE_INVALID_RAYS)
+          if (unlikely(!ray.valid())) continue;
+#endif
+          bounds.extend(ray.org);
+          keys[numValid++] = i-begin;
+        }
+
+        /* compute sort keys from octant, Morton code of the origin, and ray index */
+        const vfloat4 base = (vfloat4)bounds.lower;
+        const vfloat4 diag = (vfloat4)bounds.upper - base;
+        const vfloat4 scale = select(diag > vfloat4(1E-19f), rcp(diag) * vfloat4(1024.0f * 0.99f), vfloat4(0.0f));
+        for (size_t i=0; i<numValid; i++)
+        {
+          const Ray& ray = getRay(begin+keys[i]);
+          const uint64_t octantID = movemask(vfloat4(ray.dir) < 0.0f) & 0x7;
+          const vint4 binID = vint4(((vfloat4)ray.org-base)*scale);
+          const uint64_t code = bitInterleave((unsigned int)extract<0>(binID),(unsigned int)extract<1>(binID),(unsigned int)extract<2>(binID));
+          keys[i] = (octantID << 48) | (code << 16) | keys[i];
+        }
+        std::sort(keys,keys+numValid);
+
+        /* trace sorted rays in chunks of common octant */
+        size_t numRays = 0;
+        for (size_t i=0; i<numValid; i++)
+        {
+          if (numRays && (numRays == MAX_RAYS_PER_OCTANT || (keys[i] >> 48) != (keys[i-1] >> 48))) {
+            traceOctant(scene,rays,numRays,context,intersect);
+            numRays = 0;
+          }
+          rays[numRays++] = &getRay(begin+(keys[i] & 0xFFFF));
+        }
+        if (numRays) traceOctant(scene,rays,numRays,context,intersect);
+      }
+    }
+
+    /*! Traces a ray stream with per ray traversal statistics, where
+     *  getRay(i) returns ray i of the stream and stats[i] are its
+     *  statistics. The rays are sorted by octant as in filterAOS. As
+     *  the traversers index the statistics by the position of the ray
+     *  in the traced chunk, each chunk gets traced with cleared local
+     *  statistics, which get accumulated into the statistics of the
+     *  rays afterwards. */
+    template<typename GetRay>
+    __forceinline void filterStats(Scene* scene, const size_t N, const GetRay& getRay, RTCTraversalStats* stats, IntersectContext* context, const bool intersect)
+    {
+      __aligned(64) Ray* octants[8][MAX_RAYS_PER_OCTANT];
+      size_t rayIDs[8][MAX_RAYS_PER_OCTANT];
+      size_t rays_in_octant[8];
+      for (size_t i=0;i<8;i++) rays_in_octant[i] = 0;
+      RTCTraversalStats local[MAX_RAYS_PER_OCTANT];
+
+      auto flush = [&] (const size_t octantID)
+      {
+        const size_t numRays = rays_in_octant[octantID];
+        for (size_t j=0; j<numRays; j++)
+          local[j].numNodes = local[j].numLeaves = local[j].numPrimBlocks = local[j].numFilterCalls = 0;
+
+        context->stats = local;
+        traceOctant(scene,octants[octantID],numRays,context,intersect);
+        context->stats = stats;
+
+        for (size_t j=0; j<numRays; j++)
+        {
+          RTCTraversalStats& s = stats[rayIDs[octantID][j]];
+          s.numNodes       += local[j].numNodes;
+          s.numLeaves      += local[j].numLeaves;
+          s.numPrimBlocks  += local[j].numPrimBlocks;
+          s.numFilterCalls += local[j].numFilterCalls;
+        }
+        rays_in_octant[octantID] = 0;
+      };
+
+      for (size_t i=0; i<N; i++)
+      {
+        Ray& ray = getRay(i);
+        /* skip invalid rays */
+        if (unlikely(ray.tnear > ray.tfar)) continue;
+        if (unlikely(!intersect && ray.geomID == 0)) continue; // ignore already occluded rays
+#if defined(EMBREE_IGNORE_INVALID_RAYS)
+        if (unlikely(!ray.valid())) continue;
+#endif
+        const size_t octantID = movemask(vfloat4(ray.dir) < 0.0f) & 0x7;
+        octants[octantID][rays_in_octant[octantID]] = &ray;
+        rayIDs[octantID][rays_in_octant[octantID]] = i;
+        if (unlikely(++rays_in_octant[octantID] == MAX_RAYS_PER_OCTANT))
+          flush(octantID);
+      }
+
+      /* flush remaining rays per octant */
+      for (size_t i=0;i<8;i++)
+        if (rays_in_octant[i]) flush(i);
+    }
+
+    /*! Traces a SOA or SOP ray stream with per ray traversal
+     *  statistics. Blocks of consecutive rays get gathered, traced
+     *  with filterStats, and the valid rays get scattered back. The
+     *  ray i of a SOA stream s has the statistics s*N+i. */
+    template<typename RayStreamT>
+    __forceinline void filterStatsGathered(Scene* scene, RayStreamT& rayN, const size_t streams, const size_t N, const size_t stream_offset, IntersectContext* context, const bool intersect)
+    {
+      RTCTraversalStats* stats = context->stats;
+      __aligned(64) Ray rays[MAX_RAYS_PER_OCTANT];
+      bool valid[MAX_RAYS_PER_OCTANT];
+
+      for (size_t s=0, soffset=0; s<streams; s++, soffset+=stream_offset)
+      {
+        for (size_t begin=0; begin<N; begin+=MAX_RAYS_PER_OCTANT)
+        {
+          const size_t end = min(begin+MAX_RAYS_PER_OCTANT,N);
+          for (size_t i=begin; i<end; i++)
+          {
+            const size_t offset = soffset + sizeof(float) * i;
+            valid[i-begin] = rayN.isValidByOffset(offset);
+            if (valid[i-begin]) {
+              rays[i-begin] = rayN.gatherByOffset(offset);
+            } else { /* gets skipped by filterStats */
+              rays[i-begin].tnear = 1.0f;
+              rays[i-begin].tfar  = 0.0f;
+            }
+          }
+
+          filterStats(scene,end-begin,[&] (const size_t i) -> Ray& { return rays[i]; },stats+s*N+begin,context,intersect);
+
+          for (size_t i=begin; i<end; i++)
+            if (valid[i-begin]) rayN.scatterByOffset(soffset + sizeof(float) * i,rays[i-begin],intersect);
+        }
+      }
+    }
+
+    /*! traces the rays at the specified offsets of a SOA or SOP ray stream in packets of VSIZEX rays */
+    template<typename RayStreamT>
+    __forceinline void tracePackets(Scene* scene, RayStreamT& rayN, const size_t* offsets, const size_t numRays, IntersectContext* context, const bool intersect)
+    {
+      for (size_t i=0; i<numRays; i+=VSIZEX)
+      {
+        const size_t n = min(numRays-i,size_t(VSIZEX));
+        const vboolx valid = vintx(step) < vintx(int(n));
+
+        /* unused lanes replicate the last ray to keep them well defined */
+        __aligned(64) RayK<VSIZEX> ray;
+        for (size_t k=0; k<VSIZEX; k++)
+          ray.set(k,rayN.gatherByOffset(offsets[i+min(k,n-1)]));
+
+        if (intersect) {
+          STAT3(normal.trav_repacked,1,n,VSIZEX);
+          scene->intersect(valid,ray,context);
+        } else {
+          STAT3(shadow.trav_repacked,1,n,VSIZEX);
+          scene->occluded (valid,ray,context);
+        }
+
+        for (size_t k=0; k<n; k++) {
+          Ray r; ray.get(k,r);
+          rayN.scatterByOffset(offsets[i+k],r,intersect);
+        }
+      }
+    }
+
+    /*! Traces SOA or SOP ray streams with the packet intersectors. The
+     *  valid rays of packets with inactive lanes are pooled by
+     *  direction octant over all packets of the stream and re-packed
+     *  into full packets, which keeps the SIMD lanes of the hybrid
+     *  traverser busy when many rays of the input packets already
+     *  terminated. Fully active packets are traced in place if the
+     *  stream layout matches RayK<VSIZEX> (rayData != nullptr). */
+    template<typename RayStreamT>
+    __forceinline void filterRepacked(Scene* scene, RayStreamT& rayN, char* rayData, const size_t streams, const size_t N, const size_t stream_offset, IntersectContext* context, const bool intersect)
+    {
+      size_t octants[8][MAX_RAYS_PER_OCTANT];
+      size_t rays_in_octant[8];
+      for (size_t i=0;i<8;i++) rays_in_octant[i] = 0;
+
+      for (size_t s=0, soffset=0; s<streams; s++, soffset+=stream_offset)
+      {
+        /* trace fully active packets in place */
+        if (rayData)
+        {
+          RayK<VSIZEX>& ray = *(RayK<VSIZEX>*)(rayData + soffset);
+          const vboolx valid = ray.tnear <= ray.tfar;
+          if (all(valid))
+          {
+            if (intersect) scene->intersect(valid,ray,context);
+            else           scene->occluded (valid,ray,context);
+            continue;
+          }
+        }
+
+        /* pool the valid rays of partially active packets */
+        for (size_t i=0; i<N; i++)
+        {
+          const size_t offset = soffset + sizeof(float) * i;
+          if (unlikely(!rayN.isValidByOffset(offset))) continue;
+
+#if defined(EMBREE_IGNORE_INVALID_RAYS)
+          __aligned(64) Ray ray = rayN.gatherByOffset(offset);
+          if (unlikely(!ray.valid())) continue; 
+#endif
+
+          const size_t octantID = rayN.getOctantByOffset(offset);
+          assert(octantID < 8);
+          octants[octantID][rays_in_octant[octantID]++] = offset;
+
+          if (unlikely(rays_in_octant[octantID] == MAX_RAYS_PER_OCTANT)) {
+            tracePackets(scene,rayN,octants[octantID],MAX_RAYS_PER_OCTANT,context,intersect);
+            rays_in_octant[octantID] = 0;
+          }
+        }
+      }
+
+      /* flush remaining rays per octant */
+      for (size_t i=0;i<8;i++)
+        if (rays_in_octant[i])
+          tracePackets(scene,rayN,octants[i],rays_in_octant[i],context,intersect);
+    }
+
+    /*! Traces a ray stream of a k-nearest hit query in packets of
+     *  consecutive rays, such that the lanes of each packet use
+     *  consecutive hit buffers. The gathered hits are written back to
+     *  the rays by the API layer, thus no rays are scattered. */
+    __forceinline void filterAOSKNearest(Scene* scene, char* rayData, const size_t N, const size_t stride, IntersectContext* context)
+    {
+      RTCHitBuffer* hitBuffers = context->hitBuffers;
+      RTCTraversalStats* stats = context->stats;
+      for (size_t i=0; i<N; i+=VSIZEX)
+      {
+        const size_t n = min(N-i,size_t(VSIZEX));
+
+        /* unused lanes replicate the last ray to keep them well defined */
+        __aligned(64) RayK<VSIZEX> ray;
+        for (size_t k=0; k<VSIZEX; k++)
+          ray.set(k,*(Ray*)(rayData + (i+min(k,n-1))*stride));
+        const vboolx valid = (vintx(step) < vintx(int(n))) & (ray.tnear <= ray.tfar);
+
+        context->hitBuffers = hitBuffers + i;
+        if (unlikely(stats)) context->stats = stats + i;
+        scene->intersect(valid,ray,context);
+      }
+      context->hitBuffers = hitBuffers;
+      context->stats = stats;
+    }
+
     __forceinline void RayStream::filterAOS(Scene *scene, RTCRay* _rayN, const size_t N, const size_t stride, IntersectContext* context, const bool intersect)
     {
       Ray* __restrict__ rayN = (Ray*)_rayN;
+
+      /* k-nearest hit queries map packet lanes to hit buffers */
+      if (unlikely(context->hitBuffers)) {
+        filterAOSKNearest(scene,(char*)_rayN,N,stride,context);
+        return;
+      }
+
+      /* per ray traversal statistics are indexed by the input ray */
+      if (unlikely(context->stats)) {
+        filterStats(scene,N,[&] (const size_t i) -> Ray& { return *(Ray*)((char*)rayN + i * stride); },context->stats,context,intersect);
+        return;
+      }
+
+      /* sort large streams by octant and origin */
+      if (N > MAX_RAYS_PER_OCTANT && scene->device->ray_stream_sort_size > MAX_RAYS_PER_OCTANT) {
+        filterSorted(scene,N,[&] (const size_t i) -> Ray& { return *(Ray*)((char*)rayN + i * stride); },context,intersect);
+        return;
+      }
+
       __aligned(64) Ray* octants[8][MAX_RAYS_PER_OCTANT];
       unsigned int rays_in_octant[8];
 
@@ -97,6 +404,19 @@ namespace embree
     __forceinline void RayStream::filterAOP(Scene *scene, RTCRay** _rayN, const size_t N,IntersectContext* context, const bool intersect)
     {
       Ray** __restrict__ rayN = (Ray**)_rayN;
+
+      /* per ray traversal statistics are indexed by the input ray */
+      if (unlikely(context->stats)) {
+        filterStats(scene,N,[&] (const size_t i) -> Ray& { return *rayN[i]; },context->stats,context,intersect);
+        return;
+      }
+
+      /* sort large streams by octant and origin */
+      if (N > MAX_RAYS_PER_OCTANT && scene->device->ray_stream_sort_size > MAX_RAYS_PER_OCTANT) {
+        filterSorted(scene,N,[&] (const size_t i) -> Ray& { return *rayN[i]; },context,intersect);
+        return;
+      }
+
       __aligned(64) Ray* octants[8][MAX_RAYS_PER_OCTANT];
       unsigned int rays_in_octant[8];
 
@@ -166,7 +486,7 @@ namespace embree
     void RayStream::filterSOACoherent(Scene *scene, char* rayData, const size_t streams, const size_t stream_offset, IntersectContext* context, const bool intersect)
     {
       /* all valid accels need to have a intersectN/occludedN */
-      bool chunkFallback = scene->isRobust() || !scene->accels.validIsecN();
+      bool chunkFallback = scene->isRobust() || !scene->validIsecN();
 
       /* check for common octant */
       if (unlikely(!chunkFallback))
@@ -249,6 +569,23 @@ namespace embree
 
     __forceinline void RayStream::filterSOA(Scene *scene, char* rayData, const size_t N, const size_t streams, const size_t stream_offset, IntersectContext* context, const bool intersect)
     {
+      /* per ray traversal statistics are indexed by the input ray */
+      if (unlikely(context->stats))
+      {
+        RayPacket rayN(rayData,N);
+        filterStatsGathered(scene,rayN,streams,N,stream_offset,context,intersect);
+        return;
+      }
+
+      /* re-pack rays of partially active packets into full packets */
+      if (unlikely(scene->device->ray_packet_repacking))
+      {
+        RayPacket rayN(rayData,N);
+        const bool inplace = N == VSIZEX && (size_t)rayData % (VSIZEX*sizeof(float)) == 0 && stream_offset % (VSIZEX*sizeof(float)) == 0;
+        filterRepacked(scene,rayN,inplace ? rayData : nullptr,streams,N,stream_offset,context,intersect);
+        return;
+      }
+
       /* can we use the fast path ? */
 #if defined(__AVX__) && ENABLE_COHERENT_STREAM_PATH == 1 
       /* fast path for packet width == SIMD width && correct RayK alignment*/
@@ -344,7 +681,7 @@ namespace embree
       RayPN& rayN = *(RayPN*)&_rayN;
 
       /* all valid accels need to have a intersectN/occludedN */
-      bool chunkFallback = scene->isRobust() || !scene->accels.validIsecN();
+      bool chunkFallback = scene->isRobust() || !scene->validIsecN();
 
       /* check for common octant */
       if (unlikely(!chunkFallback))
@@ -448,6 +785,22 @@ namespace embree
 
     void RayStream::filterSOP(Scene *scene, const RTCRayNp& _rayN, const size_t N, IntersectContext* context, const bool intersect)
     {
+      /* per ray traversal statistics are indexed by the input ray */
+      if (unlikely(context->stats))
+      {
+        RayPN& rayN = *(RayPN*)&_rayN;
+        filterStatsGathered(scene,rayN,1,N,0,context,intersect);
+        return;
+      }
+
+      /* re-pack rays of partially active packets into full packets */
+      if (unlikely(scene->device->ray_packet_repacking))
+      {
+        RayPN& rayN = *(RayPN*)&_rayN;
+        filterRepacked(scene,rayN,nullptr,1,N,0,context,intersect);
+        return;
+      }
+
       /* use fast path for coherent ray mode */
 #if defined(__AVX__) && ENABLE_COHERENT_STREAM_PATH == 1
       if (unlikely(isCoherent(context->user->flags)))
@@ -0,0 +1,140 @@
+// ======================================================================== //
+// Copyright 2009-2017 Intel Corporation                                    //
+//                                                                          //
+// Licensed under the Apache License, Version 2.0 (the "License");          //
+// you may not use this file except in compliance with the License.         //
+// You may obtain a copy of the License at                                  //
+//                                                                          //
+//     http://www.apache.org/licenses/LICENSE-2.0                           //
+//                                                                          //
+// Unless required by applicable law or agreed to in writing, software      //
+// distributed under the License is distributed on an "AS IS" BASIS,        //
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. //
+// See the License for the specific language governing permissions and      //
+// limitations under the License.                                           //
+// ======================================================================== //
+
+#include "bvh_occlusion_order.h"
+#include "../common/scene.h"
+#include "../../common/algorithms/parallel_for.h"
+
+namespace embree
+{
+  template<int N>
+  size_t BVHNOcclusionOrder<N>::recurse(NodeRef ref, size_t depth)
+  {
+    if (ref.isBarrier() || !ref.isAlignedNode()) return 0;
+    AlignedNode* node = ref.alignedNode();
+
+    /* reorder all subtrees */
+    size_t numModified = 0;
+    if (depth < PARALLEL_DEPTH)
+    {
+      size_t modified[N];
+      parallel_for(size_t(N), [&] (size_t c) {
+          modified[c] = recurse(node->child(c),depth+1);
+        });
+      for (size_t c=0; c<N; c++) numModified += modified[c];
+    }
+    else
+    {
+      for (size_t c=0; c<N; c++)
+        numModified += recurse(node->child(c),depth+1);
+    }
+
+    /* sort children by increasing area, the traversal visits the last child first */
+    size_t numChildren = 0;
+    NodeRef children[N]; BBox3fa bounds[N]; float areas[N];
+    bool sorted = true;
+    for (size_t c=0; c<N; c++)
+    {
+      const NodeRef child = node->child(c);
+      if (child == BVH::emptyNode) continue;
+      const BBox3fa b = node->bounds(c);
+      const float a = halfArea(b);
+      size_t i = numChildren++;
+      for (; i>0 && areas[i-1] > a; i--) {
+        children[i] = children[i-1]; bounds[i] = bounds[i-1]; areas[i] = areas[i-1];
+        sorted = false;
+      }
+      children[i] = child; bounds[i] = b; areas[i] = a;
+    }
+    if (sorted) return numModified;
+
+    node->clear();
+    for (size_t i=0; i<numChildren; i++)
+      node->set(i,children[i],bounds[i]);
+    return numModified+1;
+  }
+
+  template<int N>
+  size_t BVHNOcclusionOrder<N>::reorder(BVH* bvh) {
+    return recurse(bvh->root,1);
+  }
+
+  /*! builder that reorders the BVH for occlusion rays after the build */
+  template<int N>
+  class BVHNOcclusionOrderedBuilder : public Builder
+  {
+    typedef BVHN<N> BVH;
+
+  public:
+    BVHNOcclusionOrderedBuilder (BVH* bvh, Builder* builder)
+      : bvh(bvh), builder(builder) {}
+
+    void build()
+    {
+      builder->build();
+      if (bvh->root == BVH::emptyNode)
+        return;
+
+      Device* device = bvh->device;
+      double t0 = 0.0;
+      if (device->benchmark || device->verbosity(1)) t0 = getSeconds();
+      const size_t numModified = BVHNOcclusionOrder<N>::reorder(bvh);
+
+      if (device->verbosity(1)) {
+        const double dt = getSeconds()-t0;
+        Lock<MutexSys> lock(g_printMutex);
+        std::cout << "reordered BVH" << N << "<" << bvh->primTy.name << "> for occlusion : " << 1000.0f*dt << "ms, " << numModified << " nodes" << std::endl;
+      }
+    }
+
+    void deleteGeometry(size_t geomID) {
+      builder->deleteGeometry(geomID);
+    }
+
+    void clear() {
+      builder->clear();
+    }
+
+  private:
+    BVH* bvh;
+    std::unique_ptr<Builder> builder;
+  };
+
+  template<int N>
+  Builder* BVHNOcclusionOrderBuilder(BVHN<N>* bvh, Scene* scene, Builder* builder, const std::string& builderName)
+  {
+    if (builder == nullptr || !scene->isStatic() || !scene->isOcclusionOptimized())
+      return builder;
+
+    /* two-level builders share the BVHs of the meshes and nodes of out-of-core builds are mapped read-only */
+    if (builderName == "dynamic" || builderName == "morton" || builderName == "ploc" || builderName == "streaming")
+      return builder;
+    if (builderName == "default" && scene->device->build_memory_budget)
+      return builder;
+
+    return new BVHNOcclusionOrderedBuilder<N>(bvh,builder);
+  }
+
+#if defined(__AVX__)
+  template class BVHNOcclusionOrder<8>;
+  template Builder* BVHNOcclusionOrderBuilder<8>(BVHN<8>* bvh, Scene* scene, Builder* builder, const std::string& builderName);
+#endif
+
+#if !defined(__AVX__) || !defined(EMBREE_TARGET_SSE2) && !defined(EMBREE_TARGET_SSE42)
+  template class BVHNOcclusionOrder<4>;
+  template Builder* BVHNOcclusionOrderBuilder<4>(BVHN<4>* bvh, Scene* scene, Builder* builder, const std::string& builderName);
+#endif
+}
@@ -0,0 +1,59 @@
+// ======================================================================== //
+// Copyright 2009-2017 Intel Corporation                                    //
+//                                                                          //
+// Licensed under the Apache License, Version 2.0 (the "License");          //
+// you may not use this file except in compliance with the License.         //
+// You may obtain a copy of the License at                                  //
+//                                                                          //
+//     http://www.apache.org/licenses/LICENSE-2.0                           //
+//                                                                          //
+// Unless required by applicable law or agreed to in writing, software      //
+// distributed under the License is distributed on an "AS IS" BASIS,        //
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. //
+// See the License for the specific language governing permissions and      //
+// limitations under the License.                                           //
+// ======================================================================== //
+
+#pragma once
+
+#include "bvh.h"
+#include "../common/builder.h"
+
+namespace embree
+{
+  /*! Reorders the children of the aligned nodes of a BVH for
+   *  occlusion rays. The single ray and stream occlusion traversal
+   *  visits the hit children of a node from the last to the first
+   *  slot, independent of their distance, as any hit terminates the
+   *  ray. The children are sorted by increasing surface area, thus
+   *  the child most likely hit by a ray that hits the node is
+   *  visited first. The closest hit traversal orders children by
+   *  distance and is not affected. */
+  template<int N>
+  class BVHNOcclusionOrder
+  {
+    typedef BVHN<N> BVH;
+    typedef typename BVH::AlignedNode AlignedNode;
+    typedef typename BVH::NodeRef NodeRef;
+
+  public:
+
+    /*! subtrees above this depth are reordered in parallel */
+    static const size_t PARALLEL_DEPTH = 4;
+
+    /*! reorders the children of all aligned nodes, returns the number of modified nodes */
+    static size_t reorder(BVH* bvh);
+
+  private:
+    static size_t recurse(NodeRef ref, size_t depth);
+  };
+
+  /*! Creates a builder that invokes the specified builder and reorders
+   *  the children of the resulting BVH for occlusion rays afterwards.
+   *  Returns the specified builder if the scene is not a static scene
+   *  created with RTC_SCENE_OPTIMIZE_OCCLUSION, or the builder does not
+   *  produce a BVH of aligned nodes owned by that BVH (two-level and
+   *  out-of-core builders). */
+  template<int N>
+  Builder* BVHNOcclusionOrderBuilder(BVHN<N>* bvh, Scene* scene, Builder* builder, const std::string& builderName);
+}
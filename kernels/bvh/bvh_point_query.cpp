@@ -0,0 +1,108 @@
+// ======================================================================== //
+// Copyright 2009-2017 Intel Corporation                                    //
+//                                                                          //
+// Licensed under the Apache License, Version 2.0 (the "License");          //
+// you may not use this file except in compliance with the License.         //
+// You may obtain a copy of the License at                                  //
+//                                                                          //
+//     http://www.apache.org/licenses/LICENSE-2.0                           //
+//                                                                          //
+// Unless required by applicable law or agreed to in writing, software      //
+// distributed under the License is distributed on an "AS IS" BASIS,        //
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. //
+// See the License for the specific language governing permissions and      //
+// limitations under the License.                                           //
+// ======================================================================== //
+
+#include "bvh_point_query.h"
+#include "../geometry/point_query.h"
+#include "../common/stack_item.h"
+
+namespace embree
+{
+  namespace isa
+  {
+    template<int N, typename PrimitivePointQuery1>
+    void BVHNPointQuery1<N,PrimitivePointQuery1>::pointQuery(const BVH* __restrict__ bvh, RTCPointQuery& query)
+    {
+      /*! stack state */
+      StackItemT<NodeRef> stack[stackSize];           //!< stack of nodes
+      StackItemT<NodeRef>* stackPtr = stack+1;        //!< current stack pointer
+      stack[0].ptr  = bvh->root;
+      stack[0].dist = 0;
+
+      /*! the culling sphere shrinks with each closer point found */
+      const Vec3vf<N> p(query.p[0],query.p[1],query.p[2]);
+      const Vec3fa p1(query.p[0],query.p[1],query.p[2]);
+      float radius2 = sqr(query.radius);
+      bool found = false;
+
+      /* pop loop */
+      while (true) pop:
+      {
+        /*! pop next node */
+        if (unlikely(stackPtr == stack)) break;
+        stackPtr--;
+        NodeRef cur = NodeRef(stackPtr->ptr);
+
+        /*! if popped node is too far, pop next one */
+        if (unlikely(*(float*)&stackPtr->dist > radius2))
+          continue;
+
+        /* downtraversal loop */
+        while (true)
+        {
+          if (unlikely(cur.isLeaf())) break;
+          assert(cur.isAlignedNode());
+          const AlignedNode* node = cur.alignedNode();
+
+          /*! squared distances of the query position to the child bounds */
+          const vfloat<N> dx = max(node->lower_x-p.x,p.x-node->upper_x,vfloat<N>(zero));
+          const vfloat<N> dy = max(node->lower_y-p.y,p.y-node->upper_y,vfloat<N>(zero));
+          const vfloat<N> dz = max(node->lower_z-p.z,p.z-node->upper_z,vfloat<N>(zero));
+          const vfloat<N> dist = dx*dx + dy*dy + dz*dz;
+          size_t mask = movemask(dist <= vfloat<N>(radius2));
+          if (unlikely(mask == 0)) goto pop;
+
+          /*! push all hit children sorted by distance and continue with the closest one */
+          StackItemT<NodeRef>* begin = stackPtr;
+          for (; mask; stackPtr++) {
+            const size_t i = __bscf(mask);
+            stackPtr->ptr  = node->child(i);
+            stackPtr->dist = ((unsigned*)&dist)[i];
+          }
+          sort(begin,stackPtr);
+          stackPtr--;
+          cur = NodeRef(stackPtr->ptr);
+        }
+
+        /*! this is a leaf node */
+        size_t num; Primitive* prim = (Primitive*) cur.leaf(num);
+        for (size_t i=0; i<num; i++)
+          found |= PrimitivePointQuery1::pointQuery(query,p1,radius2,bvh->scene,prim[i]);
+      }
+
+      if (found) query.radius = sqrt(radius2);
+    }
+
+    ////////////////////////////////////////////////////////////////////////////////
+    /// BVH4PointQuery1 Definitions
+    ////////////////////////////////////////////////////////////////////////////////
+
+    IF_ENABLED_TRIS(DEFINE_POINT_QUERY1(BVH4Triangle4PointQuery1,BVHNPointQuery1<4 COMMA TriangleMPointQuery1<4> >));
+    IF_ENABLED_TRIS(DEFINE_POINT_QUERY1(BVH4Triangle4vPointQuery1,BVHNPointQuery1<4 COMMA TriangleMvPointQuery1<4> >));
+    IF_ENABLED_QUADS(DEFINE_POINT_QUERY1(BVH4Quad4vPointQuery1,BVHNPointQuery1<4 COMMA QuadMvPointQuery1<4> >));
+    IF_ENABLED_LINES(DEFINE_POINT_QUERY1(BVH4Line4iPointQuery1,BVHNPointQuery1<4 COMMA LineMiPointQuery1<4> >));
+
+    ////////////////////////////////////////////////////////////////////////////////
+    /// BVH8PointQuery1 Definitions
+    ////////////////////////////////////////////////////////////////////////////////
+
+#if defined(__AVX__)
+    IF_ENABLED_TRIS(DEFINE_POINT_QUERY1(BVH8Triangle4PointQuery1,BVHNPointQuery1<8 COMMA TriangleMPointQuery1<4> >));
+    IF_ENABLED_TRIS(DEFINE_POINT_QUERY1(BVH8Triangle4vPointQuery1,BVHNPointQuery1<8 COMMA TriangleMvPointQuery1<4> >));
+    IF_ENABLED_QUADS(DEFINE_POINT_QUERY1(BVH8Quad4vPointQuery1,BVHNPointQuery1<8 COMMA QuadMvPointQuery1<4> >));
+    IF_ENABLED_LINES(DEFINE_POINT_QUERY1(BVH8Line4iPointQuery1,BVHNPointQuery1<8 COMMA LineMiPointQuery1<4> >));
+#endif
+  }
+}
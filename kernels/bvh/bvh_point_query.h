@@ -0,0 +1,43 @@
+// ======================================================================== //
+// Copyright 2009-2017 Intel Corporation                                    //
+//                                                                          //
+// Licensed under the Apache License, Version 2.0 (the "License");          //
+// you may not use this file except in compliance with the License.         //
+// You may obtain a copy of the License at                                  //
+//                                                                          //
+//     http://www.apache.org/licenses/LICENSE-2.0                           //
+//                                                                          //
+// Unless required by applicable law or agreed to in writing, software      //
+// distributed under the License is distributed on an "AS IS" BASIS,        //
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. //
+// See the License for the specific language governing permissions and      //
+// limitations under the License.                                           //
+// ======================================================================== //
+
+#pragma once
+
+#include "bvh.h"
+
+namespace embree
+{
+  namespace isa
+  {
+    /*! BVH closest point query. The traversal culls the nodes against
+     *  a sphere around the query position, whose radius shrinks to the
+     *  distance of the closest point found so far. */
+    template<int N, typename PrimitivePointQuery1>
+      class BVHNPointQuery1
+    {
+      /* shortcuts for frequently used types */
+      typedef typename PrimitivePointQuery1::Primitive Primitive;
+      typedef BVHN<N> BVH;
+      typedef typename BVH::NodeRef NodeRef;
+      typedef typename BVH::AlignedNode AlignedNode;
+
+      static const size_t stackSize = 1+(N-1)*BVH::maxDepth+N;
+
+    public:
+      static void pointQuery(const BVH* This, RTCPointQuery& query);
+    };
+  }
+}
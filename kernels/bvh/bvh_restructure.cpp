@@ -0,0 +1,361 @@
+// ======================================================================== //
+// Copyright 2009-2017 Intel Corporation                                    //
+//                                                                          //
+// Licensed under the Apache License, Version 2.0 (the "License");          //
+// you may not use this file except in compliance with the License.         //
+// You may obtain a copy of the License at                                  //
+//                                                                          //
+//     http://www.apache.org/licenses/LICENSE-2.0                           //
+//                                                                          //
+// Unless required by applicable law or agreed to in writing, software      //
+// distributed under the License is distributed on an "AS IS" BASIS,        //
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. //
+// See the License for the specific language governing permissions and      //
+// limitations under the License.                                           //
+// ======================================================================== //
+
+#include "bvh_restructure.h"
+#include "bvh_statistics.h"
+#include "../common/scene.h"
+#include "../../common/algorithms/parallel_for.h"
+
+namespace embree
+{
+  /*! Workspace for optimizing a single treelet. The leaves and subsets
+   *  of leaves are encoded as bitmasks. For each subset S of leaves we
+   *  compute:
+   *
+   *   T(S,j)   : cost of a subtree over S with at most j nodes
+   *   M(S,s,j) : cost of splitting S into 2 to s subtrees with at most j nodes
+   *   F(S,s,j) : cost of splitting S into 1 to s subtrees with at most j nodes
+   *
+   *  where the cost is the sum of the half areas of all nodes. */
+  template<int N>
+  struct BVHNRestructure<N>::Treelet
+  {
+    static const size_t L = MAX_TREELET_LEAVES;
+    static const size_t J = MAX_TREELET_NODES+1;
+    static const size_t S = N+1;
+
+    __forceinline float& T(size_t set, size_t j) { return costT[set*J+j]; }
+    __forceinline float& M(size_t set, size_t s, size_t j) { return costM[(set*S+s)*J+j]; }
+    __forceinline float& F(size_t set, size_t s, size_t j) { return costF[(set*S+s)*J+j]; }
+    __forceinline unsigned char& splitM(size_t set, size_t s, size_t j) { return splitSet[(set*S+s)*J+j]; }
+    __forceinline unsigned char& nodesM(size_t set, size_t s, size_t j) { return splitNodes[(set*S+s)*J+j]; }
+
+    /*! searches the optimal topology, returns its cost */
+    float optimize(size_t slots)
+    {
+      const size_t full = (size_t(1) << numLeaves)-1;
+      const size_t k = numNodes;
+
+      for (size_t set=1; set<=full; set++)
+      {
+        /* compute bounds and area of the subset */
+        const size_t low = set & (0-set);
+        const size_t rest = set ^ low;
+        bounds[set] = rest ? merge(bounds[low],bounds[rest]) : leafBounds[__bsf(set)];
+        area[set] = halfArea(bounds[set]);
+
+        /* a single leaf needs no node */
+        if (rest == 0)
+        {
+          for (size_t j=0; j<=k; j++) {
+            T(set,j) = 0.0f;
+            for (size_t s=1; s<=N; s++) {
+              M(set,s,j) = inf;
+              F(set,s,j) = 0.0f;
+            }
+          }
+          continue;
+        }
+
+        /* split into a first subtree P that contains the lowest leaf and the remaining subtrees */
+        for (size_t s=1; s<=N; s++)
+          for (size_t j=0; j<=k; j++)
+            M(set,s,j) = inf;
+
+        for (size_t sub=0; sub<rest; sub=(sub-rest) & rest)
+        {
+          const size_t P = low | sub;
+          const size_t R = set ^ P;
+          for (size_t j1=0; j1<=k; j1++)
+          {
+            const float t = T(P,j1);
+            if (t == float(inf)) continue;
+            for (size_t j=j1; j<=k; j++) {
+              for (size_t s=2; s<=N; s++) {
+                const float c = t + F(R,s-1,j-j1);
+                if (c < M(set,s,j)) {
+                  M(set,s,j) = c;
+                  splitM(set,s,j) = (unsigned char) P;
+                  nodesM(set,s,j) = (unsigned char) j1;
+                }
+              }
+            }
+          }
+        }
+
+        /* a subtree needs a node that splits the set into up to N subtrees */
+        T(set,0) = inf;
+        for (size_t j=1; j<=k; j++)
+          T(set,j) = area[set] + M(set,N,j-1);
+
+        for (size_t j=0; j<=k; j++) {
+          F(set,1,j) = T(set,j);
+          for (size_t s=2; s<=N; s++)
+            F(set,s,j) = min(T(set,j),M(set,s,j));
+        }
+      }
+      return F(full,slots,k);
+    }
+
+    /*! computes the height of the optimal topology */
+    size_t heightT(size_t set, size_t j)
+    {
+      if ((set & (set-1)) == 0) return leafHeights[__bsf(set)];
+      return 1+heightM(set,N,j-1);
+    }
+
+    size_t heightM(size_t set, size_t s, size_t j)
+    {
+      const size_t P = splitM(set,s,j);
+      const size_t j1 = nodesM(set,s,j);
+      return max(heightT(P,j1),heightF(set^P,s-1,j-j1));
+    }
+
+    size_t heightF(size_t set, size_t s, size_t j)
+    {
+      if (s == 1 || F(set,s,j) == T(set,j)) return heightT(set,j);
+      return heightM(set,s,j);
+    }
+
+    /*! creates the optimal topology, reusing the nodes of the treelet */
+    NodeRef createT(size_t set, size_t j)
+    {
+      if ((set & (set-1)) == 0) return leaves[__bsf(set)];
+      AlignedNode* node = nodes[usedNodes++];
+      node->clear();
+      size_t slot = 0;
+      createM(node,slot,set,N,j-1);
+      return BVH::encodeNode(node);
+    }
+
+    void createM(AlignedNode* node, size_t& slot, size_t set, size_t s, size_t j)
+    {
+      const size_t P = splitM(set,s,j);
+      const size_t j1 = nodesM(set,s,j);
+      node->set(slot++,createT(P,j1),bounds[P]);
+      createF(node,slot,set^P,s-1,j-j1);
+    }
+
+    void createF(AlignedNode* node, size_t& slot, size_t set, size_t s, size_t j)
+    {
+      if (s == 1 || F(set,s,j) == T(set,j)) node->set(slot++,createT(set,j),bounds[set]);
+      else createM(node,slot,set,s,j);
+    }
+
+    size_t numLeaves;
+    NodeRef leaves[L];
+    BBox3fa leafBounds[L];
+    size_t leafHeights[L];
+
+    size_t numNodes;
+    size_t usedNodes;
+    AlignedNode* nodes[MAX_TREELET_NODES];
+
+    BBox3fa bounds[1 << L];
+    float area[1 << L];
+    float costT[(1 << L)*J];
+    float costM[(1 << L)*S*J];
+    float costF[(1 << L)*S*J];
+    unsigned char splitSet[(1 << L)*S*J];
+    unsigned char splitNodes[(1 << L)*S*J];
+  };
+
+  template<int N>
+  size_t BVHNRestructure<N>::recurse(NodeRef ref, size_t depth, Treelet& treelet, size_t& numModified)
+  {
+    if (ref.isBarrier() || !ref.isAlignedNode()) return 0;
+    AlignedNode* node = ref.alignedNode();
+
+    /* restructure all subtrees first */
+    size_t heights[N];
+    if (depth < PARALLEL_DEPTH)
+    {
+      size_t modified[N];
+      parallel_for(size_t(N), [&] (size_t c) {
+          std::unique_ptr<Treelet> local(new Treelet);
+          modified[c] = 0;
+          heights[c] = recurse(node->child(c),depth+1,*local,modified[c]);
+        });
+      for (size_t c=0; c<N; c++) numModified += modified[c];
+    }
+    else
+    {
+      for (size_t c=0; c<N; c++)
+        heights[c] = recurse(node->child(c),depth+1,treelet,numModified);
+    }
+
+    /* sort children by decreasing area */
+    size_t numChildren = 0;
+    size_t order[N]; float areas[N];
+    for (size_t c=0; c<N; c++) {
+      if (node->child(c) == BVH::emptyNode) continue;
+      const float a = halfArea(node->bounds(c));
+      size_t i = numChildren++;
+      for (; i>0 && areas[i-1] < a; i--) {
+        order[i] = order[i-1]; areas[i] = areas[i-1];
+      }
+      order[i] = c; areas[i] = a;
+    }
+
+    size_t oldHeight = 0;
+    for (size_t i=0; i<numChildren; i++)
+      oldHeight = max(oldHeight,1+heights[order[i]]);
+
+    /* form treelet by opening the largest children */
+    size_t numFixed = 0;
+    NodeRef fixed[N]; BBox3fa fixedBounds[N]; size_t fixedHeights[N];
+    treelet.numLeaves = treelet.numNodes = treelet.usedNodes = 0;
+    float oldCost = 0.0f;
+    for (size_t i=0; i<numChildren; i++)
+    {
+      const size_t c = order[i];
+      NodeRef child = node->child(c);
+      if (!child.isBarrier() && child.isAlignedNode())
+      {
+        AlignedNode* cnode = child.alignedNode();
+        size_t n = 0; while (n<N && cnode->child(n) != BVH::emptyNode) n++;
+        if (treelet.numLeaves+n <= MAX_TREELET_LEAVES && treelet.numNodes < MAX_TREELET_NODES)
+        {
+          for (size_t j=0; j<n; j++) {
+            treelet.leaves[treelet.numLeaves] = cnode->child(j);
+            treelet.leafBounds[treelet.numLeaves] = cnode->bounds(j);
+            treelet.leafHeights[treelet.numLeaves] = heights[c]-1;
+            treelet.numLeaves++;
+          }
+          treelet.nodes[treelet.numNodes++] = cnode;
+          oldCost += areas[i];
+          continue;
+        }
+      }
+      if (treelet.numLeaves < MAX_TREELET_LEAVES) {
+        treelet.leaves[treelet.numLeaves] = child;
+        treelet.leafBounds[treelet.numLeaves] = node->bounds(c);
+        treelet.leafHeights[treelet.numLeaves] = heights[c];
+        treelet.numLeaves++;
+        continue;
+      }
+      fixed[numFixed] = child;
+      fixedBounds[numFixed] = node->bounds(c);
+      fixedHeights[numFixed] = heights[c];
+      numFixed++;
+    }
+    if (treelet.numNodes == 0)
+      return oldHeight;
+
+    /* search optimal topology and only accept it if it reduces the SAH cost */
+    const size_t slots = N-numFixed;
+    const size_t full = (size_t(1) << treelet.numLeaves)-1;
+    const float newCost = treelet.optimize(slots);
+    if (!(newCost < 0.999f*oldCost))
+      return oldHeight;
+
+    /* do not exceed the maximal build depth */
+    size_t newHeight = 1+treelet.heightF(full,slots,treelet.numNodes);
+    for (size_t i=0; i<numFixed; i++)
+      newHeight = max(newHeight,1+fixedHeights[i]);
+    if (newHeight > oldHeight && depth+newHeight > BVH::maxBuildDepthLeaf)
+      return oldHeight;
+
+    /* rewrite the root of the treelet */
+    node->clear();
+    size_t slot = 0;
+    for (size_t i=0; i<numFixed; i++)
+      node->set(slot++,fixed[i],fixedBounds[i]);
+    treelet.createF(node,slot,full,slots,treelet.numNodes);
+    numModified++;
+    return newHeight;
+  }
+
+  template<int N>
+  size_t BVHNRestructure<N>::restructure(BVH* bvh)
+  {
+    size_t numModified = 0;
+    std::unique_ptr<Treelet> treelet(new Treelet);
+    recurse(bvh->root,1,*treelet,numModified);
+    return numModified;
+  }
+
+  /*! builder that restructures the BVH after the build */
+  template<int N>
+  class BVHNRestructuredBuilder : public Builder
+  {
+    typedef BVHN<N> BVH;
+
+  public:
+    BVHNRestructuredBuilder (BVH* bvh, Builder* builder)
+      : bvh(bvh), builder(builder) {}
+
+    void build()
+    {
+      builder->build();
+      if (bvh->root == BVH::emptyNode)
+        return;
+
+      Device* device = bvh->device;
+      double t0 = 0.0;
+      if (device->benchmark || device->verbosity(1)) t0 = getSeconds();
+      const size_t numModified = BVHNRestructure<N>::restructure(bvh);
+
+      if (device->verbosity(1)) {
+        const double dt = getSeconds()-t0;
+        Lock<MutexSys> lock(g_printMutex);
+        std::cout << "restructured BVH" << N << "<" << bvh->primTy.name << "> : " << 1000.0f*dt << "ms, " << numModified << " treelets" << std::endl;
+        if (device->verbosity(2))
+          std::cout << BVHNStatistics<N>(bvh).str();
+      }
+    }
+
+    void deleteGeometry(size_t geomID) {
+      builder->deleteGeometry(geomID);
+    }
+
+    void clear() {
+      builder->clear();
+    }
+
+  private:
+    BVH* bvh;
+    std::unique_ptr<Builder> builder;
+  };
+
+  template<int N>
+  Builder* BVHNRestructureBuilder(BVHN<N>* bvh, Scene* scene, Builder* builder, const std::string& builderName)
+  {
+    if (builder == nullptr || !scene->device->bvh_restructure)
+      return builder;
+
+    if (!scene->isStatic() || !scene->isHighQuality())
+      return builder;
+
+    /* two-level builders share the BVHs of the meshes and nodes of out-of-core builds are mapped read-only */
+    if (builderName == "dynamic" || builderName == "morton" || builderName == "ploc" || builderName == "streaming")
+      return builder;
+    if (builderName == "default" && scene->device->build_memory_budget)
+      return builder;
+
+    return new BVHNRestructuredBuilder<N>(bvh,builder);
+  }
+
+#if defined(__AVX__)
+  template class BVHNRestructure<8>;
+  template Builder* BVHNRestructureBuilder<8>(BVHN<8>* bvh, Scene* scene, Builder* builder, const std::string& builderName);
+#endif
+
+#if !defined(__AVX__) || !defined(EMBREE_TARGET_SSE2) && !defined(EMBREE_TARGET_SSE42)
+  template class BVHNRestructure<4>;
+  template Builder* BVHNRestructureBuilder<4>(BVHN<4>* bvh, Scene* scene, Builder* builder, const std::string& builderName);
+#endif
+}
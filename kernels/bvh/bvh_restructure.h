@@ -0,0 +1,65 @@
+// ======================================================================== //
+// Copyright 2009-2017 Intel Corporation                                    //
+//                                                                          //
+// Licensed under the Apache License, Version 2.0 (the "License");          //
+// you may not use this file except in compliance with the License.         //
+// You may obtain a copy of the License at                                  //
+//                                                                          //
+//     http://www.apache.org/licenses/LICENSE-2.0                           //
+//                                                                          //
+// Unless required by applicable law or agreed to in writing, software      //
+// distributed under the License is distributed on an "AS IS" BASIS,        //
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. //
+// See the License for the specific language governing permissions and      //
+// limitations under the License.                                           //
+// ======================================================================== //
+
+#pragma once
+
+#include "bvh.h"
+#include "../common/builder.h"
+
+namespace embree
+{
+  /*! Treelet restructuring optimizer for BVHs of aligned nodes. The
+   *  BVH is traversed bottom up in parallel. At each node a treelet
+   *  is formed by opening the largest children until the treelet has
+   *  up to MAX_TREELET_LEAVES leaves. The SAH optimal topology of
+   *  the treelet is then searched through dynamic programming over
+   *  all subsets of its leaves, reusing the nodes of the opened
+   *  children. Only BVHs of aligned nodes with leaf pointers
+   *  (e.g. Triangle4, Triangle4i, Quad4v) are supported. */
+  template<int N>
+  class BVHNRestructure
+  {
+    typedef BVHN<N> BVH;
+    typedef typename BVH::AlignedNode AlignedNode;
+    typedef typename BVH::NodeRef NodeRef;
+
+  public:
+
+    /*! maximal number of leaves of a treelet, a full BVH8 node has to fit into the treelet together with some of its siblings */
+    static const size_t MAX_TREELET_LEAVES = N == 4 ? 7 : 9;
+
+    /*! maximal number of nodes of a treelet (excluding its root) */
+    static const size_t MAX_TREELET_NODES = MAX_TREELET_LEAVES/2;
+
+    /*! subtrees above this depth are restructured in parallel */
+    static const size_t PARALLEL_DEPTH = 4;
+
+    /*! restructures the BVH, returns the number of modified treelets */
+    static size_t restructure(BVH* bvh);
+
+  private:
+    struct Treelet;
+    static size_t recurse(NodeRef ref, size_t depth, Treelet& treelet, size_t& numModified);
+  };
+
+  /*! Creates a builder that invokes the specified builder and
+   *  restructures the resulting BVH afterwards. Returns the specified
+   *  builder if the scene is not a static high quality scene, or the
+   *  builder does not produce a BVH of aligned nodes owned by that
+   *  BVH (two-level and out-of-core builders). */
+  template<int N>
+  Builder* BVHNRestructureBuilder(BVHN<N>* bvh, Scene* scene, Builder* builder, const std::string& builderName);
+}
@@ -50,6 +50,48 @@ namespace embree
     return stream.str();
   }
   
+  template<int N>
+  void BVHNStatistics<N>::add(AccelStatistics& s) const
+  {
+    s.sahArea += stat.statLeaf.leafSAH +
+      stat.statAlignedNodes.nodeSAH +
+      stat.statUnalignedNodes.nodeSAH +
+      stat.statAlignedNodesMB.nodeSAH +
+      stat.statAlignedNodesMB4D.nodeSAH +
+      stat.statUnalignedNodesMB.nodeSAH +
+      stat.statTransformNodes.nodeSAH +
+      stat.statQuantizedNodes.nodeSAH;
+
+    s.depth = max(s.depth,stat.depth);
+    s.numPrimitives       += stat.statLeaf.numPrims;
+    s.numAlignedNodes     += stat.statAlignedNodes.numNodes;
+    s.numUnalignedNodes   += stat.statUnalignedNodes.numNodes;
+    s.numAlignedNodesMB   += stat.statAlignedNodesMB.numNodes;
+    s.numAlignedNodesMB4D += stat.statAlignedNodesMB4D.numNodes;
+    s.numUnalignedNodesMB += stat.statUnalignedNodesMB.numNodes;
+    s.numTransformNodes   += stat.statTransformNodes.numNodes;
+    s.numQuantizedNodes   += stat.statQuantizedNodes.numNodes;
+    s.numLeaves           += stat.statLeaf.numLeaves;
+    s.numPrimBlocks       += stat.statLeaf.numPrimBlocks;
+
+    s.nodeChildren += stat.statAlignedNodes.fillRateNom() +
+      stat.statUnalignedNodes.fillRateNom() +
+      stat.statAlignedNodesMB.fillRateNom() +
+      stat.statAlignedNodesMB4D.fillRateNom() +
+      stat.statUnalignedNodesMB.fillRateNom() +
+      stat.statTransformNodes.fillRateNom() +
+      stat.statQuantizedNodes.fillRateNom();
+    s.nodeSlots += stat.statAlignedNodes.fillRateDen() +
+      stat.statUnalignedNodes.fillRateDen() +
+      stat.statAlignedNodesMB.fillRateDen() +
+      stat.statAlignedNodesMB4D.fillRateDen() +
+      stat.statUnalignedNodesMB.fillRateDen() +
+      stat.statTransformNodes.fillRateDen() +
+      stat.statQuantizedNodes.fillRateDen();
+    s.leafPrims += stat.statLeaf.fillRateNom(bvh);
+    s.leafSlots += stat.statLeaf.fillRateDen(bvh);
+  }
+
   template<int N>
   typename BVHNStatistics<N>::Statistics BVHNStatistics<N>::statistics(NodeRef node, const double A, const BBox1f t0t1)
   {
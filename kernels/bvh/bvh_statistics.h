@@ -287,6 +287,9 @@ namespace embree
       return stat.bytes(bvh);
     }
 
+    /*! adds the gathered statistics to the scene statistics */
+    void add(AccelStatistics& s) const;
+
   private:
     Statistics statistics(NodeRef node, const double A, const BBox1f dt);
 
@@ -24,6 +24,20 @@ namespace embree
 {
   class Scene;
 
+  /*! Statistics accumulated over all acceleration structures of a scene. */
+  struct AccelStatistics : public RTCSceneStatistics
+  {
+    AccelStatistics () {
+      memset(this,0,sizeof(AccelStatistics));
+    }
+
+    double sahArea;         //!< SAH cost scaled by the surface area of the root
+    double nodeChildren;    //!< number of used child slots
+    double nodeSlots;       //!< number of available child slots
+    double leafPrims;       //!< number of used primitive slots
+    double leafSlots;       //!< number of available primitive slots
+  };
+
   /*! Base class for the acceleration structure data. */
   class AccelData : public RefCount 
   {
@@ -40,6 +54,9 @@ namespace embree
     /*! clears the acceleration structure data */
     virtual void clear() = 0;
 
+    /*! adds build times, quality, and memory statistics of the acceleration structure */
+    virtual void addStatistics(AccelStatistics& stat) {}
+
     /*! returns normal bounds */
     __forceinline BBox3fa getBounds() const {
       return bounds.bounds();
@@ -119,6 +136,10 @@ namespace embree
                                   RTCRay** ray,        /*!< ray stream to intersect */
                                   const size_t N,      /*!< number of rays in stream */
                                   IntersectContext* context   /*!< layout flags */);
+
+    /*! Type of closest point query function pointer. */
+    typedef void (*PointQueryFunc)(void* ptr,             /*!< pointer to user data */
+                                   RTCPointQuery& query); /*!< point query to perform */
     typedef void (*ErrorFunc) ();
 
     struct Intersector1
@@ -206,13 +227,28 @@ namespace embree
       const char* name;
     };
    
+    struct PointQuery1
+    {
+      PointQuery1 (ErrorFunc error = nullptr)
+      : query((PointQueryFunc)error), name(nullptr) {}
+
+      PointQuery1 (PointQueryFunc query, const char* name)
+      : query(query), name(name) {}
+
+      operator bool() const { return name; }
+
+    public:
+      PointQueryFunc query;
+      const char* name;
+    };
+   
     struct Intersectors 
     {
       Intersectors() 
         : ptr(nullptr) {}
 
       Intersectors (ErrorFunc error) 
-      : ptr(nullptr), intersector1(error), intersector4(error), intersector8(error), intersector16(error), intersectorN(error) {}
+      : ptr(nullptr), intersector1(error), intersector4(error), intersector8(error), intersector16(error), intersectorN(error), pointQuery1(error) {}
 
       void print(size_t ident) 
       {
@@ -236,6 +272,10 @@ namespace embree
           for (size_t i=0; i<ident; i++) std::cout << " ";
           std::cout << "intersectorN = " << intersectorN.name << std::endl;
         }        
+        if (pointQuery1.name) {
+          for (size_t i=0; i<ident; i++) std::cout << " ";
+          std::cout << "pointQuery1 = " << pointQuery1.name << std::endl;
+        }
       }
 
       void select(bool filter4, bool filter8, bool filter16, bool filterN)
@@ -273,6 +313,7 @@ namespace embree
       IntersectorN intersectorN;
       IntersectorN intersectorN_filter;
       IntersectorN intersectorN_nofilter;      
+      PointQuery1 pointQuery1;
     };
   
   public:
@@ -303,19 +344,31 @@ namespace embree
     /*! Intersects a packet of 4 rays with the scene. */
     __forceinline void intersect4 (const void* valid, RTCRay4& ray, IntersectContext* context) {
       assert(intersectors.intersector4.intersect);
-      intersectors.intersector4.intersect(valid,intersectors.ptr,ray,context);
+      /* k-nearest hit queries gather hits in the code path of the intersection filters */
+      if (unlikely(context->hitBuffers) && intersectors.intersector4_filter)
+        intersectors.intersector4_filter.intersect(valid,intersectors.ptr,ray,context);
+      else
+        intersectors.intersector4.intersect(valid,intersectors.ptr,ray,context);
     }
 
     /*! Intersects a packet of 8 rays with the scene. */
     __forceinline void intersect8 (const void* valid, RTCRay8& ray, IntersectContext* context) {
       assert(intersectors.intersector8.intersect);
-      intersectors.intersector8.intersect(valid,intersectors.ptr,ray,context);
+      /* k-nearest hit queries gather hits in the code path of the intersection filters */
+      if (unlikely(context->hitBuffers) && intersectors.intersector8_filter)
+        intersectors.intersector8_filter.intersect(valid,intersectors.ptr,ray,context);
+      else
+        intersectors.intersector8.intersect(valid,intersectors.ptr,ray,context);
     }
 
     /*! Intersects a packet of 16 rays with the scene. */
     __forceinline void intersect16 (const void* valid, RTCRay16& ray, IntersectContext* context) {
       assert(intersectors.intersector16.intersect);
-      intersectors.intersector16.intersect(valid,intersectors.ptr,ray,context);
+      /* k-nearest hit queries gather hits in the code path of the intersection filters */
+      if (unlikely(context->hitBuffers) && intersectors.intersector16_filter)
+        intersectors.intersector16_filter.intersect(valid,intersectors.ptr,ray,context);
+      else
+        intersectors.intersector16.intersect(valid,intersectors.ptr,ray,context);
     }
 
     /*! Intersects a packet of N rays in SOA layout with the scene. */
@@ -326,9 +379,13 @@ namespace embree
         intersectors.intersectorN.intersect(intersectors.ptr,rayN,N,context);
       else
       {
+        /* traversal statistics are indexed by the position of the ray in the stream */
+        RTCTraversalStats* stats = context->stats;
         if (likely(context->flags == IntersectContext::INPUT_RAY_DATA_AOS))
-          for (size_t i=0; i<N; i++)
+          for (size_t i=0; i<N; i++) {
+            if (unlikely(stats)) context->stats = stats+i;
             intersect(*rayN[i],context);
+          }
         else
         {
           assert(context->getInputSOAWidth() == VSIZEX);
@@ -337,9 +394,11 @@ namespace embree
           {
             RayK<VSIZEX> &ray = *(RayK<VSIZEX>*)rayN[i];
             vbool<VSIZEX> valid = ray.tnear < ray.tfar;
+            if (unlikely(stats)) context->stats = stats+i*VSIZEX;
             intersect(valid,ray,context);
           }      
         }
+        context->stats = stats;
       }
     }
 
@@ -396,9 +455,13 @@ namespace embree
         intersectors.intersectorN.occluded(intersectors.ptr,rayN,N,context);
       else
       {
+        /* traversal statistics are indexed by the position of the ray in the stream */
+        RTCTraversalStats* stats = context->stats;
         if (likely(context->flags == IntersectContext::INPUT_RAY_DATA_AOS))
-          for (size_t i=0;i<N;i++)
+          for (size_t i=0; i<N; i++) {
+            if (unlikely(stats)) context->stats = stats+i;
             occluded(*rayN[i],context);
+          }
         else
         {
           assert(context->getInputSOAWidth() == VSIZEX);
@@ -407,9 +470,11 @@ namespace embree
           {
             RayK<VSIZEX> &ray = *(RayK<VSIZEX>*)rayN[i];
             vbool<VSIZEX> valid = ray.tnear < ray.tfar;
+            if (unlikely(stats)) context->stats = stats+i*VSIZEX;
             occluded(valid,ray,context);
           }      
         }
+        context->stats = stats;
       }
     }
 
@@ -432,6 +497,13 @@ namespace embree
     }
 #endif
 
+    /*! Finds the closest point to the query position, acceleration
+     *  structures without point query support are skipped. */
+    __forceinline void pointQuery (RTCPointQuery& query) {
+      if (intersectors.pointQuery1.query)
+        intersectors.pointQuery1.query(intersectors.ptr,query);
+    }
+
   public:
     Intersectors intersectors;
   };
@@ -471,6 +543,12 @@ namespace embree
                                TOSTRING(isa) "::" TOSTRING(symbol));          \
   }
 
+#define DEFINE_POINT_QUERY1(symbol,query)                                   \
+  Accel::PointQuery1 symbol() {                                             \
+    return Accel::PointQuery1((Accel::PointQueryFunc)query::pointQuery,     \
+                              TOSTRING(isa) "::" TOSTRING(symbol));         \
+  }
+
   /* ray stream filter interface */
   typedef void (*filterAOS_func)(Scene *scene, RTCRay*  _rayN, const size_t N, const size_t stride, IntersectContext* context, const bool intersect);
   typedef void (*filterAOP_func)(Scene *scene, RTCRay** _rayN, const size_t N, IntersectContext* context, const bool intersect);
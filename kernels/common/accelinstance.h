@@ -47,6 +47,10 @@ namespace embree
       builder->clear();
     }
 
+    void addStatistics(AccelStatistics& stat) {
+      accel->addStatistics(stat);
+    }
+
   private:
     std::unique_ptr<AccelData> accel;
     std::unique_ptr<Builder> builder;
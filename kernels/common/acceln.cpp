@@ -131,13 +131,21 @@ namespace embree
     for (size_t i=0; i<This->validAccels.size(); i++)
     {
       This->validAccels[i]->occludedN(ray,M,context);
-      /* only do this optimization if input rays are given in AOS format */
-      if (context->flags == IntersectContext::INPUT_RAY_DATA_AOS)
+      /* only do this optimization if input rays are given in AOS format,
+         traversal statistics require the rays to stay in place */
+      if (context->flags == IntersectContext::INPUT_RAY_DATA_AOS && !context->stats)
         Ray::filterOutOccluded((Ray**)ray,M);
       if (M == 0) break;
     }
   }
 
+  void AccelN::pointQuery (void* ptr, RTCPointQuery& query)
+  {
+    AccelN* This = (AccelN*)ptr;
+    for (size_t i=0; i<This->validAccels.size(); i++)
+      This->validAccels[i]->pointQuery(query);
+  }
+
   void AccelN::print(size_t ident)
   {
     for (size_t i=0; i<validAccels.size(); i++)
@@ -181,6 +189,7 @@ namespace embree
       intersectors.intersector8  = Intersector8(&intersect8,&occluded8,"AccelN::intersector8");
       intersectors.intersector16 = Intersector16(&intersect16,&occluded16,"AccelN::intersector16");
       intersectors.intersectorN  = IntersectorN(&intersectN,&occludedN,"AccelN::intersectorN");
+      intersectors.pointQuery1   = PointQuery1(&pointQuery,"AccelN::pointQuery1");
     }
     
     /*! calculate bounds */
@@ -206,5 +215,23 @@ namespace embree
     for (size_t i=0; i<accels.size(); i++) 
       accels[i]->clear();
   }
-}
 
+  void AccelN::swap(AccelN& other)
+  {
+    std::swap(accels,other.accels);
+    std::swap(validAccels,other.validAccels);
+    std::swap(validIntersectorN,other.validIntersectorN);
+    std::swap(bounds,other.bounds);
+    std::swap(intersectors,other.intersectors);
+
+    /* intersectors of multiple acceleration structures point to the AccelN itself */
+    if (intersectors.ptr == &other) intersectors.ptr = this;
+    if (other.intersectors.ptr == this) other.intersectors.ptr = &other;
+  }
+
+  void AccelN::addStatistics(AccelStatistics& stat)
+  {
+    for (size_t i=0; i<accels.size(); i++)
+      accels[i]->addStatistics(stat);
+  }
+}
@@ -44,6 +44,9 @@ namespace embree
     static void occluded16 (const void* valid, void* ptr, RTCRay16& ray, IntersectContext* context);
     static void occludedN (void* ptr, RTCRay** ray, const size_t N, IntersectContext* context);
 
+  public:
+    static void pointQuery (void* ptr, RTCPointQuery& query);
+
   public:
     void print(size_t ident);
     void immutable();
@@ -51,6 +54,8 @@ namespace embree
     void select(bool filter4, bool filter8, bool filter16, bool filterN);
     void deleteGeometry(size_t geomID);
     void clear ();
+    void swap (AccelN& other);
+    void addStatistics(AccelStatistics& stat);
     __forceinline bool validIsecN() { return validIntersectorN; }
 
   public:
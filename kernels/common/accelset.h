@@ -241,7 +241,7 @@ namespace embree
         else {
           int mask = -1;
           assert(intersectors.intersectorN.intersect);
-          intersectors.intersectorN.intersect((int*)&mask,intersectors.ptr,context->user,(RTCRayN*)&ray,1,item);
+          intersectors.intersectorN.intersect((int*)&mask,intersectors.ptr,getContext(context),(RTCRayN*)&ray,1,item);
         }
       }
    
@@ -260,7 +260,7 @@ namespace embree
         } else {
           vint4 mask = valid.mask32();
           assert(intersectors.intersectorN.intersect);          
-          intersectors.intersectorN.intersect((int*)&mask,intersectors.ptr,context->user,(RTCRayN*)&ray,4,item);
+          intersectors.intersectorN.intersect((int*)&mask,intersectors.ptr,getContext(context),(RTCRayN*)&ray,4,item);
         }
       }
 #endif
@@ -280,7 +280,7 @@ namespace embree
         } else {
           vint8 mask = valid.mask32();
           assert(intersectors.intersectorN.intersect);
-          intersectors.intersectorN.intersect((int*)&mask,intersectors.ptr,context->user,(RTCRayN*)&ray,8,item);
+          intersectors.intersectorN.intersect((int*)&mask,intersectors.ptr,getContext(context),(RTCRayN*)&ray,8,item);
         }
       }
 #endif
@@ -300,7 +300,7 @@ namespace embree
         } else {
           vint16 mask = valid.mask32();
           assert(intersectors.intersectorN.intersect);
-          intersectors.intersectorN.intersect((int*)&mask,intersectors.ptr,context->user,(RTCRayN*)&ray,16,item);
+          intersectors.intersectorN.intersect((int*)&mask,intersectors.ptr,getContext(context),(RTCRayN*)&ray,16,item);
         }
       }
 #endif
@@ -310,12 +310,12 @@ namespace embree
       {
         assert(item < size());
         if (intersectors.intersector1M.intersect) { // Intersect1N callback is optional
-          intersectors.intersector1M.intersect(intersectors.ptr,context->user,(RTCRay**)rays,N,item);
+          intersectors.intersector1M.intersect(intersectors.ptr,getContext(context),(RTCRay**)rays,N,item);
         }
         else if (N == 1) {
           int mask = -1;
           assert(intersectors.intersectorN.intersect);
-          intersectors.intersectorN.intersect((int*)&mask,intersectors.ptr,context->user,(RTCRayN*)rays[0],1,item);
+          intersectors.intersectorN.intersect((int*)&mask,intersectors.ptr,getContext(context),(RTCRayN*)rays[0],1,item);
         } 
         else 
         {
@@ -323,7 +323,7 @@ namespace embree
           StackRayPacket<MAX_INTERNAL_STREAM_SIZE> packet(N);
           for (size_t i=0; i<N; i++) packet.writeRay(i,mask,*rays[i]);
           assert(intersectors.intersectorN.intersect);
-          intersectors.intersectorN.intersect(mask,intersectors.ptr,context->user,(RTCRayN*)packet.data,N,item);
+          intersectors.intersectorN.intersect(mask,intersectors.ptr,getContext(context),(RTCRayN*)packet.data,N,item);
           for (size_t i=0; i<N; i++) packet.readHit(i,*rays[i]);
         }
       }
@@ -337,7 +337,7 @@ namespace embree
         else {
           int mask = -1;
           assert(intersectors.intersectorN.occluded);          
-          intersectors.intersectorN.occluded((int*)&mask,intersectors.ptr,context->user,(RTCRayN*)&ray,1,item);
+          intersectors.intersectorN.occluded((int*)&mask,intersectors.ptr,getContext(context),(RTCRayN*)&ray,1,item);
         }
       }
       
@@ -356,7 +356,7 @@ namespace embree
         } else {
           vint4 mask = valid.mask32();
           assert(intersectors.intersectorN.occluded);          
-          intersectors.intersectorN.occluded((int*)&mask,intersectors.ptr,context->user,(RTCRayN*)&ray,4,item);
+          intersectors.intersectorN.occluded((int*)&mask,intersectors.ptr,getContext(context),(RTCRayN*)&ray,4,item);
         }
       }
 #endif
@@ -376,7 +376,7 @@ namespace embree
         } else {
           vint8 mask = valid.mask32();
           assert(intersectors.intersectorN.occluded);          
-          intersectors.intersectorN.occluded((int*)&mask,intersectors.ptr,context->user,(RTCRayN*)&ray,8,item);
+          intersectors.intersectorN.occluded((int*)&mask,intersectors.ptr,getContext(context),(RTCRayN*)&ray,8,item);
         }
       }
 #endif
@@ -397,7 +397,7 @@ namespace embree
         } else {
           vint16 mask = valid.mask32();
           assert(intersectors.intersectorN.occluded);          
-          intersectors.intersectorN.occluded((int*)&mask,intersectors.ptr,context->user,(RTCRayN*)&ray,16,item);
+          intersectors.intersectorN.occluded((int*)&mask,intersectors.ptr,getContext(context),(RTCRayN*)&ray,16,item);
         }
       }
 #endif
@@ -406,12 +406,12 @@ namespace embree
       __forceinline void occluded1M (Ray** rays, size_t N, size_t item, IntersectContext* context) 
       {
         if (likely(intersectors.intersector1M.occluded)) { // Occluded1N callback is optional
-          intersectors.intersector1M.occluded(intersectors.ptr,context->user,(RTCRay**)rays,N,item);
+          intersectors.intersector1M.occluded(intersectors.ptr,getContext(context),(RTCRay**)rays,N,item);
         }
         else if (N == 1) {
           int mask = -1;
           assert(intersectors.intersectorN.occluded);
-          intersectors.intersectorN.occluded((int*)&mask,intersectors.ptr,context->user,(RTCRayN*)rays[0],1,item);
+          intersectors.intersectorN.occluded((int*)&mask,intersectors.ptr,getContext(context),(RTCRayN*)rays[0],1,item);
         } 
         else 
         {
@@ -419,11 +419,16 @@ namespace embree
           StackRayPacket<MAX_INTERNAL_STREAM_SIZE> packet(N);
           for (size_t i=0; i<N; i++) packet.writeRay(i,mask,*rays[i]);
           assert(intersectors.intersectorN.occluded);
-          intersectors.intersectorN.occluded(mask,intersectors.ptr,context->user,(RTCRayN*)packet.data,N,item);
+          intersectors.intersectorN.occluded(mask,intersectors.ptr,getContext(context),(RTCRayN*)packet.data,N,item);
           for (size_t i=0; i<N; i++) packet.readOcclusion(i,*rays[i]);
         }
       }
 
+      /*! returns the context passed to the intersectors, instances get passed the internal context to track the instance level */
+      __forceinline const RTCIntersectContext* getContext(IntersectContext* context) const {
+        return unlikely(intersectors.internalContext) ? (const RTCIntersectContext*) context : context->user;
+      }
+
     public:
       RTCBoundsFunc  boundsFunc;
       RTCBoundsFunc2 boundsFunc2;
@@ -432,9 +437,10 @@ namespace embree
 
       struct Intersectors 
       {
-        Intersectors() : ptr(nullptr) {}
+        Intersectors() : ptr(nullptr), internalContext(false) {}
       public:
         void* ptr;
+        bool internalContext;          //!< intersectors get passed the internal IntersectContext instead of the user context
         Intersector1 intersector1;
         Intersector4 intersector4;
         Intersector8 intersector8;
@@ -609,6 +609,10 @@ namespace embree
       return bytesUsed;
     }
 
+    size_t getFreeBytes() {
+      return bytesFree;
+    }
+
     size_t getWastedBytes() {
       return bytesWasted;
     }
@@ -34,7 +34,8 @@ namespace embree
 
   public:
     __forceinline IntersectContext(Scene* scene, const RTCIntersectContext* user_context)
-      : scene(scene), user(user_context), flags(INPUT_RAY_DATA_AOS), geomID_to_instID(nullptr) {}
+      : scene(scene), user(user_context), flags(INPUT_RAY_DATA_AOS), geomID_to_instID(nullptr), instLevel(0), hitBuffers(nullptr),
+        stats(user_context && (user_context->flags & RTC_INTERSECT_TRAVERSAL_STATS) ? user_context->traversalStats : nullptr) {}
 
   public:
     Scene* scene;
@@ -43,6 +44,9 @@ namespace embree
     const unsigned* geomID_to_instID; // required for xfm node handling
     unsigned instID; // required for xfm node handling
     unsigned geomID; // required for xfm node handling
+    unsigned instLevel; // instance level of the traversed scene, 0 for the scene passed to the ray query
+    RTCHitBuffer* hitBuffers; // hit buffers of a k-nearest hit query indexed by packet lane, nullptr for closest hit queries
+    RTCTraversalStats* stats; // traversal statistics indexed by packet lane, nullptr if not requested
 
     __forceinline void setInputSOA(size_t width)
     {
@@ -54,5 +58,35 @@ namespace embree
     {
       return flags;
     }
+
+    /*! checks if the tessellation level of subdivision surfaces is selected by the ray cone of the user context */
+    __forceinline bool hasRayCone() const {
+      return user && (user->flags & RTC_INTERSECT_RAY_CONE);
+    }
+
+    /*! counts an intersected inner node for the rays of the packet lanes set in bits */
+    __forceinline void countNodes(size_t bits) const
+    {
+      if (likely(!stats)) return;
+      while (bits) stats[__bscf(bits)].numNodes++;
+    }
+
+    /*! counts a visited leaf with num primitive blocks for the rays of the packet lanes set in bits */
+    __forceinline void countLeaves(size_t bits, size_t num) const
+    {
+      if (likely(!stats)) return;
+      while (bits) {
+        RTCTraversalStats& s = stats[__bscf(bits)];
+        s.numLeaves++;
+        s.numPrimBlocks += (unsigned int) num;
+      }
+    }
+
+    /*! counts a filter function invocation for the rays of the packet lanes set in bits */
+    __forceinline void countFilterCalls(size_t bits) const
+    {
+      if (likely(!stats)) return;
+      while (bits) stats[__bscf(bits)].numFilterCalls++;
+    }
   };
 }
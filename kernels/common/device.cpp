@@ -46,7 +46,6 @@ namespace embree
   DECLARE_SYMBOL2(RayStreamFilterFuncs,rayStreamFilterFuncs);
 
   static MutexSys g_mutex;
-  static std::map<Device*,size_t> g_cache_size_map;
   static std::map<Device*,size_t> g_num_threads_map;
 
   Device::Device (const char* cfg, bool singledevice)
@@ -74,7 +73,8 @@ namespace embree
 #endif
     State::hugepages_success &= os_init(State::hugepages,State::verbosity(3));
     
-    /*! set tessellation cache size */
+    /*! create tessellation cache */
+    tessellation_cache = make_unique(new SharedLazyTessellationCache(State::tessellation_cache_segments));
     setCacheSize( State::tessellation_cache_size );
 
     /*! enable some floating point exceptions to catch bugs */
@@ -118,6 +118,11 @@ namespace embree
 
   Device::~Device ()
   {
+    /* print tessellation cache statistics */
+    if (State::verbosity(2)) {
+      const SharedTessellationCacheStats stats = tessellation_cache->getStats();
+      if (stats.accesses) stats.print();
+    }
     setCacheSize(0);
     exitTaskingSystem();
   }
@@ -316,23 +321,10 @@ namespace embree
     return maxNumThreads;
   }
 
-  size_t getMaxCacheSize()
-  {
-    size_t maxCacheSize = 0;
-    for (std::map<Device*,size_t>::iterator i=g_cache_size_map.begin(); i!= g_cache_size_map.end(); i++)
-      maxCacheSize = max(maxCacheSize, (*i).second);
-    return maxCacheSize;
-  }
- 
   void Device::setCacheSize(size_t bytes) 
   {
 #if defined(EMBREE_GEOMETRY_SUBDIV)
-    Lock<MutexSys> lock(g_mutex);
-    if (bytes == 0) g_cache_size_map.erase(this);
-    else            g_cache_size_map[this] = bytes;
-    
-    size_t maxCacheSize = getMaxCacheSize();
-    resizeTessellationCache(maxCacheSize);
+    tessellation_cache->resize(bytes);
 #endif
   }
 
@@ -384,6 +376,7 @@ namespace embree
 
     switch (parm) {
     case RTC_SOFTWARE_CACHE_SIZE: setCacheSize(val); break;
+    case RTC_TESSELLATION_CACHE_CLEAR_STATS: tessellation_cache->clearStats(); break;
     default: throw_RTCError(RTC_INVALID_ARGUMENT, "unknown writable parameter"); break;
     };
   }
@@ -524,6 +517,14 @@ namespace embree
     case RTC_CONFIG_COMMIT_THREAD: return 1;
 #endif
 
+    case RTC_TESSELLATION_CACHE_ACCESSES         : return tessellation_cache->getStats().accesses;
+    case RTC_TESSELLATION_CACHE_HITS             : return tessellation_cache->getStats().hits;
+    case RTC_TESSELLATION_CACHE_TESSELLATIONS    : return tessellation_cache->getStats().tessellations;
+    case RTC_TESSELLATION_CACHE_TESSELLATED_BYTES: return tessellation_cache->getStats().tessellatedBytes;
+    case RTC_TESSELLATION_CACHE_TESSELLATION_TIME: return tessellation_cache->getStats().tessellationTime/1000;
+    case RTC_TESSELLATION_CACHE_FLUSHES          : return tessellation_cache->getStats().flushes;
+    case RTC_TESSELLATION_CACHE_WAIT_TIME        : return tessellation_cache->getStats().waitTime/1000;
+
     default: throw_RTCError(RTC_INVALID_ARGUMENT, "unknown readable parameter"); break;
     };
   }
@@ -25,8 +25,9 @@ namespace embree
   class BVH4Factory;
   class BVH8Factory;
   class InstanceFactory;
+  class SharedLazyTessellationCache;
 
-  class Device : public State, public MemoryMonitorInterface
+  class Device : public State, public MemoryMonitorInterface, public RefCount
   {
     ALIGNED_CLASS;
 
@@ -59,7 +60,7 @@ namespace embree
     /*! invokes the memory monitor callback */
     void memoryMonitor(ssize_t bytes, bool post);
 
-    /*! sets the size of the software cache. */
+    /*! sets the size of the tessellation cache of the device. */
     void setCacheSize(size_t bytes);
 
     /*! configures some parameter */
@@ -95,6 +96,9 @@ namespace embree
 #if USE_TASK_ARENA
     std::unique_ptr<tbb::task_arena> arena;
 #endif
+
+    /* tessellation cache of the device */
+    std::unique_ptr<SharedLazyTessellationCache> tessellation_cache;
     
     /* ray streams filter */
     RayStreamFilterFuncs rayStreamFilters;
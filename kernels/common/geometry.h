@@ -251,6 +251,11 @@ namespace embree
       throw_RTCError(RTC_INVALID_OPERATION,"operation not supported for this geometry"); 
     }
 
+    /*! Sets interpolation mode of the transformations of the instance */
+    virtual void setTransformInterpolation(RTCTransformInterpolation interpolation) {
+      throw_RTCError(RTC_INVALID_OPERATION,"operation not supported for this geometry"); 
+    }
+
     /*! for user geometries only */
   public:
 
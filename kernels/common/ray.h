@@ -34,7 +34,12 @@ namespace embree
     __forceinline RayK(const Vec3vf<K>& org, const Vec3vf<K>& dir,
                        const vfloat<K>& tnear = zero, const vfloat<K>& tfar = inf,
                        const vfloat<K>& time = zero, const vint<K>& mask = -1)
-      : org(org), dir(dir), tnear(tnear), tfar(tfar), time(time), mask(mask), geomID(-1), primID(-1), instID(-1) {}
+      : org(org), dir(dir), tnear(tnear), tfar(tfar), time(time), mask(mask), geomID(-1), primID(-1), instID(-1)
+    {
+#if RTC_MAX_INSTANCE_LEVEL_COUNT > 1
+      for (size_t l=0; l<RTC_MAX_INSTANCE_LEVEL_COUNT-1; l++) nestedInstID[l] = -1;
+#endif
+    }
 
     /* Returns the size of the ray */
     static __forceinline size_t size() { return K; }
@@ -60,6 +65,15 @@ namespace embree
 
     __forceinline void copy(const size_t dest, const size_t source);
 
+    /* Returns the instance IDs of the specified instance level */
+    __forceinline vint<K>& instIDLevel(const size_t level)
+    {
+#if RTC_MAX_INSTANCE_LEVEL_COUNT > 1
+      if (level) return nestedInstID[level-1];
+#endif
+      return instID;
+    }
+
     __forceinline void update(const vbool<K>& m_mask,
                               const vfloat<K>& new_t,
                               const vfloat<K>& new_u,
@@ -118,6 +132,9 @@ namespace embree
     vint<K> geomID;  // geometry ID
     vint<K> primID;  // primitive ID
     vint<K> instID;  // instance ID
+#if RTC_MAX_INSTANCE_LEVEL_COUNT > 1
+    vint<K> nestedInstID[RTC_MAX_INSTANCE_LEVEL_COUNT-1]; // instance IDs of nested instance levels
+#endif
   };
 
 #if defined(__AVX512F__)
@@ -156,7 +173,12 @@ namespace embree
     /* Constructs a ray from origin, direction, and ray segment. Near
      *  has to be smaller than far */
     __forceinline RayK(const Vec3fa& org, const Vec3fa& dir, float tnear = zero, float tfar = inf, float time = zero, int mask = -1)
-      : org(org), dir(dir), tnear(tnear), tfar(tfar), time(time), mask(mask), geomID(-1), primID(-1), instID(-1) {}
+      : org(org), dir(dir), tnear(tnear), tfar(tfar), time(time), mask(mask), geomID(-1), primID(-1), instID(-1)
+    {
+#if RTC_MAX_INSTANCE_LEVEL_COUNT > 1
+      for (size_t l=0; l<RTC_MAX_INSTANCE_LEVEL_COUNT-1; l++) nestedInstID[l] = -1;
+#endif
+    }
 
     /* Tests if we hit something */
     __forceinline operator bool() const { return geomID != RTC_INVALID_GEOMETRY_ID; }
@@ -166,6 +188,15 @@ namespace embree
       return all(le_mask(abs(org),Vec3fa(FLT_LARGE)) & le_mask(abs(dir),Vec3fa(FLT_LARGE))) && fabs(tnear) <= float(inf) && fabs(tfar) <= float(inf);
     }
 
+    /* Returns the instance ID of the specified instance level */
+    __forceinline unsigned& instIDLevel(const size_t level)
+    {
+#if RTC_MAX_INSTANCE_LEVEL_COUNT > 1
+      if (level) return nestedInstID[level-1];
+#endif
+      return instID;
+    }
+
     /* filter out all occluded rays from a stream of rays */
     __forceinline static void filterOutOccluded(RayK<1>** ray, size_t& N)
     {
@@ -192,6 +223,9 @@ namespace embree
     unsigned geomID;  // geometry ID
     unsigned primID;  // primitive ID
     unsigned instID;  // instance ID
+#if RTC_MAX_INSTANCE_LEVEL_COUNT > 1
+    unsigned nestedInstID[RTC_MAX_INSTANCE_LEVEL_COUNT-1]; // instance IDs of nested instance levels
+#endif
 
 #if defined(__AVX512F__)
     __forceinline void update(const vbool16& m_mask,
@@ -250,6 +284,9 @@ namespace embree
       ray[i].Ng.x = Ng.x[i]; ray[i].Ng.y = Ng.y[i]; ray[i].Ng.z = Ng.z[i];
       ray[i].u = u[i]; ray[i].v = v[i];
       ray[i].geomID = geomID[i]; ray[i].primID = primID[i]; ray[i].instID = instID[i];
+#if RTC_MAX_INSTANCE_LEVEL_COUNT > 1
+      for (size_t l=0; l<RTC_MAX_INSTANCE_LEVEL_COUNT-1; l++) ray[i].nestedInstID[l] = nestedInstID[l][i];
+#endif
     }
   }
 
@@ -263,6 +300,9 @@ namespace embree
     ray.Ng.x = Ng.x[i]; ray.Ng.y = Ng.y[i]; ray.Ng.z = Ng.z[i];
     ray.u = u[i]; ray.v = v[i];
     ray.geomID = geomID[i]; ray.primID = primID[i]; ray.instID = instID[i];
+#if RTC_MAX_INSTANCE_LEVEL_COUNT > 1
+    for (size_t l=0; l<RTC_MAX_INSTANCE_LEVEL_COUNT-1; l++) ray.nestedInstID[l] = nestedInstID[l][i];
+#endif
   }
 
   /* Converts single rays to ray packet */
@@ -277,6 +317,9 @@ namespace embree
       Ng.x[i] = ray[i].Ng.x; Ng.y[i] = ray[i].Ng.y; Ng.z[i] = ray[i].Ng.z;
       u[i] = ray[i].u; v[i] = ray[i].v;
       geomID[i] = ray[i].geomID; primID[i] = ray[i].primID; instID[i] = ray[i].instID;
+#if RTC_MAX_INSTANCE_LEVEL_COUNT > 1
+      for (size_t l=0; l<RTC_MAX_INSTANCE_LEVEL_COUNT-1; l++) nestedInstID[l][i] = ray[i].nestedInstID[l];
+#endif
     }
   }
 
@@ -290,6 +333,9 @@ namespace embree
     Ng.x[i] = ray.Ng.x; Ng.y[i] = ray.Ng.y; Ng.z[i] = ray.Ng.z;
     u[i] = ray.u; v[i] = ray.v;
     geomID[i] = ray.geomID; primID[i] = ray.primID; instID[i] = ray.instID;
+#if RTC_MAX_INSTANCE_LEVEL_COUNT > 1
+    for (size_t l=0; l<RTC_MAX_INSTANCE_LEVEL_COUNT-1; l++) nestedInstID[l][i] = ray.nestedInstID[l];
+#endif
   }
 
   /* copies a ray packet element into another element*/
@@ -302,6 +348,9 @@ namespace embree
     Ng.x[dest] = Ng.x[source]; Ng.y[dest] = Ng.y[source]; Ng.z[dest] = Ng.z[source];
     u[dest] = u[source]; v[dest] = v[source];
     geomID[dest] = geomID[source]; primID[dest] = primID[source]; instID[dest] = instID[source];
+#if RTC_MAX_INSTANCE_LEVEL_COUNT > 1
+    for (size_t l=0; l<RTC_MAX_INSTANCE_LEVEL_COUNT-1; l++) nestedInstID[l][dest] = nestedInstID[l][source];
+#endif
   }
 
   /* Shortcuts */
@@ -363,6 +412,7 @@ namespace embree
     __forceinline int* geomID(size_t offset) { return (int*) &ptr[15*4*K+offset]; };  //!< geometry ID
     __forceinline int* primID(size_t offset) { return (int*) &ptr[16*4*K+offset]; };  //!< primitive ID
     __forceinline int* instID(size_t offset) { return (int*) &ptr[17*4*K+offset]; };  //!< instance ID
+    __forceinline int* nestedInstID(size_t l, size_t offset) { return (int*) &ptr[(18+l)*4*K+offset]; };  //!< instance ID of nested instance level l+1
 
   public:
 
@@ -381,6 +431,9 @@ namespace embree
       time(offset)[0] = ray.time;
       mask(offset)[0] = ray.mask;
       instID(offset)[0] = ray.instID;
+#if RTC_MAX_INSTANCE_LEVEL_COUNT > 1
+      for (size_t l=0; l<RTC_MAX_INSTANCE_LEVEL_COUNT-1; l++) nestedInstID(l,offset)[0] = ray.nestedInstID[l];
+#endif
       geomID(offset)[0] = RTC_INVALID_GEOMETRY_ID;
     }
 
@@ -397,6 +450,9 @@ namespace embree
         ray.Ng.y = Ngy(offset)[0];
         ray.Ng.z = Ngz(offset)[0];
         ray.instID = instID(offset)[0];
+#if RTC_MAX_INSTANCE_LEVEL_COUNT > 1
+        for (size_t l=0; l<RTC_MAX_INSTANCE_LEVEL_COUNT-1; l++) ray.nestedInstID[l] = nestedInstID(l,offset)[0];
+#endif
         ray.geomID = geometryID;
         ray.primID = primID(offset)[0];
       }
@@ -420,6 +476,9 @@ namespace embree
       ray.time  = time(offset)[0];
       ray.mask  = mask(offset)[0];
       ray.instID = instID(offset)[0];
+#if RTC_MAX_INSTANCE_LEVEL_COUNT > 1
+      for (size_t l=0; l<RTC_MAX_INSTANCE_LEVEL_COUNT-1; l++) ray.nestedInstID[l] = nestedInstID(l,offset)[0];
+#endif
       ray.geomID = RTC_INVALID_GEOMETRY_ID;
       return ray;
     }
@@ -439,6 +498,9 @@ namespace embree
       ray.time  = vfloat<K>::loadu(time(offset));
       ray.mask  = vint<K>  ::loadu(mask(offset));
       ray.instID= vint<K>  ::loadu(instID(offset));
+#if RTC_MAX_INSTANCE_LEVEL_COUNT > 1
+      for (size_t l=0; l<RTC_MAX_INSTANCE_LEVEL_COUNT-1; l++) ray.nestedInstID[l] = vint<K>::loadu(nestedInstID(l,offset));
+#endif
       ray.geomID = RTC_INVALID_GEOMETRY_ID;
       return ray;
     }
@@ -456,6 +518,9 @@ namespace embree
         Ngy(offset)[0] = ray.Ng.y;
         Ngz(offset)[0] = ray.Ng.z;
         instID(offset)[0] = ray.instID;
+#if RTC_MAX_INSTANCE_LEVEL_COUNT > 1
+        for (size_t l=0; l<RTC_MAX_INSTANCE_LEVEL_COUNT-1; l++) nestedInstID(l,offset)[0] = ray.nestedInstID[l];
+#endif
       }
     }
 
@@ -477,6 +542,9 @@ namespace embree
       vfloat<K>::storeu(valid,Ngy(offset),ray.Ng.y);
       vfloat<K>::storeu(valid,Ngz(offset),ray.Ng.z);
       vint<K>  ::storeu(valid,instID(offset),ray.instID);
+#if RTC_MAX_INSTANCE_LEVEL_COUNT > 1
+      for (size_t l=0; l<RTC_MAX_INSTANCE_LEVEL_COUNT-1; l++) vint<K>::storeu(valid,nestedInstID(l,offset),ray.nestedInstID[l]);
+#endif
     }
 
     __forceinline size_t getOctantByOffset(const size_t offset)
@@ -545,6 +613,9 @@ namespace embree
     unsigned* __restrict__ geomID;  //!< geometry ID
     unsigned* __restrict__ primID;  //!< primitive ID
     unsigned* __restrict__ instID;  //!< instance ID (optional)
+#if RTC_MAX_INSTANCE_LEVEL_COUNT > 1
+    unsigned* __restrict__ nestedInstID[RTC_MAX_INSTANCE_LEVEL_COUNT-1];  //!< instance IDs of nested instance levels (optional)
+#endif
 
     template<class T>
     __forceinline void init(T &t)
@@ -567,6 +638,9 @@ namespace embree
       geomID = (unsigned *)&t.geomID;
       primID = (unsigned *)&t.primID;
       instID = (unsigned *)&t.instID;
+#if RTC_MAX_INSTANCE_LEVEL_COUNT > 1
+      for (size_t l=0; l<RTC_MAX_INSTANCE_LEVEL_COUNT-1; l++) nestedInstID[l] = (unsigned *)&t.nestedInstID[l];
+#endif
     }
 
     __forceinline Ray gatherByOffset(const size_t offset)
@@ -583,6 +657,10 @@ namespace embree
       ray.time  = time  ? *(float* __restrict__ )((char*)time  + offset) : 0.0f;
       ray.mask  = mask  ? *(unsigned * __restrict__ )((char*)mask  + offset) : -1;
       ray.instID  = instID  ? *(unsigned * __restrict__ )((char*)instID  + offset) : -1;
+#if RTC_MAX_INSTANCE_LEVEL_COUNT > 1
+      for (size_t l=0; l<RTC_MAX_INSTANCE_LEVEL_COUNT-1; l++)
+        ray.nestedInstID[l] = nestedInstID[l] ? *(unsigned * __restrict__ )((char*)nestedInstID[l] + offset) : -1;
+#endif
       ray.geomID = RTC_INVALID_GEOMETRY_ID;
       return ray;
     }
@@ -602,6 +680,10 @@ namespace embree
       ray.time  = time  ? vfloat<K>::loadu(valid,(float* __restrict__ )((char*)time  + offset)) : 0.0f;
       ray.mask  = mask  ? vint<K>::loadu(valid,(const void * __restrict__ )((char*)mask  + offset)) : -1;
       ray.instID = instID  ? vint<K>::loadu(valid,(const void * __restrict__ )((char*)instID  + offset)) : -1;
+#if RTC_MAX_INSTANCE_LEVEL_COUNT > 1
+      for (size_t l=0; l<RTC_MAX_INSTANCE_LEVEL_COUNT-1; l++)
+        ray.nestedInstID[l] = nestedInstID[l] ? vint<K>::loadu(valid,(const void * __restrict__ )((char*)nestedInstID[l] + offset)) : -1;
+#endif
       ray.geomID = RTC_INVALID_GEOMETRY_ID;
       return ray;
     }
@@ -630,6 +712,10 @@ namespace embree
           if (likely(Ngy)) *(float* __restrict__ )((char*)Ngy + offset) = ray.Ng.y;
           if (likely(Ngz)) *(float* __restrict__ )((char*)Ngz + offset) = ray.Ng.z;
           if (likely(instID)) *(unsigned * __restrict__ )((char*)instID + offset) = ray.instID;
+#if RTC_MAX_INSTANCE_LEVEL_COUNT > 1
+          for (size_t l=0; l<RTC_MAX_INSTANCE_LEVEL_COUNT-1; l++)
+            if (likely(nestedInstID[l])) *(unsigned * __restrict__ )((char*)nestedInstID[l] + offset) = ray.nestedInstID[l];
+#endif
         }
     }
 
@@ -651,6 +737,10 @@ namespace embree
       if (likely(Ngy)) vfloat<K>::storeu(valid,(float* __restrict__ )((char*)Ngy + offset), ray.Ng.y);
       if (likely(Ngz)) vfloat<K>::storeu(valid,(float* __restrict__ )((char*)Ngz + offset), ray.Ng.z);
       if (likely(instID)) vint<K>::storeu(valid,(int * __restrict__ )((char*)instID + offset), ray.instID);
+#if RTC_MAX_INSTANCE_LEVEL_COUNT > 1
+      for (size_t l=0; l<RTC_MAX_INSTANCE_LEVEL_COUNT-1; l++)
+        if (likely(nestedInstID[l])) vint<K>::storeu(valid,(int * __restrict__ )((char*)nestedInstID[l] + offset), ray.nestedInstID[l]);
+#endif
     }
 
     __forceinline size_t getOctantByOffset(const size_t offset)
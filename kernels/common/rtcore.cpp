@@ -36,7 +36,9 @@ namespace embree
     RTCORE_CATCH_BEGIN;
     RTCORE_TRACE(rtcNewDevice);
     Lock<MutexSys> lock(g_mutex);
-    return (RTCDevice) new Device(cfg,false);
+    Device* device = new Device(cfg,false);
+    device->refInc();
+    return (RTCDevice) device;
     RTCORE_CATCH_END(nullptr);
     return (RTCDevice) nullptr;
   }
@@ -47,7 +49,7 @@ namespace embree
     RTCORE_TRACE(rtcDeleteDevice);
     RTCORE_VERIFY_HANDLE(device);
     Lock<MutexSys> lock(g_mutex);
-    delete (Device*) device;
+    ((Device*) device)->refDec();
     RTCORE_CATCH_END(nullptr);
   }
 
@@ -61,6 +63,7 @@ namespace embree
     Lock<MutexSys> lock(g_mutex);
     if (g_device) throw_RTCError(RTC_INVALID_OPERATION,"already initialized");
     g_device = new Device(cfg,true);
+    g_device->refInc();
     RTCORE_CATCH_END(g_device);
   }
   
@@ -70,7 +73,7 @@ namespace embree
     RTCORE_TRACE(rtcExit);
     Lock<MutexSys> lock(g_mutex);
     if (!g_device) throw_RTCError(RTC_INVALID_OPERATION,"rtcInit has to get called before rtcExit");
-    delete g_device; g_device = nullptr;
+    g_device->refDec(); g_device = nullptr;
     RTCORE_CATCH_END(g_device);
   }
 
@@ -214,7 +217,9 @@ namespace embree
     RTCORE_TRACE(rtcNewScene);
     assert(g_device);
     if (!isCoherent(flags) && !isIncoherent(flags)) flags = RTCSceneFlags(flags | RTC_SCENE_INCOHERENT);
-    return (RTCScene) new Scene(g_device,flags,aflags);
+    Scene* scene = new Scene(g_device,flags,aflags);
+    scene->refInc();
+    return (RTCScene) scene;
     RTCORE_CATCH_END(g_device);
     return nullptr;
   }
@@ -225,11 +230,53 @@ namespace embree
     RTCORE_TRACE(rtcDeviceNewScene);
     RTCORE_VERIFY_HANDLE(device);
     if (!isCoherent(flags) && !isIncoherent(flags)) flags = RTCSceneFlags(flags | RTC_SCENE_INCOHERENT);
-    return (RTCScene) new Scene((Device*)device,flags,aflags);
+    Scene* scene = new Scene((Device*)device,flags,aflags);
+    scene->refInc();
+    return (RTCScene) scene;
     RTCORE_CATCH_END((Device*)device);
     return nullptr;
   }
 
+  RTCORE_API RTCSharedScene rtcExportScene (RTCScene hscene)
+  {
+    Scene* scene = (Scene*) hscene;
+    RTCORE_CATCH_BEGIN;
+    RTCORE_TRACE(rtcExportScene);
+    RTCORE_VERIFY_HANDLE(hscene);
+    if (!scene->isStatic()) throw_RTCError(RTC_INVALID_OPERATION,"only static scenes can get exported");
+    if (!scene->isBuild() || scene->isModified()) throw_RTCError(RTC_INVALID_OPERATION,"scene got not committed");
+    SharedScene* shared = scene->isImported() ? scene->shared.ptr : new SharedScene(scene);
+    shared->refInc();
+    return (RTCSharedScene) shared;
+    RTCORE_CATCH_END(scene->device);
+    return nullptr;
+  }
+
+  RTCORE_API RTCScene rtcDeviceImportScene (RTCDevice device, RTCSharedScene hshared)
+  {
+    SharedScene* shared = (SharedScene*) hshared;
+    RTCORE_CATCH_BEGIN;
+    RTCORE_TRACE(rtcDeviceImportScene);
+    RTCORE_VERIFY_HANDLE(device);
+    RTCORE_VERIFY_HANDLE(hshared);
+    Scene* scene = new Scene((Device*)device,shared->scene->flags,shared->scene->aflags);
+    scene->refInc();
+    scene->import(shared);
+    return (RTCScene) scene;
+    RTCORE_CATCH_END((Device*)device);
+    return nullptr;
+  }
+
+  RTCORE_API void rtcDeleteSharedScene (RTCSharedScene hshared)
+  {
+    SharedScene* shared = (SharedScene*) hshared;
+    RTCORE_CATCH_BEGIN;
+    RTCORE_TRACE(rtcDeleteSharedScene);
+    RTCORE_VERIFY_HANDLE(hshared);
+    shared->refDec();
+    RTCORE_CATCH_END(nullptr);
+  }
+
   RTCORE_API void rtcSetProgressMonitorFunction(RTCScene hscene, RTCProgressMonitorFunc func, void* ptr) 
   {
     Scene* scene = (Scene*) hscene;
@@ -246,6 +293,7 @@ namespace embree
     RTCORE_CATCH_BEGIN;
     RTCORE_TRACE(rtcCommit);
     RTCORE_VERIFY_HANDLE(hscene);
+    scene->commitWait();
     scene->commit(0,0,true);
     RTCORE_CATCH_END(scene->device);
   }
@@ -283,6 +331,37 @@ namespace embree
     RTCORE_CATCH_END(scene->device);
   }
 
+  RTCORE_API void rtcCommitAsync (RTCScene hscene) 
+  {
+    Scene* scene = (Scene*) hscene;
+    RTCORE_CATCH_BEGIN;
+    RTCORE_TRACE(rtcCommitAsync);
+    RTCORE_VERIFY_HANDLE(hscene);
+    scene->commitAsync();
+    RTCORE_CATCH_END(scene->device);
+  }
+
+  RTCORE_API bool rtcCommitFinished (RTCScene hscene) 
+  {
+    Scene* scene = (Scene*) hscene;
+    RTCORE_CATCH_BEGIN;
+    RTCORE_TRACE(rtcCommitFinished);
+    RTCORE_VERIFY_HANDLE(hscene);
+    return scene->commitFinished();
+    RTCORE_CATCH_END(scene->device);
+    return true;
+  }
+
+  RTCORE_API void rtcCommitWait (RTCScene hscene) 
+  {
+    Scene* scene = (Scene*) hscene;
+    RTCORE_CATCH_BEGIN;
+    RTCORE_TRACE(rtcCommitWait);
+    RTCORE_VERIFY_HANDLE(hscene);
+    scene->commitWait();
+    RTCORE_CATCH_END(scene->device);
+  }
+
   RTCORE_API void rtcGetBounds(RTCScene hscene, RTCBounds& bounds_o)
   {
     Scene* scene = (Scene*) hscene;
@@ -302,6 +381,18 @@ namespace embree
     RTCORE_CATCH_END(scene->device);
   }
 
+  RTCORE_API void rtcGetSceneStatistics(RTCScene hscene, RTCSceneStatistics* stats_o)
+  {
+    Scene* scene = (Scene*) hscene;
+    RTCORE_CATCH_BEGIN;
+    RTCORE_TRACE(rtcGetSceneStatistics);
+    RTCORE_VERIFY_HANDLE(hscene);
+    RTCORE_VERIFY_HANDLE(stats_o);
+    if (scene->isModified()) throw_RTCError(RTC_INVALID_OPERATION,"scene got not committed");
+    scene->getStatistics(*stats_o);
+    RTCORE_CATCH_END(scene->device);
+  }
+
   RTCORE_API void rtcGetLinearBounds(RTCScene hscene, RTCBounds* bounds_o)
   {
     Scene* scene = (Scene*) hscene;
@@ -638,6 +729,187 @@ namespace embree
 #endif
     RTCORE_CATCH_END(scene->device);
   }
+
+  /*! resets the hit buffer of a ray for a k-nearest hit query */
+  static __forceinline void initHitBuffer(RTCHitBuffer& hits, unsigned& geomID)
+  {
+    if (hits.k == 0) throw_RTCError(RTC_INVALID_ARGUMENT,"hit buffer of size zero");
+    hits.numHits = 0;
+    geomID = RTC_INVALID_GEOMETRY_ID;
+  }
+
+  /*! stores the closest gathered hit of a k-nearest hit query in the ray */
+  static __forceinline void storeClosestHit(const RTCHitBuffer& hits, RTCRay& ray)
+  {
+    if (hits.numHits == 0) return;
+    const RTCHit& hit = hits.hits[0];
+    ray.tfar = hit.t;
+    ray.u = hit.u;
+    ray.v = hit.v;
+    ray.Ng[0] = hit.Ng[0];
+    ray.Ng[1] = hit.Ng[1];
+    ray.Ng[2] = hit.Ng[2];
+    ray.geomID = hit.geomID;
+    ray.primID = hit.primID;
+    ray.instID = hit.instID;
+  }
+
+  /*! stores the closest gathered hit of a k-nearest hit query in ray i of a ray packet */
+  template<typename RTCRayK>
+  static __forceinline void storeClosestHit(const RTCHitBuffer& hits, RTCRayK& ray, size_t i)
+  {
+    if (hits.numHits == 0) return;
+    const RTCHit& hit = hits.hits[0];
+    ray.tfar[i] = hit.t;
+    ray.u[i] = hit.u;
+    ray.v[i] = hit.v;
+    ray.Ngx[i] = hit.Ng[0];
+    ray.Ngy[i] = hit.Ng[1];
+    ray.Ngz[i] = hit.Ng[2];
+    ray.geomID[i] = hit.geomID;
+    ray.primID[i] = hit.primID;
+    ray.instID[i] = hit.instID;
+  }
+
+  RTCORE_API void rtcIntersectKNearest1 (RTCScene hscene, const RTCIntersectContext* user_context, RTCRay& ray, RTCHitBuffer& hits) 
+  {
+    Scene* scene = (Scene*) hscene;
+    RTCORE_CATCH_BEGIN;
+    RTCORE_TRACE(rtcIntersectKNearest1);
+#if defined(DEBUG)
+    RTCORE_VERIFY_HANDLE(hscene);
+    if (scene->isModified()) throw_RTCError(RTC_INVALID_OPERATION,"scene got not committed");
+    if (((size_t)&ray) & 0x0F        ) throw_RTCError(RTC_INVALID_ARGUMENT, "ray not aligned to 16 bytes");   
+#endif
+    STAT3(normal.travs,1,1,1);
+    initHitBuffer(hits,ray.geomID);
+    IntersectContext context(scene,user_context);
+    context.hitBuffers = &hits;
+    scene->intersect(ray,&context);
+    storeClosestHit(hits,ray);
+    RTCORE_CATCH_END(scene->device);
+  }
+
+  RTCORE_API void rtcIntersectKNearest4 (const void* valid, RTCScene hscene, const RTCIntersectContext* user_context, RTCRay4& ray, RTCHitBuffer* hits) 
+  {
+    Scene* scene = (Scene*) hscene;
+    RTCORE_CATCH_BEGIN;
+    RTCORE_TRACE(rtcIntersectKNearest4);
+
+#if defined(EMBREE_TARGET_SIMD4) && defined (EMBREE_RAY_PACKETS)
+#if defined(DEBUG)
+    RTCORE_VERIFY_HANDLE(hscene);
+    if (scene->isModified()) throw_RTCError(RTC_INVALID_OPERATION,"scene got not committed");
+    if (((size_t)valid) & 0x0F       ) throw_RTCError(RTC_INVALID_ARGUMENT, "mask not aligned to 16 bytes");   
+    if (((size_t)&ray ) & 0x0F       ) throw_RTCError(RTC_INVALID_ARGUMENT, "ray not aligned to 16 bytes");   
+#endif
+    STAT(size_t cnt=0; for (size_t i=0; i<4; i++) cnt += ((int*)valid)[i] == -1;);
+    STAT3(normal.travs,cnt,cnt,cnt);
+    for (size_t i=0; i<4; i++) 
+      if (((int*)valid)[i] == -1) initHitBuffer(hits[i],ray.geomID[i]);
+    IntersectContext context(scene,user_context);
+    context.hitBuffers = hits;
+    scene->intersect4(valid,ray,&context);
+    for (size_t i=0; i<4; i++) 
+      if (((int*)valid)[i] == -1) storeClosestHit(hits[i],ray,i);
+#else
+    throw_RTCError(RTC_INVALID_OPERATION,"rtcIntersectKNearest4 not supported");
+#endif
+    RTCORE_CATCH_END(scene->device);
+  }
+
+  RTCORE_API void rtcIntersectKNearest8 (const void* valid, RTCScene hscene, const RTCIntersectContext* user_context, RTCRay8& ray, RTCHitBuffer* hits) 
+  {
+    Scene* scene = (Scene*) hscene;
+    RTCORE_CATCH_BEGIN;
+    RTCORE_TRACE(rtcIntersectKNearest8);
+
+#if defined(EMBREE_TARGET_SIMD8) && defined (EMBREE_RAY_PACKETS)
+#if defined(DEBUG)
+    RTCORE_VERIFY_HANDLE(hscene);
+    if (scene->isModified()) throw_RTCError(RTC_INVALID_OPERATION,"scene got not committed");
+    if (((size_t)valid) & 0x1F       ) throw_RTCError(RTC_INVALID_ARGUMENT, "mask not aligned to 32 bytes");   
+    if (((size_t)&ray ) & 0x1F       ) throw_RTCError(RTC_INVALID_ARGUMENT, "ray not aligned to 32 bytes");   
+#endif
+    STAT(size_t cnt=0; for (size_t i=0; i<8; i++) cnt += ((int*)valid)[i] == -1;);
+    STAT3(normal.travs,cnt,cnt,cnt);
+    for (size_t i=0; i<8; i++) 
+      if (((int*)valid)[i] == -1) initHitBuffer(hits[i],ray.geomID[i]);
+    IntersectContext context(scene,user_context);
+    context.hitBuffers = hits;
+    scene->intersect8(valid,ray,&context);
+    for (size_t i=0; i<8; i++) 
+      if (((int*)valid)[i] == -1) storeClosestHit(hits[i],ray,i);
+#else
+    throw_RTCError(RTC_INVALID_OPERATION,"rtcIntersectKNearest8 not supported");
+#endif
+    RTCORE_CATCH_END(scene->device);
+  }
+
+  RTCORE_API void rtcIntersectKNearest16 (const void* valid, RTCScene hscene, const RTCIntersectContext* user_context, RTCRay16& ray, RTCHitBuffer* hits) 
+  {
+    Scene* scene = (Scene*) hscene;
+    RTCORE_CATCH_BEGIN;
+    RTCORE_TRACE(rtcIntersectKNearest16);
+
+#if defined(EMBREE_TARGET_SIMD16) && defined (EMBREE_RAY_PACKETS)
+#if defined(DEBUG)
+    RTCORE_VERIFY_HANDLE(hscene);
+    if (scene->isModified()) throw_RTCError(RTC_INVALID_OPERATION,"scene got not committed");
+    if (((size_t)valid) & 0x3F       ) throw_RTCError(RTC_INVALID_ARGUMENT, "mask not aligned to 64 bytes");   
+    if (((size_t)&ray ) & 0x3F       ) throw_RTCError(RTC_INVALID_ARGUMENT, "ray not aligned to 64 bytes");   
+#endif
+    STAT(size_t cnt=0; for (size_t i=0; i<16; i++) cnt += ((int*)valid)[i] == -1;);
+    STAT3(normal.travs,cnt,cnt,cnt);
+    for (size_t i=0; i<16; i++) 
+      if (((int*)valid)[i] == -1) initHitBuffer(hits[i],ray.geomID[i]);
+    IntersectContext context(scene,user_context);
+    context.hitBuffers = hits;
+    scene->intersect16(valid,ray,&context);
+    for (size_t i=0; i<16; i++) 
+      if (((int*)valid)[i] == -1) storeClosestHit(hits[i],ray,i);
+#else
+    throw_RTCError(RTC_INVALID_OPERATION,"rtcIntersectKNearest16 not supported");
+#endif
+    RTCORE_CATCH_END(scene->device);
+  }
+
+  RTCORE_API void rtcIntersectKNearest1M (RTCScene hscene, const RTCIntersectContext* user_context, RTCRay* rays, RTCHitBuffer* hits, const size_t M, const size_t stride) 
+  {
+    Scene* scene = (Scene*) hscene;
+    RTCORE_CATCH_BEGIN;
+    RTCORE_TRACE(rtcIntersectKNearest1M);
+
+#if defined (EMBREE_RAY_PACKETS)
+#if defined(DEBUG)
+    RTCORE_VERIFY_HANDLE(hscene);
+    if (scene->isModified()) throw_RTCError(RTC_INVALID_OPERATION,"scene got not committed");
+    if (((size_t)rays ) & 0x03) throw_RTCError(RTC_INVALID_ARGUMENT, "ray not aligned to 4 bytes");   
+#endif
+    STAT3(normal.travs,M,M,M);
+    for (size_t i=0; i<M; i++)
+      initHitBuffer(hits[i],((RTCRay*)((char*)rays + i*stride))->geomID);
+    IntersectContext context(scene,user_context);
+    context.hitBuffers = hits;
+
+    /* fast codepath for single rays */
+    if (likely(M == 1)) {
+      if (likely(rays->tnear <= rays->tfar)) 
+        scene->intersect(*rays,&context);
+    } 
+
+    /* codepath for streams */
+    else {
+      scene->device->rayStreamFilters.filterAOS(scene,rays,M,stride,&context,true);   
+    }
+
+    for (size_t i=0; i<M; i++)
+      storeClosestHit(hits[i],*(RTCRay*)((char*)rays + i*stride));
+#else
+    throw_RTCError(RTC_INVALID_OPERATION,"rtcIntersectKNearest1M not supported");
+#endif
+    RTCORE_CATCH_END(scene->device);
+  }
   
   RTCORE_API void rtcOccluded (RTCScene hscene, RTCRay& ray) 
   {
@@ -948,6 +1220,40 @@ namespace embree
 #endif
     RTCORE_CATCH_END(scene->device);
   }
+
+  RTCORE_API void rtcPointQuery1 (RTCScene hscene, RTCPointQuery& query)
+  {
+    Scene* scene = (Scene*) hscene;
+    RTCORE_CATCH_BEGIN;
+    RTCORE_TRACE(rtcPointQuery1);
+#if defined(DEBUG)
+    RTCORE_VERIFY_HANDLE(hscene);
+    if (scene->isModified()) throw_RTCError(RTC_INVALID_OPERATION,"scene got not committed");
+    if (((size_t)&query) & 0x0F) throw_RTCError(RTC_INVALID_ARGUMENT, "point query not aligned to 16 bytes");   
+#endif
+    query.geomID = RTC_INVALID_GEOMETRY_ID;
+    scene->pointQuery(query);
+    RTCORE_CATCH_END(scene->device);
+  }
+
+  RTCORE_API void rtcPointQuery1M (RTCScene hscene, RTCPointQuery* queries, const size_t M, const size_t stride)
+  {
+    Scene* scene = (Scene*) hscene;
+    RTCORE_CATCH_BEGIN;
+    RTCORE_TRACE(rtcPointQuery1M);
+#if defined(DEBUG)
+    RTCORE_VERIFY_HANDLE(hscene);
+    if (scene->isModified()) throw_RTCError(RTC_INVALID_OPERATION,"scene got not committed");
+    if (((size_t)queries) & 0x0F) throw_RTCError(RTC_INVALID_ARGUMENT, "point queries not aligned to 16 bytes");   
+#endif
+    for (size_t i=0; i<M; i++)
+    {
+      RTCPointQuery& query = *(RTCPointQuery*)((char*)queries + i*stride);
+      query.geomID = RTC_INVALID_GEOMETRY_ID;
+      scene->pointQuery(query);
+    }
+    RTCORE_CATCH_END(scene->device);
+  }
   
   RTCORE_API void rtcDeleteScene (RTCScene hscene) 
   {
@@ -956,7 +1262,7 @@ namespace embree
     RTCORE_CATCH_BEGIN;
     RTCORE_TRACE(rtcDeleteScene);
     RTCORE_VERIFY_HANDLE(hscene);
-    delete scene;
+    scene->refDec();
     RTCORE_CATCH_END(device);
   }
 
@@ -1077,6 +1383,17 @@ namespace embree
     RTCORE_CATCH_END(scene->device);
   }
 
+  RTCORE_API void rtcSetTransformInterpolation (RTCScene hscene, unsigned geomID, RTCTransformInterpolation interpolation) 
+  {
+    Scene* scene = (Scene*) hscene;
+    RTCORE_CATCH_BEGIN;
+    RTCORE_TRACE(rtcSetTransformInterpolation);
+    RTCORE_VERIFY_HANDLE(hscene);
+    RTCORE_VERIFY_GEOMID(geomID);
+    ((Scene*) scene)->get_locked(geomID)->setTransformInterpolation(interpolation);
+    RTCORE_CATCH_END(scene->device);
+  }
+
   RTCORE_API unsigned rtcNewUserGeometry (RTCScene hscene, size_t numItems) {
     return rtcNewUserGeometry4(hscene,RTC_GEOMETRY_STATIC,numItems,1,RTC_INVALID_GEOMETRY_ID);
   }
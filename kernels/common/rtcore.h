@@ -29,6 +29,7 @@ namespace embree
   __forceinline bool isCoherent  (RTCSceneFlags flags) { return (flags & RTC_SCENE_COHERENT) != 0; }
   __forceinline bool isIncoherent(RTCSceneFlags flags) { return (flags & RTC_SCENE_INCOHERENT) != 0; }
   __forceinline bool isHighQuality(RTCSceneFlags flags) { return (flags & RTC_SCENE_HIGH_QUALITY) != 0; }
+  __forceinline bool isOcclusionOptimized(RTCSceneFlags flags) { return (flags & RTC_SCENE_OPTIMIZE_OCCLUSION) != 0; }
 
   /*! decoding of algorithm flags */
   __forceinline bool isInterpolatable(RTCAlgorithmFlags flags) { return (flags & RTC_INTERPOLATE) != 0; }
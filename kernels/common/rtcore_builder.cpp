@@ -28,6 +28,7 @@
 
 #include "../builders/bvh_builder_sah.h"
 #include "../builders/bvh_builder_morton.h"
+#include "../builders/bvh_builder_ploc.h"
 
 namespace embree
 { 
@@ -56,6 +57,7 @@ namespace embree
       return nullptr;
     }
 
+    template<typename MortonBuilder>
     void* rtcBuildBVHMorton(BVH* bvh,
                             const RTCBuildSettings& settings,
                             RTCBuildPrimitive* prims_i,
@@ -93,7 +95,7 @@ namespace embree
         });
 
       /* start morton build */
-      std::pair<void*,BBox3fa> root = BVHBuilderMorton::build<std::pair<void*,BBox3fa>>(
+      std::pair<void*,BBox3fa> root = MortonBuilder::template build<std::pair<void*,BBox3fa>>(
         
         /* thread local allocator for fast allocations */
         [&] () -> FastAllocator::CachedAllocator { 
@@ -124,9 +126,20 @@ namespace embree
         /* lambda function that creates BVH leaves */
         [&]( const range<unsigned>& current, const FastAllocator::CachedAllocator& alloc) -> std::pair<void*,BBox3fa>
         {
-          const size_t id = morton_src[current.begin()].index;
-          const BBox3fa bounds = prims[id].bounds(); 
-          void* node = createLeaf((RTCThreadLocalAllocator)&alloc,prims_i+current.begin(),current.size(),userPtr);
+          /* gather the primitives of the leaf in morton order */
+          const size_t items = current.size();
+          RTCBuildPrimitive localPrims[32];
+          std::vector<RTCBuildPrimitive> heapPrims;
+          RTCBuildPrimitive* leafPrims = localPrims;
+          if (items > 32) { heapPrims.resize(items); leafPrims = heapPrims.data(); }
+
+          BBox3fa bounds = empty;
+          for (size_t i=0; i<items; i++) {
+            const size_t id = morton_src[current.begin()+i].index;
+            leafPrims[i] = prims_i[id];
+            bounds.extend(prims[id].bounds());
+          }
+          void* node = createLeaf((RTCThreadLocalAllocator)&alloc,leafPrims,items,userPtr);
           return std::make_pair(node,bounds);
         },
         
@@ -340,9 +353,9 @@ namespace embree
 
       /* switch between differnet builders based on quality level */
       if (settings.quality == RTC_BUILD_QUALITY_LOW)
-        return rtcBuildBVHMorton   (bvh,settings,prims,numPrimitives,createNode,setNodeChildren,setNodeBounds,createLeaf,buildProgress,userPtr);
+        return rtcBuildBVHMorton<BVHBuilderMorton>(bvh,settings,prims,numPrimitives,createNode,setNodeChildren,setNodeBounds,createLeaf,buildProgress,userPtr);
       else if (settings.quality == RTC_BUILD_QUALITY_NORMAL)
-        return rtcBuildBVHBinnedSAH(bvh,settings,prims,numPrimitives,createNode,setNodeChildren,setNodeBounds,createLeaf,buildProgress,userPtr);
+        return rtcBuildBVHMorton<BVHBuilderPLOC>(bvh,settings,prims,numPrimitives,createNode,setNodeChildren,setNodeBounds,createLeaf,buildProgress,userPtr);
       else if (settings.quality == RTC_BUILD_QUALITY_HIGH) {
         if (splitPrimitive == nullptr || settings.extraSpace == 0)
           return rtcBuildBVHBinnedSAH(bvh,settings,prims,numPrimitives,createNode,setNodeChildren,setNodeBounds,createLeaf,buildProgress,userPtr);
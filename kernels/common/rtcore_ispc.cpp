@@ -212,6 +212,10 @@ namespace embree
   extern "C" void ispcSetTransform2 (RTCScene scene, unsigned geomID, RTCMatrixType layout, const float* xfm, size_t timeStep) {
     return rtcSetTransform2(scene,geomID,layout,xfm,timeStep);
   }
+
+  extern "C" void ispcSetTransformInterpolation (RTCScene scene, unsigned geomID, RTCTransformInterpolation interpolation) {
+    return rtcSetTransformInterpolation(scene,geomID,interpolation);
+  }
   
   extern "C" unsigned ispcNewUserGeometry (RTCScene scene, RTCGeometryFlags gflags, size_t numItems, size_t numTimeSteps, unsigned int geomID) {
     return rtcNewUserGeometry4(scene,gflags,numItems,numTimeSteps,geomID);
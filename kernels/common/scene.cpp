@@ -29,6 +29,92 @@ namespace embree
   void invalid_rtcIntersect16() { throw_RTCError(RTC_INVALID_OPERATION,"rtcIntersect16 and rtcOccluded16 not enabled"); }
   void invalid_rtcIntersectN()  { throw_RTCError(RTC_INVALID_OPERATION,"rtcIntersectN and rtcOccludedN not enabled"); }
 
+  /* rtcIntersect and rtcOccluded functions of imported scenes, they trace the exported scene */
+  static void intersectShared1 (void* ptr, RTCRay& ray, IntersectContext* context) {
+    Scene* scene = (Scene*) ptr; context->scene = scene; scene->intersect(ray,context);
+  }
+  static void occludedShared1 (void* ptr, RTCRay& ray, IntersectContext* context) {
+    Scene* scene = (Scene*) ptr; context->scene = scene; scene->occluded(ray,context);
+  }
+  static void intersectShared4 (const void* valid, void* ptr, RTCRay4& ray, IntersectContext* context) {
+    Scene* scene = (Scene*) ptr; context->scene = scene; scene->intersect4(valid,ray,context);
+  }
+  static void occludedShared4 (const void* valid, void* ptr, RTCRay4& ray, IntersectContext* context) {
+    Scene* scene = (Scene*) ptr; context->scene = scene; scene->occluded4(valid,ray,context);
+  }
+  static void intersectShared8 (const void* valid, void* ptr, RTCRay8& ray, IntersectContext* context) {
+    Scene* scene = (Scene*) ptr; context->scene = scene; scene->intersect8(valid,ray,context);
+  }
+  static void occludedShared8 (const void* valid, void* ptr, RTCRay8& ray, IntersectContext* context) {
+    Scene* scene = (Scene*) ptr; context->scene = scene; scene->occluded8(valid,ray,context);
+  }
+  static void intersectShared16 (const void* valid, void* ptr, RTCRay16& ray, IntersectContext* context) {
+    Scene* scene = (Scene*) ptr; context->scene = scene; scene->intersect16(valid,ray,context);
+  }
+  static void occludedShared16 (const void* valid, void* ptr, RTCRay16& ray, IntersectContext* context) {
+    Scene* scene = (Scene*) ptr; context->scene = scene; scene->occluded16(valid,ray,context);
+  }
+  static void intersectSharedN (void* ptr, RTCRay** ray, const size_t N, IntersectContext* context) {
+    Scene* scene = (Scene*) ptr; context->scene = scene; scene->intersectN(ray,N,context);
+  }
+  static void occludedSharedN (void* ptr, RTCRay** ray, const size_t N, IntersectContext* context) {
+    Scene* scene = (Scene*) ptr; context->scene = scene; scene->occludedN(ray,N,context);
+  }
+  static void pointQueryShared1 (void* ptr, RTCPointQuery& query) {
+    Scene* scene = (Scene*) ptr; scene->pointQuery(query);
+  }
+
+  /* rtcIntersect and rtcOccluded functions of asynchronously committed scenes, they trace the current version */
+  static __forceinline Accel* traced(void* ptr) {
+    return ((Scene*)ptr)->version.load();
+  }
+  static void intersectAsync1 (void* ptr, RTCRay& ray, IntersectContext* context) {
+    traced(ptr)->intersect(ray,context);
+  }
+  static void occludedAsync1 (void* ptr, RTCRay& ray, IntersectContext* context) {
+    traced(ptr)->occluded(ray,context);
+  }
+  static void intersectAsync4 (const void* valid, void* ptr, RTCRay4& ray, IntersectContext* context) {
+    traced(ptr)->intersect4(valid,ray,context);
+  }
+  static void occludedAsync4 (const void* valid, void* ptr, RTCRay4& ray, IntersectContext* context) {
+    traced(ptr)->occluded4(valid,ray,context);
+  }
+  static void intersectAsync8 (const void* valid, void* ptr, RTCRay8& ray, IntersectContext* context) {
+    traced(ptr)->intersect8(valid,ray,context);
+  }
+  static void occludedAsync8 (const void* valid, void* ptr, RTCRay8& ray, IntersectContext* context) {
+    traced(ptr)->occluded8(valid,ray,context);
+  }
+  static void intersectAsync16 (const void* valid, void* ptr, RTCRay16& ray, IntersectContext* context) {
+    traced(ptr)->intersect16(valid,ray,context);
+  }
+  static void occludedAsync16 (const void* valid, void* ptr, RTCRay16& ray, IntersectContext* context) {
+    traced(ptr)->occluded16(valid,ray,context);
+  }
+  static void intersectAsyncN (void* ptr, RTCRay** ray, const size_t N, IntersectContext* context) {
+    traced(ptr)->intersectN(ray,N,context);
+  }
+  static void occludedAsyncN (void* ptr, RTCRay** ray, const size_t N, IntersectContext* context) {
+    traced(ptr)->occludedN(ray,N,context);
+  }
+  static void pointQueryAsync1 (void* ptr, RTCPointQuery& query) {
+    traced(ptr)->pointQuery(query);
+  }
+
+  /* disables all ray queries not enabled by the algorithm flags */
+  static void selectAlgorithms(Accel::Intersectors& intersectors, RTCAlgorithmFlags aflags)
+  {
+    if ((aflags & RTC_INTERSECT_STREAM) == 0) 
+    {
+      intersectors.intersectorN = Accel::IntersectorN(&invalid_rtcIntersectN);
+      if ((aflags & RTC_INTERSECT1) == 0) intersectors.intersector1 = Accel::Intersector1(&invalid_rtcIntersect1);
+      if ((aflags & RTC_INTERSECT4) == 0) intersectors.intersector4 = Accel::Intersector4(&invalid_rtcIntersect4);
+      if ((aflags & RTC_INTERSECT8) == 0) intersectors.intersector8 = Accel::Intersector8(&invalid_rtcIntersect8);
+      if ((aflags & RTC_INTERSECT16) == 0) intersectors.intersector16 = Accel::Intersector16(&invalid_rtcIntersect16);
+    }
+  }
+
   Scene::Scene (Device* device, RTCSceneFlags sflags, RTCAlgorithmFlags aflags)
     : Accel(AccelData::TY_UNKNOWN),
       device(device), 
@@ -40,7 +126,8 @@ namespace embree
       needBezierIndices(false), needBezierVertices(false),
       needLineIndices(false), needLineVertices(false),
       needSubdivIndices(false), needSubdivVertices(false),
-      is_build(false), modified(true),
+      is_build(false), modified(true), commitTime(0.0), instanceLevels(0),
+      version(nullptr), commitThread(nullptr), commitDone(true),
       progressInterface(this), progress_monitor_function(nullptr), progress_monitor_ptr(nullptr), progress_monitor_counter(0), 
       numIntersectionFilters1(0), numIntersectionFilters4(0), numIntersectionFilters8(0), numIntersectionFilters16(0), numIntersectionFiltersN(0)
   {
@@ -70,6 +157,11 @@ namespace embree
       needSubdivVertices = true;
     }
 
+    createAccels();
+  }
+
+  void Scene::createAccels()
+  {
     createTriangleAccel();
     createTriangleMBAccel();
     createQuadAccel();
@@ -126,7 +218,7 @@ namespace embree
             accels.add(device->bvh4_factory->BVH4Triangle4v(this,BVHFactory::BuildVariant::STATIC,BVHFactory::IntersectVariant::ROBUST));
 
           break;
-        case /*0b10*/ 2: accels.add(device->bvh4_factory->BVH4Triangle4i(this,BVHFactory::BuildVariant::STATIC,BVHFactory::IntersectVariant::FAST  )); break;
+        case /*0b10*/ 2: accels.add(device->bvh4_factory->BVH4QuantizedTriangle4i(this)); break;
         case /*0b11*/ 3: accels.add(device->bvh4_factory->BVH4Triangle4i(this,BVHFactory::BuildVariant::STATIC,BVHFactory::IntersectVariant::ROBUST)); break;
         }
       }
@@ -248,7 +340,7 @@ namespace embree
             accels.add(device->bvh4_factory->BVH4Quad4v(this,BVHFactory::BuildVariant::STATIC,BVHFactory::IntersectVariant::ROBUST));
           break;
 
-        case /*0b10*/ 2: accels.add(device->bvh4_factory->BVH4Quad4i(this,BVHFactory::BuildVariant::STATIC,BVHFactory::IntersectVariant::FAST)); break;
+        case /*0b10*/ 2: accels.add(device->bvh4_factory->BVH4QuantizedQuad4i(this)); break;
         case /*0b11*/ 3: accels.add(device->bvh4_factory->BVH4Quad4i(this,BVHFactory::BuildVariant::STATIC,BVHFactory::IntersectVariant::ROBUST)); break;
         }
       }
@@ -415,6 +507,9 @@ namespace embree
           accels.add(device->bvh8_factory->BVH8Line4i(this));
         else
 #endif
+        if (isCompact() && !isRobust())
+          accels.add(device->bvh4_factory->BVH4QuantizedLine4i(this));
+        else
           accels.add(device->bvh4_factory->BVH4Line4i(this,BVHFactory::BuildVariant::STATIC));
       }
       else
@@ -423,6 +518,7 @@ namespace embree
       }
     }
     else if (device->line_accel == "bvh4.line4i") accels.add(device->bvh4_factory->BVH4Line4i(this));
+    else if (device->line_accel == "qbvh4.line4i") accels.add(device->bvh4_factory->BVH4QuantizedLine4i(this));
 #if defined (EMBREE_TARGET_AVX)
     else if (device->line_accel == "bvh8.line4i") accels.add(device->bvh8_factory->BVH8Line4i(this));
 #endif
@@ -464,6 +560,7 @@ namespace embree
     else if (device->subdiv_accel == "bvh4.subdivpatch1eager" ) accels.add(device->bvh4_factory->BVH4SubdivPatch1Eager(this));
     else if (device->subdiv_accel == "bvh4.subdivpatch1"      ) accels.add(device->bvh4_factory->BVH4SubdivPatch1(this,false));
     else if (device->subdiv_accel == "bvh4.subdivpatch1cached") accels.add(device->bvh4_factory->BVH4SubdivPatch1(this,true));
+    else if (device->subdiv_accel == "bvh4.grid.quantized"    ) accels.add(device->bvh4_factory->BVH4SubdivPatch1Quantized(this));
     else throw_RTCError(RTC_INVALID_ARGUMENT,"unknown subdiv accel "+device->subdiv_accel);
 #endif
   }
@@ -537,6 +634,9 @@ namespace embree
   
   Scene::~Scene () 
   {
+    if (commitThread) 
+      join(commitThread);
+
     for (size_t i=0; i<geometries.size(); i++)
       delete geometries[i];
 
@@ -548,6 +648,29 @@ namespace embree
   void Scene::clear() {
   }
 
+  void Scene::import(SharedScene* shared)
+  {
+    assert(!isBuild() && size() == 0);
+    Scene* scene = shared->scene.ptr;
+    this->shared = shared;
+    flags = scene->flags;
+    aflags = scene->aflags;
+    bounds = scene->bounds;
+    instanceLevels = scene->instanceLevels;
+
+    /* forward all ray queries to the exported scene */
+    intersectors = Accel::Intersectors(missing_rtcCommit);
+    intersectors.ptr = scene;
+    intersectors.intersector1  = Accel::Intersector1 (intersectShared1 ,occludedShared1 ,"shared");
+    intersectors.intersector4  = Accel::Intersector4 (intersectShared4 ,occludedShared4 ,"shared");
+    intersectors.intersector8  = Accel::Intersector8 (intersectShared8 ,occludedShared8 ,"shared");
+    intersectors.intersector16 = Accel::Intersector16(intersectShared16,occludedShared16,"shared");
+    intersectors.intersectorN  = Accel::IntersectorN (intersectSharedN ,occludedSharedN ,"shared");
+    intersectors.pointQuery1   = Accel::PointQuery1  (pointQueryShared1,"shared");
+    is_build = true;
+    setModified(false);
+  }
+
 #if defined(EMBREE_GEOMETRY_USER)
   unsigned Scene::newUserGeometry (unsigned geomID, RTCGeometryFlags gflags, size_t items, size_t numTimeSteps) 
   {
@@ -690,6 +813,8 @@ namespace embree
   unsigned Scene::bind(unsigned geomID, Geometry* geometry) 
   {
     Lock<SpinLock> lock(geometriesMutex);
+    if (isImported())
+      throw_RTCError(RTC_INVALID_OPERATION,"imported scenes cannot get modified");
     if (geomID == RTC_INVALID_GEOMETRY_ID)
       geomID = id_pool.allocate();
     else {
@@ -719,6 +844,22 @@ namespace embree
       throw_RTCError(RTC_INVALID_OPERATION,"invalid geometry");
     
     geometry->disable();
+
+    /* the version traced during the next asynchronous build may still reference the geometry */
+    if (version) 
+    {
+      if (std::find(deletedGeometries.begin(),deletedGeometries.end(),geomID) != deletedGeometries.end() ||
+          std::find(retiredGeometries.begin(),retiredGeometries.end(),geomID) != retiredGeometries.end())
+        throw_RTCError(RTC_INVALID_OPERATION,"invalid geometry");
+      deletedGeometries.push_back(geomID);
+      return;
+    }
+    freeGeometry(geomID);
+  }
+
+  void Scene::freeGeometry(size_t geomID)
+  {
+    Geometry* geometry = geometries[geomID];
     accels.deleteGeometry(unsigned(geomID));
     id_pool.deallocate((unsigned)geomID);
     geometries[geomID] = nullptr;
@@ -731,23 +872,34 @@ namespace embree
     /* update bounds */
     is_build = true;
     bounds = accels.bounds;
+
+    /* asynchronously committed scenes atomically switch to the new version */
+    if (version) {
+      version = &accels;
+      return;
+    }
+    
     intersectors = accels.intersectors;
 
     /* enable only algorithms choosen by application */
-    if ((aflags & RTC_INTERSECT_STREAM) == 0) 
-    {
-      intersectors.intersectorN = Accel::IntersectorN(&invalid_rtcIntersectN);
-      if ((aflags & RTC_INTERSECT1) == 0) intersectors.intersector1 = Accel::Intersector1(&invalid_rtcIntersect1);
-      if ((aflags & RTC_INTERSECT4) == 0) intersectors.intersector4 = Accel::Intersector4(&invalid_rtcIntersect4);
-      if ((aflags & RTC_INTERSECT8) == 0) intersectors.intersector8 = Accel::Intersector8(&invalid_rtcIntersect8);
-      if ((aflags & RTC_INTERSECT16) == 0) intersectors.intersector16 = Accel::Intersector16(&invalid_rtcIntersect16);
-    }
+    selectAlgorithms(intersectors,aflags);
   }
 
   void Scene::commit_task ()
   {
+    const double t0 = getSeconds();
     progress_monitor_counter = 0;
 
+    /* check that the instance levels fit into the instance IDs of the ray */
+    unsigned levels = 0;
+    for (size_t i=0; i<geometries.size(); i++) {
+      Instance* instance = dynamic_cast<Instance*>(geometries[i]);
+      if (instance && instance->isEnabled()) levels = max(levels,instance->object->instanceLevels+1);
+    }
+    if (levels > RTC_MAX_INSTANCE_LEVEL_COUNT)
+      throw_RTCError(RTC_INVALID_OPERATION,"maximal number of nested instance levels exceeded");
+    instanceLevels = levels;
+
     /* call preCommit function of each geometry */
     parallel_for(geometries.size(), [&] ( const size_t i ) {
         if (geometries[i]) geometries[i]->preCommit();
@@ -779,9 +931,31 @@ namespace embree
       intersectors.print(2);
     }
     
+    commitTime = getSeconds()-t0;
     setModified(false);
   }
 
+  void Scene::getStatistics (RTCSceneStatistics& stats)
+  {
+    /* imported scenes report the statistics of the exported scene */
+    if (shared) {
+      shared->scene->getStatistics(stats);
+      return;
+    }
+
+    /* gather statistics of the traced version of the scene */
+    AccelN* traced = version ? version.load() : &accels;
+    AccelStatistics stat;
+    traced->addStatistics(stat);
+
+    const double A = traced->getLinearBounds().expectedHalfArea();
+    stat.commitTime = commitTime;
+    stat.sah = A > 0.0 ? stat.sahArea/A : 0.0;
+    stat.nodeFillRate = stat.nodeSlots > 0.0 ? stat.nodeChildren/stat.nodeSlots : 0.0;
+    stat.leafFillRate = stat.leafSlots > 0.0 ? stat.leafPrims/stat.leafSlots : 0.0;
+    stats = stat;
+  }
+
 #if defined(TASKING_INTERNAL)
 
   void Scene::commit (size_t threadIndex, size_t threadCount, bool useThreadPool) 
@@ -935,6 +1109,93 @@ namespace embree
   }
 #endif
 
+  void Scene::commitAsyncThread(void* ptr)
+  {
+    Scene* scene = (Scene*) ptr;
+    try {
+      scene->commit(0,0,true);
+    } 
+    catch (...) {
+      scene->commitError = std::current_exception();
+    }
+    scene->commitDone = true;
+  }
+
+  void Scene::commitAsync()
+  {
+    /* only a single asynchronous build can run per scene */
+    commitWait();
+
+    /* geometries deleted before the previous commit are no longer referenced by any version */
+    for (size_t i=0; i<retiredGeometries.size(); i++)
+      freeGeometry(retiredGeometries[i]);
+    retiredGeometries.clear();
+    std::swap(retiredGeometries,deletedGeometries);
+
+    /* fast path for unchanged scenes */
+    if (!isModified()) 
+      return;
+
+    /* report error if scene not ready */
+    if (!ready())
+      throw_RTCError(RTC_INVALID_OPERATION,"not all buffers are unmapped");
+
+    /* the committed version gets traced during the build, and the
+     * version before it gets rebuilt from scratch, as the geometries
+     * got modified relative to the committed version only */
+    if (isBuild()) 
+    {
+      accels.swap(accelsPrev);
+      if (accels.accels.size() == 0) createAccels();
+      else accels.clear();
+    }
+    else
+      accelsPrev.intersectors = Accel::Intersectors(missing_rtcCommit);
+    
+    /* forward ray queries to the traced version */
+    if (version == nullptr)
+    {
+      intersectors = Accel::Intersectors(missing_rtcCommit);
+      intersectors.ptr = this;
+      intersectors.intersector1  = Accel::Intersector1 (intersectAsync1 ,occludedAsync1 ,"async");
+      intersectors.intersector4  = Accel::Intersector4 (intersectAsync4 ,occludedAsync4 ,"async");
+      intersectors.intersector8  = Accel::Intersector8 (intersectAsync8 ,occludedAsync8 ,"async");
+      intersectors.intersector16 = Accel::Intersector16(intersectAsync16,occludedAsync16,"async");
+      intersectors.intersectorN  = Accel::IntersectorN (intersectAsyncN ,occludedAsyncN ,"async");
+      intersectors.pointQuery1   = Accel::PointQuery1  (pointQueryAsync1,"async");
+      selectAlgorithms(intersectors,aflags);
+    }
+    version = &accelsPrev;
+
+    /* start build in the background */
+    commitDone = false;
+    commitThread = createThread(commitAsyncThread,this);
+  }
+
+  void Scene::commitWait()
+  {
+    if (commitThread == nullptr)
+      return;
+
+    join(commitThread);
+    commitThread = nullptr;
+
+    if (commitError) {
+      std::exception_ptr error = commitError;
+      commitError = nullptr;
+      std::rethrow_exception(error);
+    }
+  }
+
+  bool Scene::commitFinished()
+  {
+    if (!commitDone) 
+      return false;
+
+    commitWait();
+    return true;
+  }
+
   void Scene::setProgressMonitorFunction(RTCProgressMonitorFunc func, void* ptr) 
   {
     static MutexSys mutex;
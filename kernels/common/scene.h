@@ -34,6 +34,8 @@
 
 namespace embree
 {
+  class SharedScene;
+
   /*! Base class all scenes are derived from */
   class Scene : public Accel
   {
@@ -124,6 +126,9 @@ namespace embree
 
     /*! Scene destruction */
     ~Scene ();
+
+    /*! Makes this scene reference the exported scene of another device. */
+    void import(SharedScene* shared);
     
     /*! clears the scene */
     void clear();
@@ -163,6 +168,26 @@ namespace embree
     void commit_task ();
     void build () {}
 
+    /*! Builds acceleration structure for the scene in the background,
+     *  ray queries trace the previous version until the build finished. */
+    void commitAsync ();
+
+    /*! Waits for the asynchronous build to finish and reports its error. */
+    void commitWait ();
+
+    /*! Tests if the asynchronous build finished and reports its error. */
+    bool commitFinished ();
+
+    /*! Gathers build times, quality, and memory statistics of the acceleration structures. */
+    void getStatistics (RTCSceneStatistics& stats);
+
+  private:
+    static void commitAsyncThread (void* ptr);
+    void createAccels ();
+    void freeGeometry (size_t geomID);
+
+  public:
+
     void updateInterface();
 
     /* return number of geometries */
@@ -224,6 +249,7 @@ namespace embree
     __forceinline bool isCoherent() const { return embree::isCoherent(flags); }
     __forceinline bool isRobust() const { return embree::isRobust(flags); }
     __forceinline bool isHighQuality() const { return embree::isHighQuality(flags); }
+    __forceinline bool isOcclusionOptimized() const { return embree::isOcclusionOptimized(flags); }
     __forceinline bool isInterpolatable() const { return embree::isInterpolatable(aflags); }
     __forceinline bool isStreamMode() const { return embree::isStreamMode(aflags); }
 
@@ -238,6 +264,15 @@ namespace embree
     /* test if scene got already build */
     __forceinline bool isBuild() const { return is_build; }
 
+    /* test if scene got imported from some other device */
+    __forceinline bool isImported() const { return shared != null; }
+
+    /* test if all acceleration structures of the traced version support ray streams */
+    __forceinline bool validIsecN() {
+      AccelN* traced = version.load();
+      return traced ? traced->validIsecN() : accels.validIsecN();
+    }
+
   public:
     IDPool<unsigned> id_pool;
     std::vector<Geometry*> geometries; //!< list of all user geometries
@@ -264,6 +299,18 @@ namespace embree
     SpinLock geometriesMutex;
     bool is_build;
     bool modified;                   //!< true if scene got modified
+    Ref<SharedScene> shared;         //!< exported scene this scene got imported from
+    double commitTime;               //!< time of the last commit in seconds
+    unsigned instanceLevels;         //!< number of nested instance levels, 0 if the scene contains no instances
+
+    /*! asynchronous commit */
+    AccelN accelsPrev;                         //!< previous version traced during an asynchronous build
+    std::atomic<AccelN*> version;              //!< version traced by scenes that got committed asynchronously
+    thread_t commitThread;                     //!< thread of the running asynchronous build
+    std::atomic<bool> commitDone;              //!< true if the asynchronous build finished
+    std::exception_ptr commitError;            //!< error of the asynchronous build
+    std::vector<size_t> deletedGeometries;     //!< geometries deleted since the last asynchronous commit
+    std::vector<size_t> retiredGeometries;     //!< deleted geometries the previous version may still reference
     
     /*! global lock step task scheduler */
 #if defined(TASKING_INTERNAL) 
@@ -340,6 +387,20 @@ namespace embree
     std::atomic<size_t> numIntersectionFiltersN;   //!< number of enabled intersection/occlusion filters for N-wide ray packets
   };
 
+  /*! Immutable reference to a committed static scene, scenes of other
+   *  devices can get imported from it. The device of the scene is kept
+   *  alive as long as the scene is referenced. */
+  class SharedScene : public RefCount
+  {
+  public:
+    SharedScene (Scene* scene)
+      : device(scene->device), scene(scene) {}
+
+  public:
+    Ref<Device> device;
+    Ref<Scene> scene;
+  };
+
   template<> __forceinline size_t Scene::getNumPrimitives<TriangleMesh,false>() const { return world.numTriangles; }
   template<> __forceinline size_t Scene::getNumPrimitives<TriangleMesh,true>() const { return worldMB.numTriangles; }
   template<> __forceinline size_t Scene::getNumPrimitives<QuadMesh,false>() const { return world.numQuads; }
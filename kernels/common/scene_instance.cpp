@@ -32,12 +32,36 @@ namespace embree
 #endif
   }
 
+  QuaternionDecomposition::QuaternionDecomposition (const AffineSpace3fa& xfm)
+  {
+    /* orthonormalize the columns of the linear part */
+    const LinearSpace3fa& l = xfm.l;
+    const Vec3fa e0 = normalize(l.vx);
+    const Vec3fa t1 = l.vy - dot(e0,l.vy)*e0;
+    const Vec3fa e1 = normalize(t1);
+    Vec3fa e2 = normalize(l.vz - dot(e0,l.vz)*e0 - dot(e1,l.vz)*e1);
+
+    /* move reflections into the scale matrix to get a proper rotation */
+    if (l.det() < 0.0f) e2 = -e2;
+
+    scale = LinearSpace3fa(Vec3fa(dot(e0,l.vx),0.0f,0.0f),
+                           Vec3fa(dot(e0,l.vy),dot(e1,l.vy),0.0f),
+                           Vec3fa(dot(e0,l.vz),dot(e1,l.vz),dot(e2,l.vz)));
+    rotation = normalize(Quaternion3f(Vec3f(e0),Vec3f(e1),Vec3f(e2)));
+    translation = xfm.p;
+  }
+
   Instance::Instance (Scene* scene, Scene* object, size_t numTimeSteps) 
-    : AccelSet(scene,RTC_GEOMETRY_STATIC,1,numTimeSteps), object(object)
+    : AccelSet(scene,RTC_GEOMETRY_STATIC,1,numTimeSteps), object(object), interpolation(RTC_TRANSFORM_INTERPOLATION_LINEAR)
   {
     world2local0 = one;
     for (size_t i=0; i<numTimeSteps; i++) local2world[i] = one;
+    if (numTimeSteps > 1) {
+      decompositions.resize(numTimeSteps);
+      for (size_t i=0; i<numTimeSteps; i++) decompositions[i] = QuaternionDecomposition(one);
+    }
     intersectors.ptr = this;
+    intersectors.internalContext = true;
     boundsFunc3 = scene->device->instance_factory->InstanceBoundsFunc();
     boundsFuncUserPtr = nullptr;
     intersectors.intersectorN = scene->device->instance_factory->InstanceIntersectorN();
@@ -56,6 +80,19 @@ namespace embree
 
     local2world[timeStep] = xfm;
     if (timeStep == 0) world2local0 = rcp(xfm);
+    if (numTimeSteps > 1) decompositions[timeStep] = QuaternionDecomposition(xfm);
+  }
+
+  void Instance::setTransformInterpolation(RTCTransformInterpolation interpolation)
+  {
+    if (scene->isStatic() && scene->isBuild())
+      throw_RTCError(RTC_INVALID_OPERATION,"static scenes cannot get modified");
+
+    if (interpolation != RTC_TRANSFORM_INTERPOLATION_LINEAR && interpolation != RTC_TRANSFORM_INTERPOLATION_QUATERNION)
+      throw_RTCError(RTC_INVALID_ARGUMENT,"invalid transform interpolation");
+
+    this->interpolation = interpolation;
+    Geometry::update();
   }
 
   void Instance::setMask (unsigned mask) 
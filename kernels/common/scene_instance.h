@@ -30,6 +30,40 @@ namespace embree
     DEFINE_SYMBOL2(AccelSet::Intersector1M,InstanceIntersector1M);
   };
 
+  /*! Decomposition of an affine transformation into a translation, a
+   *  rotation, and an upper triangular scale/shear matrix, which get
+   *  interpolated separately for motion blurred instances. */
+  struct QuaternionDecomposition
+  {
+    __forceinline QuaternionDecomposition () {}
+
+    __forceinline QuaternionDecomposition (OneTy)
+      : scale(one), rotation(one), translation(zero) {}
+
+    /*! decomposes the linear part through Gram-Schmidt orthogonalization of its columns */
+    QuaternionDecomposition (const AffineSpace3fa& xfm);
+
+    /*! returns the affine transformation translation * rotation * scale */
+    __forceinline operator AffineSpace3fa () const {
+      return AffineSpace3fa(LinearSpace3fa(rotation)*scale,translation);
+    }
+
+  public:
+    LinearSpace3fa scale;   //!< upper triangular scale and shear matrix
+    Quaternion3f rotation;  //!< rotation as unit quaternion
+    Vec3fa translation;     //!< translation
+  };
+
+  /*! interpolates the decomposed transformations, spherically for the rotations */
+  __forceinline AffineSpace3fa lerp(const QuaternionDecomposition& d0, const QuaternionDecomposition& d1, const float t)
+  {
+    QuaternionDecomposition d;
+    d.scale = lerp(d0.scale,d1.scale,t);
+    d.rotation = slerp(d0.rotation,d1.rotation,t);
+    d.translation = lerp(d0.translation,d1.translation,t);
+    return d;
+  }
+
   /*! Instanced acceleration structure */
   struct Instance : public AccelSet
   {
@@ -42,6 +76,7 @@ namespace embree
     Instance (Scene* scene, Scene* object, size_t numTimeSteps); 
   public:
     virtual void setTransform(const AffineSpace3fa& local2world, size_t timeStep);
+    virtual void setTransformInterpolation(RTCTransformInterpolation interpolation);
     virtual void setMask (unsigned mask);
     virtual void build() {}
 
@@ -51,16 +86,38 @@ namespace embree
       return world2local0;
     }
 
-    __forceinline AffineSpace3fa getWorld2Local(float t) const 
+    __forceinline AffineSpace3fa getLocal2World(float t) const 
     {
       float ftime;
       const size_t itime = getTimeSegment(t, fnumTimeSegments, ftime);
-      return rcp(lerp(local2world[itime+0],local2world[itime+1],ftime));
+      if (unlikely(interpolation == RTC_TRANSFORM_INTERPOLATION_QUATERNION))
+        return lerp(decompositions[itime+0],decompositions[itime+1],ftime);
+      return lerp(local2world[itime+0],local2world[itime+1],ftime);
+    }
+
+    __forceinline AffineSpace3fa getWorld2Local(float t) const {
+      return rcp(getLocal2World(t));
     }
 
     template<int K>
       __forceinline AffineSpace3vf<K> getWorld2Local(const vbool<K>& valid, const vfloat<K>& t) const
     { 
+      /* the spherical interpolation is done per ray */
+      if (unlikely(interpolation == RTC_TRANSFORM_INTERPOLATION_QUATERNION))
+      {
+        AffineSpace3vf<K> space(one);
+        for (size_t bits=movemask(valid); bits!=0; )
+        {
+          const size_t i = __bscf(bits);
+          const AffineSpace3fa xfm = getLocal2World(t[i]);
+          space.l.vx.x[i] = xfm.l.vx.x; space.l.vx.y[i] = xfm.l.vx.y; space.l.vx.z[i] = xfm.l.vx.z;
+          space.l.vy.x[i] = xfm.l.vy.x; space.l.vy.y[i] = xfm.l.vy.y; space.l.vy.z[i] = xfm.l.vy.z;
+          space.l.vz.x[i] = xfm.l.vz.x; space.l.vz.y[i] = xfm.l.vz.y; space.l.vz.z[i] = xfm.l.vz.z;
+          space.p.x[i] = xfm.p.x; space.p.y[i] = xfm.p.y; space.p.z[i] = xfm.p.z;
+        }
+        return rcp(space);
+      }
+
       vfloat<K> ftime;
       const vint<K> itime_k = getTimeSegment(t, vfloat<K>(fnumTimeSegments), ftime);
       assert(any(valid));
@@ -82,6 +139,8 @@ namespace embree
     
   public:
     Scene* object;                 //!< pointer to instanced acceleration structure
+    RTCTransformInterpolation interpolation;           //!< interpolation mode of the transformations
+    avector<QuaternionDecomposition> decompositions;   //!< decomposed transformation for each timestep, only for motion blurred instances
     AffineSpace3fa world2local0;   //!< transformation from world space to local space for timestep 0
     AffineSpace3fa local2world[1]; //!< transformation from local space to world space for each timestep
   };
@@ -47,6 +47,8 @@ namespace embree
 
     cout << "    #stack nodes  = " << float(data.normal.trav_stack_nodes )*1E-6 << "M" << std::endl;
     cout << "    #stack pop    = " << float(data.normal.trav_stack_pop )*1E-6 << "M" << std::endl;
+    cout << "    #packets      = " << float(data.normal.trav_packets   )*1E-6 << "M" << std::endl;
+    cout << "    #repacked     = " << float(data.normal.trav_repacked  )*1E-6 << "M" << std::endl;
 
     size_t normal_box_hits = 0;
     size_t weighted_box_hits = 0;
@@ -76,6 +78,8 @@ namespace embree
 
       cout << "    #stack nodes = " << float(data.shadow.trav_stack_nodes )*1E-6 << "M" << std::endl;
       cout << "    #stack pop   = " << float(data.shadow.trav_stack_pop )*1E-6 << "M" << std::endl;
+      cout << "    #packets     = " << float(data.shadow.trav_packets   )*1E-6 << "M" << std::endl;
+      cout << "    #repacked    = " << float(data.shadow.trav_repacked  )*1E-6 << "M" << std::endl;
 
       size_t shadow_box_hits = 0;
       size_t weighted_shadow_box_hits = 0;
@@ -110,6 +114,14 @@ namespace embree
     cout << "    #prim_hits    = " << float(cntrs.all.normal.trav_prim_hits  )/float(cntrs.all.normal.travs) << ", " << 100.0f*active_normal_trav_prim_hits   << "% active" << std::endl;
     cout << "    #stack_pop    = " << float(cntrs.all.normal.trav_stack_pop  )/float(cntrs.all.normal.travs) << ", " << 100.0f*active_normal_trav_stack_pop   << "% active" << std::endl;
 
+    /* SIMD utilization of the ray packets entering the hybrid traversal */
+    if (cntrs.all.normal.trav_packets) {
+      cout << "    #packets      = " << float(cntrs.code.normal.trav_packets )/float(cntrs.all.normal.travs) << ", " << 100.0f*float(cntrs.active.normal.trav_packets )/float(cntrs.all.normal.trav_packets ) << "% active" << std::endl;
+    }
+    if (cntrs.all.normal.trav_repacked) {
+      cout << "    #repacked     = " << float(cntrs.code.normal.trav_repacked)/float(cntrs.all.normal.travs) << ", " << 100.0f*float(cntrs.active.normal.trav_repacked)/float(cntrs.all.normal.trav_repacked) << "% active" << std::endl;
+    }
+
     if (cntrs.all.shadow.travs) {
       float active_shadow_travs       = float(cntrs.active.shadow.travs      )/float(cntrs.all.shadow.travs      );
       float active_shadow_trav_nodes  = float(cntrs.active.shadow.trav_nodes )/float(cntrs.all.shadow.trav_nodes );
@@ -124,6 +136,12 @@ namespace embree
       cout << "    #leaves     = " << float(cntrs.all.shadow.trav_leaves)/float(cntrs.all.shadow.travs) << ", " << 100.0f*active_shadow_trav_leaves << "% active" << std::endl;
       cout << "    #prims      = " << float(cntrs.all.shadow.trav_prims  )/float(cntrs.all.shadow.travs) << ", " << 100.0f*active_shadow_trav_prims   << "% active" << std::endl;
       cout << "    #prim_hits  = " << float(cntrs.all.shadow.trav_prim_hits  )/float(cntrs.all.shadow.travs) << ", " << 100.0f*active_shadow_trav_prim_hits   << "% active" << std::endl;
+      if (cntrs.all.shadow.trav_packets) {
+        cout << "    #packets    = " << float(cntrs.code.shadow.trav_packets )/float(cntrs.all.shadow.travs) << ", " << 100.0f*float(cntrs.active.shadow.trav_packets )/float(cntrs.all.shadow.trav_packets ) << "% active" << std::endl;
+      }
+      if (cntrs.all.shadow.trav_repacked) {
+        cout << "    #repacked   = " << float(cntrs.code.shadow.trav_repacked)/float(cntrs.all.shadow.travs) << ", " << 100.0f*float(cntrs.active.shadow.trav_repacked)/float(cntrs.all.shadow.trav_repacked) << "% active" << std::endl;
+      }
 
     }
     cout << std::endl;
@@ -88,6 +88,8 @@ namespace embree
               trav_stack_pop.store(0);
               trav_stack_nodes.store(0); 
               trav_xfm_nodes.store(0); 
+              trav_packets.store(0);
+              trav_repacked.store(0);
             }
 
           public:
@@ -100,6 +102,8 @@ namespace embree
 	    std::atomic<size_t> trav_stack_pop;
 	    std::atomic<size_t> trav_stack_nodes; 
             std::atomic<size_t> trav_xfm_nodes; 
+            std::atomic<size_t> trav_packets;       //!< ray packets traced by the hybrid traversal
+            std::atomic<size_t> trav_repacked;      //!< ray packets re-packed from partially active packets
             
 	  } normal, shadow;
 	} all, active, code; 
@@ -103,6 +103,13 @@ namespace embree
 #else
       if (singledevice) tessellation_cache_size = 128*1024*1024;
 #endif
+    tessellation_cache_segments = 8;
+
+    bvh_cache = "";
+    build_memory_budget = 0;
+    bvh_restructure = true;
+    ray_stream_sort_size = 0;
+    ray_packet_repacking = false;
 
     subdiv_accel = "default";
     subdiv_accel_mb = "default";
@@ -397,6 +404,7 @@ namespace embree
             else if (flag == Token::Id("coherent")) scene_flags |= RTC_SCENE_COHERENT;
             else if (flag == Token::Id("incoherent")) scene_flags |= RTC_SCENE_INCOHERENT;
             else if (flag == Token::Id("high_quality")) scene_flags |= RTC_SCENE_HIGH_QUALITY;
+            else if (flag == Token::Id("optimize_occlusion")) scene_flags |= RTC_SCENE_OPTIMIZE_OCCLUSION;
             else if (flag == Token::Id("robust")) scene_flags |= RTC_SCENE_ROBUST;
           } while (cin->trySymbol("|"));
         }
@@ -409,6 +417,19 @@ namespace embree
         tessellation_cache_size = size_t(cin->get().Float()*1024.0f*1024.0f);
       else if (tok == Token::Id("cache_size") && cin->trySymbol("="))
         tessellation_cache_size = size_t(cin->get().Float()*1024.0f*1024.0f);
+      else if (tok == Token::Id("tessellation_cache_segments") && cin->trySymbol("="))
+        tessellation_cache_segments = cin->get().Int();
+
+      else if (tok == Token::Id("bvh_cache") && cin->trySymbol("="))
+        bvh_cache = cin->get().String();
+      else if (tok == Token::Id("build_memory_budget") && cin->trySymbol("="))
+        build_memory_budget = size_t(cin->get().Float()*1024.0f*1024.0f);
+      else if (tok == Token::Id("bvh_restructure") && cin->trySymbol("="))
+        bvh_restructure = cin->get().Int();
+      else if (tok == Token::Id("ray_stream_sort_size") && cin->trySymbol("="))
+        ray_stream_sort_size = cin->get().Int();
+      else if (tok == Token::Id("ray_packet_repacking") && cin->trySymbol("="))
+        ray_packet_repacking = cin->get().Int();
 
       else if (tok == Token::Id("alloc_main_block_size") && cin->trySymbol("="))
         alloc_main_block_size = cin->get().Int();
@@ -441,7 +462,15 @@ namespace embree
 
     std::cout << "  verbosity     = " << verbose << std::endl;
     std::cout << "  cache_size    = " << float(tessellation_cache_size)*1E-6 << " MB" << std::endl;
+    std::cout << "  cache_segments = " << tessellation_cache_segments << std::endl;
     std::cout << "  max_spatial_split_replications = " << max_spatial_split_replications << std::endl;
+    std::cout << "  bvh_cache     = " << (bvh_cache != "" ? bvh_cache : "disabled") << std::endl;
+    std::cout << "  build_memory_budget = ";
+    if (build_memory_budget) std::cout << float(build_memory_budget)*1E-6 << " MB" << std::endl;
+    else std::cout << "unlimited" << std::endl;
+    std::cout << "  bvh_restructure = " << bvh_restructure << std::endl;
+    std::cout << "  ray_stream_sort_size = " << ray_stream_sort_size << std::endl;
+    std::cout << "  ray_packet_repacking = " << ray_packet_repacking << std::endl;
     
     std::cout << "triangles:" << std::endl;
     std::cout << "  accel         = " << tri_accel << std::endl;
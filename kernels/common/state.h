@@ -111,7 +111,13 @@ namespace embree
 
   public:
     float max_spatial_split_replications;  //!< maximally replications*N many primitives in accel for spatial splits
-    size_t tessellation_cache_size;        //!< size of the shared tessellation cache 
+    size_t tessellation_cache_size;        //!< size of the tessellation cache of the device
+    size_t tessellation_cache_segments;    //!< number of segments of the tessellation cache, invalidated one at a time
+    std::string bvh_cache;                 //!< directory to store and load BVHs of static scenes, disabled if empty
+    size_t build_memory_budget;            //!< memory budget for out-of-core builds of static scenes, unlimited if 0
+    bool bvh_restructure;                  //!< restructures treelets of the BVHs of static high quality scenes
+    size_t ray_stream_sort_size;           //!< number of rays of large ray streams sorted together by octant and origin, disabled if 0
+    bool ray_packet_repacking;             //!< re-packs the active rays of ray packet streams into full packets
 
   public:
     size_t instancing_open_min;            //!< instancing opens tree to minimally that number of subtrees
@@ -20,6 +20,7 @@
 #include "../common/ray.h"
 #include "../common/hit.h"
 #include "../common/context.h"
+#include "../../include/embree2/rtcore_ray.h"
 
 namespace embree
 {
@@ -40,6 +41,7 @@ namespace embree
     __forceinline bool runIntersectionFilter1(const Geometry* const geometry, Ray& ray, IntersectContext* context,
                                               const float& u, const float& v, const float& t, const Vec3fa& Ng, const int geomID, const int primID)
     {
+      context->countFilterCalls(1);
       if (likely(geometry->intersectionFilter1)) // old code for compatibility
       {
         /* temporarily update hit information */
@@ -82,6 +84,7 @@ namespace embree
     __forceinline bool runOcclusionFilter1(const Geometry* const geometry, Ray& ray, IntersectContext* context,
                                            const float& u, const float& v, const float& t, const Vec3fa& Ng, const int geomID, const int primID)
     {
+      context->countFilterCalls(1);
       if (likely(geometry->occlusionFilter1)) // old code for compatibility
       {
         /* temporarily update hit information */
@@ -122,6 +125,7 @@ namespace embree
     __forceinline vbool4 runIntersectionFilter(const vbool4& valid, const Geometry* const geometry, Ray4& ray, IntersectContext* context,
                                                const vfloat4& u, const vfloat4& v, const vfloat4& t, const Vec3vf4& Ng, const int geomID, const int primID)
     {
+      context->countFilterCalls(movemask(valid));
       RTCFilterFunc4  filter4 = geometry->intersectionFilter4;
       if (likely(filter4)) // old code for compatibility
       {
@@ -171,6 +175,7 @@ namespace embree
     __forceinline vbool4 runOcclusionFilter(const vbool4& valid, const Geometry* const geometry, Ray4& ray, IntersectContext* context,
                                             const vfloat4& u, const vfloat4& v, const vfloat4& t, const Vec3vf4& Ng, const int geomID, const int primID)
     {
+      context->countFilterCalls(movemask(valid));
       RTCFilterFunc4 filter4 = geometry->occlusionFilter4;
       if (likely(filter4)) // old code for compatibility
       {
@@ -215,6 +220,7 @@ namespace embree
     __forceinline bool runIntersectionFilter(const Geometry* const geometry, Ray4& ray, const size_t k, IntersectContext* context,
                                              const float& u, const float& v, const float& t, const Vec3fa& Ng, const int geomID, const int primID)
     {
+      context->countFilterCalls((size_t)1 << k);
       const vbool4 valid(1 << k);
       RTCFilterFunc4  filter4 = geometry->intersectionFilter4;
       if (likely(filter4)) // old code for compatibility
@@ -262,6 +268,7 @@ namespace embree
     __forceinline bool runOcclusionFilter(const Geometry* const geometry, Ray4& ray, const size_t k, IntersectContext* context,
                                           const float& u, const float& v, const float& t, const Vec3fa& Ng, const int geomID, const int primID)
     {
+      context->countFilterCalls((size_t)1 << k);
       const vbool4 valid(1 << k);
       RTCFilterFunc4  filter4 = geometry->occlusionFilter4;
       if (likely(filter4)) // old code for compatibility
@@ -306,6 +313,7 @@ namespace embree
     __forceinline vbool8 runIntersectionFilter(const vbool8& valid, const Geometry* const geometry, Ray8& ray, IntersectContext* context,
                                                const vfloat8& u, const vfloat8& v, const vfloat8& t, const Vec3vf8& Ng, const int geomID, const int primID)
     {
+      context->countFilterCalls(movemask(valid));
       RTCFilterFunc8  filter8 = geometry->intersectionFilter8;    
       if (likely(filter8)) // old code for compatibility
       {
@@ -354,6 +362,7 @@ namespace embree
     __forceinline vbool8 runOcclusionFilter(const vbool8& valid, const Geometry* const geometry, Ray8& ray, IntersectContext* context,
                                             const vfloat8& u, const vfloat8& v, const vfloat8& t, const Vec3vf8& Ng, const int geomID, const int primID)
     {
+      context->countFilterCalls(movemask(valid));
       RTCFilterFunc8 filter8 = geometry->occlusionFilter8;
       if (likely(filter8)) // old code for compatibility
       {
@@ -397,6 +406,7 @@ namespace embree
     __forceinline bool runIntersectionFilter(const Geometry* const geometry, Ray8& ray, const size_t k, IntersectContext* context,
                                              const float& u, const float& v, const float& t, const Vec3fa& Ng, const int geomID, const int primID)
     {
+      context->countFilterCalls((size_t)1 << k);
       const vbool8 valid(1 << k);
       RTCFilterFunc8  filter8 = geometry->intersectionFilter8;
       if (likely(filter8)) // old code for compatibility
@@ -443,6 +453,7 @@ namespace embree
     __forceinline bool runOcclusionFilter(const Geometry* const geometry, Ray8& ray, const size_t k, IntersectContext* context,
                                           const float& u, const float& v, const float& t, const Vec3fa& Ng, const int geomID, const int primID)
     {
+      context->countFilterCalls((size_t)1 << k);
       const vbool8 valid(1 << k);
       RTCFilterFunc8 filter8 = geometry->occlusionFilter8;
       if (likely(filter8)) // old code for compatibility
@@ -491,6 +502,7 @@ namespace embree
     __forceinline vbool16 runIntersectionFilter(const vbool16& valid, const Geometry* const geometry, Ray16& ray, IntersectContext* context,
                                                 const vfloat16& u, const vfloat16& v, const vfloat16& t, const Vec3vf16& Ng, const int geomID, const int primID)
     {
+      context->countFilterCalls(movemask(valid));
       RTCFilterFunc16  filter16 = geometry->intersectionFilter16;
       if (likely(filter16)) // old code for compatibility
       {
@@ -539,6 +551,7 @@ namespace embree
     __forceinline vbool16 runOcclusionFilter(const vbool16& valid, const Geometry* const geometry, Ray16& ray, IntersectContext* context,
                                              const vfloat16& u, const vfloat16& v, const vfloat16& t, const Vec3vf16& Ng, const int geomID, const int primID)
     {
+      context->countFilterCalls(movemask(valid));
       RTCFilterFunc16 filter16 = geometry->occlusionFilter16;
       if (likely(filter16)) // old code for compatibility
       {
@@ -582,6 +595,7 @@ namespace embree
     __forceinline bool runIntersectionFilter(const Geometry* const geometry, Ray16& ray, const size_t k, IntersectContext* context,
                                              const float& u, const float& v, const float& t, const Vec3fa& Ng, const int geomID, const int primID)
     {
+      context->countFilterCalls((size_t)1 << k);
       const vbool16 valid(1 << k);
       RTCFilterFunc16  filter16 = geometry->intersectionFilter16;
       if (likely(filter16)) // old code for compatibility
@@ -628,6 +642,7 @@ namespace embree
     __forceinline bool runOcclusionFilter(const Geometry* const geometry, Ray16& ray, const size_t k, IntersectContext* context,
                                           const float& u, const float& v, const float& t, const Vec3fa& Ng, const int geomID, const int primID)
     {
+      context->countFilterCalls((size_t)1 << k);
       const vbool16 valid(1 << k);
       RTCFilterFunc16 filter16 = geometry->occlusionFilter16;
       if (likely(filter16)) // old code for compatibility
@@ -670,5 +685,94 @@ namespace embree
     }    
 #endif
 
+    /*! Inserts a hit into the hit buffer of a k-nearest hit query,
+     *  keeping the hits sorted by distance. Primitives referenced by
+     *  multiple leaves report the same hit repeatedly, such duplicates
+     *  are ignored. Returns the distance of the k-th hit if the buffer
+     *  is full and infinity otherwise. */
+    __forceinline float insertHit(RTCHitBuffer& buffer, const float t, const float u, const float v, const Vec3fa& Ng,
+                                  const unsigned geomID, const unsigned primID, const unsigned instID)
+    {
+      const unsigned n = buffer.numHits;
+      const bool full = n == buffer.k;
+      if (full && t >= buffer.hits[n-1].t)
+        return buffer.hits[n-1].t;
+
+      for (unsigned i=0; i<n; i++) {
+        const RTCHit& hit = buffer.hits[i];
+        if (unlikely(hit.t == t && hit.primID == primID && hit.geomID == geomID && hit.instID == instID))
+          return full ? buffer.hits[n-1].t : float(pos_inf);
+      }
+
+      /* the k-th hit gets dropped if the buffer is full */
+      unsigned i = full ? n-1 : n;
+      for (; i>0 && buffer.hits[i-1].t > t; i--)
+        buffer.hits[i] = buffer.hits[i-1];
+
+      RTCHit& hit = buffer.hits[i];
+      hit.t = t;
+      hit.u = u;
+      hit.v = v;
+      hit.Ng[0] = Ng.x;
+      hit.Ng[1] = Ng.y;
+      hit.Ng[2] = Ng.z;
+      hit.geomID = geomID;
+      hit.primID = primID;
+      hit.instID = instID;
+      if (!full) buffer.numHits++;
+      return buffer.numHits == buffer.k ? buffer.hits[buffer.k-1].t : float(pos_inf);
+    }
+
+    /*! Gathers a hit of a single ray into its k-nearest hit buffer. The
+     *  intersection filter of the geometry only decides whether the hit
+     *  gets gathered, the hit data of the ray stays unchanged. Once the
+     *  buffer is full the ray segment is shortened to the distance of
+     *  the k-th hit. */
+    __forceinline void gatherHit1(const Geometry* const geometry, Ray& ray, IntersectContext* context,
+                                  const float& u, const float& v, const float& t, const Vec3fa& Ng, const int geomID, const int primID)
+    {
+#if defined(EMBREE_INTERSECTION_FILTER)
+      if (unlikely(geometry->hasIntersectionFilter1()))
+      {
+        const float   ray_tfar   = ray.tfar;
+        const Vec3fa  ray_Ng     = ray.Ng;
+        const vfloat4 ray_uv_ids = *(vfloat4*)&ray.u;
+        const bool passed = runIntersectionFilter1(geometry,ray,context,u,v,t,Ng,geomID,primID);
+        ray.tfar = ray_tfar;
+        ray.Ng = ray_Ng;
+        *(vfloat4*)&ray.u = ray_uv_ids;
+        if (!passed) return;
+      }
+#endif
+      ray.tfar = min(ray.tfar,insertHit(context->hitBuffers[0],t,u,v,Ng,geomID,primID,ray.instID));
+    }
+
+    /*! Gathers a hit of ray k of a ray packet into the k-nearest hit
+     *  buffer of that ray, see gatherHit1. */
+    template<int K>
+    __forceinline void gatherHit(const Geometry* const geometry, RayK<K>& ray, const size_t k, IntersectContext* context,
+                                 const float& u, const float& v, const float& t, const Vec3fa& Ng, const int geomID, const int primID)
+    {
+#if defined(EMBREE_INTERSECTION_FILTER)
+      if (unlikely(geometry->hasIntersectionFilter<vfloat<K>>()))
+      {
+        const float ray_tfar = ray.tfar[k];
+        const float ray_u = ray.u[k], ray_v = ray.v[k];
+        const Vec3fa ray_Ng(ray.Ng.x[k],ray.Ng.y[k],ray.Ng.z[k]);
+        const int ray_geomID = ray.geomID[k], ray_primID = ray.primID[k];
+        const bool passed = runIntersectionFilter(geometry,ray,k,context,u,v,t,Ng,geomID,primID);
+        ray.tfar[k] = ray_tfar;
+        ray.u[k] = ray_u;
+        ray.v[k] = ray_v;
+        ray.Ng.x[k] = ray_Ng.x;
+        ray.Ng.y[k] = ray_Ng.y;
+        ray.Ng.z[k] = ray_Ng.z;
+        ray.geomID[k] = ray_geomID;
+        ray.primID[k] = ray_primID;
+        if (!passed) return;
+      }
+#endif
+      ray.tfar[k] = min(ray.tfar[k],insertHit(context->hitBuffers[k],t,u,v,Ng,geomID,primID,ray.instID[k]));
+    }
   }
 }
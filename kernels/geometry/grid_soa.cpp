@@ -22,11 +22,12 @@ namespace embree
   {  
     GridSOA::GridSOA(const SubdivPatch1Base* patches, unsigned time_steps,
                      const unsigned x0, const unsigned x1, const unsigned y0, const unsigned y1, const unsigned swidth, const unsigned sheight,
-                     const SubdivMesh* const geom, const size_t gridOffset, const size_t gridBytes, BBox3fa* bounds_o)
+                     const SubdivMesh* const geom, const size_t gridOffset, const size_t gridBytes, BBox3fa* bounds_o, const bool quantized)
       : troot(BVH4::emptyNode),
         time_steps(time_steps), width(x1-x0+1), height(y1-y0+1), dim_offset(width*height),
-        _geomID(patches->geomID()), _primID(patches->primID()), 
-        gridOffset(gridOffset), gridBytes(unsigned(gridBytes)), rootOffset(unsigned(gridOffset+time_steps*gridBytes))
+        _geomID(patches->geomID()), _primID(patches->primID()), lod(0),
+        gridOffset(gridOffset), gridBytes(unsigned(gridBytes)), rootOffset(unsigned(gridOffset+time_steps*gridBytes)),
+        quantized(quantized)
     {
       /* the generate loops need padded arrays, thus first store into these temporary arrays */
       unsigned temp_size = width*height+VSIZEX;
@@ -51,6 +52,11 @@ namespace embree
           vintx::storeu(&local_grid_uv[i], (iv << 16) | iu);
         }
 
+        if (quantized) {
+          quantize(local_grid_x,local_grid_y,local_grid_z,local_grid_uv);
+          continue;
+        }
+
         /* copy temporary data to compact grid */
         float* const grid_x  = (float*)(gridData(t) + 0*dim_offset);
         float* const grid_y  = (float*)(gridData(t) + 1*dim_offset);
@@ -77,6 +83,29 @@ namespace embree
       }
     }
 
+    void GridSOA::quantize(const float* grid_x, const float* grid_y, const float* grid_z, const float* grid_uv)
+    {
+      /* quantize relative to the bounds of the grid */
+      BBox3fa bounds(empty);
+      for (unsigned i=0; i<dim_offset; i++)
+        bounds.extend(Vec3fa(grid_x[i],grid_y[i],grid_z[i]));
+      assert(is_finite(bounds));
+
+      const float* const grid[3] = { grid_x, grid_y, grid_z };
+      for (size_t dim=0; dim<3; dim++)
+      {
+        const float extent = bounds.upper[dim]-bounds.lower[dim];
+        const float rcp_scale = extent > 0.0f ? 0xFFFF/extent : 0.0f;
+        qlower[dim] = bounds.lower[dim];
+        qscale[dim] = extent/0xFFFF;
+
+        unsigned short* const qgrid = quantizedData(dim);
+        for (unsigned i=0; i<dim_offset; i++)
+          qgrid[i] = (unsigned short) clamp(floorf((grid[dim][i]-qlower[dim])*rcp_scale+0.5f),0.0f,float(0xFFFF));
+      }
+      memcpy(quantizedUV(),grid_uv,dim_offset*sizeof(int));
+    }
+
     size_t GridSOA::getBVHBytes(const GridRange& range, const size_t nodeBytes, const size_t leafBytes)
     {
       if (range.hasLeafSize()) 
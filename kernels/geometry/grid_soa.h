@@ -32,16 +32,19 @@ namespace embree
     {
     public:
 
+      /*! size of the float block a quantized leaf gets decoded into */
+      enum { QUANTIZED_BLOCK_DIM = 9, QUANTIZED_BLOCK_SIZE = 4*QUANTIZED_BLOCK_DIM+4 };
+
       /*! GridSOA constructor */
       GridSOA(const SubdivPatch1Base* patches, const unsigned time_steps,
               const unsigned x0, const unsigned x1, const unsigned y0, const unsigned y1, const unsigned swidth, const unsigned sheight,
-              const SubdivMesh* const geom, const size_t totalBvhBytes, const size_t gridBytes, BBox3fa* bounds_o = nullptr);
+              const SubdivMesh* const geom, const size_t totalBvhBytes, const size_t gridBytes, BBox3fa* bounds_o = nullptr, const bool quantized = false);
 
       /*! Subgrid creation */
       template<typename Allocator>
         static GridSOA* create(const SubdivPatch1Base* patches, const unsigned time_steps,
                                unsigned x0, unsigned x1, unsigned y0, unsigned y1, 
-                               const Scene* scene, Allocator& alloc, BBox3fa* bounds_o = nullptr)
+                               const Scene* scene, Allocator& alloc, BBox3fa* bounds_o = nullptr, const bool quantized = false)
       {
         const unsigned width = x1-x0+1;  
         const unsigned height = y1-y0+1; 
@@ -53,22 +56,32 @@ namespace embree
           bvhBytes = (time_steps-1)*getBVHBytes(range,sizeof(BVH4::AlignedNodeMB),0);
           bvhBytes += getTemporalBVHBytes(make_range(0,int(time_steps-1)),sizeof(BVH4::AlignedNodeMB4D));
         }
-        const size_t gridBytes = 4*size_t(width)*size_t(height)*sizeof(float);  
+        assert(!quantized || time_steps == 1);
+        const size_t gridBytes = quantized ? getQuantizedGridBytes(width*height) : 4*size_t(width)*size_t(height)*sizeof(float);  
         size_t rootBytes = time_steps*sizeof(BVH4::NodeRef);
 #if !defined(__X86_64__)
         rootBytes += 4; // We read 2 elements behind the grid. As we store at least 8 root bytes after the grid we are fine in 64 bit mode. But in 32 bit mode we have to do additional padding.
 #endif
         void* data = alloc(offsetof(GridSOA,data)+bvhBytes+time_steps*gridBytes+rootBytes);
         assert(data);
-        return new (data) GridSOA(patches,time_steps,x0,x1,y0,y1,patches->grid_u_res,patches->grid_v_res,scene->get<SubdivMesh>(patches->geomID()),bvhBytes,gridBytes,bounds_o);
+        return new (data) GridSOA(patches,time_steps,x0,x1,y0,y1,patches->grid_u_res,patches->grid_v_res,scene->get<SubdivMesh>(patches->geomID()),bvhBytes,gridBytes,bounds_o,quantized);
       }
 
       /*! Grid creation */
       template<typename Allocator>
         static GridSOA* create(const SubdivPatch1Base* const patches, const unsigned time_steps,
-                               const Scene* scene, const Allocator& alloc, BBox3fa* bounds_o = nullptr) 
+                               const Scene* scene, const Allocator& alloc, BBox3fa* bounds_o = nullptr, const bool quantized = false) 
       {
-        return create(patches,time_steps,0,patches->grid_u_res-1,0,patches->grid_v_res-1,scene,alloc,bounds_o);
+        return create(patches,time_steps,0,patches->grid_u_res-1,0,patches->grid_v_res-1,scene,alloc,bounds_o,quantized);
+      }
+
+      /*! returns the size of a quantized grid in bytes, the 16 bit x, y, and z arrays are padded to keep the uv array and roots aligned */
+      static __forceinline size_t getQuantizedGridBytes(size_t numVertices) {
+        return (3*alignQuantized(numVertices)*sizeof(unsigned short) + numVertices*sizeof(int) + 7) & ~size_t(7);
+      }
+
+      static __forceinline size_t alignQuantized(size_t numVertices) {
+        return (numVertices+3) & ~size_t(3);
       }
 
        /*! returns reference to root */
@@ -90,6 +103,75 @@ namespace embree
         return gridData(t) + (((size_t) (ptr) >> 4) - 1);
       }
 
+      /*! returns pointer to the 16 bit x, y, or z array of a quantized grid */
+      __forceinline       unsigned short* quantizedData(size_t dim)       { return (      unsigned short*) gridData(0) + dim*alignQuantized(dim_offset); }
+      __forceinline const unsigned short* quantizedData(size_t dim) const { return (const unsigned short*) gridData(0) + dim*alignQuantized(dim_offset); }
+
+      /*! returns pointer to the uv array of a quantized grid */
+      __forceinline       float* quantizedUV()       { return (      float*) quantizedData(3); }
+      __forceinline const float* quantizedUV() const { return (const float*) quantizedData(3); }
+
+      /*! returns vertex i of the grid at time step t */
+      __forceinline Vec3fa vertex(size_t t, size_t i) const
+      {
+        if (unlikely(quantized)) {
+          return Vec3fa(qlower[0] + float(quantizedData(0)[i])*qscale[0],
+                        qlower[1] + float(quantizedData(1)[i])*qscale[1],
+                        qlower[2] + float(quantizedData(2)[i])*qscale[2]);
+        }
+        const float* const grid = gridData(t);
+        return Vec3fa(grid[0*dim_offset+i],grid[1*dim_offset+i],grid[2*dim_offset+i]);
+      }
+
+      /*! returns pointer to the x array of a leaf of the first time
+       *  step and the layout of the grid, the leaf of a quantized grid
+       *  gets decoded into the block */
+      __forceinline const float* decodeLeaf(const void* ptr, float block[QUANTIZED_BLOCK_SIZE], size_t& dim_offset_o, size_t& line_offset_o, size_t& lines_o) const
+      {
+        if (unlikely(quantized)) {
+          decodeQuantizedLeaf(ptr,block,line_offset_o,lines_o);
+          dim_offset_o = QUANTIZED_BLOCK_DIM;
+          return block;
+        }
+        dim_offset_o  = dim_offset;
+        line_offset_o = width;
+        lines_o       = height;
+        return gridData(0) + (((size_t) (ptr) >> 4) - 1);
+      }
+
+      /*! Decodes the vertices of a leaf of a quantized grid into the
+       *  float block, which has the layout of a 3x3 grid (2 columns or
+       *  rows if the grid is that small) and can be read by the same
+       *  gather functions as an unquantized grid. */
+      __forceinline void decodeQuantizedLeaf(const void* ptr, float block[QUANTIZED_BLOCK_SIZE], size_t& line_offset, size_t& lines) const
+      {
+        const size_t index = ((size_t) (ptr) >> 4) - 1;
+        const size_t u0 = index % width;
+        const size_t v0 = index / width;
+        line_offset = width  > 2 ? 3 : 2;
+        lines       = height > 2 ? 3 : 2;
+        assert(u0+line_offset <= width);
+        assert(v0+lines <= height);
+        
+        const float* const grid_uv = quantizedUV();
+        for (size_t v=0; v<lines; v++)
+        {
+          for (size_t u=0; u<line_offset; u++) 
+          {
+            const size_t i = (v0+v)*width+(u0+u);
+            const size_t j = v*line_offset+u;
+            const Vec3fa p = vertex(0,i);
+            block[0*QUANTIZED_BLOCK_DIM+j] = p.x;
+            block[1*QUANTIZED_BLOCK_DIM+j] = p.y;
+            block[2*QUANTIZED_BLOCK_DIM+j] = p.z;
+            block[3*QUANTIZED_BLOCK_DIM+j] = grid_uv[i];
+          }
+        }
+        /* the gather functions read one element behind each row */
+        for (size_t j=4*QUANTIZED_BLOCK_DIM; j<QUANTIZED_BLOCK_SIZE; j++)
+          block[j] = 0.0f;
+      }
+
       /*! returns the size of the BVH over the grid in bytes */
       static size_t getBVHBytes(const GridRange& range, const size_t nodeBytes, const size_t leafBytes);
 
@@ -99,27 +181,45 @@ namespace embree
       /*! calculates bounding box of grid range */
       __forceinline BBox3fa calculateBounds(size_t time, const GridRange& range) const
       {
-        const float* const grid_array = gridData(time);
-        const float* const grid_x_array = grid_array + 0 * dim_offset;
-        const float* const grid_y_array = grid_array + 1 * dim_offset;
-        const float* const grid_z_array = grid_array + 2 * dim_offset;
-        
         /* compute the bounds just for the range! */
         BBox3fa bounds( empty );
         for (unsigned v = range.v_start; v<=range.v_end; v++) 
         {
           for (unsigned u = range.u_start; u<=range.u_end; u++)
-          {
-            const float x = grid_x_array[ v * width + u];
-            const float y = grid_y_array[ v * width + u];
-            const float z = grid_z_array[ v * width + u];
-            bounds.extend( Vec3fa(x,y,z) );
-          }
+            bounds.extend(vertex(time, v * width + u));
         }
         assert(is_finite(bounds));
         return bounds;
       }
 
+      /*! Returns the coarsest level of detail whose grid spacing does
+       *  not exceed the width of the ray cone at the patch. The grid
+       *  spacing is estimated from the corners of the grid and the edge
+       *  levels of the full resolution patch. */
+      __forceinline unsigned getLOD(const SubdivPatch1Base* patch, const Vec3fa& org, const float coneWidth, const float coneSpread) const
+      {
+        const unsigned corner[4] = { 0, width-1, width*height-1, (height-1)*width };
+        Vec3fa p[4]; BBox3fa bounds(empty);
+        for (size_t i=0; i<4; i++) {
+          p[i] = vertex(0,corner[i]);
+          bounds.extend(p[i]);
+        }
+
+        float spacing = 0.0f;
+        for (size_t i=0; i<4; i++)
+          spacing = max(spacing,length(p[(i+1)%4]-p[i])/patch->level[i]);
+
+        const float dist = length(max(bounds.lower-org,org-bounds.upper,Vec3fa(zero)));
+        const float footprint = coneWidth + coneSpread*dist;
+        const unsigned max_lod = patch->maxLOD();
+        unsigned lod = 0;
+        while (lod < max_lod && spacing*float(2 << lod) <= footprint) lod++;
+        return lod;
+      }
+
+      /*! Stores the evaluated grid with 16 bit vertex coordinates relative to the grid bounds. */
+      void quantize(const float* grid_x, const float* grid_y, const float* grid_z, const float* grid_uv);
+
       /*! Evaluates grid over patch and builds BVH4 tree over the grid. */
       std::pair<BVH4::NodeRef,BBox3fa> buildBVH(BBox3fa* bounds_o);
       
@@ -278,11 +378,16 @@ namespace embree
       unsigned _geomID;
       unsigned _primID;
 
-      unsigned align2;
+      unsigned lod;        //!< the edge levels of the patch got reduced by a factor of 2^lod for this grid
       unsigned gridOffset;
       unsigned gridBytes;
       unsigned rootOffset;
 
+      unsigned quantized;  //!< vertices are stored as 16 bit offsets relative to the bounds of the grid
+      float qlower[3];     //!< lower bounds of the quantized grid
+      float qscale[3];     //!< distance between two quantization steps
+      unsigned align2;     //!< keeps the BVH nodes 16 byte aligned
+
       char data[1];        //!< after the struct we first store the BVH, then the grid, and finally the roots
     };
   }
@@ -88,21 +88,21 @@ namespace embree
 
       public:
         GridSOA* grid;
-        PlueckerIntersectorK<M,K> intersector; // FIXME: use quad intersector
+        PlueckerIntersectorK<M,K,false> intersector; // FIXME: use quad intersector
       };
 
       /*! Intersect a ray with the primitive. */
       static __forceinline void intersect(const vbool<K>& valid_i, Precalculations& pre, RayK<K>& ray, IntersectContext* context, const Primitive* prim, size_t& lazy_node)
       {
-        const size_t dim_offset    = pre.grid->dim_offset;
-        const size_t line_offset   = pre.grid->width;
-        const float* const grid_x  = pre.grid->decodeLeaf(0,prim);
+        size_t dim_offset, line_offset, lines;
+        float block[GridSOA::QUANTIZED_BLOCK_SIZE];
+        const float* const grid_x  = pre.grid->decodeLeaf(prim,block,dim_offset,line_offset,lines);
         const float* const grid_y  = grid_x + 1 * dim_offset;
         const float* const grid_z  = grid_x + 2 * dim_offset;
         const float* const grid_uv = grid_x + 3 * dim_offset;
 
-        const size_t max_x = pre.grid->width  == 2 ? 1 : 2;
-        const size_t max_y = pre.grid->height == 2 ? 1 : 2;
+        const size_t max_x = line_offset == 2 ? 1 : 2;
+        const size_t max_y = lines       == 2 ? 1 : 2;
         for (size_t y=0; y<max_y; y++)        
         {
           for (size_t x=0; x<max_x; x++)
@@ -125,16 +125,16 @@ namespace embree
       /*! Test if the ray is occluded by the primitive */
       static __forceinline vbool<K> occluded(const vbool<K>& valid_i, Precalculations& pre, RayK<K>& ray, IntersectContext* context, const Primitive* prim, size_t& lazy_node)
       {
-        const size_t dim_offset    = pre.grid->dim_offset;
-        const size_t line_offset   = pre.grid->width;
-        const float* const grid_x  = pre.grid->decodeLeaf(0,prim);
+        size_t dim_offset, line_offset, lines;
+        float block[GridSOA::QUANTIZED_BLOCK_SIZE];
+        const float* const grid_x  = pre.grid->decodeLeaf(prim,block,dim_offset,line_offset,lines);
         const float* const grid_y  = grid_x + 1 * dim_offset;
         const float* const grid_z  = grid_x + 2 * dim_offset;
         const float* const grid_uv = grid_x + 3 * dim_offset;
 
         vbool<K> valid = valid_i;
-        const size_t max_x = pre.grid->width  == 2 ? 1 : 2;
-        const size_t max_y = pre.grid->height == 2 ? 1 : 2;
+        const size_t max_x = line_offset == 2 ? 1 : 2;
+        const size_t max_y = lines       == 2 ? 1 : 2;
         for (size_t y=0; y<max_y; y++)        
         {
           for (size_t x=0; x<max_x; x++)
@@ -161,12 +161,12 @@ namespace embree
         static __forceinline void intersect(RayK<K>& ray, size_t k,
                                             IntersectContext* context,
                                             const float* const grid_x,
+                                            const size_t dim_offset,
                                             const size_t line_offset,
                                             const size_t lines,
                                             Precalculations& pre)
       {
         typedef typename Loader::vfloat vfloat;
-        const size_t dim_offset    = pre.grid->dim_offset;
         const float* const grid_y  = grid_x + 1 * dim_offset;
         const float* const grid_z  = grid_x + 2 * dim_offset;
         const float* const grid_uv = grid_x + 3 * dim_offset;
@@ -178,12 +178,12 @@ namespace embree
         static __forceinline bool occluded(RayK<K>& ray, size_t k,
                                            IntersectContext* context,
                                            const float* const grid_x,
+                                           const size_t dim_offset,
                                            const size_t line_offset,
                                            const size_t lines,
                                            Precalculations& pre)
       {
         typedef typename Loader::vfloat vfloat;
-        const size_t dim_offset    = pre.grid->dim_offset;
         const float* const grid_y  = grid_x + 1 * dim_offset;
         const float* const grid_z  = grid_x + 2 * dim_offset;
         const float* const grid_uv = grid_x + 3 * dim_offset;
@@ -194,31 +194,32 @@ namespace embree
       /*! Intersect a ray with the primitive. */
       static __forceinline void intersect(Precalculations& pre, RayK<K>& ray, size_t k, IntersectContext* context, const Primitive* prim, size_t& lazy_node)
       {
-        const size_t line_offset   = pre.grid->width;
-        const size_t lines         = pre.grid->height;
-        const float* const grid_x  = pre.grid->decodeLeaf(0,prim);
+        size_t dim_offset, line_offset, lines;
+        float block[GridSOA::QUANTIZED_BLOCK_SIZE];
+        const float* const grid_x  = pre.grid->decodeLeaf(prim,block,dim_offset,line_offset,lines);
+
 #if defined(__AVX__)
-        intersect<GridSOA::Gather3x3>( ray, k, context, grid_x, line_offset, lines, pre);
+        intersect<GridSOA::Gather3x3>( ray, k, context, grid_x, dim_offset, line_offset, lines, pre);
 #else
-        intersect<GridSOA::Gather2x3>(ray, k, context, grid_x            , line_offset, lines, pre);
+        intersect<GridSOA::Gather2x3>(ray, k, context, grid_x            , dim_offset, line_offset, lines, pre);
         if (likely(lines > 2))
-          intersect<GridSOA::Gather2x3>(ray, k, context, grid_x+line_offset, line_offset, lines, pre);
+          intersect<GridSOA::Gather2x3>(ray, k, context, grid_x+line_offset, dim_offset, line_offset, lines, pre);
 #endif
       }
 
       /*! Test if the ray is occluded by the primitive */
       static __forceinline bool occluded(Precalculations& pre, RayK<K>& ray, size_t k, IntersectContext* context, const Primitive* prim, size_t& lazy_node)
       {
-        const size_t line_offset   = pre.grid->width;
-        const size_t lines         = pre.grid->height;
-        const float* const grid_x  = pre.grid->decodeLeaf(0,prim);
+        size_t dim_offset, line_offset, lines;
+        float block[GridSOA::QUANTIZED_BLOCK_SIZE];
+        const float* const grid_x  = pre.grid->decodeLeaf(prim,block,dim_offset,line_offset,lines);
 
 #if defined(__AVX__)
-        return occluded<GridSOA::Gather3x3>( ray, k, context, grid_x, line_offset, lines, pre);
+        return occluded<GridSOA::Gather3x3>( ray, k, context, grid_x, dim_offset, line_offset, lines, pre);
 #else
-        if (occluded<GridSOA::Gather2x3>(ray, k, context, grid_x            , line_offset, lines, pre)) return true;
+        if (occluded<GridSOA::Gather2x3>(ray, k, context, grid_x            , dim_offset, line_offset, lines, pre)) return true;
         if (likely(lines > 2))
-          if (occluded<GridSOA::Gather2x3>(ray, k, context, grid_x+line_offset, line_offset, lines, pre)) return true;
+          if (occluded<GridSOA::Gather2x3>(ray, k, context, grid_x+line_offset, dim_offset, line_offset, lines, pre)) return true;
 #endif
         return false;
       }
@@ -45,19 +45,19 @@ namespace embree
         static __forceinline void intersect(Ray& ray,
                                             IntersectContext* context, 
                                             const float* const grid_x,
+                                            const size_t dim_offset,
                                             const size_t line_offset,
                                             const size_t lines,
                                             Precalculations& pre)
       {
         typedef typename Loader::vfloat vfloat;
-        const size_t dim_offset    = pre.grid->dim_offset;
         const float* const grid_y  = grid_x + 1 * dim_offset;
         const float* const grid_z  = grid_x + 2 * dim_offset;
         const float* const grid_uv = grid_x + 3 * dim_offset;
         Vec3<vfloat> v0, v1, v2;
         Loader::gather(grid_x,grid_y,grid_z,line_offset,lines,v0,v1,v2);       
         GridSOA::MapUV<Loader> mapUV(grid_uv,line_offset,lines);
-        PlueckerIntersector1<Loader::M> intersector(ray,nullptr);
+        PlueckerIntersector1<Loader::M,false> intersector(ray,nullptr);
         intersector.intersect(ray,v0,v1,v2,mapUV,Intersect1EpilogMU<Loader::M,true>(ray,context,pre.grid->geomID(),pre.grid->primID()));
       };
       
@@ -65,12 +65,12 @@ namespace embree
         static __forceinline bool occluded(Ray& ray,
                                            IntersectContext* context, 
                                            const float* const grid_x,
+                                           const size_t dim_offset,
                                            const size_t line_offset,
                                            const size_t lines,
                                            Precalculations& pre)
       {
         typedef typename Loader::vfloat vfloat;
-        const size_t dim_offset    = pre.grid->dim_offset;
         const float* const grid_y  = grid_x + 1 * dim_offset;
         const float* const grid_z  = grid_x + 2 * dim_offset;
         const float* const grid_uv = grid_x + 3 * dim_offset;
@@ -79,39 +79,39 @@ namespace embree
         Loader::gather(grid_x,grid_y,grid_z,line_offset,lines,v0,v1,v2);
         
         GridSOA::MapUV<Loader> mapUV(grid_uv,line_offset,lines);
-        PlueckerIntersector1<Loader::M> intersector(ray,nullptr);
+        PlueckerIntersector1<Loader::M,false> intersector(ray,nullptr);
         return intersector.intersect(ray,v0,v1,v2,mapUV,Occluded1EpilogMU<Loader::M,true>(ray,context,pre.grid->geomID(),pre.grid->primID()));
       }
       
       /*! Intersect a ray with the primitive. */
       static __forceinline void intersect(Precalculations& pre, Ray& ray, IntersectContext* context, const Primitive* prim, size_t& lazy_node) 
       {
-        const size_t line_offset   = pre.grid->width;
-        const size_t lines         = pre.grid->height;
-        const float* const grid_x  = pre.grid->decodeLeaf(0,prim);
+        size_t dim_offset, line_offset, lines;
+        float block[GridSOA::QUANTIZED_BLOCK_SIZE];
+        const float* const grid_x  = pre.grid->decodeLeaf(prim,block,dim_offset,line_offset,lines);
         
 #if defined(__AVX__)
-        intersect<GridSOA::Gather3x3>( ray, context, grid_x, line_offset, lines, pre);
+        intersect<GridSOA::Gather3x3>( ray, context, grid_x, dim_offset, line_offset, lines, pre);
 #else
-        intersect<GridSOA::Gather2x3>(ray, context, grid_x            , line_offset, lines, pre);
+        intersect<GridSOA::Gather2x3>(ray, context, grid_x            , dim_offset, line_offset, lines, pre);
         if (likely(lines > 2))
-          intersect<GridSOA::Gather2x3>(ray, context, grid_x+line_offset, line_offset, lines, pre);
+          intersect<GridSOA::Gather2x3>(ray, context, grid_x+line_offset, dim_offset, line_offset, lines, pre);
 #endif
       }
       
       /*! Test if the ray is occluded by the primitive */
       static __forceinline bool occluded(Precalculations& pre, Ray& ray, IntersectContext* context, const Primitive* prim, size_t& lazy_node) 
       {
-        const size_t line_offset   = pre.grid->width;
-        const size_t lines         = pre.grid->height;
-        const float* const grid_x  = pre.grid->decodeLeaf(0,prim);
+        size_t dim_offset, line_offset, lines;
+        float block[GridSOA::QUANTIZED_BLOCK_SIZE];
+        const float* const grid_x  = pre.grid->decodeLeaf(prim,block,dim_offset,line_offset,lines);
         
 #if defined(__AVX__)
-        return occluded<GridSOA::Gather3x3>( ray, context, grid_x, line_offset, lines, pre);
+        return occluded<GridSOA::Gather3x3>( ray, context, grid_x, dim_offset, line_offset, lines, pre);
 #else
-        if (occluded<GridSOA::Gather2x3>(ray, context, grid_x            , line_offset, lines, pre)) return true;
+        if (occluded<GridSOA::Gather2x3>(ray, context, grid_x            , dim_offset, line_offset, lines, pre)) return true;
         if (likely(lines > 2))
-          if (occluded<GridSOA::Gather2x3>(ray, context, grid_x+line_offset, line_offset, lines, pre)) return true;
+          if (occluded<GridSOA::Gather2x3>(ray, context, grid_x+line_offset, dim_offset, line_offset, lines, pre)) return true;
 #endif
         return false;
       }      
@@ -149,7 +149,7 @@ namespace embree
         Vec3<vfloat> v2 = lerp(a2,b2,vfloat(ftime));
 
         GridSOA::MapUV<Loader> mapUV(grid_uv,line_offset,lines);
-        PlueckerIntersector1<Loader::M> intersector(ray,nullptr);
+        PlueckerIntersector1<Loader::M,false> intersector(ray,nullptr);
         intersector.intersect(ray,v0,v1,v2,mapUV,Intersect1EpilogMU<Loader::M,true>(ray,context,pre.grid->geomID(),pre.grid->primID()));
       };
       
@@ -179,7 +179,7 @@ namespace embree
         Vec3<vfloat> v2 = lerp(a2,b2,vfloat(ftime));
         
         GridSOA::MapUV<Loader> mapUV(grid_uv,line_offset,lines);
-        PlueckerIntersector1<Loader::M> intersector(ray,nullptr);
+        PlueckerIntersector1<Loader::M,false> intersector(ray,nullptr);
         return intersector.intersect(ray,v0,v1,v2,mapUV,Occluded1EpilogMU<Loader::M,true>(ray,context,pre.grid->geomID(),pre.grid->primID()));
       }
       
@@ -21,6 +21,44 @@ namespace embree
 {
   namespace isa
   {
+    /*! number of samples per time segment to bound spherically interpolated instances */
+    static const size_t QUATERNION_BOUNDS_SAMPLES = 16;
+
+    /*! Bounds of a spherically interpolated instance at some timestep.
+     *  The bounds contain all sampled transformations of the adjacent
+     *  time segments, thus linearly interpolating the bounds of two
+     *  timesteps bounds the instance over the entire time segment. The
+     *  bounds get enlarged by half the maximal movement of the corners
+     *  between two samples, which covers the deviation of the rotated
+     *  corners from their linear motion between the samples. */
+    static BBox3fa quaternionBounds(const Instance* instance, size_t itime)
+    {
+      const size_t num_time_segments = instance->numTimeSegments();
+      BBox3fa bounds = empty;
+      float maxMove = 0.0f;
+      for (size_t iseg = itime > 0 ? itime-1 : 0; iseg <= min(itime,num_time_segments-1); iseg++)
+      {
+        Vec3fa prev[8];
+        for (size_t i=0; i<=QUATERNION_BOUNDS_SAMPLES; i++)
+        {
+          const float ftime = (float(iseg) + float(i)/float(QUATERNION_BOUNDS_SAMPLES)) / float(num_time_segments);
+          const AffineSpace3fa xfm = instance->getLocal2World(ftime);
+          const BBox3fa obounds = instance->object->bounds.interpolate(ftime);
+          for (size_t c=0; c<8; c++)
+          {
+            const Vec3fa corner(c & 1 ? obounds.upper.x : obounds.lower.x,
+                                c & 2 ? obounds.upper.y : obounds.lower.y,
+                                c & 4 ? obounds.upper.z : obounds.lower.z);
+            const Vec3fa p = xfmPoint(xfm,corner);
+            bounds.extend(p);
+            if (i > 0) maxMove = max(maxMove,length(p-prev[c]));
+            prev[c] = p;
+          }
+        }
+      }
+      return enlarge(bounds,Vec3fa(0.5f*maxMove));
+    }
+
     void InstanceBoundsFunction(void* userPtr, const Instance* instance, size_t item, size_t itime, BBox3fa& bounds_o)
     {
       assert(itime < instance->numTimeSteps);
@@ -28,6 +66,9 @@ namespace embree
       if (num_time_segments == 0) {
         bounds_o = xfmBounds(instance->local2world[itime],instance->object->bounds.bounds());
       }
+      else if (unlikely(instance->interpolation == RTC_TRANSFORM_INTERPOLATION_QUATERNION)) {
+        bounds_o = quaternionBounds(instance,itime);
+      }
       else {
         const float ftime = float(itime) / float(num_time_segments);
         const BBox3fa obounds = instance->object->bounds.interpolate(ftime);
@@ -39,38 +80,89 @@ namespace embree
       return (RTCBoundsFunc3) InstanceBoundsFunction;
     }
 
+    /* Instance IDs of all instance levels at and below some level,
+     * used to restore the instance IDs of rays that miss an instance */
+    template<typename ID>
+    struct InstanceLevels
+    {
+      /* sets the instance ID of the specified level, invalidates the
+       * instance IDs of all deeper levels, and stores the previous IDs */
+      template<typename Ray>
+      __forceinline void push(Ray& ray, const unsigned level, const unsigned instID)
+      {
+        assert(level < RTC_MAX_INSTANCE_LEVEL_COUNT);
+        for (unsigned l=level; l<RTC_MAX_INSTANCE_LEVEL_COUNT; l++) {
+          ids[l] = ray.instIDLevel(l);
+          ray.instIDLevel(l) = l == level ? instID : RTC_INVALID_GEOMETRY_ID;
+        }
+      }
+
+      /* restores the instance IDs of the specified level and all deeper levels */
+      __forceinline void pop(Ray& ray, const unsigned level) const
+      {
+        for (unsigned l=level; l<RTC_MAX_INSTANCE_LEVEL_COUNT; l++)
+          ray.instIDLevel(l) = ids[l];
+      }
+
+      /* restores the instance IDs of the specified level and all deeper levels for the masked rays */
+      template<int K>
+      __forceinline void pop(const vbool<K>& mask, RayK<K>& ray, const unsigned level) const
+      {
+        for (unsigned l=level; l<RTC_MAX_INSTANCE_LEVEL_COUNT; l++)
+          ray.instIDLevel(l) = select(mask,ids[l],ray.instIDLevel(l));
+      }
+
+      ID ids[RTC_MAX_INSTANCE_LEVEL_COUNT];
+    };
+
+    /* sets the instance ID of the specified level and invalidates the instance IDs of all deeper levels */
+    template<typename Ray>
+    __forceinline void setInstanceLevel(Ray& ray, const unsigned level, const unsigned instID)
+    {
+      assert(level < RTC_MAX_INSTANCE_LEVEL_COUNT);
+      for (unsigned l=level; l<RTC_MAX_INSTANCE_LEVEL_COUNT; l++)
+        ray.instIDLevel(l) = l == level ? instID : RTC_INVALID_GEOMETRY_ID;
+    }
+
     __forceinline void FastInstanceIntersectorN::intersect1(const Instance* instance, const RTCIntersectContext* user_context, Ray& ray, size_t item)
     {
+      const IntersectContext* parent = (const IntersectContext*) user_context;
       const AffineSpace3fa world2local = 
         likely(instance->numTimeSteps == 1) ? instance->getWorld2Local() : instance->getWorld2Local(ray.time);
       const Vec3fa ray_org = ray.org;
       const Vec3fa ray_dir = ray.dir;
       const int ray_geomID = ray.geomID;
-      const int ray_instID = ray.instID;
+      InstanceLevels<unsigned> ray_instIDs;
       ray.org = xfmPoint (world2local,ray_org);
       ray.dir = xfmVector(world2local,ray_dir);
       ray.geomID = RTC_INVALID_GEOMETRY_ID;
-      ray.instID = instance->geomID;
-      IntersectContext context(instance->object,user_context);
+      ray_instIDs.push(ray,parent->instLevel,instance->geomID);
+      IntersectContext context(instance->object,parent->user);
+      context.instLevel = parent->instLevel+1;
+      context.stats = parent->stats;
+      context.hitBuffers = parent->hitBuffers;
       instance->object->intersect((RTCRay&)ray,&context);
       ray.org = ray_org;
       ray.dir = ray_dir;
       if (ray.geomID == RTC_INVALID_GEOMETRY_ID) {
         ray.geomID = ray_geomID;
-        ray.instID = ray_instID;
+        ray_instIDs.pop(ray,parent->instLevel);
       }
     }
     
     __forceinline void FastInstanceIntersectorN::occluded1(const Instance* instance, const RTCIntersectContext* user_context, Ray& ray, size_t item)
     {
+      const IntersectContext* parent = (const IntersectContext*) user_context;
       const AffineSpace3fa world2local = 
         likely(instance->numTimeSteps == 1) ? instance->getWorld2Local() : instance->getWorld2Local(ray.time);
       const Vec3fa ray_org = ray.org;
       const Vec3fa ray_dir = ray.dir;
       ray.org = xfmPoint (world2local,ray_org);
       ray.dir = xfmVector(world2local,ray_dir);
-      ray.instID = instance->geomID;
-      IntersectContext context(instance->object,user_context);
+      setInstanceLevel(ray,parent->instLevel,instance->geomID);
+      IntersectContext context(instance->object,parent->user);
+      context.instLevel = parent->instLevel+1;
+      context.stats = parent->stats;
       instance->object->occluded((RTCRay&)ray,&context);
       ray.org = ray_org;
       ray.dir = ray_dir;
@@ -96,6 +188,7 @@ namespace embree
 
     __noinline void FastInstanceIntersectorN::intersectN(vintx* validi, const Instance* instance, const RTCIntersectContext* user_context, RayK<VSIZEX>& ray, size_t item)
     {
+      const IntersectContext* parent = (const IntersectContext*) user_context;
       AffineSpace3vf<VSIZEX> world2local;
       const vbool<VSIZEX> valid = *validi == vint<VSIZEX>(-1);
       if (likely(instance->numTimeSteps == 1)) world2local = instance->getWorld2Local();
@@ -104,22 +197,26 @@ namespace embree
       const Vec3vf<VSIZEX> ray_org = ray.org;
       const Vec3vf<VSIZEX> ray_dir = ray.dir;
       const vint<VSIZEX> ray_geomID = ray.geomID;
-      const vint<VSIZEX> ray_instID = ray.instID;
+      InstanceLevels<vint<VSIZEX>> ray_instIDs;
       ray.org = xfmPoint (world2local,ray_org);
       ray.dir = xfmVector(world2local,ray_dir);
       ray.geomID = RTC_INVALID_GEOMETRY_ID;
-      ray.instID = instance->geomID;
-      IntersectContext context(instance->object,user_context); 
+      ray_instIDs.push(ray,parent->instLevel,instance->geomID);
+      IntersectContext context(instance->object,parent->user);
+      context.instLevel = parent->instLevel+1;
+      context.stats = parent->stats;
+      context.hitBuffers = parent->hitBuffers;
       intersectObject((vint<VSIZEX>*)validi,instance->object,&context,ray);
       ray.org = ray_org;
       ray.dir = ray_dir;
       vbool<VSIZEX> nohit = ray.geomID == vint<VSIZEX>(RTC_INVALID_GEOMETRY_ID);
       ray.geomID = select(nohit,ray_geomID,ray.geomID);
-      ray.instID = select(nohit,ray_instID,ray.instID);
+      ray_instIDs.pop(nohit,ray,parent->instLevel);
     }
    
     __noinline void FastInstanceIntersectorN::occludedN(vintx* validi, const Instance* instance, const RTCIntersectContext* user_context, RayK<VSIZEX>& ray, size_t item)
     {
+      const IntersectContext* parent = (const IntersectContext*) user_context;
       AffineSpace3vf<VSIZEX> world2local;
       const vbool<VSIZEX> valid = *validi == vint<VSIZEX>(-1);
       if (likely(instance->numTimeSteps == 1)) world2local = instance->getWorld2Local();
@@ -129,8 +226,10 @@ namespace embree
       const Vec3vf<VSIZEX> ray_dir = ray.dir;
       ray.org = xfmPoint (world2local,ray_org);
       ray.dir = xfmVector(world2local,ray_dir);
-      ray.instID = instance->geomID;
-      IntersectContext context(instance->object,user_context);
+      setInstanceLevel(ray,parent->instLevel,instance->geomID);
+      IntersectContext context(instance->object,parent->user);
+      context.instLevel = parent->instLevel+1;
+      context.stats = parent->stats;
       occludedObject((vint<VSIZEX>*)validi,instance->object,&context,ray);
       ray.org = ray_org;
       ray.dir = ray_dir;
@@ -162,8 +261,9 @@ namespace embree
     
     DEFINE_SET_INTERSECTORN(InstanceIntersectorN,FastInstanceIntersectorN);
 
-    void FastInstanceIntersector1M::intersect(const Instance* instance, RTCIntersectContext* context, Ray** rays, size_t M, size_t item)
+    void FastInstanceIntersector1M::intersect(const Instance* instance, RTCIntersectContext* user_context, Ray** rays, size_t M, size_t item)
     {
+      const IntersectContext* parent = (const IntersectContext*) user_context;
       assert(M<=MAX_INTERNAL_STREAM_SIZE);
       Ray lrays[MAX_INTERNAL_STREAM_SIZE];
       AffineSpace3fa world2local = instance->getWorld2Local();
@@ -180,15 +280,26 @@ namespace embree
         lrays[i].time = rays[i]->time;
         lrays[i].mask = rays[i]->mask;
         lrays[i].geomID = RTC_INVALID_GEOMETRY_ID;
-        lrays[i].instID = instance->geomID;
+        for (unsigned l=0; l<parent->instLevel; l++)
+          lrays[i].instIDLevel(l) = rays[i]->instIDLevel(l);
+        setInstanceLevel(lrays[i],parent->instLevel,instance->geomID);
       }
 
-      rtcIntersect1M((RTCScene)instance->object,context,(RTCRay*)lrays,M,sizeof(Ray));
+      IntersectContext context(instance->object,parent->user);
+      context.instLevel = parent->instLevel+1;
+      context.stats = parent->stats;
+      if (likely(M == 1)) {
+        if (likely(lrays[0].tnear <= lrays[0].tfar))
+          instance->object->intersect((RTCRay&)lrays[0],&context);
+      } else {
+        instance->object->device->rayStreamFilters.filterAOS(instance->object,(RTCRay*)lrays,M,sizeof(Ray),&context,true);
+      }
         
       for (size_t i=0; i<M; i++)
       {
         if (lrays[i].geomID == RTC_INVALID_GEOMETRY_ID) continue;
-        rays[i]->instID = lrays[i].instID;
+        for (unsigned l=parent->instLevel; l<RTC_MAX_INSTANCE_LEVEL_COUNT; l++)
+          rays[i]->instIDLevel(l) = lrays[i].instIDLevel(l);
         rays[i]->geomID = lrays[i].geomID;
         rays[i]->primID = lrays[i].primID;
         rays[i]->u = lrays[i].u;
@@ -198,8 +309,9 @@ namespace embree
       }
     }
     
-    void FastInstanceIntersector1M::occluded (const Instance* instance, RTCIntersectContext* context, Ray** rays, size_t M, size_t item)
+    void FastInstanceIntersector1M::occluded (const Instance* instance, RTCIntersectContext* user_context, Ray** rays, size_t M, size_t item)
     {
+      const IntersectContext* parent = (const IntersectContext*) user_context;
       assert(M<MAX_INTERNAL_STREAM_SIZE);
       Ray lrays[MAX_INTERNAL_STREAM_SIZE];
       AffineSpace3fa world2local = instance->getWorld2Local();
@@ -216,10 +328,20 @@ namespace embree
         lrays[i].time = rays[i]->time;
         lrays[i].mask = rays[i]->mask;
         lrays[i].geomID = RTC_INVALID_GEOMETRY_ID;
-        lrays[i].instID = instance->geomID;
+        for (unsigned l=0; l<parent->instLevel; l++)
+          lrays[i].instIDLevel(l) = rays[i]->instIDLevel(l);
+        setInstanceLevel(lrays[i],parent->instLevel,instance->geomID);
       }
 
-      rtcOccluded1M((RTCScene)instance->object,context,(RTCRay*)lrays,M,sizeof(Ray));
+      IntersectContext context(instance->object,parent->user);
+      context.instLevel = parent->instLevel+1;
+      context.stats = parent->stats;
+      if (likely(M == 1)) {
+        if (likely(lrays[0].tnear <= lrays[0].tfar))
+          instance->object->occluded((RTCRay&)lrays[0],&context);
+      } else {
+        instance->object->device->rayStreamFilters.filterAOS(instance->object,(RTCRay*)lrays,M,sizeof(Ray),&context,false);
+      }
         
       for (size_t i=0; i<M; i++)
       {
@@ -54,6 +54,12 @@ namespace embree
 #endif
           hit.finalize();
           int instID = context->geomID_to_instID ? context->geomID_to_instID[0] : geomID;
+
+          /* gather hit of k-nearest hit query */
+          if (filter && unlikely(context->hitBuffers)) {
+            gatherHit1(geometry,ray,context,hit.u,hit.v,hit.t,hit.Ng,instID,primID);
+            return false;
+          }
           
           /* intersection filter test */
 #if defined(EMBREE_INTERSECTION_FILTER)
@@ -133,6 +139,12 @@ namespace embree
             return false;
 #endif
           hit.finalize();
+
+          /* gather hit of k-nearest hit query */
+          if (filter && unlikely(context->hitBuffers)) {
+            gatherHit(geometry,ray,k,context,hit.u,hit.v,hit.t,hit.Ng,geomID,primID);
+            return false;
+          }
           
           /* intersection filter test */
 #if defined(EMBREE_INTERSECTION_FILTER)
@@ -211,6 +223,25 @@ namespace embree
           vbool<Mx> valid = valid_i;          
           if (Mx > M) valid &= (1<<M)-1;
           hit.finalize();          
+
+          /* gather hits of k-nearest hit query */
+          if (filter && unlikely(context->hitBuffers)) 
+          {
+            for (size_t m=movemask(valid); m!=0; ) 
+            {
+              const size_t i = __bscf(m);
+              const int geomID = geomIDs[i];
+              const int instID = context->geomID_to_instID ? context->geomID_to_instID[0] : geomID;
+              Geometry* geometry = scene->get(geomID);
+#if defined(EMBREE_RAY_MASK)
+              if ((geometry->mask & ray.mask) == 0) continue;
+#endif
+              const Vec2f uv = hit.uv(i);
+              gatherHit1(geometry,ray,context,uv.x,uv.y,hit.t(i),hit.Ng(i),instID,primIDs[i]);
+            }
+            return false;
+          }
+
           size_t i = select_min(valid,hit.vt);
           int geomID = geomIDs[i];
           int instID = context->geomID_to_instID ? context->geomID_to_instID[0] : geomID;
@@ -290,6 +321,25 @@ namespace embree
           vbool<Mx> valid = valid_i;
           if (Mx > M) valid &= (1<<M)-1;
           hit.finalize();          
+
+          /* gather hits of k-nearest hit query */
+          if (filter && unlikely(context->hitBuffers)) 
+          {
+            for (size_t m=movemask(valid); m!=0; ) 
+            {
+              const size_t i = __bscf(m);
+              const int geomID = geomIDs[i];
+              const int instID = context->geomID_to_instID ? context->geomID_to_instID[0] : geomID;
+              Geometry* geometry = scene->get(geomID);
+#if defined(EMBREE_RAY_MASK)
+              if ((geometry->mask & ray.mask) == 0) continue;
+#endif
+              const Vec2f uv = hit.uv(i);
+              gatherHit1(geometry,ray,context,uv.x,uv.y,hit.t(i),hit.Ng(i),instID,primIDs[i]);
+            }
+            return false;
+          }
+
           size_t i = select_min(valid,hit.vt);
           int geomID = geomIDs[i];
           int instID = context->geomID_to_instID ? context->geomID_to_instID[0] : geomID;
@@ -434,6 +484,18 @@ namespace embree
           
           vbool<M> valid = valid_i;
           hit.finalize();
+
+          /* gather hits of k-nearest hit query */
+          if (filter && unlikely(context->hitBuffers)) 
+          {
+            for (size_t m=movemask(valid); m!=0; ) 
+            {
+              const size_t i = __bscf(m);
+              const Vec2f uv = hit.uv(i);
+              gatherHit1(geometry,ray,context,uv.x,uv.y,hit.t(i),hit.Ng(i),geomID,primID);
+            }
+            return false;
+          }
           
           size_t i = select_min(valid,hit.vt);
           
@@ -549,6 +611,17 @@ namespace embree
           if (unlikely(none(valid))) return false;
 #endif
           
+          /* gather hits of k-nearest hit query */
+          if (filter && unlikely(context->hitBuffers)) 
+          {
+            for (size_t m=movemask(valid); m!=0; ) 
+            {
+              const size_t k = __bscf(m);
+              gatherHit(geometry,ray,k,context,u[k],v[k],t[k],Vec3fa(Ng.x[k],Ng.y[k],Ng.z[k]),geomID,primID);
+            }
+            return false;
+          }
+          
           /* occlusion filter test */
 #if defined(EMBREE_INTERSECTION_FILTER)
           if (filter) {
@@ -654,6 +727,17 @@ namespace embree
           if (unlikely(none(valid))) return false;
 #endif
           
+          /* gather hits of k-nearest hit query */
+          if (filter && unlikely(context->hitBuffers)) 
+          {
+            for (size_t m=movemask(valid); m!=0; ) 
+            {
+              const size_t k = __bscf(m);
+              gatherHit(geometry,ray,k,context,u[k],v[k],t[k],Vec3fa(Ng.x[k],Ng.y[k],Ng.z[k]),geomID,primID);
+            }
+            return false;
+          }
+          
           /* intersection filter test */
 #if defined(EMBREE_INTERSECTION_FILTER)
           if (filter) {
@@ -747,6 +831,24 @@ namespace embree
           vbool<Mx> valid = valid_i;
           hit.finalize();
           if (Mx > M) valid &= (1<<M)-1;
+
+          /* gather hits of k-nearest hit query */
+          if (filter && unlikely(context->hitBuffers)) 
+          {
+            for (size_t m=movemask(valid); m!=0; ) 
+            {
+              const size_t i = __bscf(m);
+              const int geomID = geomIDs[i];
+              Geometry* geometry = scene->get(geomID);
+#if defined(EMBREE_RAY_MASK)
+              if ((geometry->mask & ray.mask[k]) == 0) continue;
+#endif
+              const Vec2f uv = hit.uv(i);
+              gatherHit(geometry,ray,k,context,uv.x,uv.y,hit.t(i),hit.Ng(i),geomID,primIDs[i]);
+            }
+            return false;
+          }
+
           size_t i = select_min(valid,hit.vt);
           assert(i<M);
           int geomID = geomIDs[i];
@@ -902,6 +1004,19 @@ namespace embree
           /* finalize hit calculation */
           vbool<M> valid = valid_i;
           hit.finalize();
+
+          /* gather hits of k-nearest hit query */
+          if (filter && unlikely(context->hitBuffers)) 
+          {
+            for (size_t m=movemask(valid); m!=0; ) 
+            {
+              const size_t i = __bscf(m);
+              const Vec2f uv = hit.uv(i);
+              gatherHit(geometry,ray,k,context,uv.x,uv.y,hit.t(i),hit.Ng(i),geomID,primID);
+            }
+            return false;
+          }
+
           size_t i = select_min(valid,hit.vt);
           
           /* intersection filter test */
@@ -17,6 +17,7 @@
 #pragma once
 
 #include "object.h"
+#include "filter.h"
 #include "../common/ray.h"
 
 namespace embree
@@ -46,7 +47,15 @@ namespace embree
           return;
 #endif
 
+        const float ray_tfar = ray.tfar;
         accel->intersect(ray,prim.primID(),context);
+
+        /* gather hit of k-nearest hit query, instances never report hits in this mode */
+        if (unlikely(context->hitBuffers) && ray.geomID != RTC_INVALID_GEOMETRY_ID) {
+          const float tfar = insertHit(context->hitBuffers[0],ray.tfar,ray.u,ray.v,ray.Ng,ray.geomID,ray.primID,ray.instID);
+          ray.tfar = min(ray_tfar,tfar);
+          ray.geomID = RTC_INVALID_GEOMETRY_ID;
+        }
       }
       
       static __forceinline bool occluded(const Precalculations& pre, Ray& ray, IntersectContext* context, const Primitive& prim) 
@@ -181,7 +190,22 @@ namespace embree
         valid &= (ray.mask & accel->mask) != 0;
         if (none(valid)) return;
 #endif
+        const vfloat<K> ray_tfar = ray.tfar;
         accel->intersect(valid,ray,prim.primID(),context);
+
+        /* gather hits of k-nearest hit query, instances never report hits in this mode */
+        if (unlikely(context->hitBuffers))
+        {
+          const vbool<K> valid_hit = valid & (ray.geomID != vint<K>(RTC_INVALID_GEOMETRY_ID));
+          for (size_t m=movemask(valid_hit); m!=0; )
+          {
+            const size_t k = __bscf(m);
+            const Vec3fa Ng(ray.Ng.x[k],ray.Ng.y[k],ray.Ng.z[k]);
+            const float tfar = insertHit(context->hitBuffers[k],ray.tfar[k],ray.u[k],ray.v[k],Ng,ray.geomID[k],ray.primID[k],ray.instID[k]);
+            ray.tfar[k] = min(ray_tfar[k],tfar);
+            ray.geomID[k] = RTC_INVALID_GEOMETRY_ID;
+          }
+        }
       }
 
       static __forceinline vbool<K> occluded(const vbool<K>& valid_i, const Precalculations& pre, RayK<K>& ray, IntersectContext* context, const Primitive& prim)
@@ -0,0 +1,168 @@
+// ======================================================================== //
+// Copyright 2009-2017 Intel Corporation                                    //
+//                                                                          //
+// Licensed under the Apache License, Version 2.0 (the "License");          //
+// you may not use this file except in compliance with the License.         //
+// You may obtain a copy of the License at                                  //
+//                                                                          //
+//     http://www.apache.org/licenses/LICENSE-2.0                           //
+//                                                                          //
+// Unless required by applicable law or agreed to in writing, software      //
+// distributed under the License is distributed on an "AS IS" BASIS,        //
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. //
+// See the License for the specific language governing permissions and      //
+// limitations under the License.                                           //
+// ======================================================================== //
+
+#pragma once
+
+#include "triangle.h"
+#include "trianglev.h"
+#include "quadv.h"
+#include "linei.h"
+
+namespace embree
+{
+  namespace isa
+  {
+    /*! Calculates the closest points of M line segments to point p,
+     *  returns the squared distances and the parametric position t of
+     *  the closest points. */
+    template<int M>
+      __forceinline vfloat<M> closestPointSegment(const Vec3vf<M>& p, const Vec3vf<M>& a, const Vec3vf<M>& b, Vec3vf<M>& q, vfloat<M>& t)
+    {
+      const Vec3vf<M> ab = b-a;
+      t = clamp(dot(p-a,ab) / max(dot(ab,ab),vfloat<M>(min_rcp_input)));
+      q = a + t*ab;
+      const Vec3vf<M> d = p-q;
+      return dot(d,d);
+    }
+
+    /*! Calculates the closest points of M triangles (a,b,c) to point p,
+     *  returns the squared distances and the barycentric coordinates
+     *  (u,v) of the closest points, such that q = a + u*(b-a) + v*(c-a). */
+    template<int M>
+      __forceinline vfloat<M> closestPointTriangle(const Vec3vf<M>& p, const Vec3vf<M>& a, const Vec3vf<M>& b, const Vec3vf<M>& c, Vec3vf<M>& q, vfloat<M>& u, vfloat<M>& v)
+    {
+      /* projection of p into the plane of the triangle */
+      const Vec3vf<M> e1 = b-a, e2 = c-a, ap = p-a;
+      const vfloat<M> d11 = dot(e1,e1), d12 = dot(e1,e2), d22 = dot(e2,e2);
+      const vfloat<M> d1p = dot(e1,ap), d2p = dot(e2,ap);
+      const vfloat<M> den = d11*d22-d12*d12;
+      const vfloat<M> pu = (d22*d1p-d12*d2p) / den;
+      const vfloat<M> pv = (d11*d2p-d12*d1p) / den;
+      const vbool<M> inside = (den > vfloat<M>(zero)) & (pu >= vfloat<M>(zero)) & (pv >= vfloat<M>(zero)) & (pu+pv <= vfloat<M>(one));
+      Vec3vf<M> qp = a + pu*e1 + pv*e2;
+      const Vec3vf<M> dp = p-qp;
+      vfloat<M> dist = select(inside,dot(dp,dp),vfloat<M>(pos_inf));
+      q = qp; u = pu; v = pv;
+
+      /* if the projection is outside, the closest point lies on one of the edges */
+      Vec3vf<M> q0,q1,q2; vfloat<M> t0,t1,t2;
+      const vfloat<M> dist0 = closestPointSegment(p,a,b,q0,t0);
+      const vfloat<M> dist1 = closestPointSegment(p,b,c,q1,t1);
+      const vfloat<M> dist2 = closestPointSegment(p,c,a,q2,t2);
+
+      const vbool<M> edge0 = dist0 < dist;
+      dist = select(edge0,dist0,dist); q = select(edge0,q0,q); u = select(edge0,t0,u); v = select(edge0,vfloat<M>(zero),v);
+      const vbool<M> edge1 = dist1 < dist;
+      dist = select(edge1,dist1,dist); q = select(edge1,q1,q); u = select(edge1,vfloat<M>(one)-t1,u); v = select(edge1,t1,v);
+      const vbool<M> edge2 = dist2 < dist;
+      dist = select(edge2,dist2,dist); q = select(edge2,q2,q); u = select(edge2,vfloat<M>(zero),u); v = select(edge2,vfloat<M>(one)-t2,v);
+      return dist;
+    }
+
+    /*! Stores the closest of M points into the point query if it is
+     *  inside the current search radius. */
+    template<int M>
+      __forceinline bool updateClosestPoint(RTCPointQuery& query, float& radius2, const vbool<M>& valid0, const vfloat<M>& dist, const Vec3vf<M>& q,
+                                            const vfloat<M>& u, const vfloat<M>& v, const vint<M>& geomID, const vint<M>& primID)
+    {
+      const vbool<M> valid = valid0 & (dist <= vfloat<M>(radius2));
+      if (likely(none(valid))) return false;
+      const size_t i = select_min(valid,dist);
+      radius2 = dist[i];
+      query.closest[0] = q.x[i];
+      query.closest[1] = q.y[i];
+      query.closest[2] = q.z[i];
+      query.u = u[i];
+      query.v = v[i];
+      query.geomID = geomID[i];
+      query.primID = primID[i];
+      return true;
+    }
+
+    template<int M>
+      struct TriangleMPointQuery1
+    {
+      typedef TriangleM<M> Primitive;
+
+      static __forceinline bool pointQuery(RTCPointQuery& query, const Vec3fa& p, float& radius2, const Scene* scene, const Primitive& tri)
+      {
+        const Vec3vf<M> v0 = tri.v0;
+        const Vec3vf<M> v1 = tri.v0-tri.e1;
+        const Vec3vf<M> v2 = tri.v0+tri.e2;
+        Vec3vf<M> q; vfloat<M> u,v;
+        const vfloat<M> dist = closestPointTriangle(Vec3vf<M>(p),v0,v1,v2,q,u,v);
+        return updateClosestPoint(query,radius2,tri.valid(),dist,q,u,v,tri.geomID(),tri.primID());
+      }
+    };
+
+    template<int M>
+      struct TriangleMvPointQuery1
+    {
+      typedef TriangleMv<M> Primitive;
+
+      static __forceinline bool pointQuery(RTCPointQuery& query, const Vec3fa& p, float& radius2, const Scene* scene, const Primitive& tri)
+      {
+        Vec3vf<M> q; vfloat<M> u,v;
+        const vfloat<M> dist = closestPointTriangle(Vec3vf<M>(p),tri.v0,tri.v1,tri.v2,q,u,v);
+        return updateClosestPoint(query,radius2,tri.valid(),dist,q,u,v,tri.geomID(),tri.primID());
+      }
+    };
+
+    /*! The quad (v0,v1,v2,v3) gets split into the triangles (v0,v1,v3)
+     *  and (v2,v3,v1), the uv coordinates of the second triangle get
+     *  flipped like in the quad intersectors. */
+    template<int M>
+      struct QuadMvPointQuery1
+    {
+      typedef QuadMv<M> Primitive;
+
+      static __forceinline bool pointQuery(RTCPointQuery& query, const Vec3fa& p, float& radius2, const Scene* scene, const Primitive& quad)
+      {
+        const Vec3vf<M> vp(p);
+        Vec3vf<M> q0,q1; vfloat<M> u0,v0,u1,v1;
+        const vfloat<M> dist0 = closestPointTriangle(vp,quad.v0,quad.v1,quad.v3,q0,u0,v0);
+        const vfloat<M> dist1 = closestPointTriangle(vp,quad.v2,quad.v3,quad.v1,q1,u1,v1);
+        const vbool<M> second = dist1 < dist0;
+        const vfloat<M> dist = select(second,dist1,dist0);
+        const Vec3vf<M> q = select(second,q1,q0);
+        const vfloat<M> u = select(second,vfloat<M>(one)-u1,u0);
+        const vfloat<M> v = select(second,vfloat<M>(one)-v1,v0);
+        return updateClosestPoint(query,radius2,quad.valid(),dist,q,u,v,quad.geomID(),quad.primID());
+      }
+    };
+
+    /*! Line segments are treated as capsules whose radius is linearly
+     *  interpolated at the closest point of the center line. */
+    template<int M>
+      struct LineMiPointQuery1
+    {
+      typedef LineMi<M> Primitive;
+
+      static __forceinline bool pointQuery(RTCPointQuery& query, const Vec3fa& p, float& radius2, const Scene* scene, const Primitive& line)
+      {
+        const Vec3vf<M> vp(p);
+        Vec4vf<M> a,b; line.gather(a,b,scene);
+        Vec3vf<M> c; vfloat<M> t;
+        const vfloat<M> distc = sqrt(closestPointSegment(vp,Vec3vf<M>(a.x,a.y,a.z),Vec3vf<M>(b.x,b.y,b.z),c,t));
+        const vfloat<M> r = a.w + t*(b.w-a.w);
+        const vbool<M> outside = distc > r;
+        const vfloat<M> d = select(outside,distc-r,vfloat<M>(zero));
+        const Vec3vf<M> q = select(outside,c+(vp-c)*(r/distc),vp);
+        return updateClosestPoint(query,radius2,line.valid(),d*d,q,t,vfloat<M>(zero),line.geomID(),line.primID());
+      }
+    };
+  }
+}
@@ -17,6 +17,7 @@
 #pragma once
 
 #include "quad_intersector_moeller.h"
+#include "triangle_intersector_pluecker.h"
 
 /*! Modified Pluecker ray/triangle intersector. The test first shifts
  *  the ray origin into the origin of the coordinate system and then
@@ -176,6 +177,10 @@ namespace embree
           valid &= absDen*vfloat<M>(ray.tnear) < (T^sgnDen);
           valid &= (T^sgnDen) <= absDen*vfloat<M>(ray.tfar);
           if (unlikely(none(valid))) return false;
+
+          /* ignore the surface the ray starts on */
+          valid &= pluecker_hit_off_origin<M>(T,den,D,vfloat<M>(max(abs(ray.org.x),abs(ray.org.y),abs(ray.org.z))));
+          if (unlikely(none(valid))) return false;
           
           /* avoid division by 0 */
           valid &= den != vfloat<M>(zero);
@@ -355,6 +360,10 @@ namespace embree
           valid &= absDen*vfloat<M>(ray.tnear[k]) < (T^sgnDen);
           valid &= (T^sgnDen) <= absDen*vfloat<M>(ray.tfar[k]);
           if (unlikely(none(valid))) return false;
+
+          /* ignore the surface the ray starts on */
+          valid &= pluecker_hit_off_origin<M>(T,den,D,vfloat<M>(max(abs(ray.org.x[k]),abs(ray.org.y[k]),abs(ray.org.z[k]))));
+          if (unlikely(none(valid))) return false;
           
           /* avoid division by 0 */
           valid &= den != vfloat<M>(zero);
@@ -419,6 +428,10 @@ namespace embree
           valid &= absDen*ray.tnear < (T^sgnDen);
           valid &= (T^sgnDen) <= absDen*ray.tfar;
           if (unlikely(none(valid))) return false;
+
+          /* ignore the surface the ray starts on */
+          valid &= pluecker_hit_off_origin<K>(T,den,D,max(abs(O.x),abs(O.y),abs(O.z)));
+          if (unlikely(none(valid))) return false;
           
           /* avoid division by 0 */
           valid &= den != vfloat<K>(zero);
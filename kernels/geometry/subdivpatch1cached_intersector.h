@@ -30,11 +30,14 @@ namespace embree
     { 
     public:
       __forceinline SubdivPatch1CachedPrecalculations (const Ray& ray, const void* ptr)
-        : T(ray,ptr) {}
+        : T(ray,ptr), cache(nullptr) {}
       
       __forceinline ~SubdivPatch1CachedPrecalculations() {
-        if (cached && this->grid) SharedLazyTessellationCache::sharedLazyTessellationCache.unlock();
+        if (cached && this->grid) cache->unlock();
       }
+
+    public:
+      SharedLazyTessellationCache* cache; //!< tessellation cache locked while the grid is used
     };
 
     template<int K, typename T, bool cached>
@@ -42,13 +45,63 @@ namespace embree
     { 
     public:
       __forceinline SubdivPatch1CachedPrecalculationsK (const vbool<K>& valid, RayK<K>& ray)
-        : T(valid,ray) {}
+        : T(valid,ray), cache(nullptr) {}
       
       __forceinline ~SubdivPatch1CachedPrecalculationsK() {
-        if (cached && this->grid) SharedLazyTessellationCache::sharedLazyTessellationCache.unlock();
+        if (cached && this->grid) cache->unlock();
       }
+
+    public:
+      SharedLazyTessellationCache* cache; //!< tessellation cache locked while the grid is used
     };
 
+    /*! Unlocks the tessellation cache for the previously used grid and
+     *  returns the tessellation cache of the device of the scene. */
+    template<typename Precalculations>
+      __forceinline SharedLazyTessellationCache* getTessellationCache(Precalculations& pre, IntersectContext* context)
+    {
+      if (pre.grid) pre.cache->unlock();
+      pre.cache = context->scene->device->tessellation_cache.get();
+      return pre.cache;
+    }
+
+    /*! Looks up the grid of a patch in the tessellation cache. If the
+     *  tessellation level is selected by the ray cone, a missing grid
+     *  is first tessellated at the coarsest level of detail, which
+     *  provides the corners of the patch to compute the level of
+     *  detail required by the ray footprint. The cached grid is only
+     *  re-tessellated if it is coarser than required, thus a grid
+     *  finer than required gets reused. */
+    template<typename LOD>
+      __forceinline GridSOA* lookupGrid(SharedLazyTessellationCache* cache, IntersectContext* context, SubdivPatch1Cached* prim, const LOD& requiredLOD)
+    {
+      Scene* scene = context->scene;
+      auto alloc = [&] (const size_t bytes) { return cache->malloc(bytes); };
+      auto create = [&] (const unsigned lod) -> GridSOA* 
+      {
+        if (likely(lod == 0))
+          return GridSOA::create((SubdivPatch1Base*)prim,1,scene,alloc);
+
+        const SubdivPatch1Base patch(*prim,lod,VSIZEX);
+        GridSOA* grid = GridSOA::create(&patch,1,scene,alloc);
+        grid->lod = lod;
+        return grid;
+      };
+
+      const bool cone = context->hasRayCone();
+      GridSOA* grid = (GridSOA*) cache->lookup(prim->entry(),scene->commitCounterSubdiv,[&] () {
+          return create(cone ? prim->maxLOD() : 0);
+        });
+      if (likely(grid->lod == 0)) 
+        return grid;
+
+      const unsigned lod = cone ? requiredLOD(grid) : 0;
+      if (lod >= grid->lod) 
+        return grid;
+
+      return cache->replace(prim->entry(),scene->commitCounterSubdiv,grid,[&] () { return create(lod); });
+    }
+
     template<bool cached>
       class SubdivPatch1CachedIntersector1
     {
@@ -56,17 +109,15 @@ namespace embree
       typedef SubdivPatch1Cached Primitive;
       typedef SubdivPatch1CachedPrecalculations<GridSOAIntersector1::Precalculations,cached> Precalculations;
 
-      static __forceinline bool processLazyNode(Precalculations& pre, IntersectContext* context, const Primitive* prim_i, size_t& lazy_node)
+      static __forceinline bool processLazyNode(Precalculations& pre, const Ray& ray, IntersectContext* context, const Primitive* prim_i, size_t& lazy_node)
       {
         Primitive* prim = (Primitive*) prim_i;
         GridSOA* grid = nullptr;
         if (cached) 
         {          
-          Scene* scene = context->scene;
-          if (pre.grid) SharedLazyTessellationCache::sharedLazyTessellationCache.unlock();
-          grid = (GridSOA*) SharedLazyTessellationCache::lookup(prim->entry(),scene->commitCounterSubdiv,[&] () {
-              auto alloc = [] (const size_t bytes) { return SharedLazyTessellationCache::sharedLazyTessellationCache.malloc(bytes); };
-              return GridSOA::create((SubdivPatch1Base*)prim,1,scene,alloc);
+          SharedLazyTessellationCache* cache = getTessellationCache(pre,context);
+          grid = lookupGrid(cache,context,prim,[&] (const GridSOA* grid) {
+              return grid->getLOD(prim,ray.org,context->user->coneWidth,context->user->coneSpread);
             });
         }
         else {
@@ -81,7 +132,7 @@ namespace embree
       static __forceinline void intersect(Precalculations& pre, Ray& ray, IntersectContext* context, const Primitive* prim, size_t ty, size_t& lazy_node) 
       {
         if (likely(ty == 0)) GridSOAIntersector1::intersect(pre,ray,context,prim,lazy_node);
-        else                 processLazyNode(pre,context,prim,lazy_node);
+        else                 processLazyNode(pre,ray,context,prim,lazy_node);
       }
       static __forceinline void intersect(Precalculations& pre, Ray& ray, IntersectContext* context, size_t ty0, const Primitive* prim, size_t ty, size_t& lazy_node) {
         intersect(pre,ray,context,prim,lazy_node);
@@ -91,7 +142,7 @@ namespace embree
       static __forceinline bool occluded(Precalculations& pre, Ray& ray, IntersectContext* context, const Primitive* prim, size_t ty, size_t& lazy_node) 
       {
         if (likely(ty == 0)) return GridSOAIntersector1::occluded(pre,ray,context,prim,lazy_node);
-        else                 return processLazyNode(pre,context,prim,lazy_node);
+        else                 return processLazyNode(pre,ray,context,prim,lazy_node);
       }
       static __forceinline bool occluded(Precalculations& pre, Ray& ray, IntersectContext* context, size_t ty0, const Primitive* prim, size_t ty, size_t& lazy_node) {
         return occluded(pre,ray,context,prim,ty,lazy_node);
@@ -112,9 +163,9 @@ namespace embree
         if (cached) 
         {
           Scene* scene = context->scene;
-          if (pre.grid) SharedLazyTessellationCache::sharedLazyTessellationCache.unlock();
-          grid = (GridSOA*) SharedLazyTessellationCache::lookup(prim->entry(),scene->commitCounterSubdiv,[&] () {
-              auto alloc = [] (const size_t bytes) { return SharedLazyTessellationCache::sharedLazyTessellationCache.malloc(bytes); };
+          SharedLazyTessellationCache* cache = getTessellationCache(pre,context);
+          grid = (GridSOA*) cache->lookup(prim->entry(),scene->commitCounterSubdiv,[&] () {
+              auto alloc = [&] (const size_t bytes) { return cache->malloc(bytes); };
               const unsigned num_time_steps = (unsigned)scene->get<SubdivMesh>(prim->geomID())->numTimeSteps;
               return GridSOA::create((SubdivPatch1Base*)prim,num_time_steps,scene,alloc);
             });
@@ -155,17 +206,22 @@ namespace embree
       typedef SubdivPatch1Cached Primitive;
       typedef SubdivPatch1CachedPrecalculationsK<K,typename GridSOAIntersectorK<K>::Precalculations,cached> Precalculations;
       
-      static __forceinline bool processLazyNode(Precalculations& pre, IntersectContext* context, const Primitive* prim_i, size_t& lazy_node)
+      /*! the packet uses the finest level of detail required by any of its active rays */
+      static __forceinline bool processLazyNode(Precalculations& pre, size_t mask, const RayK<K>& ray, IntersectContext* context, const Primitive* prim_i, size_t& lazy_node)
       {
         Primitive* prim = (Primitive*) prim_i;
         GridSOA* grid = nullptr;
         if (cached)
         {
-          Scene* scene = context->scene;
-          if (pre.grid) SharedLazyTessellationCache::sharedLazyTessellationCache.unlock();
-          grid = (GridSOA*) SharedLazyTessellationCache::lookup(prim->entry(),scene->commitCounterSubdiv,[&] () {
-              auto alloc = [] (const size_t bytes) { return SharedLazyTessellationCache::sharedLazyTessellationCache.malloc(bytes); };
-              return GridSOA::create((SubdivPatch1Base*)prim,1,scene,alloc);
+          SharedLazyTessellationCache* cache = getTessellationCache(pre,context);
+          grid = lookupGrid(cache,context,prim,[&] (const GridSOA* grid) {
+              unsigned lod = prim->maxLOD();
+              for (size_t m=mask; m!=0; ) {
+                const size_t k = __bscf(m);
+                const Vec3fa org(ray.org.x[k],ray.org.y[k],ray.org.z[k]);
+                lod = min(lod,grid->getLOD(prim,org,context->user->coneWidth,context->user->coneSpread));
+              }
+              return lod;
             });
         }
         else {
@@ -179,25 +235,25 @@ namespace embree
       static __forceinline void intersect(const vbool<K>& valid, Precalculations& pre, RayK<K>& ray, IntersectContext* context, const Primitive* prim, size_t ty, size_t& lazy_node)
       {
         if (likely(ty == 0)) GridSOAIntersectorK<K>::intersect(valid,pre,ray,context,prim,lazy_node);
-        else                 processLazyNode(pre,context,prim,lazy_node);
+        else                 processLazyNode(pre,movemask(valid),ray,context,prim,lazy_node);
       }
       
       static __forceinline vbool<K> occluded(const vbool<K>& valid, Precalculations& pre, RayK<K>& ray, IntersectContext* context, const Primitive* prim, size_t ty, size_t& lazy_node)
       {
         if (likely(ty == 0)) return GridSOAIntersectorK<K>::occluded(valid,pre,ray,context,prim,lazy_node);
-        else                 return processLazyNode(pre,context,prim,lazy_node);
+        else                 return processLazyNode(pre,movemask(valid),ray,context,prim,lazy_node);
       }
       
       static __forceinline void intersect(Precalculations& pre, RayK<K>& ray, size_t k, IntersectContext* context, const Primitive* prim, size_t ty, size_t& lazy_node)
       {
         if (likely(ty == 0)) GridSOAIntersectorK<K>::intersect(pre,ray,k,context,prim,lazy_node);
-        else                 processLazyNode(pre,context,prim,lazy_node);
+        else                 processLazyNode(pre,(size_t)1 << k,ray,context,prim,lazy_node);
       }
       
       static __forceinline bool occluded(Precalculations& pre, RayK<K>& ray, size_t k, IntersectContext* context, const Primitive* prim, size_t ty, size_t& lazy_node)
       {
         if (likely(ty == 0)) return GridSOAIntersectorK<K>::occluded(pre,ray,k,context,prim,lazy_node);
-        else                 return processLazyNode(pre,context,prim,lazy_node);
+        else                 return processLazyNode(pre,(size_t)1 << k,ray,context,prim,lazy_node);
       }
     };
 
@@ -222,9 +278,9 @@ namespace embree
         if (cached)
         {
           Scene* scene = context->scene;
-          if (pre.grid) SharedLazyTessellationCache::sharedLazyTessellationCache.unlock();
-          grid = (GridSOA*) SharedLazyTessellationCache::lookup(prim->entry(),scene->commitCounterSubdiv,[&] () {
-              auto alloc = [] (const size_t bytes) { return SharedLazyTessellationCache::sharedLazyTessellationCache.malloc(bytes); };
+          SharedLazyTessellationCache* cache = getTessellationCache(pre,context);
+          grid = (GridSOA*) cache->lookup(prim->entry(),scene->commitCounterSubdiv,[&] () {
+              auto alloc = [&] (const size_t bytes) { return cache->malloc(bytes); };
               const unsigned num_time_steps = (unsigned)scene->get<SubdivMesh>(prim->geomID())->numTimeSteps;
               return GridSOA::create((SubdivPatch1Base*)prim,num_time_steps,scene,alloc);
             });
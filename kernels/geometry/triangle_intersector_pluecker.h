@@ -32,6 +32,21 @@ namespace embree
 {
   namespace isa
   {
+    /*! Rejects hits closer to the ray origin than the floating point
+     *  error of the origin coordinates. Hit points computed as
+     *  org+t*dir in single precision are only accurate up to a few
+     *  ulps of their largest coordinate, thus far away from the
+     *  coordinate origin rays spawned at a hit point would otherwise
+     *  re-intersect the surface they start on. As T/den is the hit
+     *  distance we compare T^2*|D|^2 against (err*den)^2 to avoid the
+     *  division. */
+    template<int M>
+      __forceinline vbool<M> pluecker_hit_off_origin(const vfloat<M>& T, const vfloat<M>& den, const Vec3vf<M>& D, const vfloat<M>& orgMax)
+    {
+      const vfloat<M> err = vfloat<M>(8.0f*float(ulp))*orgMax*den;
+      return T*T*dot(D,D) > err*err;
+    }
+
     template<int M, typename UVMapper>
       struct PlueckerHitM
     {
@@ -67,7 +82,9 @@ namespace embree
       Vec3vf<M> vNg;
     };
 
-    template<int M>
+    /*! The robust flag enables the rejection of the surface the ray
+     *  starts on, see pluecker_hit_off_origin. */
+    template<int M, bool robust = true>
       struct PlueckerIntersector1
       {
         __forceinline PlueckerIntersector1() {}
@@ -119,6 +136,12 @@ namespace embree
           valid &= absDen*vfloat<M>(ray.tnear) < (T^sgnDen);
           valid &= (T^sgnDen) <= absDen*vfloat<M>(ray.tfar);
           if (unlikely(none(valid))) return false;
+
+          /* ignore the surface the ray starts on */
+          if (robust) {
+            valid &= pluecker_hit_off_origin<M>(T,den,D,vfloat<M>(max(abs(ray.org.x),abs(ray.org.y),abs(ray.org.z))));
+            if (unlikely(none(valid))) return false;
+          }
           
           /* avoid division by 0 */
           valid &= den != vfloat<M>(zero);
@@ -157,7 +180,7 @@ namespace embree
       const UVMapper& mapUV;
     };
     
-    template<int M, int K>
+    template<int M, int K, bool robust = true>
       struct PlueckerIntersectorK
       {
         __forceinline PlueckerIntersectorK(const vbool<K>& valid, const RayK<K>& ray) {}
@@ -210,6 +233,12 @@ namespace embree
           valid &= absDen*ray.tnear < (T^sgnDen);
           valid &= (T^sgnDen) <= absDen*ray.tfar;
           if (unlikely(none(valid))) return false;
+
+          /* ignore the surface the ray starts on */
+          if (robust) {
+            valid &= pluecker_hit_off_origin<K>(T,den,D,max(abs(O.x),abs(O.y),abs(O.z)));
+            if (unlikely(none(valid))) return false;
+          }
           
           /* avoid division by 0 */
           valid &= den != vfloat<K>(zero);
@@ -266,6 +295,12 @@ namespace embree
           valid &= absDen*vfloat<M>(ray.tnear[k]) < (T^sgnDen);
           valid &= (T^sgnDen) <= absDen*vfloat<M>(ray.tfar[k]);
           if (unlikely(none(valid))) return false;
+
+          /* ignore the surface the ray starts on */
+          if (robust) {
+            valid &= pluecker_hit_off_origin<M>(T,den,D,vfloat<M>(max(abs(ray.org.x[k]),abs(ray.org.y[k]),abs(ray.org.z[k]))));
+            if (unlikely(none(valid))) return false;
+          }
           
           /* avoid division by 0 */
           valid &= den != vfloat<M>(zero);
@@ -32,27 +32,27 @@ namespace embree
         typedef typename Patch::Ref Ref;
         typedef CatmullClarkPatchT<Vertex,Vertex_t> CatmullClarkPatch;
 
-        PatchEvalSimd (SharedLazyTessellationCache::CacheEntry& entry, size_t commitCounter, 
+        PatchEvalSimd (SharedLazyTessellationCache& cache, SharedLazyTessellationCache::CacheEntry& entry, size_t commitCounter, 
                        const HalfEdge* edge, const char* vertices, size_t stride, const vbool& valid0, const vfloat& u, const vfloat& v, 
                        float* P, float* dPdu, float* dPdv, float* ddPdudu, float* ddPdvdv, float* ddPdudv, const size_t dstride, const size_t N)
         : P(P), dPdu(dPdu), dPdv(dPdv), ddPdudu(ddPdudu), ddPdvdv(ddPdvdv), ddPdudv(ddPdudv), dstride(dstride), N(N)
         {
           /* conservative time for the very first allocation */
-          auto time = SharedLazyTessellationCache::sharedLazyTessellationCache.getTime(commitCounter);
+          auto time = cache.getTime(commitCounter);
 
-          Ref patch = SharedLazyTessellationCache::lookup(entry,commitCounter,[&] () {
-              auto alloc = [](size_t bytes) { return SharedLazyTessellationCache::malloc(bytes); };
+          Ref patch = cache.lookup(entry,commitCounter,[&] () {
+              auto alloc = [&](size_t bytes) { return cache.malloc(bytes); };
               return Patch::create(alloc,edge,vertices,stride);
             }, true);
 
-          auto curTime = SharedLazyTessellationCache::sharedLazyTessellationCache.getTime(commitCounter);
-          const bool allAllocationsValid = SharedLazyTessellationCache::validTime(time,curTime);
+          auto curTime = cache.getTime(commitCounter);
+          const bool allAllocationsValid = cache.validTime(time,curTime);
           
           patch = allAllocationsValid ? patch : nullptr;
 
           /* use cached data structure for calculations */
           const vbool valid1 = patch ? eval(valid0,patch,u,v,1.0f,0) : vbool(false);
-          SharedLazyTessellationCache::unlock();
+          cache.unlock();
           const vbool valid2 = valid0 & !valid1;
           if (any(valid2)) {
             FeatureAdaptiveEvalSimd<vbool,vint,vfloat,Vertex,Vertex_t>(edge,vertices,stride,valid2,u,v,P,dPdu,dPdv,ddPdudu,ddPdvdv,ddPdudv,dstride,N);
@@ -70,6 +70,21 @@ namespace embree
     updateEdgeLevels(edge_level,subdiv,mesh,simd_width);
   }
 
+  SubdivPatch1Base::SubdivPatch1Base (const SubdivPatch1Base& patch, const unsigned lod, const int simd_width)
+    : flags(patch.flags), type(patch.type), geom(patch.geom), prim(patch.prim), time_(patch.time_)
+  {
+    for (size_t i=0; i<4; i++) {
+      u[i] = patch.u[i];
+      v[i] = patch.v[i];
+      level[i] = max(ceilf(patch.level[i]/float(1 << lod)),1.0f);
+    }
+    for (size_t y=0; y<4; y++)
+      for (size_t x=0; x<4; x++)
+        patch_v[y][x] = patch.patch_v[y][x];
+
+    updateGridSize(simd_width);
+  }
+
   void SubdivPatch1Base::computeEdgeLevels(const float edge_level[4], const int subdiv[4], float level[4])
   {
     /* init discrete edge tessellation levels and grid resolution */
@@ -103,6 +118,12 @@ namespace embree
       level[i] = new_level[i];
     }
 
+    updateGridSize(simd_width);
+    return grid_changed;
+  }
+
+  void SubdivPatch1Base::updateGridSize(const int simd_width)
+  {
     /* compute grid resolution */
     Vec2i res = computeGridSize(level);
     grid_u_res = res.x; grid_v_res = res.y;
@@ -120,7 +141,5 @@ namespace embree
 	int_edge_points3 < (int)grid_v_res) {
       flags |= TRANSITION_PATCH;
     }
-
-    return grid_changed;
   }
 }
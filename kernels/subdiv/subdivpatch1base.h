@@ -68,10 +68,25 @@ namespace embree
       return Vec2f((float)u[i],(float)v[i]) * (8.0f/0x10000);
     }
 
+    /*! Creates a copy of the patch whose edge levels are reduced by a factor of 2^lod. */
+    SubdivPatch1Base (const SubdivPatch1Base& patch, const unsigned lod, const int simd_width);
+
     static void computeEdgeLevels(const float edge_level[4], const int subdiv[4], float level[4]);
     static Vec2i computeGridSize(const float level[4]);
     bool updateEdgeLevels(const float edge_level[4], const int subdiv[4], const SubdivMesh *const mesh, const int simd_width);
 
+    /*! returns how often the edge levels can get halved until all edges consist of a single segment */
+    __forceinline unsigned maxLOD() const 
+    {
+      const float max_level = max(level[0],level[1],level[2],level[3]);
+      unsigned lod = 0;
+      while (float(1 << lod) < max_level) lod++;
+      return lod;
+    }
+
+  private:
+    void updateGridSize(const int simd_width);
+
   public:
 
     __forceinline size_t getGridBytes() const {
@@ -18,43 +18,30 @@
 
 namespace embree
 {
-  SharedLazyTessellationCache SharedLazyTessellationCache::sharedLazyTessellationCache;
+  __thread SharedLazyTessellationCache::ThreadStateSlot SharedLazyTessellationCache::t_states[SharedLazyTessellationCache::NUM_THREAD_STATE_SLOTS];
+  __thread size_t SharedLazyTessellationCache::t_next_slot = 0;
 
-  __thread ThreadWorkState* SharedLazyTessellationCache::init_t_state = nullptr;
-  ThreadWorkState* SharedLazyTessellationCache::current_t_state = nullptr;
+  /* IDs are never reused, thus the slots of a thread never refer to a destroyed cache */
+  static std::atomic<size_t> g_next_cache_id(1);
+  static std::atomic<size_t> g_next_thread_id(1);
+  static __thread size_t t_thread_id = 0;
 
-  void resizeTessellationCache(size_t new_size)
-  {    
-    if (new_size >= SharedLazyTessellationCache::MAX_TESSELLATION_CACHE_SIZE)
-      new_size = SharedLazyTessellationCache::MAX_TESSELLATION_CACHE_SIZE;
-    if (SharedLazyTessellationCache::sharedLazyTessellationCache.getSize() != new_size) 
-      SharedLazyTessellationCache::sharedLazyTessellationCache.realloc(new_size);    
-  }
-
-  void resetTessellationCache()
-  {
-    //SharedLazyTessellationCache::sharedLazyTessellationCache.addCurrentIndex(SharedLazyTessellationCache::NUM_CACHE_SEGMENTS);
-    SharedLazyTessellationCache::sharedLazyTessellationCache.reset();
-  }
-  
-  SharedLazyTessellationCache::SharedLazyTessellationCache()
+  SharedLazyTessellationCache::SharedLazyTessellationCache(size_t segments)
   {
     size = 0;
     data = nullptr;
     hugepages = false;
     maxBlocks              = size/BLOCK_SIZE;
-    localTime              = NUM_CACHE_SEGMENTS;
-    next_block             = 0;
+    numSegments            = 1;
+    while (2*numSegments <= min(segments,MAX_CACHE_SEGMENTS)) numSegments *= 2;
+    segmentBlocks          = maxBlocks/numSegments;
+    cacheID                = g_next_cache_id.fetch_add(1);
+    localTime              = numSegments;
+    alloc_state            = allocState(localTime);
+    current_t_state        = nullptr;
     numRenderThreads       = 0;
-#if FORCE_SIMPLE_FLUSH == 1
-    switch_block_threshold = maxBlocks;
-#else
-    switch_block_threshold = maxBlocks/NUM_CACHE_SEGMENTS;
-#endif
+    flushes                = 0;
     threadWorkState     = new ThreadWorkState[NUM_PREALLOC_THREAD_WORK_STATES];
-
-    //reset_state.reset();
-    //linkedlist_mtx.reset();
   }
 
   SharedLazyTessellationCache::~SharedLazyTessellationCache() 
@@ -67,19 +54,36 @@ namespace embree
     }
 
     delete[] threadWorkState;
+    if (data) os_free(data,size,hugepages);
   }
 
-  void SharedLazyTessellationCache::getNextRenderThreadWorkState() 
+  ThreadWorkState* SharedLazyTessellationCache::getThreadWorkState() 
   {
-    const size_t id = numRenderThreads.fetch_add(1); 
-    if (id >= NUM_PREALLOC_THREAD_WORK_STATES) init_t_state = new ThreadWorkState(true);
-    else                                       init_t_state = &threadWorkState[id];
-    
-    /* critical section for updating link list with new thread state */
+    if (unlikely(t_thread_id == 0))
+      t_thread_id = g_next_thread_id.fetch_add(1);
+
+    /* critical section for searching and updating link list of thread states */
     linkedlist_mtx.lock();
-    init_t_state->next = current_t_state;
-    current_t_state = init_t_state;
+    ThreadWorkState* t_state = current_t_state;
+    while (t_state && t_state->threadID != t_thread_id) 
+      t_state = t_state->next;
+
+    if (t_state == nullptr)
+    {
+      const size_t id = numRenderThreads.fetch_add(1); 
+      if (id >= NUM_PREALLOC_THREAD_WORK_STATES) t_state = new ThreadWorkState(true);
+      else                                       t_state = &threadWorkState[id];
+      t_state->threadID = t_thread_id;
+      t_state->next = current_t_state;
+      current_t_state = t_state;
+    }
     linkedlist_mtx.unlock();
+
+    /* remember the state of this cache in place of the least recently registered cache */
+    ThreadStateSlot& slot = t_states[t_next_slot++ % NUM_THREAD_STATE_SLOTS];
+    slot.cacheID = cacheID;
+    slot.state = t_state;
+    return t_state;
   }
 
   void SharedLazyTessellationCache::waitForUsersLessEqual(ThreadWorkState *const t_state,
@@ -94,47 +98,38 @@ namespace embree
      }
    }
 
-  void SharedLazyTessellationCache::allocNextSegment() 
+  void SharedLazyTessellationCache::waitForUsersBefore(ThreadWorkState *const t_state,
+                                                       const size_t time)
+  {
+    while (t_state->counter.load() != 0 && t_state->epoch.load() < time)
+    {
+      _mm_pause();
+      _mm_pause();
+      _mm_pause();
+      _mm_pause();
+    }
+  }
+
+  void SharedLazyTessellationCache::allocNextSegment(const size_t segment) 
   {
     if (reset_state.try_lock())
     {
-      if (next_block >= switch_block_threshold)
+      if (getSegment() == segment)
       {
-        /* lock the linked list of thread states */
-        
-        linkedlist_mtx.lock();
+        /* invalidate the next segment, lookups starting from now do not return its data */
+        const size_t time = localTime.fetch_add(1)+1;
         
-        /* block all threads */
+        /* wait for threads that locked the cache earlier and may still
+         * use data of the next segment, threads that lock the cache
+         * from now on do not get blocked, the list of thread states is
+         * only ever extended at its head, thus can be traversed without
+         * locking */
         for (ThreadWorkState *t=current_t_state;t!=nullptr;t=t->next)
-          if (lockThread(t,THREAD_BLOCK_ATOMIC_ADD) != 0)
-            waitForUsersLessEqual(t,THREAD_BLOCK_ATOMIC_ADD);
-        
-        /* switch to the next segment */
-        addCurrentIndex();
-        CACHE_STATS(PRINT("RESET TESS CACHE"));
-        
-#if FORCE_SIMPLE_FLUSH == 1
-        next_block = 0;
-        switch_block_threshold = maxBlocks;
-#else
-        const size_t region = localTime % NUM_CACHE_SEGMENTS;
-        next_block = region * (maxBlocks/NUM_CACHE_SEGMENTS);
-        switch_block_threshold = next_block + (maxBlocks/NUM_CACHE_SEGMENTS);
-        assert( switch_block_threshold <= maxBlocks );
-#endif
-        
-        CACHE_STATS(SharedTessellationCacheStats::cache_flushes++);
-        
-        /* release all blocked threads */
-        
-        for (ThreadWorkState *t=current_t_state;t!=nullptr;t=t->next)
-          unlockThread(t,-THREAD_BLOCK_ATOMIC_ADD);
-        
-        /* unlock the linked list of thread states */
-        
-        linkedlist_mtx.unlock();
-	
+          waitForUsersBefore(t,time);
         
+        /* switch allocations to the next segment */
+        alloc_state = allocState(time);
+        flushes++;
       }
       reset_state.unlock();
     }
@@ -156,16 +151,9 @@ namespace embree
       if (lockThread(t,THREAD_BLOCK_ATOMIC_ADD) != 0)
         waitForUsersLessEqual(t,THREAD_BLOCK_ATOMIC_ADD);
 
-    /* reset to the first segment */
-    next_block = 0;
-#if FORCE_SIMPLE_FLUSH == 1
-    switch_block_threshold = maxBlocks;
-#else
-    switch_block_threshold = maxBlocks/NUM_CACHE_SEGMENTS;
-#endif
-
-    /* reset local time */
-    localTime = NUM_CACHE_SEGMENTS;
+    /* reset local time and to the first segment */
+    localTime = numSegments;
+    alloc_state = allocState(localTime);
 
     /* release all blocked threads */
     for (ThreadWorkState *t=current_t_state;t!=nullptr;t=t->next)
@@ -178,6 +166,14 @@ namespace embree
     reset_state.unlock();
   }
 
+  void SharedLazyTessellationCache::resize(size_t new_size)
+  {    
+    if (new_size >= MAX_TESSELLATION_CACHE_SIZE)
+      new_size = MAX_TESSELLATION_CACHE_SIZE;
+    if (getSize() != new_size) 
+      realloc(new_size);    
+  }
+
   void SharedLazyTessellationCache::realloc(const size_t new_size)
   {
     /* lock the reset_state */
@@ -197,20 +193,11 @@ namespace embree
     data      = nullptr;
     if (size) data = (float*)os_malloc(size,hugepages);
     maxBlocks = size/BLOCK_SIZE;    
+    segmentBlocks = maxBlocks/numSegments;
 
-    /* invalidate entire cache */
-    localTime += NUM_CACHE_SEGMENTS; 
-
-    /* reset to the first segment */
-#if FORCE_SIMPLE_FLUSH == 1
-    next_block = 0;
-    switch_block_threshold = maxBlocks;
-#else
-    const size_t region = localTime % NUM_CACHE_SEGMENTS;
-    next_block = region * (maxBlocks/NUM_CACHE_SEGMENTS);
-    switch_block_threshold = next_block + (maxBlocks/NUM_CACHE_SEGMENTS);
-    assert( switch_block_threshold <= maxBlocks );
-#endif
+    /* invalidate entire cache and continue in the next segment */
+    localTime += numSegments; 
+    alloc_state = allocState(localTime);
 
     /* release all blocked threads */
     for (ThreadWorkState *t=current_t_state;t!=nullptr;t=t->next)
@@ -228,30 +215,71 @@ namespace embree
   ////////////////////////////////////////////////////////////////////////////////////////////////////////////
   ////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
-  std::atomic<size_t> SharedTessellationCacheStats::cache_accesses(0);
-  std::atomic<size_t> SharedTessellationCacheStats::cache_hits(0);
-  std::atomic<size_t> SharedTessellationCacheStats::cache_misses(0);
-  std::atomic<size_t> SharedTessellationCacheStats::cache_flushes(0);  
-  SpinLock   SharedTessellationCacheStats::mtx;  
-  size_t SharedTessellationCacheStats::cache_num_patches(0);
+  SharedTessellationCacheStats SharedLazyTessellationCache::getStats()
+  {
+    SharedTessellationCacheStats stats;
+    for (ThreadWorkState *t=current_t_state;t!=nullptr;t=t->next)
+    {
+      stats.accesses         += t->accesses.load(std::memory_order_relaxed);
+      stats.hits             += t->hits.load(std::memory_order_relaxed);
+      stats.tessellations    += t->tessellations.load(std::memory_order_relaxed);
+      stats.tessellatedBytes += t->tessellatedBytes.load(std::memory_order_relaxed);
+      stats.tessellationTime += t->tessellationTime.load(std::memory_order_relaxed);
+      stats.waitTime         += t->waitTime.load(std::memory_order_relaxed);
+    }
+    stats.flushes = flushes;
+
+    /* the per thread counters never get reset as other threads write them */
+    linkedlist_mtx.lock();
+    stats = stats - clearedStats;
+    linkedlist_mtx.unlock();
+    return stats;
+  }
 
-  void SharedTessellationCacheStats::printStats()
+  void SharedLazyTessellationCache::clearStats()
   {
-    PRINT(cache_accesses);
-    PRINT(cache_misses);
-    PRINT(cache_hits);
-    PRINT(cache_flushes);
-    PRINT(100.0f * cache_hits / cache_accesses);
-    assert(cache_hits + cache_misses == cache_accesses);
-    PRINT(cache_num_patches);
+    const SharedTessellationCacheStats stats = getStats();
+    linkedlist_mtx.lock();
+    clearedStats += stats;
+    linkedlist_mtx.unlock();
   }
 
-  void SharedTessellationCacheStats::clearStats()
+  SharedTessellationCacheStats& SharedTessellationCacheStats::operator+= (const SharedTessellationCacheStats& other)
   {
-    SharedTessellationCacheStats::cache_accesses  = 0;
-    SharedTessellationCacheStats::cache_hits      = 0;
-    SharedTessellationCacheStats::cache_misses    = 0;
-    SharedTessellationCacheStats::cache_flushes   = 0;
+    accesses         += other.accesses;
+    hits             += other.hits;
+    tessellations    += other.tessellations;
+    tessellatedBytes += other.tessellatedBytes;
+    tessellationTime += other.tessellationTime;
+    flushes          += other.flushes;
+    waitTime         += other.waitTime;
+    return *this;
+  }
+
+  SharedTessellationCacheStats SharedTessellationCacheStats::operator- (const SharedTessellationCacheStats& other) const
+  {
+    SharedTessellationCacheStats stats;
+    stats.accesses         = accesses         - other.accesses;
+    stats.hits             = hits             - other.hits;
+    stats.tessellations    = tessellations    - other.tessellations;
+    stats.tessellatedBytes = tessellatedBytes - other.tessellatedBytes;
+    stats.tessellationTime = tessellationTime - other.tessellationTime;
+    stats.flushes          = flushes          - other.flushes;
+    stats.waitTime         = waitTime         - other.waitTime;
+    return stats;
+  }
+
+  void SharedTessellationCacheStats::print() const
+  {
+    std::cout << "tessellation cache:" << std::endl;
+    std::cout << "  accesses      = " << accesses << std::endl;
+    std::cout << "  hit rate      = " << (accesses ? 100.0*double(hits)/double(accesses) : 0.0) << " %" << std::endl;
+    std::cout << "  tessellations = " << tessellations << std::endl;
+    std::cout << "  tessellated   = " << double(tessellatedBytes)*1E-6 << " MB in " << double(tessellationTime)*1E-9 << " s";
+    if (tessellationTime) std::cout << " (" << 1E3*double(tessellatedBytes)/double(tessellationTime) << " MB/s)";
+    std::cout << std::endl;
+    std::cout << "  flushes       = " << flushes << std::endl;
+    std::cout << "  wait time     = " << double(waitTime)*1E-9 << " s" << std::endl;
   }
 
   struct cache_regression_test : public RegressionTest
@@ -259,8 +287,10 @@ namespace embree
     BarrierSys barrier;
     std::atomic<size_t> numFailed;
     std::atomic<int> threadIDCounter;
+    static const size_t numCaches = 2;
     static const size_t numEntries = 4*1024;
-    SharedLazyTessellationCache::CacheEntry entry[numEntries];
+    SharedLazyTessellationCache* cache[numCaches];
+    SharedLazyTessellationCache::CacheEntry entry[numCaches][numEntries];
 
     cache_regression_test() 
       : RegressionTest("cache_regression_test"), numFailed(0), threadIDCounter(0)
@@ -271,22 +301,25 @@ namespace embree
     static void thread_alloc(cache_regression_test* This)
     {
       int threadID = This->threadIDCounter++;
-      size_t maxN = SharedLazyTessellationCache::sharedLazyTessellationCache.maxAllocSize()/4;
       This->barrier.wait();
 
       for (size_t j=0; j<100000; j++)
       {
+        /* threads alternate between the caches */
+        const size_t c = (threadID+j/1000)%numCaches;
+        SharedLazyTessellationCache* cache = This->cache[c];
+        size_t maxN = cache->maxAllocSize()/4;
         size_t elt = (threadID+j)%numEntries;
         size_t N = min(1+10*(elt%1000),maxN);
           
-        volatile int* data = (volatile int*) SharedLazyTessellationCache::lookup(This->entry[elt],0,[&] () {
-            int* data = (int*) SharedLazyTessellationCache::sharedLazyTessellationCache.malloc(4*N);
+        volatile int* data = (volatile int*) cache->lookup(This->entry[c][elt],0,[&] () {
+            int* data = (int*) cache->malloc(4*N);
             for (size_t k=0; k<N; k++) data[k] = (int)elt;
             return data;
           });
         
         if (data == nullptr) {
-          SharedLazyTessellationCache::sharedLazyTessellationCache.unlock();
+          cache->unlock();
           This->numFailed++;
           continue;
         }
@@ -299,7 +332,7 @@ namespace embree
           }
         }
         
-        SharedLazyTessellationCache::sharedLazyTessellationCache.unlock();
+        cache->unlock();
       }
       This->barrier.wait();
     }
@@ -308,6 +341,14 @@ namespace embree
     {
       numFailed.store(0);
 
+      /* small caches with different number of segments to frequently switch segments */
+      for (size_t c=0; c<numCaches; c++) {
+        cache[c] = new SharedLazyTessellationCache(c == 0 ? SharedLazyTessellationCache::DEFAULT_CACHE_SEGMENTS : 32);
+        cache[c]->resize(4*1024*1024);
+        for (size_t i=0; i<numEntries; i++)
+          entry[c][i].tag.reset();
+      }
+
       size_t numThreads = getNumberOfLogicalThreads();
       barrier.init(numThreads+1);
 
@@ -324,16 +365,12 @@ namespace embree
       for (size_t i=0; i<numThreads; i++)
         join(threads[i]);
 
+      for (size_t c=0; c<numCaches; c++)
+        delete cache[c];
+
       return numFailed == 0;
     }
   };
 
   cache_regression_test cache_regression;
 };
-
-extern "C" void printTessCacheStats()
-{
-  PRINT("SHARED TESSELLATION CACHE");
-  embree::SharedTessellationCacheStats::printStats();
-  embree::SharedTessellationCacheStats::clearStats();
-}
@@ -18,38 +18,32 @@
 
 #include "../common/default.h"
 
-/* force a complete cache invalidation when running out of allocation space */
-#define FORCE_SIMPLE_FLUSH 0
-
 #define THREAD_BLOCK_ATOMIC_ADD 4
 
-#if defined(DEBUG)
-#define CACHE_STATS(x) 
-#else
-#define CACHE_STATS(x) 
-#endif
-
 namespace embree
 {
-  class SharedTessellationCacheStats
+  /*! Statistics of a tessellation cache */
+  struct SharedTessellationCacheStats
   {
+    SharedTessellationCacheStats () 
+      : accesses(0), hits(0), tessellations(0), tessellatedBytes(0), tessellationTime(0), flushes(0), waitTime(0) {}
+
+    SharedTessellationCacheStats& operator+= (const SharedTessellationCacheStats& other);
+    SharedTessellationCacheStats operator- (const SharedTessellationCacheStats& other) const;
+
+    /*! prints the statistics */
+    void print() const;
+
   public:
-    /* stats */
-    static std::atomic<size_t> cache_accesses;
-    static std::atomic<size_t> cache_hits;
-    static std::atomic<size_t> cache_misses;
-    static std::atomic<size_t> cache_flushes;                
-    static size_t        cache_num_patches;
-    __aligned(64) static SpinLock mtx;
-    
-    /* print stats for debugging */                 
-    static void printStats();
-    static void clearStats();
+    size_t accesses;          //!< number of lookups of patches
+    size_t hits;              //!< number of lookups that found the patch in the cache
+    size_t tessellations;     //!< number of patches tessellated into the cache
+    size_t tessellatedBytes;  //!< number of bytes allocated for tessellated patches
+    size_t tessellationTime;  //!< nanoseconds spent tessellating patches
+    size_t flushes;           //!< number of invalidated cache segments
+    size_t waitTime;          //!< nanoseconds spent waiting for other threads of the cache
   };
   
-  void resizeTessellationCache(size_t new_size);
-  void resetTessellationCache();
-  
  ////////////////////////////////////////////////////////////////////////////////
  ////////////////////////////////////////////////////////////////////////////////
  ////////////////////////////////////////////////////////////////////////////////
@@ -59,22 +53,52 @@ namespace embree
    ALIGNED_STRUCT;
 
    std::atomic<size_t> counter;
+   std::atomic<size_t> epoch;   //!< cache time when the thread locked the cache
    ThreadWorkState* next;
+   size_t threadID;
    bool allocated;
 
+   /* statistics, only written by the thread itself, thus get
+    * incremented without atomic read-modify-write operations */
+   std::atomic<size_t> accesses;
+   std::atomic<size_t> hits;
+   std::atomic<size_t> tessellations;
+   std::atomic<size_t> tessellatedBytes;
+   std::atomic<size_t> tessellationTime;
+   std::atomic<size_t> waitTime;
+
    __forceinline ThreadWorkState(bool allocated = false) 
-     : counter(0), next(nullptr), allocated(allocated) 
+     : counter(0), epoch(0), next(nullptr), threadID(0), allocated(allocated),
+       accesses(0), hits(0), tessellations(0), tessellatedBytes(0), tessellationTime(0), waitTime(0)
    {
      assert( ((size_t)this % 64) == 0 ); 
    }   
+
+   static __forceinline void add(std::atomic<size_t>& stat, const size_t v) {
+     stat.store(stat.load(std::memory_order_relaxed)+v,std::memory_order_relaxed);
+   }
+
+   static __forceinline size_t nanoseconds(const double t0, const double t1) {
+     return size_t(max(t1-t0,0.0)*1E9);
+   }
  };
 
+ /*! Lazy tessellation cache of a device. The cache is split into
+  *  segments that are filled in round robin order, switching to the
+  *  next segment invalidates all data stored in that segment. A
+  *  segment switch only waits for threads that locked the cache
+  *  before the switch, threads that lock the cache afterwards cannot
+  *  see data of the invalidated segment and proceed. */
  class __aligned(64) SharedLazyTessellationCache 
  {
+   ALIGNED_CLASS;
+
  public:
    
-   static const size_t NUM_CACHE_SEGMENTS              = 8;
+   static const size_t DEFAULT_CACHE_SEGMENTS          = 8;
+   static const size_t MAX_CACHE_SEGMENTS              = 64;
    static const size_t NUM_PREALLOC_THREAD_WORK_STATES = 512;
+   static const size_t NUM_THREAD_STATE_SLOTS          = 4;
    static const size_t COMMIT_INDEX_SHIFT              = 32+8;
 #if defined(__X86_64__)
    static const size_t REF_TAG_MASK                    = 0xffffffffff;
@@ -83,40 +107,51 @@ namespace embree
 #endif
    static const size_t MAX_TESSELLATION_CACHE_SIZE     = REF_TAG_MASK+1;
    static const size_t BLOCK_SIZE                      = 64;
-   
 
-    /*! Per thread tessellation ref cache */
-   static __thread ThreadWorkState* init_t_state;
-   static ThreadWorkState* current_t_state;
-   
-   static __forceinline ThreadWorkState *threadState() 
+   /* the allocation state stores the time of the current segment in
+    * the upper bits and the number of allocated blocks of the current
+    * segment in the lower bits */
+   static const size_t SEGMENT_OFFSET_BITS             = 40;
+   static const size_t SEGMENT_OFFSET_MASK             = ((size_t)1 << SEGMENT_OFFSET_BITS)-1;
+
+   /*! Per thread state of some recently used caches */
+   struct ThreadStateSlot
    {
-     if (unlikely(!init_t_state))
-       /* sets init_t_state, can't return pointer due to macosx icc bug*/
-       SharedLazyTessellationCache::sharedLazyTessellationCache.getNextRenderThreadWorkState();
-     return init_t_state;
+     size_t cacheID;
+     ThreadWorkState* state;
+   };
+   static __thread ThreadStateSlot t_states[NUM_THREAD_STATE_SLOTS];
+   static __thread size_t t_next_slot;
+
+   __forceinline ThreadWorkState *threadState() 
+   {
+     for (size_t i=0; i<NUM_THREAD_STATE_SLOTS; i++)
+       if (likely(t_states[i].cacheID == cacheID))
+         return t_states[i].state;
+
+     return getThreadWorkState();
    }
 
    struct Tag
    {
      __forceinline Tag() : data(0) {}
 
-     __forceinline Tag(void* ptr, size_t combinedTime) { 
-       init(ptr,combinedTime);
+     __forceinline Tag(void* ptr, const void* base, size_t combinedTime) { 
+       init(ptr,base,combinedTime);
      }
 
-     __forceinline Tag(size_t ptr, size_t combinedTime) {
-       init((void*)ptr,combinedTime); 
+     __forceinline Tag(size_t ptr, const void* base, size_t combinedTime) {
+       init((void*)ptr,base,combinedTime); 
      }
 
-     __forceinline void init(void* ptr, size_t combinedTime)
+     __forceinline void init(void* ptr, const void* base, size_t combinedTime)
      {
        if (ptr == nullptr) {
          data = 0;
          return;
        }
        int64_t new_root_ref = (int64_t) ptr;
-       new_root_ref -= (int64_t)SharedLazyTessellationCache::sharedLazyTessellationCache.getDataPtr();                                
+       new_root_ref -= (int64_t) base;
        assert( new_root_ref <= (int64_t)REF_TAG_MASK );
        new_root_ref |= (int64_t)combinedTime << COMMIT_INDEX_SHIFT; 
        data = new_root_ref;
@@ -144,33 +179,39 @@ namespace embree
    bool hugepages;
    size_t size;
    size_t maxBlocks;
+   size_t numSegments;
+   size_t segmentBlocks;
+   size_t cacheID;
    ThreadWorkState *threadWorkState;
       
    __aligned(64) std::atomic<size_t> localTime;
-   __aligned(64) std::atomic<size_t> next_block;
+   __aligned(64) std::atomic<size_t> alloc_state;
    __aligned(64) SpinLock   reset_state;
    __aligned(64) SpinLock   linkedlist_mtx;
-   __aligned(64) std::atomic<size_t> switch_block_threshold;
+   __aligned(64) std::atomic<ThreadWorkState*> current_t_state;
    __aligned(64) std::atomic<size_t> numRenderThreads;
+   __aligned(64) std::atomic<size_t> flushes;
+   SharedTessellationCacheStats clearedStats;  //!< statistics at the time they got cleared the last time
 
 
  public:
 
-      
-   SharedLazyTessellationCache();
+   /*! creates an empty cache, the number of segments is rounded down to a power of two */
+   SharedLazyTessellationCache(size_t numSegments = DEFAULT_CACHE_SEGMENTS);
    ~SharedLazyTessellationCache();
 
-   void getNextRenderThreadWorkState();
+   ThreadWorkState* getThreadWorkState();
 
    __forceinline size_t maxAllocSize() const {
-     return switch_block_threshold;
+     return segmentBlocks;
    }
 
+   __forceinline size_t getNumSegments() const { return numSegments; }
+
    __forceinline size_t getCurrentIndex() { return localTime.load(); }
-   __forceinline void   addCurrentIndex(const size_t i=1) { localTime.fetch_add(i); }
 
    __forceinline size_t getTime(const size_t globalTime) {
-     return localTime.load()+NUM_CACHE_SEGMENTS*globalTime;
+     return localTime.load()+numSegments*globalTime;
    }
 
 
@@ -179,140 +220,194 @@ namespace embree
 
    __forceinline bool isLocked(ThreadWorkState *const t_state) { return t_state->counter.load() != 0; }
 
-   static __forceinline void lock  () { sharedLazyTessellationCache.lockThread(threadState()); }
-   static __forceinline void unlock() { sharedLazyTessellationCache.unlockThread(threadState()); }
-   static __forceinline bool isLocked() { return sharedLazyTessellationCache.isLocked(threadState()); }
-   static __forceinline size_t getState() { return threadState()->counter.load(); }
-   static __forceinline void lockThreadLoop() { sharedLazyTessellationCache.lockThreadLoop(threadState()); }
-
-   static __forceinline size_t getTCacheTime(const size_t globalTime) {
-     return sharedLazyTessellationCache.getTime(globalTime);
-   }
+   __forceinline void lock  () { lockThreadLoop(threadState()); }
+   __forceinline void unlock() { unlockThread(threadState()); }
+   __forceinline bool isLocked() { return isLocked(threadState()); }
+   __forceinline size_t getState() { return threadState()->counter.load(); }
+   __forceinline void lockThreadLoop() { lockThreadLoop(threadState()); }
 
    /* per thread lock */
    __forceinline void lockThreadLoop (ThreadWorkState *const t_state) 
    { 
      while(1)
      {
-       size_t lock = SharedLazyTessellationCache::sharedLazyTessellationCache.lockThread(t_state,1);
+       /* the outermost lock records the time before the thread becomes visible as user */
+       if (t_state->counter.load() == 0)
+         t_state->epoch.store(localTime.load());
+
+       size_t lock = lockThread(t_state,1);
        if (unlikely(lock >= THREAD_BLOCK_ATOMIC_ADD))
        {
          /* lock failed wait until sync phase is over */
-         sharedLazyTessellationCache.unlockThread(t_state,-1);	       
-         sharedLazyTessellationCache.waitForUsersLessEqual(t_state,0);
+         unlockThread(t_state,-1);	       
+         const double t0 = getSeconds();
+         waitForUsersLessEqual(t_state,0);
+         ThreadWorkState::add(t_state->waitTime,ThreadWorkState::nanoseconds(t0,getSeconds()));
        }
        else
          break;
      }
    }
 
-   static __forceinline void* lookup(CacheEntry& entry, size_t globalTime)
+   __forceinline void* lookup(CacheEntry& entry, size_t globalTime)
    {   
      const int64_t subdiv_patch_root_ref = entry.tag.get(); 
-     CACHE_STATS(SharedTessellationCacheStats::cache_accesses++);
      
      if (likely(subdiv_patch_root_ref != 0)) 
      {
-       const size_t subdiv_patch_root = (subdiv_patch_root_ref & REF_TAG_MASK) + (size_t)sharedLazyTessellationCache.getDataPtr();
+       const size_t subdiv_patch_root = (subdiv_patch_root_ref & REF_TAG_MASK) + (size_t)getDataPtr();
        const size_t subdiv_patch_cache_index = extractCommitIndex(subdiv_patch_root_ref);
        
-       if (likely( sharedLazyTessellationCache.validCacheIndex(subdiv_patch_cache_index,globalTime) ))
-       {
-         CACHE_STATS(SharedTessellationCacheStats::cache_hits++);
+       if (likely( validCacheIndex(subdiv_patch_cache_index,globalTime) ))
          return (void*) subdiv_patch_root;
-       }
      }
-     CACHE_STATS(SharedTessellationCacheStats::cache_misses++);
      return nullptr;
    }
 
+   /*! invokes the constructor and accounts its time, excluding the time spent waiting for a segment switch */
+   template<typename Constructor>
+     __forceinline auto tessellate (ThreadWorkState *const t_state, const Constructor constructor) -> decltype(constructor())
+   {
+     const size_t wait0 = t_state->waitTime.load(std::memory_order_relaxed);
+     const double t0 = getSeconds();
+     auto ret = constructor();
+     const size_t t = ThreadWorkState::nanoseconds(t0,getSeconds());
+     const size_t wait = t_state->waitTime.load(std::memory_order_relaxed)-wait0;
+     ThreadWorkState::add(t_state->tessellations,1);
+     ThreadWorkState::add(t_state->tessellationTime,t > wait ? t-wait : 0);
+     return ret;
+   }
+
    template<typename Constructor>
-     static __forceinline auto lookup (CacheEntry& entry, size_t globalTime, const Constructor constructor, const bool before=false) -> decltype(constructor())
+     __forceinline auto lookup (CacheEntry& entry, size_t globalTime, const Constructor constructor, const bool before=false) -> decltype(constructor())
    {
-     ThreadWorkState *t_state = SharedLazyTessellationCache::threadState();
+     ThreadWorkState *t_state = threadState();
+     ThreadWorkState::add(t_state->accesses,1);
 
      while (true)
      {
-       sharedLazyTessellationCache.lockThreadLoop(t_state);
-       void* patch = SharedLazyTessellationCache::lookup(entry,globalTime);
-       if (patch) return (decltype(constructor())) patch;
+       lockThreadLoop(t_state);
+       void* patch = lookup(entry,globalTime);
+       if (patch) {
+         ThreadWorkState::add(t_state->hits,1);
+         return (decltype(constructor())) patch;
+       }
        
        if (entry.mutex.try_lock())
        {
          if (!validTag(entry.tag,globalTime)) 
          {
-           auto timeBefore = sharedLazyTessellationCache.getTime(globalTime);
-           auto ret = constructor(); // thread is locked here!
+           auto timeBefore = getTime(globalTime);
+           auto ret = tessellate(t_state,constructor); // thread is locked here!
            assert(ret);
            /* this should never return nullptr */
-           auto timeAfter = sharedLazyTessellationCache.getTime(globalTime);
+           auto timeAfter = getTime(globalTime);
            auto time = before ? timeBefore : timeAfter;
            __memory_barrier();
-           entry.tag = SharedLazyTessellationCache::Tag(ret,time);
+           entry.tag = SharedLazyTessellationCache::Tag(ret,getDataPtr(),time);
            __memory_barrier();
            entry.mutex.unlock();
            return ret;
          }
          entry.mutex.unlock();
        }
-       SharedLazyTessellationCache::sharedLazyTessellationCache.unlockThread(t_state);
+       unlockThread(t_state);
      }
    }
    
-   __forceinline bool validCacheIndex(const size_t i, const size_t globalTime)
+   /*! Replaces the data of a cache entry by newly constructed data, if
+    *  the entry still refers to the old data. The thread has to be
+    *  locked from the lookup of the old data. Returns the old data if
+    *  another thread currently updates the entry. */
+   template<typename Constructor>
+     __forceinline auto replace (CacheEntry& entry, size_t globalTime, void* old, const Constructor constructor) -> decltype(constructor())
    {
-#if FORCE_SIMPLE_FLUSH == 1
-     return i == getTime(globalTime);
-#else
-     return i+(NUM_CACHE_SEGMENTS-1) >= getTime(globalTime);
-#endif
-   }
+     if (!entry.mutex.try_lock())
+       return (decltype(constructor())) old;
 
-   static __forceinline bool validTime(const size_t oldtime, const size_t newTime)
-   {
-     return oldtime+(NUM_CACHE_SEGMENTS-1) >= newTime;
+     if (lookup(entry,globalTime) != old) {
+       entry.mutex.unlock();
+       return (decltype(constructor())) old;
+     }
+
+     auto ret = tessellate(threadState(),constructor); // thread is locked here!
+     assert(ret);
+     auto time = getTime(globalTime);
+     __memory_barrier();
+     entry.tag = SharedLazyTessellationCache::Tag(ret,getDataPtr(),time);
+     __memory_barrier();
+     entry.mutex.unlock();
+     return ret;
+   }
+   
+   __forceinline bool validCacheIndex(const size_t i, const size_t globalTime) {
+     return i+(numSegments-1) >= getTime(globalTime);
    }
 
+   __forceinline bool validTime(const size_t oldtime, const size_t newTime) {
+     return oldtime+(numSegments-1) >= newTime;
+   }
 
-    static __forceinline bool validTag(const Tag& tag, size_t globalTime)
-    {
-      const int64_t subdiv_patch_root_ref = tag.get(); 
-      if (subdiv_patch_root_ref == 0) return false;
-      const size_t subdiv_patch_cache_index = extractCommitIndex(subdiv_patch_root_ref);
-      return sharedLazyTessellationCache.validCacheIndex(subdiv_patch_cache_index,globalTime);
-    }
+   __forceinline bool validTag(const Tag& tag, size_t globalTime)
+   {
+     const int64_t subdiv_patch_root_ref = tag.get(); 
+     if (subdiv_patch_root_ref == 0) return false;
+     const size_t subdiv_patch_cache_index = extractCommitIndex(subdiv_patch_root_ref);
+     return validCacheIndex(subdiv_patch_cache_index,globalTime);
+   }
 
    void waitForUsersLessEqual(ThreadWorkState *const t_state,
 			      const unsigned int users);
-    
+
+   /*! waits until the thread does not use data from before the specified time anymore */
+   void waitForUsersBefore(ThreadWorkState *const t_state,
+                           const size_t time);
+
+   __forceinline size_t allocState(const size_t time) const {
+     return time << SEGMENT_OFFSET_BITS;
+   }
+
+   __forceinline size_t getSegment() const {
+     return alloc_state.load() >> SEGMENT_OFFSET_BITS;
+   }
+
+   /*! allocates blocks in the current segment, returns -1 if the segment is full */
    __forceinline size_t alloc(const size_t blocks)
    {
-     if (unlikely(blocks >= switch_block_threshold))
+     if (unlikely(blocks >= segmentBlocks))
        throw_RTCError(RTC_INVALID_OPERATION,"allocation exceeds size of tessellation cache segment");
 
-     assert(blocks < switch_block_threshold);
-     size_t index = next_block.fetch_add(blocks);
-     if (unlikely(index + blocks >= switch_block_threshold)) return (size_t)-1;
-     return index;
+     size_t state = alloc_state.load();
+     while (true)
+     {
+       const size_t offset = state & SEGMENT_OFFSET_MASK;
+       if (unlikely(offset + blocks >= segmentBlocks)) return (size_t)-1;
+       if (alloc_state.compare_exchange_weak(state,state+blocks)) {
+         const size_t region = (state >> SEGMENT_OFFSET_BITS) & (numSegments-1);
+         return region*segmentBlocks + offset;
+       }
+     }
    }
 
-   static __forceinline void* malloc(const size_t bytes)
+   __forceinline void* malloc(const size_t bytes)
    {
-     size_t block_index = -1;
+     const size_t blocks = (bytes+BLOCK_SIZE-1)/BLOCK_SIZE;
      ThreadWorkState *const t_state = threadState();
      while (true)
      {
-       block_index = sharedLazyTessellationCache.alloc((bytes+BLOCK_SIZE-1)/BLOCK_SIZE);
-       if (block_index == (size_t)-1)
-       {
-         sharedLazyTessellationCache.unlockThread(t_state);		  
-         sharedLazyTessellationCache.allocNextSegment();
-         sharedLazyTessellationCache.lockThread(t_state);
-         continue; 
+       const size_t segment = getSegment();
+       const size_t block_index = alloc(blocks);
+       if (likely(block_index != (size_t)-1)) {
+         ThreadWorkState::add(t_state->tessellatedBytes,blocks*BLOCK_SIZE);
+         return getBlockPtr(block_index);
        }
-       break;
+
+       unlockThread(t_state);		  
+       const double t0 = getSeconds();
+       allocNextSegment(segment);
+       ThreadWorkState::add(t_state->waitTime,ThreadWorkState::nanoseconds(t0,getSeconds()));
+       lockThreadLoop(t_state);
      }
-     return sharedLazyTessellationCache.getBlockPtr(block_index);
    }
 
    __forceinline void *getBlockPtr(const size_t block_index)
@@ -324,15 +419,20 @@ namespace embree
    }
 
    __forceinline void*  getDataPtr()      { return data; }
-   __forceinline size_t getNumUsedBytes() { return next_block * BLOCK_SIZE; }
    __forceinline size_t getMaxBlocks()    { return maxBlocks; }
    __forceinline size_t getSize()         { return size; }
 
-   void allocNextSegment();
+   /*! switches from the specified full segment to the next segment */
+   void allocNextSegment(const size_t segment);
+
+   /*! resizes the cache, sizes are clamped to the maximal cache size */
+   void resize(size_t new_size);
    void realloc(const size_t newSize);
 
    void reset();
 
-   static SharedLazyTessellationCache sharedLazyTessellationCache;
+   /*! returns the statistics accumulated over all threads since they got cleared */
+   SharedTessellationCacheStats getStats();
+   void clearStats();
  };
 }
@@ -150,6 +150,9 @@ namespace embree
     ray.geomID = -1;
     ray.primID = -1;
     ray.instID = -1;
+#if RTC_MAX_INSTANCE_LEVEL_COUNT > 1
+    for (size_t l=0; l<RTC_MAX_INSTANCE_LEVEL_COUNT-1; l++) ray.nestedInstID[l] = -1;
+#endif
   }
 
   __forceinline RTCRay makeRay(const Vec3fa& org, const Vec3fa& dir) 
@@ -274,6 +277,9 @@ namespace embree
     ray_o.time[i] = ray_i.time;
     ray_o.mask[i] = ray_i.mask;
     ray_o.instID[i] = ray_i.instID;
+#if RTC_MAX_INSTANCE_LEVEL_COUNT > 1
+    for (size_t l=0; l<RTC_MAX_INSTANCE_LEVEL_COUNT-1; l++) ray_o.nestedInstID[l][i] = ray_i.nestedInstID[l];
+#endif
     ray_o.geomID[i] = ray_i.geomID;
     ray_o.primID[i] = ray_i.primID;
     ray_o.u[i] = ray_i.u;
@@ -296,6 +302,9 @@ namespace embree
     ray_o.time[i] = ray_i.time;
     ray_o.mask[i] = ray_i.mask;
     ray_o.instID[i] = ray_i.instID;
+#if RTC_MAX_INSTANCE_LEVEL_COUNT > 1
+    for (size_t l=0; l<RTC_MAX_INSTANCE_LEVEL_COUNT-1; l++) ray_o.nestedInstID[l][i] = ray_i.nestedInstID[l];
+#endif
     ray_o.geomID[i] = ray_i.geomID;
     ray_o.primID[i] = ray_i.primID;
     ray_o.u[i] = ray_i.u;
@@ -318,6 +327,9 @@ namespace embree
     ray_o.time[i] = ray_i.time;
     ray_o.mask[i] = ray_i.mask;
     ray_o.instID[i] = ray_i.instID;
+#if RTC_MAX_INSTANCE_LEVEL_COUNT > 1
+    for (size_t l=0; l<RTC_MAX_INSTANCE_LEVEL_COUNT-1; l++) ray_o.nestedInstID[l][i] = ray_i.nestedInstID[l];
+#endif
     ray_o.geomID[i] = ray_i.geomID;
     ray_o.primID[i] = ray_i.primID;
     ray_o.u[i] = ray_i.u;
@@ -340,6 +352,9 @@ namespace embree
     RTCRayN_time(ray_o,N,i) = ray_i.time;
     RTCRayN_mask(ray_o,N,i) = ray_i.mask;
     RTCRayN_instID(ray_o,N,i) = ray_i.instID;
+#if RTC_MAX_INSTANCE_LEVEL_COUNT > 1
+    for (size_t l=0; l<RTC_MAX_INSTANCE_LEVEL_COUNT-1; l++) RTCRayN_nestedInstID(ray_o,N,i,l) = ray_i.nestedInstID[l];
+#endif
     RTCRayN_geomID(ray_o,N,i) = ray_i.geomID;
     RTCRayN_primID(ray_o,N,i) = ray_i.primID;
     RTCRayN_u(ray_o,N,i) = ray_i.u;
@@ -363,6 +378,9 @@ namespace embree
     ray_o.time = ray_i.time[i];
     ray_o.mask = ray_i.mask[i];
     ray_o.instID = ray_i.instID[i];
+#if RTC_MAX_INSTANCE_LEVEL_COUNT > 1
+    for (size_t l=0; l<RTC_MAX_INSTANCE_LEVEL_COUNT-1; l++) ray_o.nestedInstID[l] = ray_i.nestedInstID[l][i];
+#endif
     ray_o.geomID = ray_i.geomID[i];
     ray_o.primID = ray_i.primID[i];
     ray_o.u = ray_i.u[i];
@@ -387,6 +405,9 @@ namespace embree
     ray_o.time = ray_i.time[i];
     ray_o.mask = ray_i.mask[i];
     ray_o.instID = ray_i.instID[i];
+#if RTC_MAX_INSTANCE_LEVEL_COUNT > 1
+    for (size_t l=0; l<RTC_MAX_INSTANCE_LEVEL_COUNT-1; l++) ray_o.nestedInstID[l] = ray_i.nestedInstID[l][i];
+#endif
     ray_o.geomID = ray_i.geomID[i];
     ray_o.primID = ray_i.primID[i];
     ray_o.u = ray_i.u[i];
@@ -411,6 +432,9 @@ namespace embree
     ray_o.time = ray_i.time[i];
     ray_o.mask = ray_i.mask[i];
     ray_o.instID = ray_i.instID[i];
+#if RTC_MAX_INSTANCE_LEVEL_COUNT > 1
+    for (size_t l=0; l<RTC_MAX_INSTANCE_LEVEL_COUNT-1; l++) ray_o.nestedInstID[l] = ray_i.nestedInstID[l][i];
+#endif
     ray_o.geomID = ray_i.geomID[i];
     ray_o.primID = ray_i.primID[i];
     ray_o.u = ray_i.u[i];
@@ -435,6 +459,9 @@ namespace embree
     ray_o.time = RTCRayN_time(ray_i,N,i);
     ray_o.mask = RTCRayN_mask(ray_i,N,i);
     ray_o.instID = RTCRayN_instID(ray_i,N,i);
+#if RTC_MAX_INSTANCE_LEVEL_COUNT > 1
+    for (size_t l=0; l<RTC_MAX_INSTANCE_LEVEL_COUNT-1; l++) ray_o.nestedInstID[l] = RTCRayN_nestedInstID(ray_i,N,i,l);
+#endif
     ray_o.geomID = RTCRayN_geomID(ray_i,N,i);
     ray_o.primID = RTCRayN_primID(ray_i,N,i);
     ray_o.u = RTCRayN_u(ray_i,N,i);
@@ -596,6 +623,7 @@ namespace embree
     if (sflags & RTC_SCENE_COMPACT) str += "Compact";
     if (sflags & RTC_SCENE_ROBUST ) str += "Robust";
     if (sflags & RTC_SCENE_HIGH_QUALITY) str += "HighQuality";
+    if (sflags & RTC_SCENE_OPTIMIZE_OCCLUSION) str += "OptimizeOcclusion";
     return str;
   }
 
@@ -832,6 +860,9 @@ namespace embree
       rayp.time = &RTCRayN_time(ray,N,0); 
       rayp.mask = &RTCRayN_mask(ray,N,0); 
       rayp.instID = &RTCRayN_instID(ray,N,0); 
+#if RTC_MAX_INSTANCE_LEVEL_COUNT > 1
+      for (size_t l=0; l<RTC_MAX_INSTANCE_LEVEL_COUNT-1; l++) rayp.nestedInstID[l] = &RTCRayN_nestedInstID(ray,N,0,l);
+#endif
       rayp.geomID = &RTCRayN_geomID(ray,N,0); 
       rayp.primID = &RTCRayN_primID(ray,N,0); 
       rayp.u = &RTCRayN_u(ray,N,0); 
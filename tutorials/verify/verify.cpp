@@ -1114,6 +1114,491 @@ namespace embree
     }
   };
 
+  struct BVHCacheTest : public VerifyApplication::Test
+  {
+    RTCSceneFlags sflags;
+
+    BVHCacheTest (std::string name, int isa, RTCSceneFlags sflags)
+      : VerifyApplication::Test(name,isa,VerifyApplication::TEST_SHOULD_PASS), sflags(sflags) {}
+
+    static std::string cacheDirectory()
+    {
+#if defined(_WIN32)
+      const char* dir = getenv("TEMP");
+      return dir ? dir : ".";
+#else
+      const char* dir = getenv("TMPDIR");
+      return dir ? dir : "/tmp";
+#endif
+    }
+
+    VerifyApplication::TestReturnValue run(VerifyApplication* state, bool silent)
+    {
+      std::string cfg = state->rtcore + ",isa="+stringOfISA(isa)+",bvh_cache=\""+cacheDirectory()+"\"";
+      RTCDeviceRef device = rtcNewDevice(cfg.c_str());
+      errorHandler(nullptr,rtcDeviceGetError(device));
+
+      /* the first scene builds and stores the BVH, the others load it
+       * while previous scenes keep their mapping of the cache file alive */
+      const size_t numScenes = 3;
+      const size_t numRays = 32*32;
+      Ref<VerifyScene> scenes[numScenes];
+      std::vector<RTCRay> rays[numScenes];
+      for (size_t i=0; i<numScenes; i++)
+      {
+        scenes[i] = new VerifyScene(device,sflags,aflags);
+        scenes[i]->addGeometry(RTC_GEOMETRY_STATIC,SceneGraph::createTriangleSphere(Vec3fa(-1,0,0),1.0f,50));
+        scenes[i]->addGeometry(RTC_GEOMETRY_STATIC,SceneGraph::createQuadSphere(Vec3fa(+1,0,0),1.0f,50));
+        rtcCommit (*scenes[i]);
+        AssertNoError(device);
+
+        for (size_t j=0; j<numRays; j++) {
+          const float x = -2.5f + 5.0f*float(j%32)/31.0f;
+          const float z = -1.5f + 3.0f*float(j/32)/31.0f;
+          RTCRay ray = makeRay(Vec3fa(x,10,z),Vec3fa(0,-1,0));
+          rtcIntersect(*scenes[i],ray);
+          rays[i].push_back(ray);
+        }
+        AssertNoError(device);
+      }
+
+      for (size_t i=1; i<numScenes; i++)
+      {
+        for (size_t j=0; j<numRays; j++)
+        {
+          if (rays[0][j].geomID != rays[i][j].geomID) return VerifyApplication::FAILED;
+          if (rays[0][j].primID != rays[i][j].primID) return VerifyApplication::FAILED;
+          if (rays[0][j].tfar   != rays[i][j].tfar  ) return VerifyApplication::FAILED;
+        }
+      }
+      return VerifyApplication::PASSED;
+    }
+  };
+
+  struct StreamingBuildTest : public VerifyApplication::Test
+  {
+    RTCSceneFlags sflags;
+
+    StreamingBuildTest (std::string name, int isa, RTCSceneFlags sflags)
+      : VerifyApplication::Test(name,isa,VerifyApplication::TEST_SHOULD_PASS), sflags(sflags) {}
+
+    struct MemoryUsage
+    {
+      MemoryUsage () : bytes(0), peak(0) {}
+      std::atomic<ssize_t> bytes;
+      std::atomic<ssize_t> peak;
+    };
+
+    static bool memoryMonitor(void* userPtr, const ssize_t bytes, const bool /*post*/)
+    {
+      MemoryUsage* usage = (MemoryUsage*) userPtr;
+      const ssize_t cur = usage->bytes += bytes;
+      ssize_t peak = usage->peak;
+      while (cur > peak && !usage->peak.compare_exchange_weak(peak,cur));
+      return true;
+    }
+
+    /* builds a scene and traces a grid of rays, returns the peak memory consumption reported during the build */
+    ssize_t trace(VerifyApplication* state, const std::string& cfg, std::vector<RTCRay>& rays)
+    {
+      RTCDeviceRef device = rtcNewDevice(cfg.c_str());
+      errorHandler(nullptr,rtcDeviceGetError(device));
+      MemoryUsage usage;
+      rtcDeviceSetMemoryMonitorFunction2(device,memoryMonitor,&usage);
+
+      VerifyScene scene(device,sflags,aflags);
+      scene.addGeometry(RTC_GEOMETRY_STATIC,SceneGraph::createTriangleSphere(Vec3fa(-1,0,0),1.0f,200));
+      scene.addGeometry(RTC_GEOMETRY_STATIC,SceneGraph::createQuadSphere(Vec3fa(+1,0,0),1.0f,200));
+      const ssize_t bytesScene = usage.bytes;
+      usage.peak = bytesScene;
+      rtcCommit (scene);
+      AssertNoError(device);
+      const ssize_t peak = usage.peak-bytesScene;
+
+      for (size_t j=0; j<64*64; j++) {
+        const float x = -2.5f + 5.0f*float(j%64)/63.0f;
+        const float z = -1.5f + 3.0f*float(j/64)/63.0f;
+        RTCRay ray = makeRay(Vec3fa(x,10,z),Vec3fa(0,-1,0));
+        rtcIntersect(scene,ray);
+        rays.push_back(ray);
+      }
+      AssertNoError(device);
+      rtcDeviceSetMemoryMonitorFunction2(device,nullptr,nullptr);
+      return peak;
+    }
+
+    VerifyApplication::TestReturnValue run(VerifyApplication* state, bool silent)
+    {
+      std::string cfg = state->rtcore + ",isa="+stringOfISA(isa);
+      std::vector<RTCRay> rays0, rays1;
+      const ssize_t peak0 = trace(state,cfg,rays0);
+      const ssize_t peak1 = trace(state,cfg+",build_memory_budget=1",rays1);
+
+      for (size_t j=0; j<rays0.size(); j++)
+      {
+        if (rays0[j].geomID != rays1[j].geomID) return VerifyApplication::FAILED;
+        if (abs(rays0[j].tfar-rays1[j].tfar) > 1E-4f) return VerifyApplication::FAILED;
+      }
+
+      /* only the default static accels are built out-of-core */
+      if (sflags == RTC_SCENE_STATIC && peak1 >= peak0)
+        return VerifyApplication::FAILED;
+
+      return VerifyApplication::PASSED;
+    }
+  };
+
+  struct PLOCBuildTest : public VerifyApplication::Test
+  {
+    RTCSceneFlags sflags;
+
+    PLOCBuildTest (std::string name, int isa, RTCSceneFlags sflags)
+      : VerifyApplication::Test(name,isa,VerifyApplication::TEST_SHOULD_PASS), sflags(sflags) {}
+
+    void trace(VerifyApplication* state, const std::string& cfg, std::vector<RTCRay>& rays)
+    {
+      RTCDeviceRef device = rtcNewDevice(cfg.c_str());
+      errorHandler(nullptr,rtcDeviceGetError(device));
+      VerifyScene scene(device,sflags,aflags);
+      scene.addGeometry(RTC_GEOMETRY_STATIC,SceneGraph::createTriangleSphere(Vec3fa(-1,0,0),1.0f,100));
+      scene.addGeometry(RTC_GEOMETRY_STATIC,SceneGraph::createQuadSphere(Vec3fa(+1,0,0),1.0f,100));
+      rtcCommit (scene);
+      AssertNoError(device);
+
+      for (size_t j=0; j<64*64; j++) {
+        const float x = -2.5f + 5.0f*float(j%64)/63.0f;
+        const float z = -1.5f + 3.0f*float(j/64)/63.0f;
+        RTCRay ray = makeRay(Vec3fa(x,10,z),Vec3fa(0,-1,0));
+        rtcIntersect(scene,ray);
+        rays.push_back(ray);
+      }
+      AssertNoError(device);
+    }
+
+    VerifyApplication::TestReturnValue run(VerifyApplication* state, bool silent)
+    {
+      std::string cfg = state->rtcore + ",isa="+stringOfISA(isa);
+      std::vector<RTCRay> rays0, rays1;
+      trace(state,cfg,rays0);
+      /* the compact robust BVH4<Quad4i> has no PLOC builder */
+      const bool quad4i = (sflags & RTC_SCENE_COMPACT) && (sflags & RTC_SCENE_ROBUST);
+      trace(state,cfg+",tri_builder=ploc"+(quad4i ? "" : ",quad_builder=ploc"),rays1);
+
+      for (size_t j=0; j<rays0.size(); j++)
+      {
+        if (rays0[j].geomID != rays1[j].geomID) return VerifyApplication::FAILED;
+        if (abs(rays0[j].tfar-rays1[j].tfar) > 1E-4f) return VerifyApplication::FAILED;
+      }
+      return VerifyApplication::PASSED;
+    }
+  };
+
+  struct BVHRestructureTest : public VerifyApplication::Test
+  {
+    RTCSceneFlags sflags;
+
+    BVHRestructureTest (std::string name, int isa, RTCSceneFlags sflags)
+      : VerifyApplication::Test(name,isa,VerifyApplication::TEST_SHOULD_PASS), sflags(sflags) {}
+
+    void trace(VerifyApplication* state, const std::string& cfg, std::vector<RTCRay>& rays)
+    {
+      RTCDeviceRef device = rtcNewDevice(cfg.c_str());
+      errorHandler(nullptr,rtcDeviceGetError(device));
+      VerifyScene scene(device,sflags,aflags);
+      scene.addGeometry(RTC_GEOMETRY_STATIC,SceneGraph::createTriangleSphere(Vec3fa(-1,0,0),1.0f,100));
+      scene.addGeometry(RTC_GEOMETRY_STATIC,SceneGraph::createQuadSphere(Vec3fa(+1,0,0),1.0f,100));
+      rtcCommit (scene);
+      AssertNoError(device);
+
+      for (size_t j=0; j<64*64; j++) {
+        const float x = -2.5f + 5.0f*float(j%64)/63.0f;
+        const float z = -1.5f + 3.0f*float(j/64)/63.0f;
+        RTCRay ray = makeRay(Vec3fa(x,10,z),Vec3fa(0,-1,0));
+        rtcIntersect(scene,ray);
+        rays.push_back(ray);
+      }
+      AssertNoError(device);
+    }
+
+    VerifyApplication::TestReturnValue run(VerifyApplication* state, bool silent)
+    {
+      std::string cfg = state->rtcore + ",isa="+stringOfISA(isa);
+      std::vector<RTCRay> rays0, rays1;
+      trace(state,cfg+",bvh_restructure=0",rays0);
+      trace(state,cfg+",bvh_restructure=1",rays1);
+
+      for (size_t j=0; j<rays0.size(); j++)
+      {
+        if (rays0[j].geomID != rays1[j].geomID) return VerifyApplication::FAILED;
+        if (abs(rays0[j].tfar-rays1[j].tfar) > 1E-4f) return VerifyApplication::FAILED;
+      }
+      return VerifyApplication::PASSED;
+    }
+  };
+
+  struct OcclusionOrderTest : public VerifyApplication::Test
+  {
+    RTCSceneFlags sflags;
+
+    OcclusionOrderTest (std::string name, int isa, RTCSceneFlags sflags)
+      : VerifyApplication::Test(name,isa,VerifyApplication::TEST_SHOULD_PASS), sflags(sflags) {}
+
+    /* traces the rays as single rays and as ray stream */
+    void trace(const RTCDeviceRef& device, RTCSceneFlags sflags, std::vector<RTCRay>& rays_in, std::vector<RTCRay>& rays_out)
+    {
+      VerifyScene scene(device,sflags,aflags_all);
+      scene.addGeometry(RTC_GEOMETRY_STATIC,SceneGraph::createTriangleSphere(Vec3fa(-1,0,0),1.0f,100));
+      scene.addGeometry(RTC_GEOMETRY_STATIC,SceneGraph::createQuadSphere(Vec3fa(+1,0,0),1.0f,100));
+      scene.addGeometry(RTC_GEOMETRY_STATIC,SceneGraph::createTrianglePlane(Vec3fa(-3,-1.5f,-3),Vec3fa(6,0,0),Vec3fa(0,0,6),8,8));
+      rtcCommit (scene);
+      AssertNoError(device);
+
+      std::vector<RTCRay> rays1 = rays_in, rays2 = rays_in, rays3 = rays_in;
+      for (auto& ray : rays1) rtcIntersect(scene,ray);
+      for (auto& ray : rays2) rtcOccluded(scene,ray);
+      RTCIntersectContext context;
+      context.flags = RTC_INTERSECT_INCOHERENT;
+      context.userRayExt = nullptr;
+      rtcOccluded1M(scene,&context,rays3.data(),rays3.size(),sizeof(RTCRay));
+      AssertNoError(device);
+      rays_out.insert(rays_out.end(),rays1.begin(),rays1.end());
+      rays_out.insert(rays_out.end(),rays2.begin(),rays2.end());
+      rays_out.insert(rays_out.end(),rays3.begin(),rays3.end());
+    }
+
+    VerifyApplication::TestReturnValue run(VerifyApplication* state, bool silent)
+    {
+      std::string cfg = state->rtcore + ",isa="+stringOfISA(isa);
+      RTCDeviceRef device = rtcNewDevice(cfg.c_str());
+      errorHandler(nullptr,rtcDeviceGetError(device));
+
+      /* rays in random directions from inside and outside of the spheres */
+      std::vector<RTCRay> rays;
+      for (size_t i=0; i<4096; i++)
+      {
+        const Vec3fa org(6.0f*random_float()-3.0f,6.0f*random_float()-3.0f,6.0f*random_float()-3.0f);
+        const Vec3fa dir(2.0f*random_float()-1.0f,2.0f*random_float()-1.0f,2.0f*random_float()-1.0f);
+        rays.push_back(makeRay(org,dir));
+      }
+
+      /* the ordered BVH has to report the same hits */
+      std::vector<RTCRay> rays0, rays1;
+      trace(device,sflags,rays,rays0);
+      trace(device,RTCSceneFlags(sflags | RTC_SCENE_OPTIMIZE_OCCLUSION),rays,rays1);
+
+      for (size_t j=0; j<rays0.size(); j++)
+      {
+        if (rays0[j].geomID != rays1[j].geomID) return VerifyApplication::FAILED;
+        if (abs(rays0[j].tfar-rays1[j].tfar) > 1E-4f) return VerifyApplication::FAILED;
+      }
+      return VerifyApplication::PASSED;
+    }
+  };
+
+  struct SharedSceneTest : public VerifyApplication::Test
+  {
+    RTCSceneFlags sflags;
+
+    SharedSceneTest (std::string name, int isa, RTCSceneFlags sflags)
+      : VerifyApplication::Test(name,isa,VerifyApplication::TEST_SHOULD_PASS), sflags(sflags) {}
+
+    void trace(RTCScene scene, std::vector<RTCRay>& rays)
+    {
+      for (size_t j=0; j<64*64; j++) {
+        const float x = -2.5f + 5.0f*float(j%64)/63.0f;
+        const float z = -1.5f + 3.0f*float(j/64)/63.0f;
+        RTCRay ray = makeRay(Vec3fa(x,10,z),Vec3fa(0,-1,0));
+        rtcIntersect(scene,ray);
+        rays.push_back(ray);
+      }
+    }
+
+    VerifyApplication::TestReturnValue run(VerifyApplication* state, bool silent)
+    {
+      std::string cfg = state->rtcore + ",isa="+stringOfISA(isa);
+      Ref<SceneGraph::Node> trimesh = SceneGraph::createTriangleSphere(Vec3fa(-1,0,0),1.0f,100);
+      Ref<SceneGraph::Node> quadmesh = SceneGraph::createQuadSphere(Vec3fa(+1,0,0),1.0f,100);
+
+      /* build scene on first device and export it */
+      std::vector<RTCRay> rays0, rays1, rays2;
+      RTCSharedScene shared = nullptr;
+      {
+        RTCDeviceRef device = rtcNewDevice(cfg.c_str());
+        errorHandler(nullptr,rtcDeviceGetError(device));
+        VerifyScene scene(device,sflags,aflags);
+        scene.addGeometry(RTC_GEOMETRY_STATIC,trimesh);
+        scene.addGeometry(RTC_GEOMETRY_STATIC,quadmesh);
+        rtcCommit (scene);
+        trace(scene,rays0);
+        shared = rtcExportScene(scene);
+        AssertNoError(device);
+      }
+
+      /* import and trace scene from second device after the first device got released */
+      RTCDeviceRef device = rtcNewDevice((cfg+",threads=1").c_str());
+      errorHandler(nullptr,rtcDeviceGetError(device));
+      RTCSceneRef scene = rtcDeviceImportScene(device,shared);
+      rtcDeleteSharedScene(shared);
+      AssertNoError(device);
+      trace(scene,rays1);
+      AssertNoError(device);
+
+      /* imported scenes are read-only */
+      rtcNewTriangleMesh(scene,RTC_GEOMETRY_STATIC,1,3);
+      if (rtcDeviceGetError(device) != RTC_INVALID_OPERATION) return VerifyApplication::FAILED;
+
+      /* instance imported scene */
+      {
+        VerifyScene scene2(device,RTC_SCENE_STATIC,aflags);
+        rtcNewInstance3(scene2,scene,1);
+        rtcCommit(scene2);
+        AssertNoError(device);
+        trace(scene2,rays2);
+        AssertNoError(device);
+      }
+
+      for (size_t j=0; j<rays0.size(); j++)
+      {
+        if (rays0[j].geomID != rays1[j].geomID || rays0[j].geomID != rays2[j].geomID) return VerifyApplication::FAILED;
+        if (rays0[j].primID != rays1[j].primID || rays0[j].primID != rays2[j].primID) return VerifyApplication::FAILED;
+        if (rays0[j].tfar != rays1[j].tfar) return VerifyApplication::FAILED;
+        if (abs(rays0[j].tfar-rays2[j].tfar) > 1E-4f) return VerifyApplication::FAILED;
+      }
+      return VerifyApplication::PASSED;
+    }
+  };
+
+  struct AsyncCommitTest : public VerifyApplication::Test
+  {
+    RTCSceneFlags sflags;
+
+    AsyncCommitTest (std::string name, int isa, RTCSceneFlags sflags)
+      : VerifyApplication::Test(name,isa,VerifyApplication::TEST_SHOULD_PASS), sflags(sflags) {}
+
+    void trace(RTCScene scene, std::vector<RTCRay>& rays)
+    {
+      rays.clear();
+      for (size_t j=0; j<64*64; j++) {
+        const float x = -2.5f + 5.0f*float(j%64)/63.0f;
+        const float z = -1.5f + 3.0f*float(j/64)/63.0f;
+        RTCRay ray = makeRay(Vec3fa(x,10,z),Vec3fa(0,-1,0));
+        rtcIntersect(scene,ray);
+        rays.push_back(ray);
+      }
+    }
+
+    static bool equal(const RTCRay& ray0, const RTCRay& ray1)
+    {
+      if ((ray0.geomID == RTC_INVALID_GEOMETRY_ID) != (ray1.geomID == RTC_INVALID_GEOMETRY_ID)) return false;
+      if (ray0.geomID == RTC_INVALID_GEOMETRY_ID) return true;
+      return ray0.primID == ray1.primID && abs(ray0.tfar-ray1.tfar) <= 1E-4f;
+    }
+
+    /* each ray has to hit either the previous or the new version of the scene */
+    static bool valid(const std::vector<RTCRay>& rays, const std::vector<RTCRay>& prev, const std::vector<RTCRay>& next)
+    {
+      for (size_t j=0; j<rays.size(); j++)
+        if (!equal(rays[j],prev[j]) && !equal(rays[j],next[j])) return false;
+      return true;
+    }
+
+    VerifyApplication::TestReturnValue run(VerifyApplication* state, bool silent)
+    {
+      std::string cfg = state->rtcore + ",isa="+stringOfISA(isa);
+      RTCDeviceRef device = rtcNewDevice(cfg.c_str());
+      errorHandler(nullptr,rtcDeviceGetError(device));
+      Ref<SceneGraph::Node> sphereA = SceneGraph::createTriangleSphere(Vec3fa(-1,0,0),1.0f,200);
+      Ref<SceneGraph::Node> sphereB = SceneGraph::createQuadSphere(Vec3fa(+1,0,0),1.0f,200);
+
+      /* reference results of both versions */
+      std::vector<RTCRay> raysA, raysB, rays;
+      {
+        VerifyScene sceneA(device,sflags,aflags);
+        sceneA.addGeometry(RTC_GEOMETRY_STATIC,sphereA);
+        rtcCommit(sceneA);
+        trace(sceneA,raysA);
+        VerifyScene sceneB(device,sflags,aflags);
+        sceneB.addGeometry(RTC_GEOMETRY_STATIC,sphereB);
+        rtcCommit(sceneB);
+        trace(sceneB,raysB);
+        AssertNoError(device);
+      }
+
+      VerifyScene scene(device,sflags,aflags);
+      unsigned geomID = scene.addGeometry(RTC_GEOMETRY_STATIC,sphereA);
+      rtcCommitAsync(scene);
+      rtcCommitWait(scene);
+      AssertNoError(device);
+      trace(scene,rays);
+      if (!valid(rays,raysA,raysA)) return VerifyApplication::FAILED;
+
+      /* alternate between both versions, rays traced during the build hit the previous version */
+      for (size_t i=0; i<4; i++)
+      {
+        const bool toB = (i%2) == 0;
+        rtcDeleteGeometry(scene,geomID);
+        geomID = scene.addGeometry(RTC_GEOMETRY_STATIC,toB ? sphereB : sphereA);
+        rtcCommitAsync(scene);
+        AssertNoError(device);
+        while (!rtcCommitFinished(scene)) {
+          trace(scene,rays);
+          if (!valid(rays,toB ? raysA : raysB,toB ? raysB : raysA)) return VerifyApplication::FAILED;
+        }
+        AssertNoError(device);
+        trace(scene,rays);
+        if (!valid(rays,toB ? raysB : raysA,toB ? raysB : raysA)) return VerifyApplication::FAILED;
+      }
+
+      /* synchronous commits of asynchronously committed scenes */
+      rtcDeleteGeometry(scene,geomID);
+      geomID = scene.addGeometry(RTC_GEOMETRY_STATIC,sphereB);
+      rtcCommitAsync(scene);
+      rtcCommit(scene);
+      AssertNoError(device);
+      trace(scene,rays);
+      if (!valid(rays,raysB,raysB)) return VerifyApplication::FAILED;
+      return VerifyApplication::PASSED;
+    }
+  };
+
+  struct SceneStatisticsTest : public VerifyApplication::Test
+  {
+    RTCSceneFlags sflags;
+
+    SceneStatisticsTest (std::string name, int isa, RTCSceneFlags sflags)
+      : VerifyApplication::Test(name,isa,VerifyApplication::TEST_SHOULD_PASS), sflags(sflags) {}
+
+    VerifyApplication::TestReturnValue run(VerifyApplication* state, bool silent)
+    {
+      std::string cfg = state->rtcore + ",isa="+stringOfISA(isa);
+      RTCDeviceRef device = rtcNewDevice(cfg.c_str());
+      errorHandler(nullptr,rtcDeviceGetError(device));
+      Ref<SceneGraph::Node> sphere = SceneGraph::createTriangleSphere(Vec3fa(0,0,0),1.0f,100);
+
+      VerifyScene scene(device,sflags,aflags);
+      scene.addGeometry(RTC_GEOMETRY_STATIC,sphere);
+      RTCSceneStatistics stats;
+      rtcGetSceneStatistics(scene,&stats);
+      AssertError(device,RTC_INVALID_OPERATION); // error, scene not committed
+      rtcCommit(scene);
+      rtcGetSceneStatistics(scene,&stats);
+      AssertNoError(device);
+
+      if (stats.commitTime <= 0.0 || stats.buildTime <= 0.0) return VerifyApplication::FAILED;
+      if (stats.primRefTime < 0.0 || stats.hierarchyTime < 0.0) return VerifyApplication::FAILED;
+      if (stats.numPrimitives < sphere->numPrimitives()) return VerifyApplication::FAILED;
+      if (stats.numLeaves == 0 || stats.numPrimBlocks < stats.numLeaves) return VerifyApplication::FAILED;
+      const size_t numNodes = stats.numAlignedNodes + stats.numUnalignedNodes + stats.numAlignedNodesMB + stats.numAlignedNodesMB4D
+        + stats.numUnalignedNodesMB + stats.numTransformNodes + stats.numQuantizedNodes;
+      if (numNodes == 0 || stats.depth == 0) return VerifyApplication::FAILED;
+      if (stats.nodeFillRate <= 0.0 || stats.nodeFillRate > 1.0) return VerifyApplication::FAILED;
+      if (stats.leafFillRate <= 0.0 || stats.leafFillRate > 1.0) return VerifyApplication::FAILED;
+      if (stats.sah <= 0.0) return VerifyApplication::FAILED;
+      if (stats.bytesUsed == 0) return VerifyApplication::FAILED;
+      return VerifyApplication::PASSED;
+    }
+  };
+
   struct OverlappingGeometryTest : public VerifyApplication::Test
   {
     RTCSceneFlags sflags;
@@ -1630,14 +2115,72 @@ namespace embree
     }
   };
 
-  struct GarbageGeometryTest : public VerifyApplication::Test
+  struct IncrementalUpdateTest : public VerifyApplication::Test
   {
-    GarbageGeometryTest (std::string name, int isa)
-      : VerifyApplication::Test(name,isa,VerifyApplication::TEST_SHOULD_PASS) {}
+    RTCSceneFlags sflags;
+    RTCGeometryFlags gflags;
+
+    IncrementalUpdateTest (std::string name, int isa, RTCSceneFlags sflags, RTCGeometryFlags gflags)
+      : VerifyApplication::Test(name,isa,VerifyApplication::TEST_SHOULD_PASS), sflags(sflags), gflags(gflags) {}
     
     VerifyApplication::TestReturnValue run(VerifyApplication* state, bool silent)
     {
-      std::string cfg = state->rtcore + "isa="+stringOfISA(isa);
+      std::string cfg = state->rtcore + ",isa="+stringOfISA(isa);
+      RTCDeviceRef device = rtcNewDevice(cfg.c_str());
+      errorHandler(nullptr,rtcDeviceGetError(device));
+      VerifyScene scene(device,sflags,aflags);
+      AssertNoError(device);
+
+      /* grid of spheres of which only few get moved per commit */
+      const size_t numSpheres = 64;
+      const size_t numPhi = 8;
+      const size_t numVertices = 2*numPhi*(numPhi+1);
+      std::vector<Vec3fa> pos(numSpheres);
+      std::vector<unsigned> geom(numSpheres);
+      for (size_t i=0; i<numSpheres; i++) {
+        pos[i] = Vec3fa(2.0f*float(i%8),0.0f,2.0f*float(i/8));
+        geom[i] = scene.addSphere(sampler,gflags,pos[i],0.5f,numPhi).first;
+      }
+      rtcCommit (scene);
+      AssertNoError(device);
+
+      for (size_t i=0; i<32; i++) 
+      {
+        /* move some spheres up and down, which changes their bounds in the top level hierarchy */
+        for (size_t j=0; j<2; j++) 
+        {
+          const size_t k = (7*i+29*j+3) % numSpheres;
+          Vec3fa ds(0.0f,float((i+j)%3)*10.0f-pos[k].y,0.0f);
+          UpdateTest::move_mesh(scene,geom[k],numVertices,ds); pos[k] += ds;
+        }
+        rtcCommit (scene);
+        AssertNoError(device);
+
+        /* rays through the sphere centers hit that sphere, rays between the spheres miss */
+        for (size_t k=0; k<numSpheres; k++)
+        {
+          RTCRay ray0 = makeRay(pos[k]+Vec3fa(0,50,0),Vec3fa(0,-1,0));
+          RTCRay ray1 = makeRay(pos[k]+Vec3fa(1,50,1),Vec3fa(0,-1,0));
+          rtcIntersect(scene,ray0);
+          rtcIntersect(scene,ray1);
+          if (ray0.geomID != geom[k]) return VerifyApplication::FAILED;
+          if (ray1.geomID != RTC_INVALID_GEOMETRY_ID) return VerifyApplication::FAILED;
+        }
+      }
+      AssertNoError(device);
+
+      return VerifyApplication::PASSED;
+    }
+  };
+
+  struct GarbageGeometryTest : public VerifyApplication::Test
+  {
+    GarbageGeometryTest (std::string name, int isa)
+      : VerifyApplication::Test(name,isa,VerifyApplication::TEST_SHOULD_PASS) {}
+    
+    VerifyApplication::TestReturnValue run(VerifyApplication* state, bool silent)
+    {
+      std::string cfg = state->rtcore + "isa="+stringOfISA(isa);
       RTCDeviceRef device = rtcNewDevice(cfg.c_str());
       errorHandler(nullptr,rtcDeviceGetError(device));
 
@@ -1963,134 +2506,1190 @@ namespace embree
       AssertNoError(device);
       rtcCommit(scene);
       AssertNoError(device);
-      
-      bool passed = true;
-      passed &= checkTriangleInterpolation(scene,geomID,RTC_VERTEX_BUFFER0,vertices0.data(),N,N);
-      //passed &= checkTriangleInterpolation(scene,geomID,RTC_VERTEX_BUFFER1,vertices1.data(),N,N);
-      passed &= checkTriangleInterpolation(scene,geomID,RTC_USER_VERTEX_BUFFER0,user_vertices0.data(),N,N);
-      passed &= checkTriangleInterpolation(scene,geomID,RTC_USER_VERTEX_BUFFER1,user_vertices1.data(),N,N);
-      
-      passed &= checkTriangleInterpolation(scene,geomID,RTC_VERTEX_BUFFER0,vertices0.data(),1,N);
-      //passed &= checkTriangleInterpolation(scene,geomID,RTC_VERTEX_BUFFER1,vertices1.data(),1,N);
-      passed &= checkTriangleInterpolation(scene,geomID,RTC_USER_VERTEX_BUFFER0,user_vertices0.data(),1,N);
-      passed &= checkTriangleInterpolation(scene,geomID,RTC_USER_VERTEX_BUFFER1,user_vertices1.data(),1,N);
-      
+      
+      bool passed = true;
+      passed &= checkTriangleInterpolation(scene,geomID,RTC_VERTEX_BUFFER0,vertices0.data(),N,N);
+      //passed &= checkTriangleInterpolation(scene,geomID,RTC_VERTEX_BUFFER1,vertices1.data(),N,N);
+      passed &= checkTriangleInterpolation(scene,geomID,RTC_USER_VERTEX_BUFFER0,user_vertices0.data(),N,N);
+      passed &= checkTriangleInterpolation(scene,geomID,RTC_USER_VERTEX_BUFFER1,user_vertices1.data(),N,N);
+      
+      passed &= checkTriangleInterpolation(scene,geomID,RTC_VERTEX_BUFFER0,vertices0.data(),1,N);
+      //passed &= checkTriangleInterpolation(scene,geomID,RTC_VERTEX_BUFFER1,vertices1.data(),1,N);
+      passed &= checkTriangleInterpolation(scene,geomID,RTC_USER_VERTEX_BUFFER0,user_vertices0.data(),1,N);
+      passed &= checkTriangleInterpolation(scene,geomID,RTC_USER_VERTEX_BUFFER1,user_vertices1.data(),1,N);
+      
+      AssertNoError(device);
+
+      return (VerifyApplication::TestReturnValue) passed;
+    }
+  };
+  
+  const size_t num_interpolation_hair_vertices = 13;
+  const size_t num_interpolation_hairs = 4;
+
+  __aligned(16) int interpolation_hair_indices[num_interpolation_hairs] = {
+    0, 3, 6, 9
+  };
+
+  struct InterpolateHairTest : public VerifyApplication::Test
+  {
+    size_t N;
+    
+    InterpolateHairTest (std::string name, int isa, size_t N)
+      : VerifyApplication::Test(name,isa,VerifyApplication::TEST_SHOULD_PASS), N(N) {}
+    
+    bool checkHairInterpolation(const RTCSceneRef& scene, int geomID, int primID, float u, float v, int v0, RTCBufferType buffer, float* data, size_t N, size_t N_total)
+    {
+      bool passed = true;
+      float P[256], dPdu[256], dPdv[256];
+      rtcInterpolate(scene,geomID,primID,u,v,buffer,P,dPdu,dPdv,N);
+      
+      for (size_t i=0; i<N; i++) {
+        const float p00 = data[(v0+0)*N_total+i];
+        const float p01 = data[(v0+1)*N_total+i];
+        const float p02 = data[(v0+2)*N_total+i];
+        const float p03 = data[(v0+3)*N_total+i];
+        const float t0 = 1.0f - u, t1 = u;
+        const float p10 = p00 * t0 + p01 * t1;
+        const float p11 = p01 * t0 + p02 * t1;
+        const float p12 = p02 * t0 + p03 * t1;
+        const float p20 = p10 * t0 + p11 * t1;
+        const float p21 = p11 * t0 + p12 * t1;
+        const float p30 = p20 * t0 + p21 * t1;
+        passed &= fabs(p30-P[i]) < 1E-4f;
+      }
+      return passed;
+    }
+    
+    bool checkHairInterpolation(const RTCSceneRef& scene, int geomID, RTCBufferType buffer, float* vertices0, size_t N, size_t N_total)
+    {
+      bool passed = true;
+      passed &= checkHairInterpolation(scene,geomID,0,0.0f,0.0f,0,buffer,vertices0,N,N_total);
+      passed &= checkHairInterpolation(scene,geomID,1,0.5f,0.0f,3,buffer,vertices0,N,N_total);
+      passed &= checkHairInterpolation(scene,geomID,2,0.0f,0.0f,6,buffer,vertices0,N,N_total);
+      passed &= checkHairInterpolation(scene,geomID,3,0.2f,0.0f,9,buffer,vertices0,N,N_total);
+      return passed;
+    }
+    
+    VerifyApplication::TestReturnValue run(VerifyApplication* state, bool silent)
+    {
+      std::string cfg = state->rtcore + ",isa="+stringOfISA(isa);
+      RTCDeviceRef device = rtcNewDevice(cfg.c_str());
+      errorHandler(nullptr,rtcDeviceGetError(device));
+
+      size_t M = num_interpolation_vertices*N+16; // padds the arrays with some valid data
+      
+      RTCSceneRef scene = rtcDeviceNewScene(device,RTC_SCENE_DYNAMIC,RTC_INTERPOLATE);
+      AssertNoError(device);
+      unsigned int geomID = rtcNewBezierHairGeometry(scene, RTC_GEOMETRY_STATIC, num_interpolation_hairs, num_interpolation_hair_vertices, 1);
+      AssertNoError(device);
+      
+      rtcSetBuffer(scene, geomID, RTC_INDEX_BUFFER,  interpolation_hair_indices , 0, sizeof(unsigned int));
+      AssertNoError(device);
+      
+      std::vector<float> vertices0(M);
+      for (size_t i=0; i<M; i++) vertices0[i] = random_float();
+      rtcSetBuffer(scene, geomID, RTC_VERTEX_BUFFER0, vertices0.data(), 0, N*sizeof(float));
+      AssertNoError(device);
+      
+      /*std::vector<float> vertices1(M);
+        for (size_t i=0; i<M; i++) vertices1[i] = random_float();
+        rtcSetBuffer(scene, geomID, RTC_VERTEX_BUFFER1, vertices1.data(), 0, N*sizeof(float));
+        AssertNoError(device);*/
+      
+      std::vector<float> user_vertices0(M);
+      for (size_t i=0; i<M; i++) user_vertices0[i] = random_float();
+      rtcSetBuffer(scene, geomID, RTC_USER_VERTEX_BUFFER0, user_vertices0.data(), 0, N*sizeof(float));
+      AssertNoError(device);
+      
+      std::vector<float> user_vertices1(M);
+      for (size_t i=0; i<M; i++) user_vertices1[i] = random_float();
+      rtcSetBuffer(scene, geomID, RTC_USER_VERTEX_BUFFER1, user_vertices1.data(), 0, N*sizeof(float));
+      AssertNoError(device);
+      
+      rtcDisable(scene,geomID);
+      AssertNoError(device);
+      rtcCommit(scene);
+      AssertNoError(device);
+      
+      bool passed = true;
+      passed &= checkHairInterpolation(scene,geomID,RTC_VERTEX_BUFFER0,vertices0.data(),N,N);
+      //passed &= checkHairInterpolation(scene,geomID,RTC_VERTEX_BUFFER1,vertices1.data(),N,N);
+      passed &= checkHairInterpolation(scene,geomID,RTC_USER_VERTEX_BUFFER0,user_vertices0.data(),N,N);
+      passed &= checkHairInterpolation(scene,geomID,RTC_USER_VERTEX_BUFFER1,user_vertices1.data(),N,N);
+      
+      passed &= checkHairInterpolation(scene,geomID,RTC_VERTEX_BUFFER0,vertices0.data(),1,N);
+      //passed &= checkHairInterpolation(scene,geomID,RTC_VERTEX_BUFFER1,vertices1.data(),1,N);
+      passed &= checkHairInterpolation(scene,geomID,RTC_USER_VERTEX_BUFFER0,user_vertices0.data(),1,N);
+      passed &= checkHairInterpolation(scene,geomID,RTC_USER_VERTEX_BUFFER1,user_vertices1.data(),1,N);
+      
+      AssertNoError(device);
+
+      return (VerifyApplication::TestReturnValue) passed;
+    }
+  };
+
+  /////////////////////////////////////////////////////////////////////////////////
+  /////////////////////////////////////////////////////////////////////////////////
+  /////////////////////////////////////////////////////////////////////////////////
+  /////////////////////////////////////////////////////////////////////////////////
+
+  struct RayStreamSortTest : public VerifyApplication::IntersectTest
+  {
+    RTCSceneFlags sflags;
+
+    RayStreamSortTest (std::string name, int isa, RTCSceneFlags sflags, IntersectMode imode, IntersectVariant ivariant)
+      : VerifyApplication::IntersectTest(name,isa,imode,ivariant,VerifyApplication::TEST_SHOULD_PASS), sflags(sflags) {}
+
+    VerifyApplication::TestReturnValue run(VerifyApplication* state, bool silent)
+    {
+      std::string cfg = state->rtcore + ",isa="+stringOfISA(isa)+",ray_stream_sort_size=256";
+      RTCDeviceRef device = rtcNewDevice(cfg.c_str());
+      errorHandler(nullptr,rtcDeviceGetError(device));
+      if (!supportsIntersectMode(device,imode))
+        return VerifyApplication::SKIPPED;
+
+      VerifyScene scene(device,sflags,aflags_all);
+      scene.addGeometry(RTC_GEOMETRY_STATIC,SceneGraph::createTriangleSphere(Vec3fa(-1,0,0),1.0f,50));
+      scene.addGeometry(RTC_GEOMETRY_STATIC,SceneGraph::createQuadSphere(Vec3fa(+1,0,0),1.0f,50));
+      rtcCommit(scene);
+      AssertNoError(device);
+
+      /* incoherent rays of all octants, some of them invalid */
+      const size_t numRays = 1000;
+      vector_t<RTCRay,aligned_allocator<RTCRay,16>> rays(numRays), rays_ref(numRays);
+      for (size_t i=0; i<numRays; i++)
+      {
+        const Vec3fa org(4.0f*random_float()-2.0f,4.0f*random_float()-2.0f,4.0f*random_float()-2.0f);
+        const Vec3fa dir(2.0f*random_float()-1.0f,2.0f*random_float()-1.0f,2.0f*random_float()-1.0f);
+        rays[i] = rays_ref[i] = i%17 == 0 ? makeRay(org,dir,pos_inf,neg_inf) : makeRay(org,dir);
+      }
+      IntersectWithMode(MODE_INTERSECT1,ivariant,scene,rays_ref.data(),numRays);
+      IntersectWithMode(imode,ivariant,scene,rays.data(),numRays);
+      AssertNoError(device);
+
+      for (size_t i=0; i<numRays; i++)
+      {
+        if ((rays[i].geomID == RTC_INVALID_GEOMETRY_ID) != (rays_ref[i].geomID == RTC_INVALID_GEOMETRY_ID)) return VerifyApplication::FAILED;
+        if (ivariant & VARIANT_OCCLUDED) continue;
+        if (rays[i].geomID != rays_ref[i].geomID) return VerifyApplication::FAILED;
+        if (rays[i].primID != rays_ref[i].primID) return VerifyApplication::FAILED;
+        if (abs(rays[i].tfar-rays_ref[i].tfar) > 1E-4f) return VerifyApplication::FAILED;
+      }
+      return VerifyApplication::PASSED;
+    }
+  };
+
+  struct NestedInstanceTest : public VerifyApplication::IntersectTest
+  {
+    RTCSceneFlags sflags;
+
+    NestedInstanceTest (std::string name, int isa, RTCSceneFlags sflags, IntersectMode imode, IntersectVariant ivariant)
+      : VerifyApplication::IntersectTest(name,isa,imode,ivariant,VerifyApplication::TEST_SHOULD_PASS), sflags(sflags) {}
+
+    /* offset of the two instances of level l-1 in the scene of level l */
+    static float instanceOffset(size_t l) {
+      return 1.5f*float(1 << (l-1));
+    }
+
+    /* computes the expected instance IDs of a ray along the z axis, returns false if the ray is too close to some silhouette */
+    bool expectedHit(float x, unsigned& geomID, unsigned instIDs[RTC_MAX_INSTANCE_LEVEL_COUNT])
+    {
+      for (size_t l=0; l<RTC_MAX_INSTANCE_LEVEL_COUNT; l++)
+        instIDs[l] = RTC_INVALID_GEOMETRY_ID;
+
+      for (size_t l=RTC_MAX_INSTANCE_LEVEL_COUNT, i=0; l>0; l--, i++)
+      {
+        if (abs(abs(x)-0.25f) < 0.05f) return false;
+        if (abs(x) < 0.25f) { geomID = 0; return true; }
+        instIDs[i] = x < 0.0f ? 1 : 2;
+        x -= x < 0.0f ? -instanceOffset(l) : instanceOffset(l);
+      }
+      if (abs(abs(x)-1.0f) < 0.05f) return false;
+      geomID = abs(x) < 1.0f ? 0 : RTC_INVALID_GEOMETRY_ID;
+      if (geomID == RTC_INVALID_GEOMETRY_ID)
+        for (size_t l=0; l<RTC_MAX_INSTANCE_LEVEL_COUNT; l++)
+          instIDs[l] = RTC_INVALID_GEOMETRY_ID;
+      return true;
+    }
+
+    VerifyApplication::TestReturnValue run(VerifyApplication* state, bool silent)
+    {
+      std::string cfg = state->rtcore + ",isa="+stringOfISA(isa);
+      RTCDeviceRef device = rtcNewDevice(cfg.c_str());
+      errorHandler(nullptr,rtcDeviceGetError(device));
+      if (!supportsIntersectMode(device,imode))
+        return VerifyApplication::SKIPPED;
+
+      /* the scene of level l contains a small sphere and two instances of the scene of level l-1 */
+      std::vector<Ref<VerifyScene>> scenes;
+      scenes.push_back(new VerifyScene(device,sflags,aflags_all));
+      scenes.back()->addGeometry(RTC_GEOMETRY_STATIC,SceneGraph::createTriangleSphere(Vec3fa(0,0,0),1.0f,50));
+      rtcCommit(*scenes.back());
+      AssertNoError(device);
+
+      for (size_t l=1; l<=RTC_MAX_INSTANCE_LEVEL_COUNT+1; l++)
+      {
+        scenes.push_back(new VerifyScene(device,sflags,aflags_all));
+        VerifyScene& scene = *scenes.back();
+        scene.addGeometry(RTC_GEOMETRY_STATIC,SceneGraph::createTriangleSphere(Vec3fa(0,0,0),0.25f,50));
+        for (float s : { -1.0f, +1.0f })
+        {
+          const AffineSpace3fa xfm = AffineSpace3fa::translate(Vec3fa(s*instanceOffset(l),0,0));
+          unsigned geomID = rtcNewInstance3(scene,*scenes[l-1],1);
+          rtcSetTransform2(scene,geomID,RTC_MATRIX_COLUMN_MAJOR_ALIGNED16,(float*)&xfm,0);
+        }
+        AssertNoError(device);
+        rtcCommit(scene);
+
+        /* one level more than supported has to fail */
+        if (l > RTC_MAX_INSTANCE_LEVEL_COUNT) {
+          if (rtcDeviceGetError(device) != RTC_INVALID_OPERATION) return VerifyApplication::FAILED;
+          scenes.pop_back();
+        }
+        AssertNoError(device);
+      }
+
+      /* trace rays along the z axis through the outermost scene */
+      const float width = 3.0f*float(1 << RTC_MAX_INSTANCE_LEVEL_COUNT);
+      const size_t numRays = 1000;
+      vector_t<RTCRay,aligned_allocator<RTCRay,16>> rays(numRays);
+      for (size_t i=0; i<numRays; i++)
+        rays[i] = makeRay(Vec3fa(width*(float(i)/float(numRays)-0.5f),0,10),Vec3fa(0,0,-1));
+      IntersectWithMode(imode,ivariant,*scenes.back(),rays.data(),numRays);
+      AssertNoError(device);
+
+      for (size_t i=0; i<numRays; i++)
+      {
+        unsigned geomID; unsigned instIDs[RTC_MAX_INSTANCE_LEVEL_COUNT];
+        if (!expectedHit(rays[i].org[0],geomID,instIDs)) continue;
+        if ((rays[i].geomID == RTC_INVALID_GEOMETRY_ID) != (geomID == RTC_INVALID_GEOMETRY_ID)) return VerifyApplication::FAILED;
+        if (ivariant & VARIANT_OCCLUDED) continue;
+        if (rays[i].geomID != geomID) return VerifyApplication::FAILED;
+        if (rays[i].instID != instIDs[0]) return VerifyApplication::FAILED;
+#if RTC_MAX_INSTANCE_LEVEL_COUNT > 1
+        for (size_t l=1; l<RTC_MAX_INSTANCE_LEVEL_COUNT; l++)
+          if (rays[i].nestedInstID[l-1] != instIDs[l]) return VerifyApplication::FAILED;
+#endif
+      }
+      return VerifyApplication::PASSED;
+    }
+  };
+
+  struct QuaternionInstanceTest : public VerifyApplication::IntersectTest
+  {
+    RTCSceneFlags sflags;
+
+    QuaternionInstanceTest (std::string name, int isa, RTCSceneFlags sflags, IntersectMode imode, IntersectVariant ivariant)
+      : VerifyApplication::IntersectTest(name,isa,imode,ivariant,VerifyApplication::TEST_SHOULD_PASS), sflags(sflags) {}
+
+    VerifyApplication::TestReturnValue run(VerifyApplication* state, bool silent)
+    {
+      std::string cfg = state->rtcore + ",isa="+stringOfISA(isa);
+      RTCDeviceRef device = rtcNewDevice(cfg.c_str());
+      errorHandler(nullptr,rtcDeviceGetError(device));
+      if (!supportsIntersectMode(device,imode))
+        return VerifyApplication::SKIPPED;
+
+      VerifyScene scene0(device,RTC_SCENE_STATIC,aflags_all);
+      scene0.addGeometry(RTC_GEOMETRY_STATIC,SceneGraph::createTriangleSphere(Vec3fa(4,0,0),0.5f,50));
+      rtcCommit(scene0);
+      AssertNoError(device);
+
+      /* instance rotating by 180 degrees around the z axis in two time segments */
+      const size_t numTimeSteps = 3;
+      VerifyScene scene1(device,sflags,aflags_all);
+      unsigned geomID = rtcNewInstance3(scene1,scene0,numTimeSteps);
+      for (size_t t=0; t<numTimeSteps; t++) {
+        const AffineSpace3fa xfm = AffineSpace3fa::rotate(Vec3fa(0,0,1),float(pi)*float(t)/float(numTimeSteps-1));
+        rtcSetTransform2(scene1,geomID,RTC_MATRIX_COLUMN_MAJOR_ALIGNED16,(float*)&xfm,t);
+      }
+      rtcSetTransformInterpolation(scene1,geomID,RTC_TRANSFORM_INTERPOLATION_QUATERNION);
+      rtcCommit(scene1);
+      AssertNoError(device);
+
+      /* rays towards the rotated sphere center hit, rays towards the linearly interpolated center miss */
+      const size_t numRays = 256;
+      vector_t<RTCRay,aligned_allocator<RTCRay,16>> rays(numRays);
+      std::vector<bool> skip(numRays);
+      for (size_t i=0; i<numRays; i++)
+      {
+        const float time = random_float();
+        const float angle = float(pi)*time;
+        const Vec3fa rotated(4.0f*cos(angle),4.0f*sin(angle),0.0f);
+        const Vec3fa linear(4.0f-8.0f*time,time < 0.5f ? 8.0f*time : 8.0f-8.0f*time,0.0f);
+        skip[i] = i%2 == 0 && length(rotated-linear) < 1.0f; // linearly interpolated center is too close to the sphere
+        rays[i] = makeRay((i%2 ? rotated : linear)+Vec3fa(0,0,10),Vec3fa(0,0,-1));
+        rays[i].time = time;
+      }
+      IntersectWithMode(imode,ivariant,scene1,rays.data(),numRays);
+      AssertNoError(device);
+
+      for (size_t i=0; i<numRays; i++)
+      {
+        if (skip[i]) continue;
+        if ((rays[i].geomID == RTC_INVALID_GEOMETRY_ID) != (i%2 == 0)) return VerifyApplication::FAILED;
+        if (ivariant & VARIANT_OCCLUDED) continue;
+        if (i%2 && abs(rays[i].tfar-9.5f) > 1E-2f) return VerifyApplication::FAILED;
+      }
+      return VerifyApplication::PASSED;
+    }
+  };
+
+  struct RayPacketRepackingTest : public VerifyApplication::IntersectTest
+  {
+    RTCSceneFlags sflags;
+
+    RayPacketRepackingTest (std::string name, int isa, RTCSceneFlags sflags, IntersectMode imode, IntersectVariant ivariant)
+      : VerifyApplication::IntersectTest(name,isa,imode,ivariant,VerifyApplication::TEST_SHOULD_PASS), sflags(sflags) {}
+
+    VerifyApplication::TestReturnValue run(VerifyApplication* state, bool silent)
+    {
+      std::string cfg = state->rtcore + ",isa="+stringOfISA(isa)+",ray_packet_repacking=1";
+      RTCDeviceRef device = rtcNewDevice(cfg.c_str());
+      errorHandler(nullptr,rtcDeviceGetError(device));
+      if (!supportsIntersectMode(device,imode))
+        return VerifyApplication::SKIPPED;
+
+      VerifyScene scene(device,sflags,aflags_all);
+      scene.addGeometry(RTC_GEOMETRY_STATIC,SceneGraph::createTriangleSphere(Vec3fa(-1,0,0),1.0f,50));
+      scene.addGeometry(RTC_GEOMETRY_STATIC,SceneGraph::createQuadSphere(Vec3fa(+1,0,0),1.0f,50));
+      rtcCommit(scene);
+      AssertNoError(device);
+
+      /* incoherent rays of all octants, most of them invalid to get partially active packets */
+      const size_t numRays = 1000;
+      vector_t<RTCRay,aligned_allocator<RTCRay,16>> rays(numRays), rays_ref(numRays);
+      for (size_t i=0; i<numRays; i++)
+      {
+        const Vec3fa org(4.0f*random_float()-2.0f,4.0f*random_float()-2.0f,4.0f*random_float()-2.0f);
+        const Vec3fa dir(2.0f*random_float()-1.0f,2.0f*random_float()-1.0f,2.0f*random_float()-1.0f);
+        rays[i] = rays_ref[i] = i%3 || i%64 < 8 ? makeRay(org,dir) : makeRay(org,dir,pos_inf,neg_inf);
+      }
+      IntersectWithMode(MODE_INTERSECT1,ivariant,scene,rays_ref.data(),numRays);
+      IntersectWithMode(imode,ivariant,scene,rays.data(),numRays);
+      AssertNoError(device);
+
+      for (size_t i=0; i<numRays; i++)
+      {
+        if ((rays[i].geomID == RTC_INVALID_GEOMETRY_ID) != (rays_ref[i].geomID == RTC_INVALID_GEOMETRY_ID)) return VerifyApplication::FAILED;
+        if (ivariant & VARIANT_OCCLUDED) continue;
+        if (rays[i].geomID != rays_ref[i].geomID) return VerifyApplication::FAILED;
+        if (rays[i].primID != rays_ref[i].primID) return VerifyApplication::FAILED;
+        if (abs(rays[i].tfar-rays_ref[i].tfar) > 1E-4f) return VerifyApplication::FAILED;
+      }
+      return VerifyApplication::PASSED;
+    }
+  };
+
+  struct KNearestHitsTest : public VerifyApplication::IntersectTest
+  {
+    RTCSceneFlags sflags;
+    static const unsigned K = 3;
+
+    KNearestHitsTest (std::string name, int isa, RTCSceneFlags sflags, IntersectMode imode)
+      : VerifyApplication::IntersectTest(name,isa,imode,VARIANT_INTERSECT,VerifyApplication::TEST_SHOULD_PASS), sflags(sflags) {}
+
+    /* rejects all hits of odd primitives */
+    static void rejectOddFilterN(int* valid, void* userPtr, const RTCIntersectContext* context, RTCRayN* ray, const RTCHitN* hit, const size_t N)
+    {
+      for (size_t i=0; i<N; i++)
+        if (RTCHitN_primID(hit,N,i) & 1) valid[i] = 0;
+    }
+
+    /* records all hits of a ray without accepting any, used to compute the reference */
+    static void recordFilterN(int* valid, void* userPtr, const RTCIntersectContext* context, RTCRayN* ray, const RTCHitN* hit, const size_t N)
+    {
+      std::vector<RTCHit>& hits = *(std::vector<RTCHit>*) context->userRayExt;
+      for (size_t i=0; i<N; i++)
+      {
+        if (valid[i] == 0) continue;
+        valid[i] = 0;
+        if (userPtr && (RTCHitN_primID(hit,N,i) & 1)) continue;
+        RTCHit h;
+        h.t = RTCHitN_t(hit,N,i); h.u = RTCHitN_u(hit,N,i); h.v = RTCHitN_v(hit,N,i);
+        h.Ng[0] = RTCHitN_Ng_x(hit,N,i); h.Ng[1] = RTCHitN_Ng_y(hit,N,i); h.Ng[2] = RTCHitN_Ng_z(hit,N,i);
+        h.geomID = RTCHitN_geomID(hit,N,i); h.primID = RTCHitN_primID(hit,N,i); h.instID = RTCHitN_instID(hit,N,i);
+        hits.push_back(h);
+      }
+    }
+
+    /* two spheres and an instanced sphere, the filter function is only set for the reference scene */
+    void createScene(VerifyScene& scene, VerifyScene& object, bool reference)
+    {
+      const unsigned geomID0 = scene.addGeometry(RTC_GEOMETRY_STATIC,SceneGraph::createTriangleSphere(Vec3fa(-1,0,0),1.0f,50));
+      const unsigned geomID1 = scene.addGeometry(RTC_GEOMETRY_STATIC,SceneGraph::createQuadSphere(Vec3fa(+1,0,0),1.0f,50));
+      const unsigned geomID2 = object.addGeometry(RTC_GEOMETRY_STATIC,SceneGraph::createTriangleSphere(Vec3fa(0,0,0),1.5f,50));
+      if (reference) rtcSetIntersectionFilterFunctionN(object,geomID2,recordFilterN);
+      rtcCommit(object);
+      const AffineSpace3fa xfm = AffineSpace3fa::translate(Vec3fa(0,0.5f,0));
+      const unsigned geomID3 = rtcNewInstance3(scene,object,1);
+      rtcSetTransform2(scene,geomID3,RTC_MATRIX_COLUMN_MAJOR_ALIGNED16,(float*)&xfm,0);
+      if (reference) {
+        rtcSetIntersectionFilterFunctionN(scene,geomID0,recordFilterN);
+        rtcSetIntersectionFilterFunctionN(scene,geomID1,recordFilterN);
+        rtcSetUserData(scene,geomID1,(void*)1);
+      } else {
+        rtcSetIntersectionFilterFunctionN(scene,geomID1,rejectOddFilterN);
+      }
+      rtcCommit(scene);
+    }
+
+    template<typename RTCRayK, size_t N, typename Func>
+    static void intersectKNearestK(RTCRay* rays, RTCHitBuffer* hits, size_t numRays, const Func& func)
+    {
+      for (size_t i=0; i<numRays; i+=N)
+      {
+        const size_t M = min(N,numRays-i);
+        __aligned(64) int valid[N];
+        RTCRayK ray;
+        for (size_t j=0; j<N; j++) valid[j] = j<M ? -1 : 0;
+        for (size_t j=0; j<M; j++) setRay(ray,j,rays[i+j]);
+        for (size_t j=M; j<N; j++) setRay(ray,j,makeRay(zero,zero,pos_inf,neg_inf));
+        func(valid,ray,hits+i);
+        for (size_t j=0; j<M; j++) rays[i+j] = getRay(ray,j);
+      }
+    }
+
+    void intersectKNearest(RTCScene scene, RTCRay* rays, RTCHitBuffer* hits, size_t numRays)
+    {
+      RTCIntersectContext context;
+      context.flags = RTC_INTERSECT_INCOHERENT;
+      context.userRayExt = nullptr;
+
+      switch (imode)
+      {
+      case MODE_INTERSECT1:
+        for (size_t i=0; i<numRays; i++) rtcIntersectKNearest1(scene,&context,rays[i],hits[i]);
+        break;
+      case MODE_INTERSECT4:
+        intersectKNearestK<RTCRay4,4>(rays,hits,numRays,[&] (int* valid, RTCRay4& ray, RTCHitBuffer* h) { rtcIntersectKNearest4(valid,scene,&context,ray,h); });
+        break;
+      case MODE_INTERSECT8:
+        intersectKNearestK<RTCRay8,8>(rays,hits,numRays,[&] (int* valid, RTCRay8& ray, RTCHitBuffer* h) { rtcIntersectKNearest8(valid,scene,&context,ray,h); });
+        break;
+      case MODE_INTERSECT16:
+        intersectKNearestK<RTCRay16,16>(rays,hits,numRays,[&] (int* valid, RTCRay16& ray, RTCHitBuffer* h) { rtcIntersectKNearest16(valid,scene,&context,ray,h); });
+        break;
+      case MODE_INTERSECT1M:
+        rtcIntersectKNearest1M(scene,&context,rays,hits,numRays,sizeof(RTCRay));
+        break;
+      default:
+        break;
+      }
+    }
+
+    VerifyApplication::TestReturnValue run(VerifyApplication* state, bool silent)
+    {
+      std::string cfg = state->rtcore + ",isa="+stringOfISA(isa);
+      RTCDeviceRef device = rtcNewDevice(cfg.c_str());
+      errorHandler(nullptr,rtcDeviceGetError(device));
+      if (!supportsIntersectMode(device,imode))
+        return VerifyApplication::SKIPPED;
+
+      VerifyScene scene(device,sflags,aflags_all), object(device,sflags,aflags_all);
+      VerifyScene scene_ref(device,sflags,aflags_all), object_ref(device,sflags,aflags_all);
+      createScene(scene,object,false);
+      createScene(scene_ref,object_ref,true);
+      AssertNoError(device);
+
+      /* rays along the z axis passing through multiple spheres */
+      const size_t numRays = 1000;
+      vector_t<RTCRay,aligned_allocator<RTCRay,16>> rays(numRays);
+      for (size_t i=0; i<numRays; i++)
+      {
+        const Vec3fa org(6.0f*random_float()-3.0f,4.0f*random_float()-2.0f,-5.0f);
+        const Vec3fa dir(0.2f*random_float()-0.1f,0.2f*random_float()-0.1f,1.0f);
+        rays[i] = makeRay(org,dir);
+      }
+
+      /* reference hits are all hits recorded by the filter functions, sorted and clamped to K */
+      std::vector<std::vector<RTCHit>> hits_ref(numRays);
+      for (size_t i=0; i<numRays; i++)
+      {
+        RTCIntersectContext context;
+        context.flags = RTC_INTERSECT_COHERENT;
+        context.userRayExt = &hits_ref[i];
+        RTCRay ray = rays[i];
+        rtcIntersect1Ex(scene_ref,&context,ray);
+        std::vector<RTCHit>& hits = hits_ref[i];
+        std::sort(hits.begin(),hits.end(),[] (const RTCHit& a, const RTCHit& b) { return a.t < b.t; });
+        hits.erase(std::unique(hits.begin(),hits.end(),[] (const RTCHit& a, const RTCHit& b) {
+              return a.t == b.t && a.geomID == b.geomID && a.primID == b.primID && a.instID == b.instID; }),hits.end());
+        if (hits.size() > K) hits.resize(K);
+      }
+      AssertNoError(device);
+
+      std::vector<RTCHit> storage(numRays*K);
+      std::vector<RTCHitBuffer> hits(numRays);
+      for (size_t i=0; i<numRays; i++) {
+        hits[i].hits = &storage[i*K];
+        hits[i].k = K;
+        hits[i].numHits = -1;
+      }
+      intersectKNearest(scene,rays.data(),hits.data(),numRays);
+      AssertNoError(device);
+
+      size_t numFull = 0;
+      for (size_t i=0; i<numRays; i++)
+      {
+        if (hits[i].numHits != hits_ref[i].size()) return VerifyApplication::FAILED;
+        numFull += hits[i].numHits == K;
+        for (size_t j=0; j<hits[i].numHits; j++)
+        {
+          const RTCHit& hit = hits[i].hits[j];
+          const RTCHit& ref = hits_ref[i][j];
+          if (abs(hit.t-ref.t) > 1E-4f) return VerifyApplication::FAILED;
+          if (hit.geomID != ref.geomID || hit.instID != ref.instID) return VerifyApplication::FAILED;
+          if (hit.geomID == 1 && hit.instID == RTC_INVALID_GEOMETRY_ID && (hit.primID & 1)) return VerifyApplication::FAILED;
+        }
+        /* the ray stores the closest hit */
+        const RTCHit* closest = hits[i].numHits ? &hits[i].hits[0] : nullptr;
+        if (rays[i].geomID != (closest ? closest->geomID : RTC_INVALID_GEOMETRY_ID)) return VerifyApplication::FAILED;
+        if (closest && rays[i].tfar != closest->t) return VerifyApplication::FAILED;
+      }
+      /* many rays pass through more than K surfaces */
+      if (numFull == 0) return VerifyApplication::FAILED;
+      return VerifyApplication::PASSED;
+    }
+  };
+
+  struct TraversalStatsTest : public VerifyApplication::IntersectTest
+  {
+    RTCSceneFlags sflags;
+
+    TraversalStatsTest (std::string name, int isa, RTCSceneFlags sflags, IntersectMode imode, IntersectVariant ivariant)
+      : VerifyApplication::IntersectTest(name,isa,imode,ivariant,VerifyApplication::TEST_SHOULD_PASS), sflags(sflags) {}
+
+    /* accepts all hits and counts the filter invocations in the user data */
+    static void countIntersectionFilterN(int* valid, void* userPtr, const RTCIntersectContext* context, RTCRayN* ray, const RTCHitN* hit, const size_t N)
+    {
+      std::atomic<size_t>& counter = *(std::atomic<size_t>*) userPtr;
+      for (size_t i=0; i<N; i++)
+      {
+        if (valid[i] != -1) continue;
+        counter++;
+        RTCRayN_instID(ray,N,i) = RTCHitN_instID(hit,N,i);
+        RTCRayN_geomID(ray,N,i) = RTCHitN_geomID(hit,N,i);
+        RTCRayN_primID(ray,N,i) = RTCHitN_primID(hit,N,i);
+        RTCRayN_u(ray,N,i) = RTCHitN_u(hit,N,i);
+        RTCRayN_v(ray,N,i) = RTCHitN_v(hit,N,i);
+        RTCRayN_tfar(ray,N,i) = RTCHitN_t(hit,N,i);
+        RTCRayN_Ng_x(ray,N,i) = RTCHitN_Ng_x(hit,N,i);
+        RTCRayN_Ng_y(ray,N,i) = RTCHitN_Ng_y(hit,N,i);
+        RTCRayN_Ng_z(ray,N,i) = RTCHitN_Ng_z(hit,N,i);
+      }
+    }
+
+    static void countOcclusionFilterN(int* valid, void* userPtr, const RTCIntersectContext* context, RTCRayN* ray, const RTCHitN* hit, const size_t N)
+    {
+      std::atomic<size_t>& counter = *(std::atomic<size_t>*) userPtr;
+      for (size_t i=0; i<N; i++)
+      {
+        if (valid[i] != -1) continue;
+        counter++;
+        RTCRayN_geomID(ray,N,i) = 0;
+      }
+    }
+
+    /* two spheres and an instanced sphere, all with filter functions */
+    void createScene(VerifyScene& scene, VerifyScene& object, std::atomic<size_t>* counter)
+    {
+      const unsigned geomID0 = scene.addGeometry(RTC_GEOMETRY_STATIC,SceneGraph::createTriangleSphere(Vec3fa(-1,0,0),1.0f,50));
+      const unsigned geomID1 = scene.addGeometry(RTC_GEOMETRY_STATIC,SceneGraph::createQuadSphere(Vec3fa(+1,0,0),1.0f,50));
+      const unsigned geomID2 = object.addGeometry(RTC_GEOMETRY_STATIC,SceneGraph::createTriangleSphere(Vec3fa(0,0,0),0.5f,50));
+      rtcSetIntersectionFilterFunctionN(object,geomID2,countIntersectionFilterN);
+      rtcSetOcclusionFilterFunctionN(object,geomID2,countOcclusionFilterN);
+      rtcSetUserData(object,geomID2,counter);
+      rtcCommit(object);
+      const AffineSpace3fa xfm = AffineSpace3fa::translate(Vec3fa(0,1.5f,0));
+      const unsigned geomID3 = rtcNewInstance3(scene,object,1);
+      rtcSetTransform2(scene,geomID3,RTC_MATRIX_COLUMN_MAJOR_ALIGNED16,(float*)&xfm,0);
+      for (unsigned geomID : { geomID0, geomID1 }) {
+        rtcSetIntersectionFilterFunctionN(scene,geomID,countIntersectionFilterN);
+        rtcSetOcclusionFilterFunctionN(scene,geomID,countOcclusionFilterN);
+        rtcSetUserData(scene,geomID,counter);
+      }
+      rtcCommit(scene);
+    }
+
+    template<typename RTCRayK, size_t N, typename Func>
+    static void traceK(RTCRay* rays, size_t numRays, const Func& func)
+    {
+      for (size_t i=0; i<numRays; i+=N)
+      {
+        const size_t M = min(N,numRays-i);
+        __aligned(64) int valid[N];
+        RTCRayK ray;
+        for (size_t j=0; j<N; j++) valid[j] = (j<M && rays[i+j].tnear <= rays[i+j].tfar) ? -1 : 0;
+        for (size_t j=0; j<M; j++) setRay(ray,j,rays[i+j]);
+        for (size_t j=M; j<N; j++) setRay(ray,j,makeRay(zero,zero,pos_inf,neg_inf));
+        func(valid,ray,i);
+        for (size_t j=0; j<M; j++) rays[i+j] = getRay(ray,j);
+      }
+    }
+
+    /* traces the rays with the statistics of ray i stored at stats[i], or without statistics if stats is null */
+    void trace(RTCScene scene, RTCRay* rays, RTCTraversalStats* stats, size_t numRays)
+    {
+      const bool occluded = (ivariant & VARIANT_INTERSECT_OCCLUDED_MASK) == VARIANT_OCCLUDED;
+      RTCIntersectContext context;
+      context.flags = (ivariant & VARIANT_COHERENT_INCOHERENT_MASK) == VARIANT_COHERENT ? RTC_INTERSECT_COHERENT : RTC_INTERSECT_INCOHERENT;
+      if (stats) context.flags = RTCIntersectFlags(context.flags | RTC_INTERSECT_TRAVERSAL_STATS);
+      context.userRayExt = nullptr;
+      context.traversalStats = stats;
+
+      switch (imode)
+      {
+      case MODE_INTERSECT1:
+        for (size_t i=0; i<numRays; i++) {
+          if (rays[i].tnear > rays[i].tfar) continue;
+          context.traversalStats = stats ? stats+i : nullptr;
+          if (occluded) rtcOccluded1Ex(scene,&context,rays[i]);
+          else          rtcIntersect1Ex(scene,&context,rays[i]);
+        }
+        break;
+      case MODE_INTERSECT4:
+        traceK<RTCRay4,4>(rays,numRays,[&] (int* valid, RTCRay4& ray, size_t i) {
+            context.traversalStats = stats ? stats+i : nullptr;
+            if (occluded) rtcOccluded4Ex(valid,scene,&context,ray);
+            else          rtcIntersect4Ex(valid,scene,&context,ray);
+          });
+        break;
+      case MODE_INTERSECT8:
+        traceK<RTCRay8,8>(rays,numRays,[&] (int* valid, RTCRay8& ray, size_t i) {
+            context.traversalStats = stats ? stats+i : nullptr;
+            if (occluded) rtcOccluded8Ex(valid,scene,&context,ray);
+            else          rtcIntersect8Ex(valid,scene,&context,ray);
+          });
+        break;
+      case MODE_INTERSECT16:
+        traceK<RTCRay16,16>(rays,numRays,[&] (int* valid, RTCRay16& ray, size_t i) {
+            context.traversalStats = stats ? stats+i : nullptr;
+            if (occluded) rtcOccluded16Ex(valid,scene,&context,ray);
+            else          rtcIntersect16Ex(valid,scene,&context,ray);
+          });
+        break;
+      case MODE_INTERSECT1M:
+        if (occluded) rtcOccluded1M(scene,&context,rays,numRays,sizeof(RTCRay));
+        else          rtcIntersect1M(scene,&context,rays,numRays,sizeof(RTCRay));
+        break;
+      case MODE_INTERSECT1Mp:
+      {
+        std::vector<RTCRay*> rptrs(numRays);
+        for (size_t i=0; i<numRays; i++) rptrs[i] = &rays[i];
+        if (occluded) rtcOccluded1Mp(scene,&context,rptrs.data(),numRays);
+        else          rtcIntersect1Mp(scene,&context,rptrs.data(),numRays);
+        break;
+      }
+      case MODE_INTERSECTNM1:  IntersectWithNMMode<1> (ivariant,scene,&context,rays,numRays); break;
+      case MODE_INTERSECTNM3:  IntersectWithNMMode<3> (ivariant,scene,&context,rays,numRays); break;
+      case MODE_INTERSECTNM4:  IntersectWithNMMode<4> (ivariant,scene,&context,rays,numRays); break;
+      case MODE_INTERSECTNM8:  IntersectWithNMMode<8> (ivariant,scene,&context,rays,numRays); break;
+      case MODE_INTERSECTNM16: IntersectWithNMMode<16>(ivariant,scene,&context,rays,numRays); break;
+      default:
+        break;
+      }
+    }
+
+    VerifyApplication::TestReturnValue run(VerifyApplication* state, bool silent)
+    {
+      std::string cfg = state->rtcore + ",isa="+stringOfISA(isa);
+      RTCDeviceRef device = rtcNewDevice(cfg.c_str());
+      errorHandler(nullptr,rtcDeviceGetError(device));
+      if (!supportsIntersectMode(device,imode))
+        return VerifyApplication::SKIPPED;
+
+      std::atomic<size_t> numFilterCalls(0);
+      VerifyScene scene(device,sflags,aflags_all), object(device,sflags,aflags_all);
+      createScene(scene,object,&numFilterCalls);
+      AssertNoError(device);
+
+      /* rays along the z axis, every 10th ray is invalid */
+      const size_t numRays = 1000;
+      vector_t<RTCRay,aligned_allocator<RTCRay,16>> rays_in(numRays);
+      for (size_t i=0; i<numRays; i++)
+      {
+        const Vec3fa org(6.0f*random_float()-3.0f,5.0f*random_float()-2.0f,-5.0f);
+        const Vec3fa dir(0.2f*random_float()-0.1f,0.2f*random_float()-0.1f,1.0f);
+        rays_in[i] = makeRay(org,dir);
+        if (i%10 == 5) { rays_in[i].tnear = 1.0f; rays_in[i].tfar = 0.0f; }
+      }
+
+      /* reference hits without statistics */
+      vector_t<RTCRay,aligned_allocator<RTCRay,16>> rays_ref = rays_in;
+      trace(scene,rays_ref.data(),nullptr,numRays);
+      AssertNoError(device);
+      if (numFilterCalls == 0) return VerifyApplication::FAILED;
+
+      /* statistics get accumulated over two identical queries */
+      std::vector<RTCTraversalStats> stats(numRays+16); // padding lanes of the last ray packet
+      for (auto& s : stats) s.numNodes = s.numLeaves = s.numPrimBlocks = s.numFilterCalls = 0;
+      size_t numFilterCallsStats[2];
+      vector_t<RTCRay,aligned_allocator<RTCRay,16>> rays = rays_in;
+      for (size_t pass=0; pass<2; pass++)
+      {
+        rays = rays_in;
+        numFilterCalls = 0;
+        trace(scene,rays.data(),stats.data(),numRays);
+        AssertNoError(device);
+        numFilterCallsStats[pass] = numFilterCalls;
+      }
+
+      size_t sumFilterCalls = 0;
+      size_t numHits = 0;
+      for (size_t i=0; i<numRays; i++)
+      {
+        /* same hits as without statistics */
+        if (rays[i].geomID != rays_ref[i].geomID) return VerifyApplication::FAILED;
+        if (rays[i].geomID != RTC_INVALID_GEOMETRY_ID && rays[i].tfar != rays_ref[i].tfar) return VerifyApplication::FAILED;
+
+        const RTCTraversalStats& s = stats[i];
+        sumFilterCalls += s.numFilterCalls;
+        if (s.numNodes % 2 || s.numLeaves % 2 || s.numPrimBlocks % 2 || s.numFilterCalls % 2) return VerifyApplication::FAILED;
+
+        /* invalid rays are not traversed */
+        if (rays_in[i].tnear > rays_in[i].tfar) {
+          if (s.numNodes || s.numLeaves || s.numPrimBlocks || s.numFilterCalls) return VerifyApplication::FAILED;
+          continue;
+        }
+
+        /* valid rays intersect at least the root node, hits require a leaf */
+        if (s.numNodes == 0 || s.numPrimBlocks < s.numLeaves) return VerifyApplication::FAILED;
+        if (rays[i].geomID != RTC_INVALID_GEOMETRY_ID) {
+          numHits++;
+          if (s.numLeaves == 0 || s.numFilterCalls == 0) return VerifyApplication::FAILED;
+        }
+      }
+      if (numHits == 0) return VerifyApplication::FAILED;
+      if (sumFilterCalls != numFilterCallsStats[0]+numFilterCallsStats[1]) return VerifyApplication::FAILED;
+      return VerifyApplication::PASSED;
+    }
+  };
+
+  struct PointQueryTest : public VerifyApplication::Test
+  {
+    RTCSceneFlags sflags;
+    bool stream;
+
+    PointQueryTest (std::string name, int isa, RTCSceneFlags sflags, bool stream)
+      : VerifyApplication::Test(name,isa,VerifyApplication::TEST_SHOULD_PASS), sflags(sflags), stream(stream) {}
+
+    /* distance of p to the segment (a,b) */
+    static float distanceSegment(const Vec3fa& p, const Vec3fa& a, const Vec3fa& b, float& t)
+    {
+      const Vec3fa ab = b-a;
+      t = clamp(dot(p-a,ab)/dot(ab,ab),0.0f,1.0f);
+      return length(p-(a+t*ab));
+    }
+
+    /* distance of p to the triangle (a,b,c) */
+    static float distanceTriangle(const Vec3fa& p, const Vec3fa& a, const Vec3fa& b, const Vec3fa& c)
+    {
+      const Vec3fa N = normalize(cross(b-a,c-a));
+      const Vec3fa q = p-dot(p-a,N)*N;
+      if (dot(cross(b-a,q-a),N) >= 0.0f && dot(cross(c-b,q-b),N) >= 0.0f && dot(cross(a-c,q-c),N) >= 0.0f)
+        return abs(dot(p-a,N));
+      float t;
+      return min(distanceSegment(p,a,b,t),distanceSegment(p,b,c,t),distanceSegment(p,c,a,t));
+    }
+
+    /* brute force closest distance to all primitives of the scene */
+    static float distanceReference(const Vec3fa& p, const Ref<SceneGraph::TriangleMeshNode>& trimesh, const Ref<SceneGraph::QuadMeshNode>& quadmesh, const Ref<SceneGraph::LineSegmentsNode>& lines)
+    {
+      float dist = pos_inf;
+      const avector<Vec3fa>& tv = trimesh->positions[0];
+      for (auto& tri : trimesh->triangles)
+        dist = min(dist,distanceTriangle(p,tv[tri.v0],tv[tri.v1],tv[tri.v2]));
+      const avector<Vec3fa>& qv = quadmesh->positions[0];
+      for (auto& quad : quadmesh->quads) {
+        dist = min(dist,distanceTriangle(p,qv[quad.v0],qv[quad.v1],qv[quad.v3]));
+        dist = min(dist,distanceTriangle(p,qv[quad.v2],qv[quad.v3],qv[quad.v1]));
+      }
+      const avector<Vec3fa>& lv = lines->positions[0];
+      for (auto i : lines->indices) {
+        float t; const float d = distanceSegment(p,lv[i],lv[i+1],t);
+        dist = min(dist,max(0.0f,d-((1.0f-t)*lv[i].w+t*lv[i+1].w)));
+      }
+      return dist;
+    }
+
+    VerifyApplication::TestReturnValue run(VerifyApplication* state, bool silent)
+    {
+      std::string cfg = state->rtcore + ",isa="+stringOfISA(isa);
+      RTCDeviceRef device = rtcNewDevice(cfg.c_str());
+      errorHandler(nullptr,rtcDeviceGetError(device));
+
+      /* a triangle sphere, a quad sphere, and a polyline above both spheres */
+      Ref<SceneGraph::TriangleMeshNode> trimesh = SceneGraph::createTriangleSphere(Vec3fa(-1.5f,0,0),1.0f,20).dynamicCast<SceneGraph::TriangleMeshNode>();
+      Ref<SceneGraph::QuadMeshNode> quadmesh = SceneGraph::createQuadSphere(Vec3fa(+1.5f,0,0),1.0f,20).dynamicCast<SceneGraph::QuadMeshNode>();
+      Ref<SceneGraph::LineSegmentsNode> lines = new SceneGraph::LineSegmentsNode(nullptr,1);
+      for (size_t i=0; i<=32; i++) {
+        const float x = 5.0f*float(i)/32.0f-2.5f;
+        lines->positions[0].push_back(Vec3fa(x,1.5f,0.5f*sin(4.0f*x),0.05f+0.05f*float(i&1)));
+        if (i<32) lines->indices.push_back(unsigned(i));
+      }
+
+      VerifyScene scene(device,sflags,aflags_all);
+      const unsigned geomID0 = scene.addGeometry(RTC_GEOMETRY_STATIC,trimesh.dynamicCast<SceneGraph::Node>());
+      const unsigned geomID1 = scene.addGeometry(RTC_GEOMETRY_STATIC,quadmesh.dynamicCast<SceneGraph::Node>());
+      const unsigned geomID2 = scene.addGeometry(RTC_GEOMETRY_STATIC,lines.dynamicCast<SceneGraph::Node>());
+      rtcCommit(scene);
+      AssertNoError(device);
+
+      /* random query positions around the scene, every second one with a search radius that is too small */
+      const size_t numQueries = 1000;
+      std::vector<float> dist_ref(numQueries);
+      std::vector<bool> too_small(numQueries);
+      vector_t<RTCPointQuery,aligned_allocator<RTCPointQuery,16>> queries(numQueries);
+      for (size_t i=0; i<numQueries; i++)
+      {
+        const Vec3fa p(6.0f*random_float()-3.0f,5.0f*random_float()-2.5f,4.0f*random_float()-2.0f);
+        dist_ref[i] = distanceReference(p,trimesh,quadmesh,lines);
+        too_small[i] = (i & 1) && dist_ref[i] > 0.0f;
+        queries[i].p[0] = p.x; queries[i].p[1] = p.y; queries[i].p[2] = p.z;
+        queries[i].radius = too_small[i] ? 0.5f*dist_ref[i] : float(inf);
+      }
+
+      if (stream) rtcPointQuery1M(scene,queries.data(),numQueries,sizeof(RTCPointQuery));
+      else for (size_t i=0; i<numQueries; i++) rtcPointQuery1(scene,queries[i]);
+      AssertNoError(device);
+
+      for (size_t i=0; i<numQueries; i++)
+      {
+        const RTCPointQuery& query = queries[i];
+        const Vec3fa p(query.p[0],query.p[1],query.p[2]);
+        const Vec3fa closest(query.closest[0],query.closest[1],query.closest[2]);
+
+        /* nothing is found inside a too small search radius and the radius stays unchanged */
+        if (too_small[i]) {
+          if (query.geomID != RTC_INVALID_GEOMETRY_ID) return VerifyApplication::FAILED;
+          if (query.radius != 0.5f*dist_ref[i]) return VerifyApplication::FAILED;
+          continue;
+        }
+
+        if (query.geomID != geomID0 && query.geomID != geomID1 && query.geomID != geomID2) return VerifyApplication::FAILED;
+        if (abs(query.radius-dist_ref[i]) > 1E-4f) return VerifyApplication::FAILED;
+        if (abs(length(closest-p)-query.radius) > 1E-4f) return VerifyApplication::FAILED;
+
+        /* the closest point has to match the reported primitive and barycentric coordinates */
+        Vec3fa q = closest;
+        if (query.geomID == geomID0) {
+          const SceneGraph::TriangleMeshNode::Triangle& tri = trimesh->triangles[query.primID];
+          const avector<Vec3fa>& v = trimesh->positions[0];
+          q = v[tri.v0] + query.u*(v[tri.v1]-v[tri.v0]) + query.v*(v[tri.v2]-v[tri.v0]);
+        }
+        else if (query.geomID == geomID1) {
+          const SceneGraph::QuadMeshNode::Quad& quad = quadmesh->quads[query.primID];
+          const avector<Vec3fa>& v = quadmesh->positions[0];
+          if (query.u+query.v <= 1.0f) q = v[quad.v0] + query.u*(v[quad.v1]-v[quad.v0]) + query.v*(v[quad.v3]-v[quad.v0]);
+          else                         q = v[quad.v2] + (1.0f-query.u)*(v[quad.v3]-v[quad.v2]) + (1.0f-query.v)*(v[quad.v1]-v[quad.v2]);
+        }
+        if (length(q-closest) > 1E-4f) return VerifyApplication::FAILED;
+      }
+      return VerifyApplication::PASSED;
+    }
+  };
+
+  struct SubdivRayConeTest : public VerifyApplication::IntersectTest
+  {
+    SubdivRayConeTest (std::string name, int isa, IntersectMode imode)
+      : VerifyApplication::IntersectTest(name,isa,imode,VARIANT_INTERSECT,VerifyApplication::TEST_SHOULD_PASS) {}
+
+    template<typename RTCRayK, size_t N, typename Func>
+    static void intersectK(RTCRay* rays, size_t numRays, const Func& func)
+    {
+      for (size_t i=0; i<numRays; i+=N)
+      {
+        const size_t M = min(N,numRays-i);
+        __aligned(64) int valid[N];
+        RTCRayK ray;
+        for (size_t j=0; j<N; j++) valid[j] = j<M ? -1 : 0;
+        for (size_t j=0; j<M; j++) setRay(ray,j,rays[i+j]);
+        for (size_t j=M; j<N; j++) setRay(ray,j,makeRay(zero,zero,pos_inf,neg_inf));
+        func(valid,ray);
+        for (size_t j=0; j<M; j++) rays[i+j] = getRay(ray,j);
+      }
+    }
+
+    void intersect(RTCScene scene, const RTCIntersectContext& context, RTCRay* rays, size_t numRays)
+    {
+      switch (imode)
+      {
+      case MODE_INTERSECT1:
+        for (size_t i=0; i<numRays; i++) rtcIntersect1Ex(scene,&context,rays[i]);
+        break;
+      case MODE_INTERSECT4:
+        intersectK<RTCRay4,4>(rays,numRays,[&] (int* valid, RTCRay4& ray) { rtcIntersect4Ex(valid,scene,&context,ray); });
+        break;
+      case MODE_INTERSECT8:
+        intersectK<RTCRay8,8>(rays,numRays,[&] (int* valid, RTCRay8& ray) { rtcIntersect8Ex(valid,scene,&context,ray); });
+        break;
+      case MODE_INTERSECT16:
+        intersectK<RTCRay16,16>(rays,numRays,[&] (int* valid, RTCRay16& ray) { rtcIntersect16Ex(valid,scene,&context,ray); });
+        break;
+      case MODE_INTERSECT1M:
+        rtcIntersect1M(scene,&context,rays,numRays,sizeof(RTCRay));
+        break;
+      default:
+        break;
+      }
+    }
+
+    VerifyApplication::TestReturnValue run(VerifyApplication* state, bool silent)
+    {
+      std::string cfg = state->rtcore + ",isa="+stringOfISA(isa);
+      RTCDeviceRef device = rtcNewDevice(cfg.c_str());
+      errorHandler(nullptr,rtcDeviceGetError(device));
+      if (!supportsIntersectMode(device,imode))
+        return VerifyApplication::SKIPPED;
+
+      /* static scenes tessellate subdivision surfaces eagerly, thus use dynamic scenes */
+      VerifyScene scene(device,RTC_SCENE_DYNAMIC,aflags_all), scene_ref(device,RTC_SCENE_DYNAMIC,aflags_all);
+      scene.addGeometry(RTC_GEOMETRY_STATIC,SceneGraph::createSubdivSphere(zero,1.0f,8,32));
+      scene_ref.addGeometry(RTC_GEOMETRY_STATIC,SceneGraph::createSubdivSphere(zero,1.0f,8,32));
+      rtcCommit(scene);
+      rtcCommit(scene_ref);
+      AssertNoError(device);
+
+      /* distant rays hitting the front of the sphere */
+      const size_t numRays = 1000;
+      vector_t<RTCRay,aligned_allocator<RTCRay,16>> rays_init(numRays);
+      for (size_t i=0; i<numRays; i++) {
+        const Vec3fa org(random_float()-0.5f,random_float()-0.5f,-100.0f);
+        rays_init[i] = makeRay(org,Vec3fa(0,0,1));
+      }
+      vector_t<RTCRay,aligned_allocator<RTCRay,16>> rays(rays_init), rays_ref(rays_init);
+
+      RTCIntersectContext context;
+      context.flags = RTC_INTERSECT_INCOHERENT;
+      context.userRayExt = nullptr;
+      context.coneWidth = 0.0f;
+      context.coneSpread = 0.0f;
+      intersect(scene_ref,context,rays_ref.data(),numRays);
+
+      RTCIntersectContext context_cone = context;
+      context_cone.flags = RTCIntersectFlags(RTC_INTERSECT_INCOHERENT | RTC_INTERSECT_RAY_CONE);
+      context_cone.coneSpread = 0.02f;
+      const float footprint = 100.0f*context_cone.coneSpread;
+
+      /* the wide ray cones tessellate the patches coarser, the hits have to stay inside the footprint */
+      intersect(scene,context_cone,rays.data(),numRays);
+      AssertNoError(device);
+      size_t numCoarse = 0;
+      for (size_t i=0; i<numRays; i++) {
+        if (rays[i].geomID == RTC_INVALID_GEOMETRY_ID || rays_ref[i].geomID == RTC_INVALID_GEOMETRY_ID) return VerifyApplication::FAILED;
+        if (abs(rays[i].tfar-rays_ref[i].tfar) > footprint) return VerifyApplication::FAILED;
+        numCoarse += rays[i].tfar != rays_ref[i].tfar;
+      }
+      if (numCoarse == 0) return VerifyApplication::FAILED;
+
+      /* rays without ray cone re-tessellate the coarse grids at full resolution */
+      rays = rays_init;
+      intersect(scene,context,rays.data(),numRays);
+      for (size_t i=0; i<numRays; i++)
+        if (rays[i].tfar != rays_ref[i].tfar) return VerifyApplication::FAILED;
+
+      /* the ray cones reuse the finer grids of the cache */
+      rays = rays_init;
+      intersect(scene,context_cone,rays.data(),numRays);
+      AssertNoError(device);
+      for (size_t i=0; i<numRays; i++)
+        if (rays[i].tfar != rays_ref[i].tfar) return VerifyApplication::FAILED;
+
+      return VerifyApplication::PASSED;
+    }
+  };
+
+  struct TessellationCacheTest : public VerifyApplication::Test
+  {
+    TessellationCacheTest (std::string name, int isa)
+      : VerifyApplication::Test(name,isa,VerifyApplication::TEST_SHOULD_PASS) {}
+
+    VerifyApplication::TestReturnValue run(VerifyApplication* state, bool silent)
+    {
+      std::string cfg = state->rtcore + ",isa="+stringOfISA(isa);
+      RTCDeviceRef device_ref = rtcNewDevice(cfg.c_str());
+      errorHandler(nullptr,rtcDeviceGetError(device_ref));
+
+      /* each device owns a small tessellation cache that frequently switches segments */
+      std::string cfg_small = cfg + ",tessellation_cache_size=1,tessellation_cache_segments=16";
+      RTCDeviceRef device0 = rtcNewDevice(cfg_small.c_str());
+      errorHandler(nullptr,rtcDeviceGetError(device0));
+      RTCDeviceRef device1 = rtcNewDevice(cfg_small.c_str());
+      errorHandler(nullptr,rtcDeviceGetError(device1));
+
+      /* static scenes tessellate subdivision surfaces eagerly, thus use dynamic scenes */
+      VerifyScene scene_ref(device_ref,RTC_SCENE_DYNAMIC,aflags_all);
+      VerifyScene scene0(device0,RTC_SCENE_DYNAMIC,aflags_all);
+      VerifyScene scene1(device1,RTC_SCENE_DYNAMIC,aflags_all);
+      scene_ref.addGeometry(RTC_GEOMETRY_STATIC,SceneGraph::createSubdivSphere(zero,1.0f,8,32));
+      scene0.addGeometry(RTC_GEOMETRY_STATIC,SceneGraph::createSubdivSphere(zero,1.0f,8,32));
+      scene1.addGeometry(RTC_GEOMETRY_STATIC,SceneGraph::createSubdivSphere(zero,1.0f,8,32));
+      rtcCommit(scene_ref);
+      rtcCommit(scene0);
+      rtcCommit(scene1);
+      AssertNoError(device_ref);
+      AssertNoError(device0);
+      AssertNoError(device1);
+
+      const size_t numRays = 4096;
+      vector_t<RTCRay,aligned_allocator<RTCRay,16>> rays_init(numRays);
+      for (size_t i=0; i<numRays; i++) {
+        const Vec3fa org(2.0f*random_float()-1.0f,2.0f*random_float()-1.0f,-100.0f);
+        rays_init[i] = makeRay(org,Vec3fa(0,0,1));
+      }
+      vector_t<RTCRay,aligned_allocator<RTCRay,16>> rays_ref(rays_init);
+      for (size_t i=0; i<numRays; i++)
+        rtcIntersect(scene_ref,rays_ref[i]);
+      AssertNoError(device_ref);
+
+      /* trace incoherently through both devices in parallel, the hits have to match exactly */
+      const size_t numTasks = 64;
+      std::atomic<size_t> numFailed(0);
+      parallel_for(numTasks, [&](size_t task) 
+      {
+        RTCScene scene = (task%2) ? (RTCScene) scene1 : (RTCScene) scene0;
+        for (size_t j=task; j<4*numRays; j+=numTasks)
+        {
+          const RTCRay& ray_ref = rays_ref[j%numRays];
+          RTCRay ray = rays_init[j%numRays];
+          rtcIntersect(scene,ray);
+          if (ray.geomID != ray_ref.geomID || ray.primID != ray_ref.primID ||
+              ray.tfar != ray_ref.tfar || ray.u != ray_ref.u || ray.v != ray_ref.v)
+            numFailed++;
+        }
+      });
+      AssertNoError(device0);
+      AssertNoError(device1);
+
+      return (VerifyApplication::TestReturnValue) (numFailed == 0);
+    }
+  };
+
+  struct QuantizedGridTest : public VerifyApplication::IntersectTest
+  {
+    QuantizedGridTest (std::string name, int isa, IntersectMode imode, IntersectVariant ivariant)
+      : VerifyApplication::IntersectTest(name,isa,imode,ivariant,VerifyApplication::TEST_SHOULD_PASS) {}
+
+    VerifyApplication::TestReturnValue run(VerifyApplication* state, bool silent)
+    {
+      std::string cfg = state->rtcore + ",isa="+stringOfISA(isa);
+      std::string cfg_ref = cfg + ",subdiv_accel=bvh4.subdivpatch1";
+      RTCDeviceRef device_ref = rtcNewDevice(cfg_ref.c_str());
+      errorHandler(nullptr,rtcDeviceGetError(device_ref));
+      std::string cfg_quantized = cfg + ",subdiv_accel=bvh4.grid.quantized";
+      RTCDeviceRef device = rtcNewDevice(cfg_quantized.c_str());
+      errorHandler(nullptr,rtcDeviceGetError(device));
+      if (!supportsIntersectMode(device,imode))
+        return VerifyApplication::SKIPPED;
+
+      VerifyScene scene_ref(device_ref,RTC_SCENE_STATIC,aflags_all);
+      VerifyScene scene(device,RTC_SCENE_STATIC,aflags_all);
+      scene_ref.addGeometry(RTC_GEOMETRY_STATIC,SceneGraph::createSubdivSphere(zero,1.0f,8,32));
+      scene.addGeometry(RTC_GEOMETRY_STATIC,SceneGraph::createSubdivSphere(zero,1.0f,8,32));
+      rtcCommit(scene_ref);
+      rtcCommit(scene);
+      AssertNoError(device_ref);
+      AssertNoError(device);
+
+      /* distant rays that hit or miss the sphere, but stay away from its silhouette */
+      const size_t numRays = 1000;
+      vector_t<RTCRay,aligned_allocator<RTCRay,16>> rays(numRays), rays_ref(numRays);
+      for (size_t i=0; i<numRays; i++)
+      {
+        Vec3fa org;
+        do { org = Vec3fa(3.0f*random_float()-1.5f,3.0f*random_float()-1.5f,-100.0f); }
+        while (abs(length(Vec2f(org.x,org.y))-1.0f) < 0.1f);
+        rays[i] = rays_ref[i] = makeRay(org,Vec3fa(0,0,1));
+      }
+      IntersectWithMode(MODE_INTERSECT1,ivariant,scene_ref,rays_ref.data(),numRays);
+      IntersectWithMode(imode,ivariant,scene,rays.data(),numRays);
+      AssertNoError(device_ref);
       AssertNoError(device);
 
-      return (VerifyApplication::TestReturnValue) passed;
+      /* the quantized vertices deviate from the grid vertices by at most half a quantization step */
+      for (size_t i=0; i<numRays; i++)
+      {
+        if ((rays[i].geomID == RTC_INVALID_GEOMETRY_ID) != (rays_ref[i].geomID == RTC_INVALID_GEOMETRY_ID)) return VerifyApplication::FAILED;
+        if (ivariant & VARIANT_OCCLUDED) continue;
+        if (rays[i].geomID != rays_ref[i].geomID) return VerifyApplication::FAILED;
+        if (abs(rays[i].tfar-rays_ref[i].tfar) > 1E-3f) return VerifyApplication::FAILED;
+      }
+      return VerifyApplication::PASSED;
     }
   };
-  
-  const size_t num_interpolation_hair_vertices = 13;
-  const size_t num_interpolation_hairs = 4;
-
-  __aligned(16) int interpolation_hair_indices[num_interpolation_hairs] = {
-    0, 3, 6, 9
-  };
 
-  struct InterpolateHairTest : public VerifyApplication::Test
+  struct TessellationCacheStatsTest : public VerifyApplication::Test
   {
-    size_t N;
-    
-    InterpolateHairTest (std::string name, int isa, size_t N)
-      : VerifyApplication::Test(name,isa,VerifyApplication::TEST_SHOULD_PASS), N(N) {}
-    
-    bool checkHairInterpolation(const RTCSceneRef& scene, int geomID, int primID, float u, float v, int v0, RTCBufferType buffer, float* data, size_t N, size_t N_total)
+    TessellationCacheStatsTest (std::string name, int isa)
+      : VerifyApplication::Test(name,isa,VerifyApplication::TEST_SHOULD_PASS) {}
+
+    /* traces the same grid of rays towards the front of the sphere in each pass */
+    static void trace(RTCScene scene, size_t N)
     {
-      bool passed = true;
-      float P[256], dPdu[256], dPdv[256];
-      rtcInterpolate(scene,geomID,primID,u,v,buffer,P,dPdu,dPdv,N);
-      
-      for (size_t i=0; i<N; i++) {
-        const float p00 = data[(v0+0)*N_total+i];
-        const float p01 = data[(v0+1)*N_total+i];
-        const float p02 = data[(v0+2)*N_total+i];
-        const float p03 = data[(v0+3)*N_total+i];
-        const float t0 = 1.0f - u, t1 = u;
-        const float p10 = p00 * t0 + p01 * t1;
-        const float p11 = p01 * t0 + p02 * t1;
-        const float p12 = p02 * t0 + p03 * t1;
-        const float p20 = p10 * t0 + p11 * t1;
-        const float p21 = p11 * t0 + p12 * t1;
-        const float p30 = p20 * t0 + p21 * t1;
-        passed &= fabs(p30-P[i]) < 1E-4f;
+      for (size_t y=0; y<N; y++) {
+        for (size_t x=0; x<N; x++) {
+          RTCRay ray = makeRay(Vec3fa(2.0f*(x+0.5f)/N-1.0f,2.0f*(y+0.5f)/N-1.0f,-100.0f),Vec3fa(0,0,1));
+          rtcIntersect(scene,ray);
+        }
       }
-      return passed;
-    }
-    
-    bool checkHairInterpolation(const RTCSceneRef& scene, int geomID, RTCBufferType buffer, float* vertices0, size_t N, size_t N_total)
-    {
-      bool passed = true;
-      passed &= checkHairInterpolation(scene,geomID,0,0.0f,0.0f,0,buffer,vertices0,N,N_total);
-      passed &= checkHairInterpolation(scene,geomID,1,0.5f,0.0f,3,buffer,vertices0,N,N_total);
-      passed &= checkHairInterpolation(scene,geomID,2,0.0f,0.0f,6,buffer,vertices0,N,N_total);
-      passed &= checkHairInterpolation(scene,geomID,3,0.2f,0.0f,9,buffer,vertices0,N,N_total);
-      return passed;
     }
-    
+
     VerifyApplication::TestReturnValue run(VerifyApplication* state, bool silent)
     {
       std::string cfg = state->rtcore + ",isa="+stringOfISA(isa);
       RTCDeviceRef device = rtcNewDevice(cfg.c_str());
       errorHandler(nullptr,rtcDeviceGetError(device));
-
-      size_t M = num_interpolation_vertices*N+16; // padds the arrays with some valid data
-      
-      RTCSceneRef scene = rtcDeviceNewScene(device,RTC_SCENE_DYNAMIC,RTC_INTERPOLATE);
-      AssertNoError(device);
-      unsigned int geomID = rtcNewBezierHairGeometry(scene, RTC_GEOMETRY_STATIC, num_interpolation_hairs, num_interpolation_hair_vertices, 1);
-      AssertNoError(device);
-      
-      rtcSetBuffer(scene, geomID, RTC_INDEX_BUFFER,  interpolation_hair_indices , 0, sizeof(unsigned int));
-      AssertNoError(device);
-      
-      std::vector<float> vertices0(M);
-      for (size_t i=0; i<M; i++) vertices0[i] = random_float();
-      rtcSetBuffer(scene, geomID, RTC_VERTEX_BUFFER0, vertices0.data(), 0, N*sizeof(float));
-      AssertNoError(device);
-      
-      /*std::vector<float> vertices1(M);
-        for (size_t i=0; i<M; i++) vertices1[i] = random_float();
-        rtcSetBuffer(scene, geomID, RTC_VERTEX_BUFFER1, vertices1.data(), 0, N*sizeof(float));
-        AssertNoError(device);*/
-      
-      std::vector<float> user_vertices0(M);
-      for (size_t i=0; i<M; i++) user_vertices0[i] = random_float();
-      rtcSetBuffer(scene, geomID, RTC_USER_VERTEX_BUFFER0, user_vertices0.data(), 0, N*sizeof(float));
-      AssertNoError(device);
-      
-      std::vector<float> user_vertices1(M);
-      for (size_t i=0; i<M; i++) user_vertices1[i] = random_float();
-      rtcSetBuffer(scene, geomID, RTC_USER_VERTEX_BUFFER1, user_vertices1.data(), 0, N*sizeof(float));
-      AssertNoError(device);
-      
-      rtcDisable(scene,geomID);
-      AssertNoError(device);
+      std::string cfg_small = cfg + ",tessellation_cache_size=1,tessellation_cache_segments=16";
+      RTCDeviceRef device_small = rtcNewDevice(cfg_small.c_str());
+      errorHandler(nullptr,rtcDeviceGetError(device_small));
+
+      /* static scenes tessellate subdivision surfaces eagerly, thus use dynamic scenes */
+      VerifyScene scene(device,RTC_SCENE_DYNAMIC,aflags_all);
+      VerifyScene scene_small(device_small,RTC_SCENE_DYNAMIC,aflags_all);
+      scene.addGeometry(RTC_GEOMETRY_STATIC,SceneGraph::createSubdivSphere(zero,1.0f,8,32));
+      scene_small.addGeometry(RTC_GEOMETRY_STATIC,SceneGraph::createSubdivSphere(zero,1.0f,8,32));
       rtcCommit(scene);
+      rtcCommit(scene_small);
       AssertNoError(device);
-      
-      bool passed = true;
-      passed &= checkHairInterpolation(scene,geomID,RTC_VERTEX_BUFFER0,vertices0.data(),N,N);
-      //passed &= checkHairInterpolation(scene,geomID,RTC_VERTEX_BUFFER1,vertices1.data(),N,N);
-      passed &= checkHairInterpolation(scene,geomID,RTC_USER_VERTEX_BUFFER0,user_vertices0.data(),N,N);
-      passed &= checkHairInterpolation(scene,geomID,RTC_USER_VERTEX_BUFFER1,user_vertices1.data(),N,N);
-      
-      passed &= checkHairInterpolation(scene,geomID,RTC_VERTEX_BUFFER0,vertices0.data(),1,N);
-      //passed &= checkHairInterpolation(scene,geomID,RTC_VERTEX_BUFFER1,vertices1.data(),1,N);
-      passed &= checkHairInterpolation(scene,geomID,RTC_USER_VERTEX_BUFFER0,user_vertices0.data(),1,N);
-      passed &= checkHairInterpolation(scene,geomID,RTC_USER_VERTEX_BUFFER1,user_vertices1.data(),1,N);
-      
+      AssertNoError(device_small);
+
+      auto get = [] (RTCDevice device, RTCParameter parm) { return rtcDeviceGetParameter1i(device,parm); };
+
+      /* the first pass tessellates the patches into the large cache */
+      const size_t N = 32, numRays = N*N;
+      trace(scene,N);
       AssertNoError(device);
+      if (get(device,RTC_TESSELLATION_CACHE_ACCESSES) < (ssize_t)numRays) return VerifyApplication::FAILED;
+      if (get(device,RTC_TESSELLATION_CACHE_HITS) >= get(device,RTC_TESSELLATION_CACHE_ACCESSES)) return VerifyApplication::FAILED;
+      if (get(device,RTC_TESSELLATION_CACHE_TESSELLATIONS) == 0) return VerifyApplication::FAILED;
+      if (get(device,RTC_TESSELLATION_CACHE_TESSELLATED_BYTES) == 0) return VerifyApplication::FAILED;
+      if (get(device,RTC_TESSELLATION_CACHE_FLUSHES) != 0) return VerifyApplication::FAILED;
+
+      /* the other device does not see these statistics */
+      if (get(device_small,RTC_TESSELLATION_CACHE_ACCESSES) != 0) return VerifyApplication::FAILED;
+
+      /* after clearing the statistics, the second pass finds all patches in the cache */
+      rtcDeviceSetParameter1i(device,RTC_TESSELLATION_CACHE_CLEAR_STATS,0);
+      if (get(device,RTC_TESSELLATION_CACHE_ACCESSES) != 0) return VerifyApplication::FAILED;
+      trace(scene,N);
+      AssertNoError(device);
+      if (get(device,RTC_TESSELLATION_CACHE_ACCESSES) < (ssize_t)numRays) return VerifyApplication::FAILED;
+      if (get(device,RTC_TESSELLATION_CACHE_HITS) != get(device,RTC_TESSELLATION_CACHE_ACCESSES)) return VerifyApplication::FAILED;
+      if (get(device,RTC_TESSELLATION_CACHE_TESSELLATIONS) != 0) return VerifyApplication::FAILED;
+      if (get(device,RTC_TESSELLATION_CACHE_TESSELLATED_BYTES) != 0) return VerifyApplication::FAILED;
 
-      return (VerifyApplication::TestReturnValue) passed;
+      /* the small cache has to invalidate segments */
+      for (size_t i=0; i<4; i++) trace(scene_small,N);
+      AssertNoError(device_small);
+      if (get(device_small,RTC_TESSELLATION_CACHE_FLUSHES) == 0) return VerifyApplication::FAILED;
+      if (get(device_small,RTC_TESSELLATION_CACHE_TESSELLATIONS) == 0) return VerifyApplication::FAILED;
+
+      return VerifyApplication::PASSED;
     }
   };
 
-  /////////////////////////////////////////////////////////////////////////////////
-  /////////////////////////////////////////////////////////////////////////////////
-  /////////////////////////////////////////////////////////////////////////////////
-  /////////////////////////////////////////////////////////////////////////////////
-
   struct TriangleHitTest : public VerifyApplication::IntersectTest
   {
     RTCSceneFlags sflags; 
@@ -2653,6 +4252,82 @@ namespace embree
     }
   };
 
+  struct SelfIntersectionTest : public VerifyApplication::IntersectTest
+  {
+    ALIGNED_STRUCT;
+    RTCSceneFlags sflags;
+    std::string model;
+    Vec3fa pos;
+    float radius;
+    static const size_t N = 10;
+    static const size_t maxStreamSize = 100;
+    
+    SelfIntersectionTest (std::string name, int isa, RTCSceneFlags sflags, IntersectMode imode, std::string model, const Vec3fa& pos, const float radius)
+      : VerifyApplication::IntersectTest(name,isa,imode,VARIANT_INTERSECT,VerifyApplication::TEST_SHOULD_PASS), sflags(sflags), model(model), pos(pos), radius(radius) {}
+    
+    VerifyApplication::TestReturnValue run(VerifyApplication* state, bool silent)
+    {
+      std::string cfg = state->rtcore + ",isa="+stringOfISA(isa);
+      RTCDeviceRef device = rtcNewDevice(cfg.c_str());
+      errorHandler(nullptr,rtcDeviceGetError(device));
+      if (!supportsIntersectMode(device,imode))
+        return VerifyApplication::SKIPPED;
+
+      /* the sphere has to stay convex after rounding its vertices to the precision at pos */
+      VerifyScene scene(device,sflags,to_aflags(imode));
+      const size_t size = 32;
+      if      (model == "sphere.triangles") scene.addGeometry(RTC_GEOMETRY_STATIC,SceneGraph::createTriangleSphere(pos,radius,size));
+      else if (model == "sphere.quads"    ) scene.addGeometry(RTC_GEOMETRY_STATIC,SceneGraph::createQuadSphere    (pos,radius,size));
+      rtcCommit (scene);
+      AssertNoError(device);
+      
+      size_t numTests = 0;
+      size_t numFailures = 0;
+      for (auto ivariant : state->intersectVariants)
+      for (size_t i=0; i<size_t(N*state->intensity); i++) 
+      {
+        for (size_t M=1; M<maxStreamSize; M++)
+        {
+          /* shoot primary rays from outside onto the sphere */
+          __aligned(16) RTCRay rays[maxStreamSize];
+          for (size_t j=0; j<M; j++) 
+          {
+            const Vec3fa org = pos + 2.0f*radius*normalize(2.0f*random_Vec3fa() - Vec3fa(1.0f));
+            const Vec3fa dir = pos + 0.5f*radius*(2.0f*random_Vec3fa() - Vec3fa(1.0f)) - org;
+            rays[j] = makeRay(org,dir); 
+          }
+          IntersectWithMode(imode,ivariant,scene,rays,M);
+
+          /* spawn secondary rays at the hit points that leave the sphere */
+          size_t K = 0;
+          for (size_t j=0; j<M; j++) 
+          {
+            if (rays[j].geomID == RTC_INVALID_GEOMETRY_ID) continue;
+            const RTCRay& ray = rays[j];
+            const Vec3fa org = Vec3fa(ray.org[0],ray.org[1],ray.org[2]) + ray.tfar*Vec3fa(ray.dir[0],ray.dir[1],ray.dir[2]);
+            Vec3fa Ng = normalize(Vec3fa(ray.Ng[0],ray.Ng[1],ray.Ng[2]));
+            if (dot(Ng,org-pos) < 0.0f) Ng = -Ng;
+            Vec3fa dir = normalize(2.0f*random_Vec3fa() - Vec3fa(1.0f));
+            if (dot(dir,Ng) < 0.0f) dir = -dir;
+            dir = normalize(dir + 0.2f*Ng); // avoid grazing rays as rounding breaks convexity
+            rays[K++] = makeRay(org,dir);
+          }
+          IntersectWithMode(imode,ivariant,scene,rays,K);
+          for (size_t j=0; j<K; j++) {
+            numTests++;
+            numFailures += rays[j].geomID != RTC_INVALID_GEOMETRY_ID;
+          }
+        }
+      }
+      AssertNoError(device);
+
+      double failRate = double(numFailures) / double(numTests);
+      bool failed = failRate > 0.00002;
+      if (!silent) { printf(" (%f%%)", 100.0f*failRate); fflush(stdout); }
+      return (VerifyApplication::TestReturnValue)(!failed);
+    }
+  };
+
   struct SmallTriangleHitTest : public VerifyApplication::IntersectTest
   {
     ALIGNED_STRUCT;
@@ -4184,6 +5859,49 @@ namespace embree
       for (auto sflags : sceneFlags) 
         groups.top()->add(new BuildTest(to_string(sflags),isa,sflags,RTC_GEOMETRY_STATIC));
       groups.pop();
+
+      push(new TestGroup("bvh_cache",true,true));
+      for (auto sflags : sceneFlags) 
+        groups.top()->add(new BVHCacheTest(to_string(sflags),isa,sflags));
+      groups.pop();
+
+      push(new TestGroup("streaming_build",true,true));
+      for (auto sflags : sceneFlags)
+        groups.top()->add(new StreamingBuildTest(to_string(sflags),isa,sflags));
+      groups.pop();
+
+      push(new TestGroup("ploc_build",true,true));
+      for (auto sflags : sceneFlags)
+        groups.top()->add(new PLOCBuildTest(to_string(sflags),isa,sflags));
+      groups.pop();
+
+      push(new TestGroup("bvh_restructure",true,true));
+      for (auto sflags : sceneFlags)
+        if (!(sflags & RTC_SCENE_DYNAMIC) && !(sflags & RTC_SCENE_HIGH_QUALITY))
+          groups.top()->add(new BVHRestructureTest(to_string(sflags),isa,RTCSceneFlags(sflags | RTC_SCENE_HIGH_QUALITY)));
+      groups.pop();
+
+      push(new TestGroup("occlusion_order",true,true));
+      for (auto sflags : sceneFlags)
+        if (!(sflags & RTC_SCENE_DYNAMIC))
+          groups.top()->add(new OcclusionOrderTest(to_string(sflags),isa,sflags));
+      groups.pop();
+
+      push(new TestGroup("shared_scene",true,true));
+      for (auto sflags : sceneFlags)
+        if (!(sflags & RTC_SCENE_DYNAMIC))
+          groups.top()->add(new SharedSceneTest(to_string(sflags),isa,sflags));
+      groups.pop();
+
+      push(new TestGroup("async_commit",true,true));
+      for (auto sflags : sceneFlagsDynamic)
+        groups.top()->add(new AsyncCommitTest(to_string(sflags),isa,sflags));
+      groups.pop();
+
+      push(new TestGroup("scene_statistics",true,true));
+      for (auto sflags : sceneFlags)
+        groups.top()->add(new SceneStatisticsTest(to_string(sflags),isa,sflags));
+      groups.pop();
       
       push(new TestGroup("overlapping_primitives",true,true));
       for (auto sflags : sceneFlags)
@@ -4218,6 +5936,13 @@ namespace embree
       }
       groups.pop();
 
+      push(new TestGroup("incremental_update",true,true));
+      for (auto sflags : sceneFlagsDynamic) {
+        groups.top()->add(new IncrementalUpdateTest("deformable."+to_string(sflags),isa,sflags,RTC_GEOMETRY_DEFORMABLE));
+        groups.top()->add(new IncrementalUpdateTest("dynamic."+to_string(sflags),isa,sflags,RTC_GEOMETRY_DYNAMIC));
+      }
+      groups.pop();
+
       groups.top()->add(new GarbageGeometryTest("build_garbage_geom",isa));
 
       GeometryType gtypes_memory[] = { TRIANGLE_MESH, TRIANGLE_MESH_MB, QUAD_MESH, QUAD_MESH_MB, HAIR_GEOMETRY, HAIR_GEOMETRY_MB, LINE_GEOMETRY, LINE_GEOMETRY_MB };
@@ -4271,6 +5996,75 @@ namespace embree
                 groups.top()->add(new TriangleHitTest(to_string(sflags,imode,ivariant),isa,sflags,RTC_GEOMETRY_STATIC,imode,ivariant));
       groups.pop();
       
+      push(new TestGroup("ray_stream_sort",true,true));
+      for (auto sflags : sceneFlags) 
+        for (auto imode : { MODE_INTERSECT1M, MODE_INTERSECT1Mp })
+          for (auto ivariant : intersectVariants)
+            if (has_variant(imode,ivariant))
+              groups.top()->add(new RayStreamSortTest(to_string(sflags,imode,ivariant),isa,sflags,imode,ivariant));
+      groups.pop();
+
+      push(new TestGroup("nested_instances",true,true));
+      for (auto sflags : sceneFlags)
+        for (auto imode : intersectModes)
+          for (auto ivariant : intersectVariants)
+            if (has_variant(imode,ivariant))
+              groups.top()->add(new NestedInstanceTest(to_string(sflags,imode,ivariant),isa,sflags,imode,ivariant));
+      groups.pop();
+
+      push(new TestGroup("quaternion_instances",true,true));
+      for (auto sflags : sceneFlags)
+        for (auto imode : intersectModes)
+          for (auto ivariant : intersectVariants)
+            if (has_variant(imode,ivariant))
+              groups.top()->add(new QuaternionInstanceTest(to_string(sflags,imode,ivariant),isa,sflags,imode,ivariant));
+      groups.pop();
+
+      push(new TestGroup("ray_packet_repacking",true,true));
+      for (auto sflags : sceneFlags)
+        for (auto imode : { MODE_INTERSECTNM3, MODE_INTERSECTNM4, MODE_INTERSECTNM8, MODE_INTERSECTNM16, MODE_INTERSECTNp })
+          for (auto ivariant : intersectVariants)
+            if (has_variant(imode,ivariant))
+              groups.top()->add(new RayPacketRepackingTest(to_string(sflags,imode,ivariant),isa,sflags,imode,ivariant));
+      groups.pop();
+
+      push(new TestGroup("k_nearest_hits",true,true));
+      for (auto sflags : sceneFlags)
+        for (auto imode : { MODE_INTERSECT1, MODE_INTERSECT4, MODE_INTERSECT8, MODE_INTERSECT16, MODE_INTERSECT1M })
+          groups.top()->add(new KNearestHitsTest(to_string(sflags,imode),isa,sflags,imode));
+      groups.pop();
+
+      push(new TestGroup("traversal_stats",true,true));
+      for (auto sflags : sceneFlags)
+        for (auto imode : { MODE_INTERSECT1, MODE_INTERSECT4, MODE_INTERSECT8, MODE_INTERSECT16, MODE_INTERSECT1M, MODE_INTERSECT1Mp,
+                            MODE_INTERSECTNM1, MODE_INTERSECTNM3, MODE_INTERSECTNM4, MODE_INTERSECTNM8, MODE_INTERSECTNM16 })
+          for (auto ivariant : { VARIANT_INTERSECT_COHERENT, VARIANT_OCCLUDED_COHERENT, VARIANT_INTERSECT_INCOHERENT, VARIANT_OCCLUDED_INCOHERENT })
+            if (has_variant(imode,ivariant))
+              groups.top()->add(new TraversalStatsTest(to_string(sflags,imode,ivariant),isa,sflags,imode,ivariant));
+      groups.pop();
+
+      push(new TestGroup("point_query",true,true));
+      for (auto sflags : sceneFlags)
+        if (!(sflags & RTC_SCENE_COMPACT))
+          for (bool stream : { false, true })
+            groups.top()->add(new PointQueryTest(to_string(sflags)+(stream ? ".1M" : ".1"),isa,sflags,stream));
+      groups.pop();
+
+      push(new TestGroup("subdiv_ray_cone",true,true));
+      for (auto imode : { MODE_INTERSECT1, MODE_INTERSECT4, MODE_INTERSECT8, MODE_INTERSECT16, MODE_INTERSECT1M })
+        groups.top()->add(new SubdivRayConeTest(to_string(imode),isa,imode));
+      groups.pop();
+
+      groups.top()->add(new TessellationCacheTest("tessellation_cache",isa));
+      groups.top()->add(new TessellationCacheStatsTest("tessellation_cache_stats",isa));
+
+      push(new TestGroup("quantized_grids",true,true));
+      for (auto imode : intersectModes)
+        for (auto ivariant : intersectVariants)
+          if (has_variant(imode,ivariant))
+            groups.top()->add(new QuantizedGridTest(to_string(imode,ivariant),isa,imode,ivariant));
+      groups.pop();
+
       push(new TestGroup("quad_hit",true,true));
       for (auto sflags : sceneFlags) 
         for (auto imode : intersectModes) 
@@ -4378,6 +6172,16 @@ namespace embree
         groups.pop();
       }
       
+      push(new TestGroup("self_intersection",true,true)); {
+        std::string selfIntersectionModels [] = {"sphere.triangles", "sphere.quads"};
+        const Vec3fa self_intersection_pos = Vec3fa(6.4E6f,0.0f,0.0f);
+        for (auto sflags : sceneFlagsRobust) 
+          for (auto imode : intersectModes) 
+            for (std::string model : selfIntersectionModels) 
+              groups.top()->add(new SelfIntersectionTest(to_string(sflags,imode)+"."+model,isa,sflags,imode,model,self_intersection_pos,1000.0f));
+        groups.pop();
+      }
+      
       /*push(new TestGroup("small_triangle_hit_test",true,true)); {
         const Vec3fa pos = Vec3fa(0.0f,0.0f,0.0f);
         const float radius = 1000000.0f;